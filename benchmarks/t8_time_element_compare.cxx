@@ -0,0 +1,154 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2023 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <sc_flops.h>
+#include <sc_options.h>
+#include <sc_statistics.h>
+
+#include <t8.h>
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+/* In this file we benchmark t8_element_compare for the different element
+ * classes. For each class, all elements of a uniform refinement of the root
+ * are shuffled and sorted with t8_element_compare. Afterwards, each element is
+ * searched in the sorted array. For quads and hexes, the default scheme compares
+ * the elements with p4est_quadrant_compare resp. p8est_quadrant_compare, which
+ * is the reference for the triangle and tetrahedron timings.
+ */
+
+static void
+t8_time_element_compare (t8_eclass_scheme_c *ts, const int level, sc_statinfo_t *sort_stat,
+                         sc_statinfo_t *search_stat)
+{
+  const t8_gloidx_t num_elements = ts->t8_element_count_leaves_from_root (level);
+  const size_t element_size = ts->t8_element_size ();
+  std::vector<char> element_memory (num_elements * element_size);
+  std::vector<t8_element_t *> elements (num_elements);
+
+  for (t8_gloidx_t ielement = 0; ielement < num_elements; ielement++) {
+    elements[ielement] = (t8_element_t *) (element_memory.data () + ielement * element_size);
+  }
+  ts->t8_element_init (num_elements, (t8_element_t *) element_memory.data ());
+  for (t8_gloidx_t ielement = 0; ielement < num_elements; ielement++) {
+    ts->t8_element_set_linear_id (elements[ielement], level, ielement);
+  }
+  std::mt19937 generator (0);
+  std::shuffle (elements.begin (), elements.end (), generator);
+  std::vector<t8_element_t *> queries (elements);
+
+  const auto less = [ts] (const t8_element_t *elem1, const t8_element_t *elem2) {
+    return ts->t8_element_compare (elem1, elem2) < 0;
+  };
+
+  sc_flopinfo_t fi, snapshot;
+  sc_flops_start (&fi);
+  sc_flops_snap (&fi, &snapshot);
+  std::sort (elements.begin (), elements.end (), less);
+  sc_flops_shot (&fi, &snapshot);
+  sc_stats_set1 (sort_stat, snapshot.iwtime, sort_stat->variable);
+
+  size_t num_found = 0;
+  sc_flops_snap (&fi, &snapshot);
+  for (const t8_element_t *query : queries) {
+    num_found += std::binary_search (elements.begin (), elements.end (), query, less);
+  }
+  sc_flops_shot (&fi, &snapshot);
+  sc_stats_set1 (search_stat, snapshot.iwtime, search_stat->variable);
+  SC_CHECK_ABORT (num_found == queries.size (), "Not all elements were found.");
+
+  ts->t8_element_deinit (num_elements, (t8_element_t *) element_memory.data ());
+}
+
+int
+main (int argc, char **argv)
+{
+  int helpme;
+  int level;
+  char usage[BUFSIZ];
+  char help[BUFSIZ];
+
+  /* brief help message */
+  int sreturnA = snprintf (usage, BUFSIZ,
+                           "Usage:\t%s <OPTIONS>\n\t%s -h\t"
+                           "for a brief overview of all options.",
+                           basename (argv[0]), basename (argv[0]));
+  /* long help message */
+  int sreturnB = snprintf (help, BUFSIZ,
+                           "Time sorting and searching of uniformly refined elements of "
+                           "each element class with t8_element_compare.\n\n%s\n",
+                           usage);
+  if (sreturnA > BUFSIZ || sreturnB > BUFSIZ) {
+    /* The usage string or help message was truncated */
+    /* Note: gcc >= 7.1 prints a warning if we
+     * do not check the return value of snprintf. */
+    t8_debugf ("Warning: Truncated usage string and help message to '%s' and '%s'\n", usage, help);
+  }
+
+  int mpiret = sc_MPI_Init (&argc, &argv);
+  SC_CHECK_MPI (mpiret);
+
+  sc_init (sc_MPI_COMM_WORLD, 1, 1, NULL, SC_LP_ESSENTIAL);
+  t8_init (SC_LP_DEFAULT);
+
+  sc_options_t *opt = sc_options_new (argv[0]);
+  sc_options_add_switch (opt, 'h', "help", &helpme, "Display a short help message.");
+  sc_options_add_int (opt, 'l', "level", &level, 6, "The refinement level of the elements. Default: 6");
+
+  int parsed = sc_options_parse (t8_get_package_id (), SC_LP_ERROR, opt, argc, argv);
+  if (parsed >= 0 && !helpme && level >= 0) {
+    const t8_eclass_t eclasses[] = { T8_ECLASS_QUAD, T8_ECLASS_TRIANGLE, T8_ECLASS_HEX, T8_ECLASS_TET };
+    const int num_eclasses = sizeof (eclasses) / sizeof (eclasses[0]);
+    char names[2 * num_eclasses][BUFSIZ];
+    sc_statinfo_t stats[2 * num_eclasses];
+    t8_scheme_cxx_t *scheme = t8_scheme_new_default_cxx ();
+
+    for (int iclass = 0; iclass < num_eclasses; iclass++) {
+      snprintf (names[2 * iclass], BUFSIZ, "%s sort", t8_eclass_to_string[eclasses[iclass]]);
+      snprintf (names[2 * iclass + 1], BUFSIZ, "%s search", t8_eclass_to_string[eclasses[iclass]]);
+      sc_stats_init (&stats[2 * iclass], names[2 * iclass]);
+      sc_stats_init (&stats[2 * iclass + 1], names[2 * iclass + 1]);
+      t8_time_element_compare (scheme->eclass_schemes[eclasses[iclass]], level, &stats[2 * iclass],
+                               &stats[2 * iclass + 1]);
+    }
+    sc_stats_compute (sc_MPI_COMM_WORLD, 2 * num_eclasses, stats);
+    sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, 2 * num_eclasses, stats, 1, 1);
+    t8_scheme_cxx_unref (&scheme);
+  }
+  else {
+    /* Display help message and usage. */
+    t8_global_productionf ("%s\n", help);
+    sc_options_print_usage (t8_get_package_id (), SC_LP_ERROR, opt, NULL);
+  }
+
+  sc_options_destroy (opt);
+  sc_finalize ();
+
+  mpiret = sc_MPI_Finalize ();
+  SC_CHECK_MPI (mpiret);
+
+  return 0;
+}
@@ -34,9 +34,10 @@
 /* In this file benchmarks the `t8_set_join_by_vertices` routine by reading in
  * a given mesh file, retrieving the vertices and building the face
  * connectivity. The benchmark results are compared to the
- * `t8_cmesh_readmshfile` routine. Up to now, the latter is much faster. In the
- * future, `t8_set_join_by_vertices` may be optimized to close up to the reader
- * in terms of speed.
+ * `t8_cmesh_readmshfile` routine.
+ * Alternatively, the trees of a brick of hexahedra are distributed over all
+ * processes and joined with `t8_cmesh_set_join_by_vertices_parallel`, which
+ * shows the scaling with the number of trees and processes.
  */
 
 static void
@@ -90,6 +91,63 @@ test_with_cmesh (t8_cmesh_t cmesh)
   T8_FREE (all_eclasses);
 }
 
+/* Benchmark `t8_cmesh_set_join_by_vertices_parallel` with a brick of
+ * num_cubes^3 hexahedra whose trees are uniformly distributed over all processes. */
+static void
+test_with_brick (const int num_cubes)
+{
+  int mpirank, mpisize;
+  int mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  const t8_gloidx_t num_trees = (t8_gloidx_t) num_cubes * num_cubes * num_cubes;
+  const t8_gloidx_t first_tree = num_trees * mpirank / mpisize;
+  const t8_locidx_t ntrees = num_trees * (mpirank + 1) / mpisize - first_tree;
+
+  t8_global_productionf ("ntrees = %lli.\n", (long long) num_trees);
+
+  /* Arrays for the face connectivity computations via vertices. */
+  double *all_verts = T8_ALLOC (double, ntrees *T8_ECLASS_MAX_CORNERS *T8_ECLASS_MAX_DIM);
+  t8_eclass_t *all_eclasses = T8_ALLOC (t8_eclass_t, ntrees);
+
+  /* Compute the vertices of the local cubes. */
+  for (t8_locidx_t itree = 0; itree < ntrees; itree++) {
+    const t8_gloidx_t gtree = first_tree + itree;
+    const t8_gloidx_t cube[3] = { gtree % num_cubes, gtree / num_cubes % num_cubes, gtree / num_cubes / num_cubes };
+    all_eclasses[itree] = T8_ECLASS_HEX;
+    for (int ivert = 0; ivert < T8_ECLASS_MAX_CORNERS; ivert++) {
+      for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+        all_verts[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord)]
+          = (double) (cube[icoord] + ((ivert >> icoord) & 1)) / num_cubes;
+      }
+    }
+  }
+
+  sc_flopinfo_t fi, snapshot;
+  sc_statinfo_t stats[1];
+
+  /* Start timer */
+  sc_flops_start (&fi);
+  sc_flops_snap (&fi, &snapshot);
+
+  /* Compute face connectivity. */
+  t8_cmesh_set_join_by_vertices_parallel (NULL, first_tree, ntrees, all_eclasses, all_verts, NULL,
+                                          sc_MPI_COMM_WORLD);
+
+  /* Measure passed time. */
+  sc_flops_shot (&fi, &snapshot);
+  sc_stats_set1 (&stats[0], snapshot.iwtime, "t8_cmesh_set_join_by_vertices_parallel");
+
+  /* Print stats. */
+  sc_stats_compute (sc_MPI_COMM_WORLD, 1, stats);
+  sc_stats_print (t8_get_package_id (), SC_LP_STATISTICS, 1, stats, 1, 1);
+
+  T8_FREE (all_verts);
+  T8_FREE (all_eclasses);
+}
+
 int
 main (int argc, char **argv)
 {
@@ -118,6 +176,7 @@ main (int argc, char **argv)
   t8_init (SC_LP_DEFAULT);
 
   int helpme;
+  int num_cubes;
 
   const char *meshfile;
 
@@ -125,6 +184,8 @@ main (int argc, char **argv)
   sc_options_t *opt = sc_options_new (argv[0]);
   sc_options_add_switch (opt, 'h', "help", &helpme, "Display a short help message.");
   sc_options_add_string (opt, 'f', "fileprefix", &meshfile, NULL, "File prefix of the mesh file (without .msh)");
+  sc_options_add_int (opt, 'b', "brick", &num_cubes, 0,
+                      "Instead of a mesh file, join the trees of a distributed brick of b^3 hexahedra.");
 
   int parsed = sc_options_parse (t8_get_package_id (), SC_LP_ERROR, opt, argc, argv);
 
@@ -160,6 +221,9 @@ main (int argc, char **argv)
 
     t8_cmesh_unref (&cmesh);
   }
+  else if (parsed >= 0 && num_cubes > 0) {
+    test_with_brick (num_cubes);
+  }
   else {
     /* Display help message and usage. */
     t8_global_productionf ("%s\n", help);
@@ -28,6 +28,7 @@
 #include <t8_forest/t8_forest_geometrical.h>
 #include <t8_forest/t8_forest_profiling.h>
 #include <t8_forest/t8_forest_iterate.h>
+#include <t8_forest/t8_forest_iterate.hxx>
 #include <t8_forest/t8_forest_partition.h>
 #include <t8_forest/t8_forest_ghost.h>
 #include <example/common/t8_example_common.h>
@@ -516,7 +517,7 @@ t8_advect_advance_element (t8_advect_problem_t *problem, t8_locidx_t lelement)
 /* Compute element midpoint and vol and store at element_data field. */
 static void
 t8_advect_compute_element_data (t8_advect_problem_t *problem, t8_advect_element_data_t *elem_data,
-                                const t8_element_t *element, t8_locidx_t ltreeid, t8_eclass_scheme_c *ts)
+                                const t8_element_t *element, t8_locidx_t ltreeid, const t8_eclass_scheme_c *ts)
 {
   /* Compute the midpoint coordinates of element */
   t8_forest_element_centroid (problem->forest, ltreeid, element, elem_data->midpoint);
@@ -982,76 +983,70 @@ t8_advect_project_element_data (t8_advect_problem_t *problem)
 static void
 t8_advect_problem_init_elements (t8_advect_problem_t *problem)
 {
-  t8_locidx_t itree, ielement, idata;
-  t8_locidx_t num_trees, num_elems_in_tree;
   t8_element_t **neighbors;
   int iface, ineigh;
   t8_advect_element_data_t *elem_data;
-  t8_eclass_scheme_c *ts, *neigh_scheme;
+  t8_eclass_scheme_c *neigh_scheme;
   double speed, max_speed = 0, min_diam = -1, delta_t, min_delta_t;
   double u[3];
   double diam;
   double min_vol = 1e9;
 
-  num_trees = t8_forest_get_num_local_trees (problem->forest);
   /* maximum possible delta_t value */
   min_delta_t = problem->T - problem->t;
-  for (itree = 0, idata = 0; itree < num_trees; itree++) {
-    ts = t8_forest_get_eclass_scheme (problem->forest, t8_forest_get_tree_class (problem->forest, itree));
-    num_elems_in_tree = t8_forest_get_tree_num_elements (problem->forest, itree);
-    for (ielement = 0; ielement < num_elems_in_tree; ielement++, idata++) {
-      const t8_element_t *element = t8_forest_get_element_in_tree (problem->forest, itree, ielement);
-      elem_data = (t8_advect_element_data_t *) t8_sc_array_index_locidx (problem->element_data, idata);
-      /* Initialize the element's midpoint and volume */
-      t8_advect_compute_element_data (problem, elem_data, element, itree, ts);
-      /* Compute the minimum diameter */
-      diam = t8_forest_element_diam (problem->forest, itree, element);
-      T8_ASSERT (diam > 0);
-      min_diam = min_diam < 0 ? diam : SC_MIN (min_diam, diam);
-      /* Compute the maximum velocity */
-      problem->u (elem_data->midpoint, problem->t, u);
-      speed = t8_vec_norm (u);
-      max_speed = SC_MAX (max_speed, speed);
-
-      /* Compute minimum necessary time step */
-      delta_t = problem->T - problem->t;
-      if (speed > 0) {
-        delta_t = problem->cfl * diam / speed;
-      }
-      min_delta_t = SC_MIN (delta_t, min_delta_t);
-      if (problem->volume_refine >= 0 && problem->min_vol <= 0) {
-        /* Compute the minimum volume */
-        min_vol = SC_MIN (min_vol, elem_data->vol);
+  /* Iterate over all local elements, idata is the local index of the element in the forest */
+  t8_forest_for_each_element (problem->forest, [&] (const auto *scheme, t8_locidx_t itree, t8_locidx_t ielement,
+                                                    t8_locidx_t idata, const t8_element_t *element) {
+    elem_data = (t8_advect_element_data_t *) t8_sc_array_index_locidx (problem->element_data, idata);
+    /* Initialize the element's midpoint and volume */
+    t8_advect_compute_element_data (problem, elem_data, element, itree, scheme);
+    /* Compute the minimum diameter */
+    diam = t8_forest_element_diam (problem->forest, itree, element);
+    T8_ASSERT (diam > 0);
+    min_diam = min_diam < 0 ? diam : SC_MIN (min_diam, diam);
+    /* Compute the maximum velocity */
+    problem->u (elem_data->midpoint, problem->t, u);
+    speed = t8_vec_norm (u);
+    max_speed = SC_MAX (max_speed, speed);
+
+    /* Compute minimum necessary time step */
+    delta_t = problem->T - problem->t;
+    if (speed > 0) {
+      delta_t = problem->cfl * diam / speed;
+    }
+    min_delta_t = SC_MIN (delta_t, min_delta_t);
+    if (problem->volume_refine >= 0 && problem->min_vol <= 0) {
+      /* Compute the minimum volume */
+      min_vol = SC_MIN (min_vol, elem_data->vol);
+    }
+    /* Set the initial condition */
+    t8_advect_element_set_phi (problem, idata, problem->phi_0 (elem_data->midpoint, 0, problem->udata_for_phi));
+    /* Set the level */
+    elem_data->level = scheme->t8_element_level (element);
+    /* Set the faces */
+    elem_data->num_faces = scheme->t8_element_num_faces (element);
+    for (iface = 0; iface < elem_data->num_faces; iface++) {
+      /* Compute the indices of the face neighbors */
+
+      t8_forest_leaf_face_neighbors (problem->forest, itree, element, &neighbors, iface,
+                                     &elem_data->dual_faces[iface], &elem_data->num_neighbors[iface],
+                                     &elem_data->neighs[iface], &neigh_scheme, 1);
+      for (ineigh = 0; ineigh < elem_data->num_neighbors[iface]; ineigh++) {
+        elem_data->neigh_level[iface] = neigh_scheme->t8_element_level (neighbors[ineigh]);
       }
-      /* Set the initial condition */
-      t8_advect_element_set_phi (problem, idata, problem->phi_0 (elem_data->midpoint, 0, problem->udata_for_phi));
-      /* Set the level */
-      elem_data->level = ts->t8_element_level (element);
-      /* Set the faces */
-      elem_data->num_faces = ts->t8_element_num_faces (element);
-      for (iface = 0; iface < elem_data->num_faces; iface++) {
-        /* Compute the indices of the face neighbors */
-
-        t8_forest_leaf_face_neighbors (problem->forest, itree, element, &neighbors, iface,
-                                       &elem_data->dual_faces[iface], &elem_data->num_neighbors[iface],
-                                       &elem_data->neighs[iface], &neigh_scheme, 1);
-        for (ineigh = 0; ineigh < elem_data->num_neighbors[iface]; ineigh++) {
-          elem_data->neigh_level[iface] = neigh_scheme->t8_element_level (neighbors[ineigh]);
-        }
 
-        if (elem_data->num_neighbors[iface] > 0) {
-          neigh_scheme->t8_element_destroy (elem_data->num_neighbors[iface], neighbors);
-          T8_FREE (neighbors);
-          //t8_global_essentialf("alloc face %i of elem %i\n", iface, ielement);
-          elem_data->fluxes[iface] = T8_ALLOC (double, elem_data->num_neighbors[iface]);
-        }
-        else {
-          elem_data->fluxes[iface] = T8_ALLOC (double, 1);
-        }
-        elem_data->flux_valid[iface] = 0;
+      if (elem_data->num_neighbors[iface] > 0) {
+        neigh_scheme->t8_element_destroy (elem_data->num_neighbors[iface], neighbors);
+        T8_FREE (neighbors);
+        //t8_global_essentialf("alloc face %i of elem %i\n", iface, ielement);
+        elem_data->fluxes[iface] = T8_ALLOC (double, elem_data->num_neighbors[iface]);
+      }
+      else {
+        elem_data->fluxes[iface] = T8_ALLOC (double, 1);
       }
+      elem_data->flux_valid[iface] = 0;
     }
-  }
+  });
   /* Exchange ghost values */
   t8_forest_ghost_exchange_data (problem->forest, problem->phi_values);
 
@@ -1186,7 +1181,6 @@ t8_advect_solve (t8_cmesh_t cmesh, t8_flow_function_3d_fn u, t8_example_level_se
 {
   t8_advect_problem_t *problem;
   int iface, ineigh;
-  t8_locidx_t itree, ielement, lelement;
   t8_advect_element_data_t *elem_data, *neigh_data = NULL;
   double flux;
   double l_infty, L_2;
@@ -1261,159 +1255,155 @@ t8_advect_solve (t8_cmesh_t cmesh, t8_flow_function_3d_fn u, t8_example_level_se
     sc_stats_accumulate (&problem->stats[ADVECT_ELEM_AVG], t8_forest_get_global_num_elements (problem->forest));
 
     solve_time -= sc_MPI_Wtime ();
-    for (itree = 0, lelement = 0; itree < t8_forest_get_num_local_trees (problem->forest); itree++) {
-      /* tree loop */
-      /* Get the scheme of this tree */
-      for (ielement = 0; ielement < t8_forest_get_tree_num_elements (problem->forest, itree); ielement++, lelement++) {
-        /* element loop */
-        /* Get a pointer to the element data */
-        elem_data = (t8_advect_element_data_t *) t8_sc_array_index_locidx (problem->element_data, lelement);
-        const t8_element_t *elem = t8_forest_get_element_in_tree (problem->forest, itree, ielement);
-        num_faces = elem_data->num_faces;
-        /* Compute left and right flux */
-        for (iface = 0; iface < num_faces; iface++) {
-          if (elem_data->flux_valid[iface] <= 0 || adapted_or_partitioned) {
-
-            /* Compute flux at this face */
-            if (adapted_or_partitioned) {
-              /* We changed the mesh, so that we have to calculate the neighbor
-               * indices again. */
-              if (elem_data->num_neighbors[iface] > 0) {
-                T8_FREE (elem_data->neighs[iface]);
-                T8_FREE (elem_data->dual_faces[iface]);
-                elem_data->flux_valid[iface] = -1;
-              }
-              T8_FREE (elem_data->fluxes[iface]);
-              neighbor_time = -sc_MPI_Wtime ();
-              t8_forest_leaf_face_neighbors (problem->forest, itree, elem, &neighs, iface,
-                                             &elem_data->dual_faces[iface], &elem_data->num_neighbors[iface],
-                                             &elem_data->neighs[iface], &neigh_scheme, 1);
-              for (ineigh = 0; ineigh < elem_data->num_neighbors[iface]; ineigh++) {
-                elem_data->neigh_level[iface] = neigh_scheme->t8_element_level (neighs[ineigh]);
-              }
+    /* Iterate over all local elements, lelement is the local index of the element in the forest */
+    t8_forest_for_each_element (problem->forest, [&] (const auto *scheme, t8_locidx_t itree, t8_locidx_t ielement,
+                                                      t8_locidx_t lelement, const t8_element_t *elem) {
+      /* Get a pointer to the element data */
+      elem_data = (t8_advect_element_data_t *) t8_sc_array_index_locidx (problem->element_data, lelement);
+      num_faces = elem_data->num_faces;
+      /* Compute left and right flux */
+      for (iface = 0; iface < num_faces; iface++) {
+        if (elem_data->flux_valid[iface] <= 0 || adapted_or_partitioned) {
+
+          /* Compute flux at this face */
+          if (adapted_or_partitioned) {
+            /* We changed the mesh, so that we have to calculate the neighbor
+             * indices again. */
+            if (elem_data->num_neighbors[iface] > 0) {
+              T8_FREE (elem_data->neighs[iface]);
+              T8_FREE (elem_data->dual_faces[iface]);
+              elem_data->flux_valid[iface] = -1;
+            }
+            T8_FREE (elem_data->fluxes[iface]);
+            neighbor_time = -sc_MPI_Wtime ();
+            t8_forest_leaf_face_neighbors (problem->forest, itree, elem, &neighs, iface,
+                                           &elem_data->dual_faces[iface], &elem_data->num_neighbors[iface],
+                                           &elem_data->neighs[iface], &neigh_scheme, 1);
+            for (ineigh = 0; ineigh < elem_data->num_neighbors[iface]; ineigh++) {
+              elem_data->neigh_level[iface] = neigh_scheme->t8_element_level (neighs[ineigh]);
+            }
 
-              T8_ASSERT (neighs != NULL || elem_data->num_neighbors[iface] == 0);
-              if (neighs != NULL) {
-                neigh_scheme->t8_element_destroy (elem_data->num_neighbors[iface], neighs);
+            T8_ASSERT (neighs != NULL || elem_data->num_neighbors[iface] == 0);
+            if (neighs != NULL) {
+              neigh_scheme->t8_element_destroy (elem_data->num_neighbors[iface], neighs);
 
-                T8_FREE (neighs);
-              }
+              T8_FREE (neighs);
+            }
 
-              /* Allocate flux storage */
-              elem_data->fluxes[iface] = T8_ALLOC (double, SC_MAX (1, elem_data->num_neighbors[iface]));
-              elem_data->flux_valid[iface] = 0;
+            /* Allocate flux storage */
+            elem_data->fluxes[iface] = T8_ALLOC (double, SC_MAX (1, elem_data->num_neighbors[iface]));
+            elem_data->flux_valid[iface] = 0;
 
-              neighbor_time += sc_MPI_Wtime ();
-              sc_stats_accumulate (&problem->stats[ADVECT_NEIGHS], neighbor_time);
-              /* We want to count all runs over the solver time as one */
-              problem->stats[ADVECT_NEIGHS].count = 1;
-            }
+            neighbor_time += sc_MPI_Wtime ();
+            sc_stats_accumulate (&problem->stats[ADVECT_NEIGHS], neighbor_time);
+            /* We want to count all runs over the solver time as one */
+            problem->stats[ADVECT_NEIGHS].count = 1;
+          }
 
-            /* sensible default */
-            neigh_data = NULL;
-            neigh_is_ghost = 0;
-            /* Compute whether this is a hanging face
-             * and whether the first neighbor is a ghost */
-            if (elem_data->num_neighbors[iface] >= 1) {
+          /* sensible default */
+          neigh_data = NULL;
+          neigh_is_ghost = 0;
+          /* Compute whether this is a hanging face
+           * and whether the first neighbor is a ghost */
+          if (elem_data->num_neighbors[iface] >= 1) {
 
-              neigh_index = elem_data->neighs[iface][0];
-              neigh_is_ghost = neigh_index >= t8_forest_get_local_num_elements (problem->forest);
-              hanging = elem_data->level != elem_data->neigh_level[iface];
+            neigh_index = elem_data->neighs[iface][0];
+            neigh_is_ghost = neigh_index >= t8_forest_get_local_num_elements (problem->forest);
+            hanging = elem_data->level != elem_data->neigh_level[iface];
+          }
+          else {
+            hanging = 0;
+            neigh_is_ghost = 0;
+          }
+          flux_time = -sc_MPI_Wtime ();
+          if (problem->dim == 1) {
+            if (elem_data->num_neighbors[iface] == 0) {
+              T8_ASSERT (elem_data->num_neighbors[iface] <= 0);
+              /* This is a boundary */
+              neigh_index = -1;
             }
-            else {
-              hanging = 0;
-              neigh_is_ghost = 0;
+            flux = t8_advect_flux_upwind_1d (problem, lelement, neigh_index, iface);
+            elem_data->fluxes[iface][0] = flux;
+            elem_data->flux_valid[iface] = 1;
+          }
+          else {
+            T8_ASSERT (problem->dim == 2 || problem->dim == 3);
+            /* Check whether the flux for the neighbor element was computed */
+            /* Get a pointer to the neighbor element */
+            if (elem_data->num_neighbors[iface] >= 1 && !neigh_is_ghost) {
+              neigh_data = (t8_advect_element_data_t *) t8_sc_array_index_locidx (problem->element_data, neigh_index);
             }
-            flux_time = -sc_MPI_Wtime ();
-            if (problem->dim == 1) {
-              if (elem_data->num_neighbors[iface] == 0) {
-                T8_ASSERT (elem_data->num_neighbors[iface] <= 0);
-                /* This is a boundary */
-                neigh_index = -1;
-              }
-              flux = t8_advect_flux_upwind_1d (problem, lelement, neigh_index, iface);
-              elem_data->fluxes[iface][0] = flux;
+
+            /* Get the phi value at the current element */
+            phi_plus = t8_advect_element_get_phi (problem, lelement);
+            if (elem_data->num_neighbors[iface] == 1) {
+              dual_face = elem_data->dual_faces[iface][0];
+              /* There is exactly one face-neighbor */
+              /* get the phi value at the neighbor element */
+              phi_minus = t8_advect_element_get_phi (problem, neigh_index);
+              flux = t8_advect_flux_upwind (problem, phi_plus, phi_minus, itree, elem, iface);
+
               elem_data->flux_valid[iface] = 1;
-            }
-            else {
-              T8_ASSERT (problem->dim == 2 || problem->dim == 3);
-              /* Check whether the flux for the neighbor element was computed */
-              /* Get a pointer to the neighbor element */
-              if (elem_data->num_neighbors[iface] >= 1 && !neigh_is_ghost) {
-                neigh_data = (t8_advect_element_data_t *) t8_sc_array_index_locidx (problem->element_data, neigh_index);
-              }
+              elem_data->fluxes[iface][0] = flux;
 
-              /* Get the phi value at the current element */
-              phi_plus = t8_advect_element_get_phi (problem, lelement);
-              if (elem_data->num_neighbors[iface] == 1) {
-                dual_face = elem_data->dual_faces[iface][0];
-                /* There is exactly one face-neighbor */
-                /* get the phi value at the neighbor element */
-                phi_minus = t8_advect_element_get_phi (problem, neigh_index);
-                flux = t8_advect_flux_upwind (problem, phi_plus, phi_minus, itree, elem, iface);
-
-                elem_data->flux_valid[iface] = 1;
-                elem_data->fluxes[iface][0] = flux;
-
-                /* If this face is not hanging, we can set the
-                 * flux of the neighbor element as well */
-                if (!adapted_or_partitioned && !neigh_is_ghost && !hanging) {
-                  if (neigh_data->flux_valid[dual_face] < 0) {
-                    neigh_data->fluxes[dual_face] = T8_ALLOC (double, 1);
-                    neigh_data->dual_faces[dual_face] = T8_ALLOC (int, 1);
-                    neigh_data->neighs[dual_face] = T8_ALLOC (t8_locidx_t, 1);
-                  }
-                  SC_CHECK_ABORT (dual_face < neigh_data->num_faces, "num\n");
-                  //         SC_CHECK_ABORT (neigh_data->num_neighbors[dual_face] == 1, "dual face\n");
-                  neigh_data->fluxes[dual_face][0] = -flux;
-                  neigh_data->dual_faces[dual_face][0] = iface;
-                  neigh_data->neighs[dual_face][0] = lelement;
-                  neigh_data->flux_valid[dual_face] = 1;
+              /* If this face is not hanging, we can set the
+               * flux of the neighbor element as well */
+              if (!adapted_or_partitioned && !neigh_is_ghost && !hanging) {
+                if (neigh_data->flux_valid[dual_face] < 0) {
+                  neigh_data->fluxes[dual_face] = T8_ALLOC (double, 1);
+                  neigh_data->dual_faces[dual_face] = T8_ALLOC (int, 1);
+                  neigh_data->neighs[dual_face] = T8_ALLOC (t8_locidx_t, 1);
                 }
+                SC_CHECK_ABORT (dual_face < neigh_data->num_faces, "num\n");
+                //         SC_CHECK_ABORT (neigh_data->num_neighbors[dual_face] == 1, "dual face\n");
+                neigh_data->fluxes[dual_face][0] = -flux;
+                neigh_data->dual_faces[dual_face][0] = iface;
+                neigh_data->neighs[dual_face][0] = lelement;
+                neigh_data->flux_valid[dual_face] = 1;
               }
-              else if (elem_data->num_neighbors[iface] > 1) {
-                flux = t8_advect_flux_upwind_hanging (problem, lelement, itree, elem, iface, adapted_or_partitioned);
-              }
-              else {
-                /* This element is at the domain boundary */
-                /* We enforce outflow boundary conditions */
-                T8_ASSERT (elem_data->num_neighbors[iface] <= 0);
-                t8_advect_boundary_set_phi (problem, lelement, &phi_minus);
+            }
+            else if (elem_data->num_neighbors[iface] > 1) {
+              flux = t8_advect_flux_upwind_hanging (problem, lelement, itree, elem, iface, adapted_or_partitioned);
+            }
+            else {
+              /* This element is at the domain boundary */
+              /* We enforce outflow boundary conditions */
+              T8_ASSERT (elem_data->num_neighbors[iface] <= 0);
+              t8_advect_boundary_set_phi (problem, lelement, &phi_minus);
 
-                flux = t8_advect_flux_upwind (problem, phi_plus, phi_minus, itree, elem, iface);
+              flux = t8_advect_flux_upwind (problem, phi_plus, phi_minus, itree, elem, iface);
 
-                elem_data->flux_valid[iface] = 1;
-                elem_data->fluxes[iface][0] = flux;
-              }
+              elem_data->flux_valid[iface] = 1;
+              elem_data->fluxes[iface][0] = flux;
             }
-            flux_time += sc_MPI_Wtime ();
-
-            sc_stats_accumulate (&problem->stats[ADVECT_FLUX], flux_time);
-            /* We want to count all runs over the solver time as one */
-            problem->stats[ADVECT_FLUX].count = 1;
           }
+          flux_time += sc_MPI_Wtime ();
+
+          sc_stats_accumulate (&problem->stats[ADVECT_FLUX], flux_time);
+          /* We want to count all runs over the solver time as one */
+          problem->stats[ADVECT_FLUX].count = 1;
         }
-        if (problem->dummy_op) {
-          /* simulate more load per element */
-          int i, j;
-          double *phi_values;
-          double dummy_time = -sc_MPI_Wtime ();
-          phi_values = (double *) t8_sc_array_index_locidx (problem->phi_values, ielement);
-          phi_values[1] = 0;
-          for (i = 1; i < 5; i++) {
-            phi_values[1] *= i;
-            for (j = 0; j < 5; j++) {
-              phi_values[1] += pow (i, j);
-            }
+      }
+      if (problem->dummy_op) {
+        /* simulate more load per element */
+        int i, j;
+        double *phi_values;
+        double dummy_time = -sc_MPI_Wtime ();
+        phi_values = (double *) t8_sc_array_index_locidx (problem->phi_values, ielement);
+        phi_values[1] = 0;
+        for (i = 1; i < 5; i++) {
+          phi_values[1] *= i;
+          for (j = 0; j < 5; j++) {
+            phi_values[1] += pow (i, j);
           }
-          dummy_time += sc_MPI_Wtime ();
-          sc_stats_accumulate (&problem->stats[ADVECT_DUMMY], dummy_time);
-          problem->stats[ADVECT_DUMMY].count = 1;
         }
-        /* Compute time step */
-        t8_advect_advance_element (problem, lelement);
+        dummy_time += sc_MPI_Wtime ();
+        sc_stats_accumulate (&problem->stats[ADVECT_DUMMY], dummy_time);
+        problem->stats[ADVECT_DUMMY].count = 1;
       }
-    }
+      /* Compute time step */
+      t8_advect_advance_element (problem, lelement);
+    });
     adapted_or_partitioned = 0;
     /* Store the advanced phi value in each element */
     t8_advect_project_element_data (problem);
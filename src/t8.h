@@ -132,6 +132,11 @@ typedef enum {
   T8_MPI_PARTITION_FOREST,              /**< Used for forest partitioning */
   T8_MPI_GHOST_FOREST,                  /**< Used for for ghost layer creation */
   T8_MPI_GHOST_EXC_FOREST,              /**< Used for ghost data exchange */
+  T8_MPI_GHOST_EXC_SHMEM,               /**< Used for setting up shared memory ghost data exchange */
+  T8_MPI_CMESH_READ_MSH_FILE,           /**< Used for parallel reading of msh files */
+  T8_MPI_CMESH_JOIN_BY_VERTICES,        /**< Used for joining distributed trees by their vertices */
+  T8_MPI_CMESH_REORDER,                 /**< Used for renumbering the trees of a partitioned cmesh */
+  T8_MPI_PARTITION_DATA,                /**< Used for transferring element data to a new partition */
   T8_MPI_TEST_ELEMENT_PACK_TAG,         /**< Used for testing mpi pack and unpack functionality */
   T8_MPI_TAG_LAST
 } t8_MPI_tag_t;
@@ -213,6 +213,32 @@ t8_cmesh_set_partition_offsets (t8_cmesh_t cmesh, t8_shmem_array_t tree_offsets)
 void
 t8_cmesh_set_partition_uniform (t8_cmesh_t cmesh, int element_level, t8_scheme_cxx_t *ts);
 
+/** The orderings of the trees that can be requested with \ref t8_cmesh_set_reorder. */
+typedef enum t8_cmesh_reorder_type
+{
+  T8_CMESH_REORDER_NONE = 0, /**< Keep the tree ids as they were set. */
+  T8_CMESH_REORDER_SFC,      /**< Order the trees along a Morton curve through their centroids. */
+  T8_CMESH_REORDER_RCM,      /**< Order the trees by reverse Cuthill-McKee on their face graph. */
+  T8_CMESH_REORDER_COUNT     /**< The number of orderings. */
+} t8_cmesh_reorder_type_t;
+
+/** Renumber the trees of a cmesh during \ref t8_cmesh_commit, such that
+ * trees that are close in the mesh get close tree ids.
+ * The trees are either sorted along a space-filling curve through their centroids,
+ * which are computed from the tree vertices, or by a reverse Cuthill-McKee ordering
+ * of the face connections. Neither ordering requires an external library.
+ * All tree ids given to the cmesh before commit refer to the old numbering.
+ * If the cmesh is partitioned, each process renumbers its local trees within its own
+ * range of tree ids and the partition must not contain shared trees. To obtain a
+ * partition with few ghosts, reorder a replicated cmesh and partition it afterwards.
+ * This call is only valid when the cmesh is not yet committed and not derived.
+ * \param [in,out] cmesh        The cmesh to be updated.
+ * \param [in]     reorder      The ordering of the trees.
+ * \see t8_cmesh_reorder for a reordering with METIS.
+ */
+void
+t8_cmesh_set_reorder (t8_cmesh_t cmesh, t8_cmesh_reorder_type_t reorder);
+
 /** Refine the cmesh to a given level.
  * Thus split each tree into x^level subtrees
  * TODO: implement */
@@ -435,6 +461,35 @@ t8_cmesh_t
 t8_cmesh_load_and_distribute (const char *fileprefix, int num_files, sc_MPI_Comm comm, t8_load_mode_t mode,
                               int procs_per_node);
 
+/** Save a committed cmesh to a single binary file.
+ * The trees, ghosts, face neighbors and attributes of each process are stored
+ * as they are in memory, together with an index that records the range of trees
+ * of each process. The file can only be read on machines with the same data layout.
+ * This function is collective.
+ * Currently, it is only legal to save cmeshes that use the linear geometry.
+ * \param [in] cmesh       A committed cmesh.
+ * \param [in] filename    The name of the file to write.
+ * \param [in] comm        The communicator of \a cmesh.
+ * \return                 True on success, false otherwise (on all processes).
+ */
+int
+t8_cmesh_save_binary (t8_cmesh_t cmesh, const char *filename, sc_MPI_Comm comm);
+
+/** Load a cmesh from a binary file written with \ref t8_cmesh_save_binary.
+ * The data of the trees is mapped into memory and used in place, where available,
+ * instead of being parsed and copied.
+ * A replicated cmesh is loaded on every process.
+ * A partitioned cmesh must be loaded with at least as many processes as it was saved with.
+ * Process i then loads the trees of process i, and the additional processes have no trees.
+ * Use \ref t8_cmesh_set_partition_uniform to redistribute the trees to all processes.
+ * This function is collective.
+ * \param [in] filename    The name of the file to read.
+ * \param [in] comm        The communicator of the new cmesh.
+ * \return                 The committed cmesh, or NULL if the file could not be read.
+ */
+t8_cmesh_t
+t8_cmesh_load_binary (const char *filename, sc_MPI_Comm comm);
+
 /** Check whether a given MPI communicator assigns the same rank and mpisize
   * as stored in a cmesh.
   * \param [in] cmesh       The cmesh to be considered.
@@ -323,6 +323,15 @@ t8_cmesh_set_partition_uniform (t8_cmesh_t cmesh, const int element_level, t8_sc
   }
 }
 
+void
+t8_cmesh_set_reorder (t8_cmesh_t cmesh, const t8_cmesh_reorder_type_t reorder)
+{
+  T8_ASSERT (t8_cmesh_is_initialized (cmesh));
+  T8_ASSERT (0 <= reorder && reorder < T8_CMESH_REORDER_COUNT);
+
+  cmesh->set_reorder = reorder;
+}
+
 t8_gloidx_t
 t8_cmesh_get_first_treeid (const t8_cmesh_t cmesh)
 {
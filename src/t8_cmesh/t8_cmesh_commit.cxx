@@ -35,6 +35,7 @@
 #include <t8_cmesh/t8_cmesh_partition.h>
 #include <t8_cmesh/t8_cmesh_copy.h>
 #include <t8_cmesh/t8_cmesh_geometry.h>
+#include <t8_cmesh/t8_cmesh_reorder.h>
 #include <t8_geometry/t8_geometry_handler.hxx>
 
 typedef struct ghost_facejoins_struct
@@ -511,6 +512,10 @@ t8_cmesh_commit_from_stash (t8_cmesh_t cmesh, sc_MPI_Comm comm)
 {
   T8_ASSERT (cmesh != NULL);
 
+  if (cmesh->set_reorder != T8_CMESH_REORDER_NONE) {
+    /* Renumber the trees before they are committed */
+    t8_cmesh_reorder_stash (cmesh, comm);
+  }
   if (cmesh->set_partition) {
     /* partitioned commit */
     t8_cmesh_commit_partitioned_new (cmesh, comm);
@@ -549,6 +554,7 @@ t8_cmesh_commit (t8_cmesh_t cmesh, sc_MPI_Comm comm)
   mpiret = sc_MPI_Comm_rank (comm, &cmesh->mpirank);
   SC_CHECK_MPI (mpiret);
   if (cmesh->set_from != NULL) {
+    SC_CHECK_ABORT (cmesh->set_reorder == T8_CMESH_REORDER_NONE, "Reordering a derived cmesh is not supported.\n");
     cmesh->dimension = cmesh->set_from->dimension;
     if (cmesh->face_knowledge == -1) {
       /* Keep the face knowledge of the from cmesh, if -1 was specified */
@@ -32,199 +32,346 @@
 #include <t8_cmesh/t8_cmesh_stash.h>
 #include <t8_cmesh/t8_cmesh_helpers.h>
 #include <vector>
-#include <map>
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+/* The number of bins per coordinate direction of the grid to which the face
+ * centroids are assigned. This should be more than enough for (almost) all cases,
+ * i.e. 2^P4EST_QMAXLEVEL =~ 1.073e9. */
+#define T8_CMESH_JOIN_NUM_BINS 1e9
+
+/* The tolerance for two vertex coordinates to match, relative to the magnitude of the coordinates. */
+#define T8_CMESH_JOIN_TOLERANCE (10.0 * T8_PRECISION_EPS)
+
+/* The maximum number of grid cells whose tolerance extended box contains a face centroid. */
+#define T8_CMESH_JOIN_MAX_CELLS 8
+
+/* The grid to which the face centroids are assigned. */
+typedef struct
+{
+  double min_coord; /* The origin of the grid. */
+  double cell_size; /* The edge length of a grid cell. */
+  double tolerance; /* The tolerance for two vertex coordinates to match. */
+} t8_cmesh_join_grid_t;
+
+/* A tree face with its vertices and the grid cell that contains its centroid.
+ * Two faces are connected if their vertices match up to the tolerance. */
+typedef struct
+{
+  double verts[T8_ECLASS_MAX_CORNERS_2D * T8_ECLASS_MAX_DIM]; /* The vertices in face vertex order. */
+  int64_t cell[T8_ECLASS_MAX_DIM];                             /* The grid cell containing the face centroid. */
+  int64_t bin[T8_ECLASS_MAX_DIM];                              /* The grid cell this copy of the face is sent to. */
+  t8_gloidx_t tree;                                            /* The id of the tree. */
+  t8_eclass_t eclass;                                          /* The eclass of the tree. */
+  int face;                                                    /* The face number within the tree. */
+  int num_verts;                                               /* The number of vertices of the face. */
+  int owner;                                                   /* The process that holds the tree. */
+} t8_cmesh_join_face_t;
+
+/* The connection of a tree face that was found by the process owning the face cell. */
+typedef struct
+{
+  t8_gloidx_t tree;       /* The id of the tree. */
+  t8_gloidx_t neigh_tree; /* The id of the neighbor tree. */
+  int face;               /* The face number within the tree. */
+  int neigh_face;         /* The face number within the neighbor tree. */
+  int orientation;        /* The orientation of the connection. */
+} t8_cmesh_join_result_t;
+
+/* Mix the bits of a 64 bit integer (finalizer of splitmix64). */
+static inline uint64_t
+t8_cmesh_join_mix (uint64_t x)
+{
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ULL;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebULL;
+  x ^= x >> 31;
+  return x;
+}
 
-void
-t8_cmesh_set_join_by_vertices (t8_cmesh_t cmesh, const t8_gloidx_t ntrees, const t8_eclass_t *eclasses,
-                               const double *vertices, int **connectivity, const int do_both_directions)
+/* Compute the hash value of a grid cell. */
+static inline uint64_t
+t8_cmesh_join_cell_hash (const int64_t *cell)
 {
-  /* If `connectivity` is NULL then the following array gets freed at the end of this routine. */
-  int *conn = T8_ALLOC (int, ntrees *T8_ECLASS_MAX_FACES * 3);
-  for (int i = 0; i < ntrees * T8_ECLASS_MAX_FACES * 3; i++) {
-    conn[i] = -1;
+  uint64_t hash = 0;
+  for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+    hash = t8_cmesh_join_mix (hash ^ (uint64_t) cell[icoord]);
   }
+  return hash;
+}
 
-  /* Compute minimum and maximum of the cmesh domain. */
-  double min_coord = vertices[0];
-  double max_coord = vertices[0];
-
-  for (int itree = 0; itree < ntrees; itree++) {
-    const t8_eclass_t eclass = eclasses[itree];
-    const int nverts = t8_eclass_num_vertices[eclass];
-    const int edim = t8_eclass_to_dimension[eclass];
-
+/* Compute the minimum and maximum coordinate of all tree vertices. */
+static void
+t8_cmesh_join_bounds (const t8_gloidx_t ntrees, const t8_eclass_t *eclasses, const double *vertices,
+                      double *min_coord, double *max_coord)
+{
+  *min_coord = ntrees > 0 ? vertices[0] : 0;
+  *max_coord = *min_coord;
+  for (t8_gloidx_t itree = 0; itree < ntrees; itree++) {
+    const int nverts = t8_eclass_num_vertices[eclasses[itree]];
     for (int ivert = 0; ivert < nverts; ivert++) {
-      for (int icoord = 0; icoord < edim; icoord++) {
+      for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
         const double coord
           = vertices[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord)];
-
-        if (coord < min_coord) {
-          min_coord = coord;
-        }
-
-        if (coord > max_coord) {
-          max_coord = coord;
-        }
+        *min_coord = SC_MIN (*min_coord, coord);
+        *max_coord = SC_MAX (*max_coord, coord);
       }
     }
   }
+}
 
-  /* Setup hash table `faces` mapping a hash key to a pair containing `(itree, iface)`. */
-  std::multimap<unsigned long, std::pair<int, int>> faces;
-
-  /* `num_bins` should be more than enough for (almost) all cases.
-   * I.e., 2^P4EST_QMAXLEVEL =~ 1.073e9.
-   */
-  const double num_bins = 1e9; /* Number of bins. */
-  const double inverse_bin_size = num_bins / (max_coord - min_coord);
+/* Setup the grid over the domain [min_coord, max_coord]^3. A grid cell is at least
+ * four times the tolerance wide, such that matching faces lie in neighboring cells.
+ * The grid is shifted by a fraction of a cell, such that the centroids of regular meshes
+ * rarely lie on cell boundaries. */
+static void
+t8_cmesh_join_grid_init (t8_cmesh_join_grid_t *grid, const double min_coord, const double max_coord)
+{
+  grid->tolerance = T8_CMESH_JOIN_TOLERANCE * SC_MAX (1.0, SC_MAX (fabs (min_coord), fabs (max_coord)));
+  grid->cell_size = SC_MAX ((max_coord - min_coord) / T8_CMESH_JOIN_NUM_BINS, 4 * grid->tolerance);
+  grid->min_coord = min_coord - 0.381966 * grid->cell_size;
+}
 
-  for (int itree = 0; itree < ntrees; itree++) {
-    const t8_eclass_t eclass = eclasses[itree];
+/* Compute the centroid of a face relative to the grid origin, in units of the cell size. */
+static void
+t8_cmesh_join_face_centroid (const t8_cmesh_join_face_t *face, const t8_cmesh_join_grid_t *grid,
+                             double centroid[T8_ECLASS_MAX_DIM])
+{
+  for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+    double sum = 0;
+    for (int iface_vert = 0; iface_vert < face->num_verts; iface_vert++) {
+      sum += face->verts[iface_vert * T8_ECLASS_MAX_DIM + icoord];
+    }
+    centroid[icoord] = (sum / face->num_verts - grid->min_coord) / grid->cell_size;
+  }
+}
 
-    /* Get the number of faces of this element. */
-    const int nfaces = t8_eclass_num_faces[eclass];
+/* Copy the vertices of the face \a iface of tree \a itree and compute the grid cell of its centroid. */
+static void
+t8_cmesh_join_face_init (t8_cmesh_join_face_t *face, const t8_gloidx_t ntrees, const t8_eclass_t *eclasses,
+                         const double *vertices, const t8_gloidx_t itree, const int iface, const t8_gloidx_t first_tree,
+                         const t8_cmesh_join_grid_t *grid, const int owner)
+{
+  const t8_eclass_t eclass = eclasses[itree];
+  double centroid[T8_ECLASS_MAX_DIM];
+
+  memset (face, 0, sizeof (*face));
+  face->tree = first_tree + itree;
+  face->eclass = eclass;
+  face->face = iface;
+  face->num_verts = t8_eclass_num_vertices[t8_eclass_face_types[eclass][iface]];
+  face->owner = owner;
+  for (int iface_vert = 0; iface_vert < face->num_verts; iface_vert++) {
+    /* Map from a face vertex id to the element vertex id. */
+    const int ivert = t8_face_vertex_to_tree_vertex[eclass][iface][iface_vert];
+    for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+      face->verts[iface_vert * T8_ECLASS_MAX_DIM + icoord]
+        = vertices[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord)];
+    }
+  }
+  t8_cmesh_join_face_centroid (face, grid, centroid);
+  for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+    face->cell[icoord] = (int64_t) floor (centroid[icoord]);
+  }
+}
 
-    /* Loop over all faces of the current cmesh element. */
-    for (int iface = 0; iface < nfaces; iface++) {
-      /* Get the number of vertices per face of this element. */
-      const int nface_verts = t8_eclass_num_vertices[t8_eclass_face_types[eclass][iface]];
+/* Compute all grid cells whose box, extended by twice the tolerance, contains the
+ * centroid of \a face. The first cell is the cell of the face itself. The centroid
+ * of a matching face lies in one of these cells, even if the centroids of the two
+ * faces are on different sides of a cell boundary. Return the number of cells. */
+static int
+t8_cmesh_join_face_cells (const t8_cmesh_join_face_t *face, const t8_cmesh_join_grid_t *grid,
+                          int64_t cells[T8_CMESH_JOIN_MAX_CELLS][T8_ECLASS_MAX_DIM])
+{
+  const double margin = 2 * grid->tolerance / grid->cell_size;
+  double centroid[T8_ECLASS_MAX_DIM];
+  int offsets[T8_ECLASS_MAX_DIM][2];
+  int num_offsets[T8_ECLASS_MAX_DIM];
+  int num_cells = 1;
+
+  t8_cmesh_join_face_centroid (face, grid, centroid);
+  for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+    const double position = centroid[icoord] - face->cell[icoord];
+    offsets[icoord][0] = 0;
+    num_offsets[icoord] = 1;
+    if (position < margin) {
+      offsets[icoord][num_offsets[icoord]++] = -1;
+    }
+    else if (1 - position <= margin) {
+      offsets[icoord][num_offsets[icoord]++] = 1;
+    }
+    num_cells *= num_offsets[icoord];
+  }
+  for (int icell = 0; icell < num_cells; icell++) {
+    int index = icell;
+    for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+      cells[icell][icoord] = face->cell[icoord] + offsets[icoord][index % num_offsets[icoord]];
+      index /= num_offsets[icoord];
+    }
+  }
+  return num_cells;
+}
 
-      /* Compute the hash key. The idea is to convert the rescaled vertices of a tree face to
-       * long integers and add them up. We apply a bit of seeding by also adding `icoord`. See below. */
-      unsigned long hash = 0;
+/* Return true if every vertex of \a face matches a vertex of \a neigh up to the tolerance.
+ * On a match, \a face_vert_order holds for each face vertex the matching neighbor face vertex. */
+static int
+t8_cmesh_join_face_match (const t8_cmesh_join_face_t *face, const t8_cmesh_join_face_t *neigh,
+                          const t8_cmesh_join_grid_t *grid, int face_vert_order[T8_ECLASS_MAX_CORNERS_2D])
+{
+  if (face->num_verts != neigh->num_verts) {
+    return 0;
+  }
+  for (int iface_vert = 0; iface_vert < face->num_verts; iface_vert++) {
+    face_vert_order[iface_vert] = -1;
+    for (int neigh_iface_vert = 0; neigh_iface_vert < neigh->num_verts; neigh_iface_vert++) {
+      int icoord = 0;
+      while (icoord < T8_ECLASS_MAX_DIM
+             && fabs (face->verts[iface_vert * T8_ECLASS_MAX_DIM + icoord]
+                      - neigh->verts[neigh_iface_vert * T8_ECLASS_MAX_DIM + icoord])
+                  <= grid->tolerance) {
+        icoord++;
+      }
+      if (icoord == T8_ECLASS_MAX_DIM) {
+        face_vert_order[iface_vert] = neigh_iface_vert;
+        break;
+      }
+    }
+    if (face_vert_order[iface_vert] < 0) {
+      return 0;
+    }
+  }
+  return 1;
+}
 
-      /* Loop over the vertices of the current element's face. */
-      for (int iface_vert = 0; iface_vert < nface_verts; iface_vert++) {
-        /* Map from a face vertex id to the element vertex id. */
-        const int ivert = t8_face_vertex_to_tree_vertex[eclass][iface][iface_vert];
+/* Order faces by the cell they are sent to, and faces in the same cell by their trees and face numbers. */
+static bool
+t8_cmesh_join_face_less (const t8_cmesh_join_face_t &face_a, const t8_cmesh_join_face_t &face_b)
+{
+  for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+    if (face_a.bin[icoord] != face_b.bin[icoord]) {
+      return face_a.bin[icoord] < face_b.bin[icoord];
+    }
+  }
+  return face_a.tree < face_b.tree || (face_a.tree == face_b.tree && face_a.face < face_b.face);
+}
 
-        for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
-          const int index = T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord);
-          const double rescaled = (vertices[index] - min_coord) * inverse_bin_size;
+/* Compute the orientation of the connection of two matching faces.
+ * \a face_vert_order is the order of the face vertices of \a neigh as
+ * encountered at the face vertices of \a face.
+ * Face corner 0 of the face with the lower face direction connects
+ * to a corner of the other face. The number of this corner is the
+ * orientation code. */
+static int
+t8_cmesh_join_orientation (const t8_cmesh_join_face_t *face, const t8_cmesh_join_face_t *neigh,
+                           const int face_vert_order[T8_ECLASS_MAX_CORNERS_2D])
+{
+  int smaller_bigger_face_condition;
+  const int compare = t8_eclass_compare (face->eclass, neigh->eclass);
+  if (compare < 0) {
+    /* This tree class is smaller than neigh. tree class. */
+    smaller_bigger_face_condition = 1;
+  }
+  else if (compare > 0) {
+    /* This tree class is bigger than neigh. tree class. */
+    smaller_bigger_face_condition = 0;
+  }
+  else {
+    /* This tree class is the same as the neigh. tree class.
+       Then the face with the smaller face id is the smaller one. */
+    smaller_bigger_face_condition = face->face < neigh->face;
+  }
 
-          /* Simple hash function. */
-          hash = hash + icoord + static_cast<unsigned long> (rescaled + 0.5);
-        }
-      }
+  if (smaller_bigger_face_condition) {
+    return face_vert_order[0];
+  }
+  for (int iface_vert = 0; iface_vert < face->num_verts; iface_vert++) {
+    if (0 == face_vert_order[iface_vert]) {
+      return iface_vert;
+    }
+  }
+  return -1;
+}
 
-      /* Loop over all pre-registered faces with the same hash. */
-      auto range = faces.equal_range (hash);
-      for (auto it = range.first; it != range.second; ++it) {
-        /* Query potentially neighboring `itree` and `iface`. */
-        const int neigh_itree = std::get<0> (it->second);
-        const int neigh_iface = std::get<1> (it->second);
+void
+t8_cmesh_set_join_by_vertices (t8_cmesh_t cmesh, const t8_gloidx_t ntrees, const t8_eclass_t *eclasses,
+                               const double *vertices, int **connectivity, const int do_both_directions)
+{
+  /* If `connectivity` is NULL then the following array gets freed at the end of this routine. */
+  int *conn = T8_ALLOC (int, ntrees *T8_ECLASS_MAX_FACES * 3);
+  for (int i = 0; i < ntrees * T8_ECLASS_MAX_FACES * 3; i++) {
+    conn[i] = -1;
+  }
 
-        /* Retrieve the potentially neighboring element class. */
-        const t8_eclass_t neigh_eclass = eclasses[neigh_itree];
+  /* Compute minimum and maximum of the cmesh domain. */
+  double min_coord, max_coord;
+  t8_cmesh_join_grid_t grid;
+  t8_cmesh_join_bounds (ntrees, eclasses, vertices, &min_coord, &max_coord);
+  t8_cmesh_join_grid_init (&grid, min_coord, max_coord);
 
-        /* Get the number of vertices per face of potentially neighboring element. */
-        const int neigh_nface_verts = t8_eclass_num_vertices[t8_eclass_face_types[neigh_eclass][neigh_iface]];
+  /* Collect all tree faces and the grid cells of their centroids. */
+  std::vector<t8_cmesh_join_face_t> faces;
+  for (t8_gloidx_t itree = 0; itree < ntrees; itree++) {
+    const int nfaces = t8_eclass_num_faces[eclasses[itree]];
+    for (int iface = 0; iface < nfaces; iface++) {
+      faces.emplace_back ();
+      t8_cmesh_join_face_init (&faces.back (), ntrees, eclasses, vertices, itree, iface, 0, &grid, 0);
+    }
+  }
 
-        /* If the number of face vertices do not match we can skip. */
-        if (nface_verts != neigh_nface_verts) {
+  /* Setup an open addressing hash table with linear probing that stores the indices
+   * of the faces that have not found a neighbor yet, hashed by the cells of their centroids.
+   * Its capacity is a power of two with at least twice the number of faces. Empty slots are marked with -1. */
+  size_t capacity = 1;
+  while (capacity < 2 * faces.size ()) {
+    capacity <<= 1;
+  }
+  std::vector<int64_t> table (capacity, -1);
+
+  for (size_t iface_index = 0; iface_index < faces.size (); iface_index++) {
+    const t8_cmesh_join_face_t *face = &faces[iface_index];
+    int64_t cells[T8_CMESH_JOIN_MAX_CELLS][T8_ECLASS_MAX_DIM];
+    const int num_cells = t8_cmesh_join_face_cells (face, &grid, cells);
+
+    /* Loop over all registered faces in the cells near the centroid of the face. */
+    int found_neighbor = 0;
+    for (int icell = 0; icell < num_cells && !found_neighbor; icell++) {
+      for (size_t slot = t8_cmesh_join_cell_hash (cells[icell]) & (capacity - 1); table[slot] >= 0;
+           slot = (slot + 1) & (capacity - 1)) {
+        const t8_cmesh_join_face_t *neigh = &faces[table[slot]];
+        int face_vert_order[T8_ECLASS_MAX_CORNERS_2D];
+        if (memcmp (neigh->cell, cells[icell], sizeof (neigh->cell))
+            || !t8_cmesh_join_face_match (face, neigh, &grid, face_vert_order)) {
           continue;
         }
-
-        /* The order of the encountered face vertices is needed for computing
-         * the orientation later on. Prepare the array for that here. */
-        int face_vert_order[T8_ECLASS_MAX_EDGES_2D];
-        for (int i = 0; i < T8_ECLASS_MAX_EDGES_2D; i++) {
-          face_vert_order[i] = -1;
-        }
-
-        int match_count = 0; /* This tracks the number of matching vertices. */
-        /* Loop over the vertices of the current element's face. */
-        for (int iface_vert = 0; iface_vert < nface_verts; iface_vert++) {
-          /* Map from a face vertex id to the element vertex id. */
-          const int ivert = t8_face_vertex_to_tree_vertex[eclass][iface][iface_vert];
-
-          /* Loop over the vertices of the potentially neighboring element's face. */
-          for (int neigh_iface_vert = 0; neigh_iface_vert < neigh_nface_verts; neigh_iface_vert++) {
-            /* Map from a face vertex id to the element vertex id. */
-            const int neigh_ivert = t8_face_vertex_to_tree_vertex[neigh_eclass][neigh_iface][neigh_iface_vert];
-
-            int match_count_per_coord = 0; /* Tracks the matching of x, y and z coordinates of two vertices. */
-            for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
-              /* Retrieve the x, y or z component of the face vertex
-               * coordinate from the vertices array. */
-
-              const double face_vert
-                = vertices[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord)];
-              const double neigh_face_vert = vertices[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM,
-                                                                   neigh_itree, neigh_ivert, icoord)];
-
-              /* Compare the coordinates with some tolerance. */
-              if (fabs (face_vert - neigh_face_vert) < 10.0 * T8_PRECISION_EPS) {
-                match_count_per_coord++;
-              }
-            }
-
-            /* In case all x, y and z components match we increase the match_count variable. */
-            if (match_count_per_coord == T8_ECLASS_MAX_DIM) {
-              match_count++;
-              /* Store the encountered face vertex order for later use. */
-              face_vert_order[iface_vert] = neigh_iface_vert;
-              continue;
-            }
-          }
-        }
-
-        /* If the number of matching face vertices is equal to the actual number of the face's vertices
-         * we interpret this as a face-to-face connection between two elements. */
-        if (match_count == nface_verts) {
-          /* Compute the orientation of the face-to-face connection.
-           * Face corner 0 of the face with the lower face direction connects
-           * to a corner of the other face. The number of this corner is the
-           * orientation code. */
-          int orientation = -1;
-          int smaller_bigger_face_condition = -1;
-
-          const int compare = t8_eclass_compare (eclass, neigh_eclass);
-          if (compare < 0) {
-            /* This tree class is smaller than neigh. tree class. */
-            smaller_bigger_face_condition = 1;
-          }
-          else if (compare > 0) {
-            /* This tree class is bigger than neigh. tree class. */
-            smaller_bigger_face_condition = 0;
-          }
-          else {
-            /* This tree class is the same as the neigh. tree class. 
-               Then the face with the smaller face id is the smaller one. */
-            smaller_bigger_face_condition = iface < neigh_iface;
-          }
-
-          if (smaller_bigger_face_condition) {
-            orientation = face_vert_order[0];
-          }
-          else {
-            for (int iface_vert = 0; iface_vert < nface_verts; iface_vert++) {
-              if (0 == face_vert_order[iface_vert]) {
-                orientation = iface_vert;
-                break;
-              }
-            }
-          }
-
-          /* Store the results. */
-          conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, itree, iface, 0)] = neigh_itree;
-          conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, itree, iface, 1)] = neigh_iface;
-          conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, itree, iface, 2)] = orientation;
-
-          if (do_both_directions) {
-            conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, neigh_itree, neigh_iface, 0)] = itree;
-            conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, neigh_itree, neigh_iface, 1)] = iface;
-            conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, neigh_itree, neigh_iface, 2)] = orientation;
-          }
-
-          break;
+        /* All face vertices match. We interpret this as a face-to-face connection between two elements. */
+        const int orientation = t8_cmesh_join_orientation (face, neigh, face_vert_order);
+        const int itree = face->tree;
+        const int neigh_itree = neigh->tree;
+
+        /* Store the results. */
+        conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, itree, face->face, 0)] = neigh_itree;
+        conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, itree, face->face, 1)] = neigh->face;
+        conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, itree, face->face, 2)] = orientation;
+
+        if (do_both_directions) {
+          conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, neigh_itree, neigh->face, 0)] = itree;
+          conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, neigh_itree, neigh->face, 1)] = face->face;
+          conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, neigh_itree, neigh->face, 2)] = orientation;
         }
-      } /* Loop over faces with identical hash. */
-
-      /* Register the current pair of `itree` and `iface` with given `hash` in the hash table. */
-      faces.insert (std::make_pair (hash, std::make_pair (itree, iface)));
-    } /* Loop over faces. */
-  }   /* Loop over trees. */
+        found_neighbor = 1;
+        break;
+      }
+    }
+    if (!found_neighbor) {
+      /* Register the current face in the first empty slot of the probe sequence of its cell. */
+      size_t slot = t8_cmesh_join_cell_hash (face->cell) & (capacity - 1);
+      while (table[slot] >= 0) {
+        slot = (slot + 1) & (capacity - 1);
+      }
+      table[slot] = iface_index;
+    }
+  }
 
   /* Transfer the computed face connectivity to the `cmesh` object. */
   if (cmesh != NULL) {
@@ -253,6 +400,185 @@ t8_cmesh_set_join_by_vertices (t8_cmesh_t cmesh, const t8_gloidx_t ntrees, const
   }
 }
 
+/* Send the records in send[iproc] to process iproc and receive the records
+ * from process iproc in recv[iproc]. */
+template <typename T>
+static void
+t8_cmesh_join_alltoall (std::vector<std::vector<T>> &send, std::vector<std::vector<T>> &recv, sc_MPI_Comm comm)
+{
+  int mpisize, mpirank, mpiret;
+  int num_requests = 0;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  std::vector<int> send_counts (mpisize), recv_counts (mpisize);
+  std::vector<sc_MPI_Request> requests (2 * mpisize);
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    send_counts[iproc] = send[iproc].size ();
+  }
+  mpiret = sc_MPI_Alltoall (send_counts.data (), 1, sc_MPI_INT, recv_counts.data (), 1, sc_MPI_INT, comm);
+  SC_CHECK_MPI (mpiret);
+
+  recv.resize (mpisize);
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    if (iproc == mpirank) {
+      /* Our own records are copied. */
+      recv[iproc] = send[iproc];
+    }
+    else if (recv_counts[iproc] > 0) {
+      recv[iproc].resize (recv_counts[iproc]);
+      mpiret = sc_MPI_Irecv (recv[iproc].data (), recv_counts[iproc] * sizeof (T), sc_MPI_BYTE, iproc,
+                             T8_MPI_CMESH_JOIN_BY_VERTICES, comm, &requests[num_requests++]);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    if (iproc != mpirank && send_counts[iproc] > 0) {
+      mpiret = sc_MPI_Isend (send[iproc].data (), send_counts[iproc] * sizeof (T), sc_MPI_BYTE, iproc,
+                             T8_MPI_CMESH_JOIN_BY_VERTICES, comm, &requests[num_requests++]);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  mpiret = sc_MPI_Waitall (num_requests, requests.data (), sc_MPI_STATUSES_IGNORE);
+  SC_CHECK_MPI (mpiret);
+}
+
+void
+t8_cmesh_set_join_by_vertices_parallel (t8_cmesh_t cmesh, const t8_gloidx_t first_tree,
+                                        const t8_locidx_t num_local_trees, const t8_eclass_t *eclasses,
+                                        const double *vertices, t8_gloidx_t **connectivity, sc_MPI_Comm comm)
+{
+  int mpisize, mpirank, mpiret;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  /* If `connectivity` is NULL then the following array gets freed at the end of this routine. */
+  t8_gloidx_t *conn = T8_ALLOC (t8_gloidx_t, num_local_trees *T8_ECLASS_MAX_FACES * 3);
+  for (t8_locidx_t i = 0; i < num_local_trees * T8_ECLASS_MAX_FACES * 3; i++) {
+    conn[i] = -1;
+  }
+
+  /* All processes snap the vertices to the same grid over the global domain. */
+  double local_bounds[2], min_coord, max_coord;
+  t8_cmesh_join_bounds (num_local_trees, eclasses, vertices, &local_bounds[0], &local_bounds[1]);
+  if (num_local_trees == 0) {
+    local_bounds[0] = DBL_MAX;
+    local_bounds[1] = -DBL_MAX;
+  }
+  mpiret = sc_MPI_Allreduce (&local_bounds[0], &min_coord, 1, sc_MPI_DOUBLE, sc_MPI_MIN, comm);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Allreduce (&local_bounds[1], &max_coord, 1, sc_MPI_DOUBLE, sc_MPI_MAX, comm);
+  SC_CHECK_MPI (mpiret);
+  t8_cmesh_join_grid_t grid;
+  t8_cmesh_join_grid_init (&grid, min_coord, max_coord);
+
+  /* Send each face to the processes that own the hash values of the cells near its centroid.
+   * Matching faces both end up in the cell of the centroid of either face, regardless of
+   * which processes hold their trees. */
+  std::vector<std::vector<t8_cmesh_join_face_t>> send_faces (mpisize), recv_faces;
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const int nfaces = t8_eclass_num_faces[eclasses[itree]];
+    for (int iface = 0; iface < nfaces; iface++) {
+      t8_cmesh_join_face_t face;
+      int64_t cells[T8_CMESH_JOIN_MAX_CELLS][T8_ECLASS_MAX_DIM];
+      t8_cmesh_join_face_init (&face, num_local_trees, eclasses, vertices, itree, iface, first_tree, &grid, mpirank);
+      const int num_cells = t8_cmesh_join_face_cells (&face, &grid, cells);
+      for (int icell = 0; icell < num_cells; icell++) {
+        memcpy (face.bin, cells[icell], sizeof (face.bin));
+        send_faces[t8_cmesh_join_cell_hash (cells[icell]) % mpisize].push_back (face);
+      }
+    }
+  }
+  t8_cmesh_join_alltoall (send_faces, recv_faces, comm);
+  send_faces.clear ();
+
+  /* Sort the received faces by their cells. The faces of the same cell are then adjacent. */
+  std::vector<t8_cmesh_join_face_t> faces;
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    faces.insert (faces.end (), recv_faces[iproc].begin (), recv_faces[iproc].end ());
+  }
+  recv_faces.clear ();
+  std::sort (faces.begin (), faces.end (), t8_cmesh_join_face_less);
+
+  /* Compare the faces of each cell. A connection is reported only in the cell of the centroid
+   * of the first face, such that it is found once. Send the found connections back to the
+   * processes holding the trees. */
+  std::vector<std::vector<t8_cmesh_join_result_t>> send_results (mpisize), recv_results;
+  std::vector<char> matched (faces.size (), 0);
+  for (size_t first_index = 0; first_index < faces.size ();) {
+    size_t end_index = first_index + 1;
+    while (end_index < faces.size () && !memcmp (faces[end_index].bin, faces[first_index].bin, sizeof (faces[0].bin))) {
+      end_index++;
+    }
+    for (size_t iface_index = first_index; iface_index < end_index; iface_index++) {
+      const t8_cmesh_join_face_t *face = &faces[iface_index];
+      if (matched[iface_index] || memcmp (face->cell, face->bin, sizeof (face->cell))) {
+        continue;
+      }
+      for (size_t ineigh_index = iface_index + 1; ineigh_index < end_index; ineigh_index++) {
+        const t8_cmesh_join_face_t *neigh = &faces[ineigh_index];
+        int face_vert_order[T8_ECLASS_MAX_CORNERS_2D];
+        if (matched[ineigh_index] || !t8_cmesh_join_face_match (face, neigh, &grid, face_vert_order)) {
+          continue;
+        }
+        const int orientation = t8_cmesh_join_orientation (face, neigh, face_vert_order);
+        send_results[face->owner].push_back ({ face->tree, neigh->tree, face->face, neigh->face, orientation });
+        send_results[neigh->owner].push_back ({ neigh->tree, face->tree, neigh->face, face->face, orientation });
+        matched[iface_index] = matched[ineigh_index] = 1;
+        break;
+      }
+    }
+    first_index = end_index;
+  }
+  faces.clear ();
+  t8_cmesh_join_alltoall (send_results, recv_results, comm);
+
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    for (const t8_cmesh_join_result_t &result : recv_results[iproc]) {
+      const t8_locidx_t itree = result.tree - first_tree;
+      T8_ASSERT (0 <= itree && itree < num_local_trees);
+      conn[T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_FACES, 3, itree, result.face, 0)] = result.neigh_tree;
+      conn[T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_FACES, 3, itree, result.face, 1)] = result.neigh_face;
+      conn[T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_FACES, 3, itree, result.face, 2)] = result.orientation;
+    }
+  }
+
+  /* Transfer the computed face connectivity to the `cmesh` object. Connections
+   * between two local trees are set only once. */
+  if (cmesh != NULL) {
+    for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+      const t8_gloidx_t gtree = first_tree + itree;
+      const int nfaces = t8_eclass_num_faces[eclasses[itree]];
+
+      for (int iface = 0; iface < nfaces; iface++) {
+        const t8_gloidx_t neigh_tree = conn[T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_FACES, 3, itree, iface, 0)];
+        const int neigh_iface = conn[T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_FACES, 3, itree, iface, 1)];
+        const int orientation = conn[T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_FACES, 3, itree, iface, 2)];
+        const int neigh_is_local = first_tree <= neigh_tree && neigh_tree < first_tree + num_local_trees;
+
+        if (neigh_tree > -1
+            && (!neigh_is_local || gtree < neigh_tree || (gtree == neigh_tree && iface < neigh_iface))) {
+          t8_cmesh_set_join (cmesh, gtree, neigh_tree, iface, neigh_iface, orientation);
+        }
+      }
+    }
+  }
+
+  /* Pass the `conn` array to the caller if asked for. */
+  if (connectivity == NULL) {
+    T8_FREE (conn);
+  }
+  else {
+    *connectivity = conn;
+  }
+}
+
 void
 t8_cmesh_set_join_by_stash (t8_cmesh_t cmesh, int **connectivity, const int do_both_directions)
 {
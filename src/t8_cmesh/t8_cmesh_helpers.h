@@ -48,10 +48,12 @@ T8_EXTERN_C_BEGIN ();
  *                                      For each element and each face the following is stored:
  *                                      neighbor_tree_id, neighbor_dual_face_id, orientation
  * \param[in]       do_both_directions  Compute the connectivity from both neighboring sides.
- *                                      Takes much longer to compute.
  *
- * \warning  This routine might be too expensive for very large meshes. In this case, 
- *           consider to use a fully featured mesh generator.
+ * The faces are stored in a hash table by the cell of a grid over the bounding box of all
+ * vertices that contains their centroid. Each face is compared to the faces in the cells near
+ * its centroid, and two faces match if their vertices agree up to a small tolerance.
+ * All trees must be given on the calling process, see \ref t8_cmesh_set_join_by_vertices_parallel
+ * for distributed input.
  *
  * \note This routine does not detect periodic boundaries.
  */
@@ -59,6 +61,35 @@ void
 t8_cmesh_set_join_by_vertices (t8_cmesh_t cmesh, const t8_gloidx_t ntrees, const t8_eclass_t *eclasses,
                                const double *vertices, int **connectivity, const int do_both_directions);
 
+/** Sets the face connectivity information of an un-committed \cmesh based on the vertices of
+ * trees that are distributed over the processes of a communicator.
+ * Each process holds the consecutive range of trees starting at global id \a first_tree.
+ * The faces are sent to processes by the hash values of the grid cells near their centroids
+ * and matched there per cell, such that trees on different processes are joined.
+ * This function is collective.
+ * \param[in,out]   cmesh               Pointer to a t8code cmesh object. If set to NULL this argument is ignored.
+ *                                      Otherwise, the joins of all local trees are set, including those with
+ *                                      trees of other processes.
+ * \param[in]       first_tree          Global id of the first local tree.
+ * \param[in]       num_local_trees     Number of local trees.
+ * \param[in]       eclasses            List of element classes of the local trees of length [num_local_trees].
+ * \param[in]       vertices            List of per element vertices of the local trees with dimensions
+ *                                      [num_local_trees,T8_ECLASS_MAX_CORNERS,T8_ECLASS_MAX_DIM].
+ * \param[in,out]   connectivity        If connectivity is not NULL the variable is filled with a pointer to an
+ *                                      allocated face connectivity array. The ownership of this
+ *                                      array goes to the caller. The dimension of \a connectivity are
+ *                                      [num_local_trees,T8_ECLASS_MAX_FACES,3].
+ *                                      For each local tree and each face the following is stored:
+ *                                      global neighbor_tree_id, neighbor_dual_face_id, orientation
+ * \param[in]       comm                The communicator over which the trees are distributed.
+ *
+ * \note This routine does not detect periodic boundaries.
+ */
+void
+t8_cmesh_set_join_by_vertices_parallel (t8_cmesh_t cmesh, const t8_gloidx_t first_tree,
+                                        const t8_locidx_t num_local_trees, const t8_eclass_t *eclasses,
+                                        const double *vertices, t8_gloidx_t **connectivity, sc_MPI_Comm comm);
+
 /** Sets the face connectivity information of an un-committed \cmesh based on the cmesh stash.
  * \param[in,out]   cmesh               An uncommitted cmesh. The trees eclasses and vertices do need to be set.
  * \param[in,out]   connectivity        If connectivity is not NULL the variable is filled with a pointer to an
@@ -68,10 +99,7 @@ t8_cmesh_set_join_by_vertices (t8_cmesh_t cmesh, const t8_gloidx_t ntrees, const
  *                                      [ntrees,T8_ECLASS_MAX_FACES,3].
  *                                      For each element and each face the following is stored:
  *                                      neighbor_tree_id, neighbor_dual_face_id, orientation
- * \param[in]       do_both_directions  Compute the connectivity from both neighboring sides. Takes much longer to compute.
- *
- * \warning This routine might be too expensive for very large meshes. In this case,
- *          consider to use a fully featured mesh generator.
+ * \param[in]       do_both_directions  Compute the connectivity from both neighboring sides.
  *
  * \note This routine does not detect periodic boundaries.
  */
@@ -28,6 +28,7 @@
 #include <t8_geometry/t8_geometry_implementations/t8_geometry_cad.h>
 #include "t8_cmesh_types.h"
 #include "t8_cmesh_stash.h"
+#include <algorithm>
 
 #ifdef _WIN32
 #include "t8_windows.h"
@@ -205,6 +206,7 @@ t8_cmesh_check_version_of_msh_file (FILE *fp)
     for (int n_versions = 0; n_versions < T8_CMESH_N_SUPPORTED_MSH_FILE_VERSIONS; ++n_versions) {
       t8_global_errorf ("%d.X\n", t8_cmesh_supported_msh_file_versions[n_versions]);
     }
+    t8_global_errorf ("Binary msh-files of version 4.1 can be read with t8_cmesh_from_msh_file_parallel.\n");
     goto die_format;
   }
 
@@ -238,6 +240,48 @@ die_format:
   return -1;
 }
 
+/* Compute how the vertices of a tree with negative volume are switched to correct its volume.
+ * For triangles and quads we switch 1 and 2.
+ * For tets we switch 0 and 3.
+ * For prisms we switch 0 and 3, 1 and 4, 2 and 5.
+ * For hexahedra we switch 0 and 4, 1 and 5, 2 and 6, 3 and 7.
+ * For pyramids we switch 0 and 4.
+ * \param [in]  eclass          The class of the tree.
+ * \param [out] switch_indices  Vertex i is switched with vertex \a switch_indices[i].
+ * \return                      The number of switches.
+ */
+static int
+t8_msh_file_negative_volume_switches (const t8_eclass_t eclass, int switch_indices[4])
+{
+  switch (eclass) {
+  case T8_ECLASS_TRIANGLE:
+  case T8_ECLASS_QUAD:
+    switch_indices[0] = 0;
+    switch_indices[1] = 2;
+    return 2;
+  case T8_ECLASS_TET:
+    switch_indices[0] = 3;
+    return 1;
+  case T8_ECLASS_PRISM:
+    switch_indices[0] = 3;
+    switch_indices[1] = 4;
+    switch_indices[2] = 5;
+    return 3;
+  case T8_ECLASS_HEX:
+    switch_indices[0] = 4;
+    switch_indices[1] = 5;
+    switch_indices[2] = 6;
+    switch_indices[3] = 7;
+    return 4;
+  case T8_ECLASS_PYRAMID:
+    switch_indices[0] = 4;
+    return 1;
+  default:
+    SC_ABORT_NOT_REACHED ();
+  }
+  return 0;
+}
+
 /* Read an open .msh file of version 2 and parse the nodes into a hash table. */
 static sc_hash_t *
 t8_msh_file_2_read_nodes (FILE *fp, t8_locidx_t *num_nodes, sc_mempool_t **node_mempool)
@@ -635,39 +679,7 @@ t8_cmesh_msh_file_2_read_eles (t8_cmesh_t cmesh, FILE *fp, sc_hash_t *vertices,
         int iswitch;
         T8_ASSERT (t8_eclass_to_dimension[eclass] > 1);
         t8_debugf ("Correcting negative volume of tree %li\n", static_cast<long> (tree_count));
-        switch (eclass) {
-        case T8_ECLASS_TRIANGLE:
-        case T8_ECLASS_QUAD:
-          /* We switch vertex 1 and vertex 2. */
-          num_switches = 2;
-          switch_indices[0] = 0;
-          switch_indices[1] = 2;
-          break;
-        case T8_ECLASS_TET:
-          /* We switch vertex 0 and vertex 3 */
-          num_switches = 1;
-          switch_indices[0] = 3;
-          break;
-        case T8_ECLASS_PRISM:
-          num_switches = 3;
-          switch_indices[0] = 3;
-          switch_indices[1] = 4;
-          switch_indices[2] = 5;
-          break;
-        case T8_ECLASS_HEX:
-          num_switches = 4;
-          switch_indices[0] = 4;
-          switch_indices[1] = 5;
-          switch_indices[2] = 6;
-          switch_indices[3] = 7;
-          break;
-        case T8_ECLASS_PYRAMID:
-          num_switches = 1;
-          switch_indices[0] = 4;
-          break;
-        default:
-          SC_ABORT_NOT_REACHED ();
-        }
+        num_switches = t8_msh_file_negative_volume_switches (eclass, switch_indices);
 
         for (iswitch = 0; iswitch < num_switches; ++iswitch) {
           /* We switch vertex 0 + iswitch and vertex switch_indices[iswitch] */
@@ -974,39 +986,7 @@ t8_cmesh_msh_file_4_read_eles (t8_cmesh_t cmesh, FILE *fp, sc_hash_t *vertices,
           int iswitch;
           T8_ASSERT (t8_eclass_to_dimension[eclass] > 1);
           t8_debugf ("Correcting negative volume of tree %li\n", static_cast<long> (tree_count));
-          switch (eclass) {
-          case T8_ECLASS_TRIANGLE:
-          case T8_ECLASS_QUAD:
-            /* We switch vertex 1 and vertex 2. */
-            num_switches = 2;
-            switch_indices[0] = 0;
-            switch_indices[1] = 2;
-            break;
-          case T8_ECLASS_TET:
-            /* We switch vertex 0 and vertex 3. */
-            num_switches = 1;
-            switch_indices[0] = 3;
-            break;
-          case T8_ECLASS_PRISM:
-            num_switches = 3;
-            switch_indices[0] = 3;
-            switch_indices[1] = 4;
-            switch_indices[2] = 5;
-            break;
-          case T8_ECLASS_HEX:
-            num_switches = 4;
-            switch_indices[0] = 4;
-            switch_indices[1] = 5;
-            switch_indices[2] = 6;
-            switch_indices[3] = 7;
-            break;
-          case T8_ECLASS_PYRAMID:
-            num_switches = 1;
-            switch_indices[0] = 4;
-            break;
-          default:
-            SC_ABORT_NOT_REACHED ();
-          }
+          num_switches = t8_msh_file_negative_volume_switches (eclass, switch_indices);
 
           for (iswitch = 0; iswitch < num_switches; ++iswitch) {
             /* We switch vertex 0 + iswitch and vertex switch_indices[iswitch] */
@@ -1753,6 +1733,765 @@ t8_cmesh_msh_file_find_neighbors (t8_cmesh_t cmesh, const sc_array_t *vertex_ind
   t8_debugf ("Done finding tree neighbors.\n");
 }
 
+/* The parallel reader for binary .msh files of version 4.1.
+ * Each process reads a contiguous range of the nodes and a contiguous range
+ * of the trees directly from the file. The nodes are distributed by their tag:
+ * process p stores the nodes with tags in the p-th of mpisize equally sized
+ * tag intervals. The coordinates of the tree vertices as well as the face
+ * connections are then resolved by exchanging messages with these processes. */
+
+/* Information about a node or element block in the binary file. */
+typedef struct
+{
+  t8_gloidx_t offset;      /* The file offset of the data of this block. */
+  t8_gloidx_t num_entries; /* The number of nodes or elements in this block. */
+  int num_values;          /* For nodes the number of doubles per node,
+                            * for elements the number of nodes per element. */
+  int eclass;              /* For elements the eclass of the block. */
+} t8_msh_file_block_t;
+
+/* A node with its coordinates. */
+typedef struct
+{
+  t8_gloidx_t tag;
+  double coordinates[3];
+} t8_msh_file_node_record_t;
+
+/* A face connection between two trees. */
+typedef struct
+{
+  t8_gloidx_t gtree1;
+  t8_gloidx_t gtree2;
+  int face1;
+  int face2;
+  int orientation;
+} t8_msh_file_join_t;
+
+/* A face of a tree, sent to the process that owns its smallest node tag. */
+typedef struct
+{
+  t8_gloidx_t key[T8_ECLASS_MAX_CORNERS_2D];      /* The sorted node tags of the face, padded with -1. */
+  t8_gloidx_t vertices[T8_ECLASS_MAX_CORNERS_2D]; /* The node tags of the face in face vertex order. */
+  t8_gloidx_t gtree;                              /* The global id of the tree. */
+  int face;                                       /* The face number within the tree. */
+  int eclass;                                     /* The eclass of the tree. */
+} t8_msh_file_face_record_t;
+
+/* A tree read by the parallel reader. Also used to send ghost trees. */
+typedef struct
+{
+  t8_gloidx_t gtree;
+  int eclass;
+  int num_joins;
+  t8_gloidx_t nodes[T8_ECLASS_MAX_CORNERS]; /* The node tags in t8code vertex order. */
+  double vertices[3 * T8_ECLASS_MAX_CORNERS];
+  t8_msh_file_join_t joins[T8_ECLASS_MAX_FACES];
+} t8_msh_file_tree_record_t;
+
+/* The number of nodes of the gmsh element types up to T8_NUM_GMSH_ELEM_CLASSES.
+ * We need them to skip blocks of element types that we do not read. */
+const int t8_msh_element_type_num_nodes[T8_NUM_GMSH_ELEM_CLASSES + 1]
+  = { 0, 2, 3, 4, 4, 8, 6, 5, 3, 6, 9, 10, 27, 18, 14, 1 };
+
+/* The dimension of the gmsh element types up to T8_NUM_GMSH_ELEM_CLASSES. */
+const int t8_msh_element_type_dim[T8_NUM_GMSH_ELEM_CLASSES + 1] = { -1, 1, 2, 2, 3, 3, 3, 3, 1, 2, 2, 3, 3, 3, 3, 0 };
+
+static int
+t8_msh_file_gloidx_compare (const void *a, const void *b)
+{
+  const t8_gloidx_t ga = *(const t8_gloidx_t *) a;
+  const t8_gloidx_t gb = *(const t8_gloidx_t *) b;
+  return ga < gb ? -1 : ga != gb;
+}
+
+static int
+t8_msh_file_node_record_compare (const void *a, const void *b)
+{
+  return t8_msh_file_gloidx_compare (&((const t8_msh_file_node_record_t *) a)->tag,
+                                     &((const t8_msh_file_node_record_t *) b)->tag);
+}
+
+static int
+t8_msh_file_tree_record_compare (const void *a, const void *b)
+{
+  return t8_msh_file_gloidx_compare (&((const t8_msh_file_tree_record_t *) a)->gtree,
+                                     &((const t8_msh_file_tree_record_t *) b)->gtree);
+}
+
+/* Order faces by their sorted node tags and then by their tree. */
+static int
+t8_msh_file_face_record_compare (const void *a, const void *b)
+{
+  const t8_msh_file_face_record_t *face_a = (const t8_msh_file_face_record_t *) a;
+  const t8_msh_file_face_record_t *face_b = (const t8_msh_file_face_record_t *) b;
+
+  for (int ivertex = 0; ivertex < T8_ECLASS_MAX_CORNERS_2D; ++ivertex) {
+    const int ret = t8_msh_file_gloidx_compare (face_a->key + ivertex, face_b->key + ivertex);
+    if (ret) {
+      return ret;
+    }
+  }
+  return t8_msh_file_gloidx_compare (&face_a->gtree, &face_b->gtree);
+}
+
+/* The process that stores the node with tag \a tag. */
+static int
+t8_msh_file_node_owner (const t8_gloidx_t tag, const t8_gloidx_t min_tag, const t8_gloidx_t max_tag,
+                        const int mpisize)
+{
+  SC_CHECK_ABORTF (min_tag <= tag && tag <= max_tag, "Node tag %lli is not in the range of node tags of the file.\n",
+                   (long long) tag);
+  return (int) ((tag - min_tag) * mpisize / (max_tag - min_tag + 1));
+}
+
+/* The first tree of process \a rank if \a num_trees trees are uniformly distributed. */
+static t8_gloidx_t
+t8_msh_file_first_tree (const int rank, const t8_gloidx_t num_trees, const int mpisize)
+{
+  return num_trees * rank / mpisize;
+}
+
+/* The process that owns the tree \a gtree if \a num_trees trees are uniformly distributed. */
+static int
+t8_msh_file_tree_owner (const t8_gloidx_t gtree, const t8_gloidx_t num_trees, const int mpisize)
+{
+  T8_ASSERT (0 <= gtree && gtree < num_trees);
+  /* The owner is the largest rank p with first_tree (p) <= gtree */
+  return (int) (((gtree + 1) * mpisize - 1) / num_trees);
+}
+
+/* Exchange arrays of records between all processes of a communicator.
+ * \param [in]  comm      The communicator.
+ * \param [in]  send      For each process an array of records to send to it.
+ * \param [out] recv      For each process an initialized array of the same element size.
+ *                        On output it holds the records received from this process.
+ */
+static void
+t8_msh_file_alltoall (sc_MPI_Comm comm, sc_array_t *send, sc_array_t *recv)
+{
+  int mpisize, mpirank, mpiret;
+  int num_requests = 0;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  int *send_counts = T8_ALLOC (int, mpisize);
+  int *recv_counts = T8_ALLOC (int, mpisize);
+  sc_MPI_Request *requests = T8_ALLOC (sc_MPI_Request, 2 * mpisize);
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    send_counts[iproc] = send[iproc].elem_count;
+  }
+  mpiret = sc_MPI_Alltoall (send_counts, 1, sc_MPI_INT, recv_counts, 1, sc_MPI_INT, comm);
+  SC_CHECK_MPI (mpiret);
+
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    T8_ASSERT (recv[iproc].elem_size == send[iproc].elem_size);
+    sc_array_resize (&recv[iproc], recv_counts[iproc]);
+    const int num_bytes = recv_counts[iproc] * recv[iproc].elem_size;
+    if (iproc == mpirank) {
+      /* Our own records are copied. */
+      if (num_bytes > 0) {
+        memcpy (recv[iproc].array, send[iproc].array, num_bytes);
+      }
+    }
+    else if (num_bytes > 0) {
+      mpiret = sc_MPI_Irecv (recv[iproc].array, num_bytes, sc_MPI_BYTE, iproc, T8_MPI_CMESH_READ_MSH_FILE, comm,
+                             requests + num_requests++);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    const int num_bytes = send_counts[iproc] * send[iproc].elem_size;
+    if (iproc != mpirank && num_bytes > 0) {
+      mpiret = sc_MPI_Isend (send[iproc].array, num_bytes, sc_MPI_BYTE, iproc, T8_MPI_CMESH_READ_MSH_FILE, comm,
+                             requests + num_requests++);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  mpiret = sc_MPI_Waitall (num_requests, requests, sc_MPI_STATUSES_IGNORE);
+  SC_CHECK_MPI (mpiret);
+
+  T8_FREE (send_counts);
+  T8_FREE (recv_counts);
+  T8_FREE (requests);
+}
+
+/* Initialize an array of record arrays, one for each process. */
+static sc_array_t *
+t8_msh_file_proc_arrays_new (const int mpisize, const size_t elem_size)
+{
+  sc_array_t *arrays = T8_ALLOC (sc_array_t, mpisize);
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    sc_array_init (arrays + iproc, elem_size);
+  }
+  return arrays;
+}
+
+static void
+t8_msh_file_proc_arrays_destroy (const int mpisize, sc_array_t *arrays)
+{
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    sc_array_reset (arrays + iproc);
+  }
+  T8_FREE (arrays);
+}
+
+/* Concatenate the arrays of all processes into one array. */
+static void
+t8_msh_file_proc_arrays_concat (const int mpisize, sc_array_t *arrays, sc_array_t *all)
+{
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    const size_t old_count = all->elem_count;
+    sc_array_resize (all, old_count + arrays[iproc].elem_count);
+    if (arrays[iproc].elem_count > 0) {
+      memcpy (sc_array_index (all, old_count), arrays[iproc].array, arrays[iproc].elem_count * all->elem_size);
+    }
+  }
+}
+
+/* Read exactly \a count items of size \a size at the current position. Return true on success. */
+static int
+t8_msh_file_fread (void *buffer, const size_t size, const size_t count, FILE *fp)
+{
+  return fread (buffer, size, count, fp) == count;
+}
+
+/* Skip the binary $Entities section of a file of version 4.1.
+ * fp must point to the beginning of the section data. Return true on success. */
+static int
+t8_msh_file_skip_binary_entities (FILE *fp)
+{
+  size_t num_entities[4];
+  size_t num_tags;
+
+  if (!t8_msh_file_fread (num_entities, sizeof (size_t), 4, fp)) {
+    return 0;
+  }
+  for (int entity_dim = 0; entity_dim <= 3; ++entity_dim) {
+    for (size_t ientity = 0; ientity < num_entities[entity_dim]; ++ientity) {
+      /* The tag followed by the coordinates of a point or the bounding box of the entity. */
+      fseek (fp, sizeof (int) + (entity_dim == 0 ? 3 : 6) * sizeof (double), SEEK_CUR);
+      /* The physical tags */
+      if (!t8_msh_file_fread (&num_tags, sizeof (size_t), 1, fp)) {
+        return 0;
+      }
+      fseek (fp, num_tags * sizeof (int), SEEK_CUR);
+      if (entity_dim > 0) {
+        /* The bounding entities */
+        if (!t8_msh_file_fread (&num_tags, sizeof (size_t), 1, fp)) {
+          return 0;
+        }
+        fseek (fp, num_tags * sizeof (int), SEEK_CUR);
+      }
+    }
+  }
+  return !ferror (fp) && !feof (fp);
+}
+
+/* Parse the layout of a binary .msh file of version 4.1.
+ * We only read the headers of the node and element blocks and skip their data.
+ * \param [in]  fp              The opened file.
+ * \param [in]  dim             The dimension of the trees to read.
+ * \param [out] node_blocks     Filled with all node blocks.
+ * \param [out] element_blocks  Filled with all element blocks of dimension \a dim.
+ * \param [out] node_tag_range  The minimum and maximum node tag.
+ * \return                      True on success.
+ */
+static int
+t8_msh_file_read_binary_layout (FILE *fp, const int dim, sc_array_t *node_blocks, sc_array_t *element_blocks,
+                                t8_gloidx_t node_tag_range[2])
+{
+  char *line = (char *) malloc (1024);
+  char first_word[2048] = "\0";
+  size_t linen = 1024;
+  int version_number, sub_version_number, file_type, data_size, one;
+  int block_ints[3];
+  size_t block_count, header[4];
+  int found_nodes = 0;
+
+  fseek (fp, 0, SEEK_SET);
+  if (t8_cmesh_msh_read_next_line (&line, &linen, fp) < 0 || sscanf (line, "%2047s", first_word) != 1
+      || strcmp (first_word, "$MeshFormat")) {
+    t8_global_errorf ("The file does not start with a MeshFormat section.\n");
+    goto die_layout;
+  }
+  if (t8_cmesh_msh_read_next_line (&line, &linen, fp) < 0
+      || sscanf (line, "%d.%d %d %d", &version_number, &sub_version_number, &file_type, &data_size) != 4) {
+    t8_global_errorf ("Reading of the MeshFormat-number failed.\n");
+    goto die_layout;
+  }
+  if (version_number != 4 || sub_version_number != 1 || file_type != 1) {
+    t8_global_errorf ("The parallel msh reader only supports binary msh-files of version 4.1.\n");
+    goto die_layout;
+  }
+  if (data_size != sizeof (size_t)) {
+    t8_global_errorf ("The data size %i of the msh-file does not match the size of size_t.\n", data_size);
+    goto die_layout;
+  }
+  if (!t8_msh_file_fread (&one, sizeof (int), 1, fp) || one != 1) {
+    t8_global_errorf ("The endianness of the msh-file does not match the endianness of this machine.\n");
+    goto die_layout;
+  }
+
+  /* Walk through the sections until we reach the elements */
+  while (t8_cmesh_msh_read_next_line (&line, &linen, fp) >= 0) {
+    if (sscanf (line, "%2047s", first_word) != 1) {
+      continue;
+    }
+    if (!strcmp (first_word, "$EndMeshFormat") || !strcmp (first_word, "$EndEntities")
+        || !strcmp (first_word, "$EndNodes")) {
+      continue;
+    }
+    if (!strcmp (first_word, "$PhysicalNames")) {
+      /* This section is stored as ASCII */
+      while (t8_cmesh_msh_read_next_line (&line, &linen, fp) >= 0 && strncmp (line, "$EndPhysicalNames", 17)) {
+      }
+    }
+    else if (!strcmp (first_word, "$Entities")) {
+      if (!t8_msh_file_skip_binary_entities (fp)) {
+        t8_global_errorf ("Error while reading the entities of the msh-file.\n");
+        goto die_layout;
+      }
+    }
+    else if (!strcmp (first_word, "$Nodes")) {
+      if (!t8_msh_file_fread (header, sizeof (size_t), 4, fp)) {
+        t8_global_errorf ("Premature end of file while reading num nodes and num blocks.\n");
+        goto die_layout;
+      }
+      node_tag_range[0] = header[2];
+      node_tag_range[1] = header[3];
+      for (size_t iblock = 0; iblock < header[0]; ++iblock) {
+        if (!t8_msh_file_fread (block_ints, sizeof (int), 3, fp)
+            || !t8_msh_file_fread (&block_count, sizeof (size_t), 1, fp)) {
+          t8_global_errorf ("Error while reading node block information.\n");
+          goto die_layout;
+        }
+        t8_msh_file_block_t *block = (t8_msh_file_block_t *) sc_array_push (node_blocks);
+        block->offset = ftell (fp);
+        block->num_entries = block_count;
+        /* The coordinates followed by the parameters if the block is parametric. */
+        block->num_values = 3 + (block_ints[2] ? block_ints[0] : 0);
+        block->eclass = T8_ECLASS_COUNT;
+        fseek (fp, block_count * (sizeof (size_t) + block->num_values * sizeof (double)), SEEK_CUR);
+      }
+      found_nodes = 1;
+    }
+    else if (!strcmp (first_word, "$Elements")) {
+      if (!found_nodes) {
+        t8_global_errorf ("The Nodes section must precede the Elements section.\n");
+        goto die_layout;
+      }
+      if (!t8_msh_file_fread (header, sizeof (size_t), 4, fp)) {
+        t8_global_errorf ("Premature end of file while reading num trees and num blocks.\n");
+        goto die_layout;
+      }
+      for (size_t iblock = 0; iblock < header[0]; ++iblock) {
+        if (!t8_msh_file_fread (block_ints, sizeof (int), 3, fp)
+            || !t8_msh_file_fread (&block_count, sizeof (size_t), 1, fp)) {
+          t8_global_errorf ("Error while reading element block information.\n");
+          goto die_layout;
+        }
+        const int ele_type = block_ints[2];
+        if (ele_type <= 0 || ele_type > T8_NUM_GMSH_ELEM_CLASSES) {
+          t8_global_errorf ("tree type %i is not supported by t8code.\n", ele_type);
+          goto die_layout;
+        }
+        const int num_nodes = t8_msh_element_type_num_nodes[ele_type];
+        if (t8_msh_element_type_dim[ele_type] == dim) {
+          if (t8_msh_tree_type_to_eclass[ele_type] == T8_ECLASS_COUNT) {
+            t8_global_errorf ("tree type %i is not supported by t8code.\n", ele_type);
+            goto die_layout;
+          }
+          t8_msh_file_block_t *block = (t8_msh_file_block_t *) sc_array_push (element_blocks);
+          block->offset = ftell (fp);
+          block->num_entries = block_count;
+          block->num_values = num_nodes;
+          block->eclass = t8_msh_tree_type_to_eclass[ele_type];
+        }
+        /* Each element is stored as its tag followed by its node tags. */
+        fseek (fp, block_count * (1 + num_nodes) * sizeof (size_t), SEEK_CUR);
+      }
+      free (line);
+      return !ferror (fp);
+    }
+    else {
+      t8_global_errorf ("The section %s is not supported by the parallel msh reader.\n", first_word);
+      goto die_layout;
+    }
+  }
+  t8_global_errorf ("The msh-file does not contain an Elements section.\n");
+
+die_layout:
+  free (line);
+  return 0;
+}
+
+/* Read the nodes with positions [first_node, end_node) in the order of the file. */
+static int
+t8_msh_file_read_binary_nodes (FILE *fp, const sc_array_t *node_blocks, const t8_gloidx_t first_node,
+                               const t8_gloidx_t end_node, sc_array_t *nodes)
+{
+  t8_gloidx_t block_first = 0;
+  size_t *tags = NULL;
+  double *values = NULL;
+
+  for (size_t iblock = 0; iblock < node_blocks->elem_count && block_first < end_node; ++iblock) {
+    const t8_msh_file_block_t *block = (const t8_msh_file_block_t *) sc_array_index (node_blocks, iblock);
+    const t8_gloidx_t block_end = block_first + block->num_entries;
+    const t8_gloidx_t read_first = SC_MAX (first_node, block_first);
+    const t8_gloidx_t read_end = SC_MIN (end_node, block_end);
+    if (read_first < read_end) {
+      const size_t num_read = read_end - read_first;
+      const size_t first_in_block = read_first - block_first;
+      tags = T8_REALLOC (tags, size_t, num_read);
+      values = T8_REALLOC (values, double, num_read * block->num_values);
+      /* The block stores all node tags followed by all coordinates. */
+      fseek (fp, block->offset + first_in_block * sizeof (size_t), SEEK_SET);
+      if (!t8_msh_file_fread (tags, sizeof (size_t), num_read, fp)) {
+        goto die_nodes;
+      }
+      fseek (fp,
+             block->offset + block->num_entries * sizeof (size_t)
+               + first_in_block * block->num_values * sizeof (double),
+             SEEK_SET);
+      if (!t8_msh_file_fread (values, sizeof (double), num_read * block->num_values, fp)) {
+        goto die_nodes;
+      }
+      for (size_t inode = 0; inode < num_read; ++inode) {
+        t8_msh_file_node_record_t *node = (t8_msh_file_node_record_t *) sc_array_push (nodes);
+        node->tag = tags[inode];
+        memcpy (node->coordinates, values + inode * block->num_values, 3 * sizeof (double));
+      }
+    }
+    block_first = block_end;
+  }
+  T8_FREE (tags);
+  T8_FREE (values);
+  return 1;
+
+die_nodes:
+  T8_FREE (tags);
+  T8_FREE (values);
+  return 0;
+}
+
+/* Read the trees with ids [first_tree, end_tree) and store their node tags. */
+static int
+t8_msh_file_read_binary_trees (FILE *fp, const sc_array_t *element_blocks, const t8_gloidx_t first_tree,
+                               const t8_gloidx_t end_tree, sc_array_t *trees)
+{
+  t8_gloidx_t block_first = 0;
+  size_t *entries = NULL;
+
+  for (size_t iblock = 0; iblock < element_blocks->elem_count && block_first < end_tree; ++iblock) {
+    const t8_msh_file_block_t *block = (const t8_msh_file_block_t *) sc_array_index (element_blocks, iblock);
+    const t8_gloidx_t block_end = block_first + block->num_entries;
+    const t8_gloidx_t read_first = SC_MAX (first_tree, block_first);
+    const t8_gloidx_t read_end = SC_MIN (end_tree, block_end);
+    if (read_first < read_end) {
+      const size_t num_read = read_end - read_first;
+      const int entry_size = 1 + block->num_values;
+      const t8_eclass_t eclass = (t8_eclass_t) block->eclass;
+      entries = T8_REALLOC (entries, size_t, num_read * entry_size);
+      fseek (fp, block->offset + (read_first - block_first) * entry_size * sizeof (size_t), SEEK_SET);
+      if (!t8_msh_file_fread (entries, sizeof (size_t), num_read * entry_size, fp)) {
+        T8_FREE (entries);
+        return 0;
+      }
+      for (size_t itree = 0; itree < num_read; ++itree) {
+        t8_msh_file_tree_record_t *tree = (t8_msh_file_tree_record_t *) sc_array_push (trees);
+        tree->gtree = read_first + itree;
+        tree->eclass = eclass;
+        tree->num_joins = 0;
+        /* We skip the element tag and store the nodes in t8code order. */
+        for (int ivertex = 0; ivertex < t8_eclass_num_vertices[eclass]; ++ivertex) {
+          tree->nodes[ivertex] = entries[itree * entry_size + 1 + t8_vertex_to_msh_vertex_num[eclass][ivertex]];
+        }
+      }
+    }
+    block_first = block_end;
+  }
+  T8_FREE (entries);
+  return 1;
+}
+
+/* Fill the vertex coordinates of the trees. The nodes are distributed
+ * among the processes and stored sorted by their tag in \a owned_nodes. */
+static void
+t8_msh_file_resolve_tree_vertices (sc_MPI_Comm comm, const int mpisize, sc_array_t *trees,
+                                   const sc_array_t *owned_nodes, const t8_gloidx_t node_tag_range[2])
+{
+  sc_array_t needed_tags;
+  sc_array_t *requests = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_gloidx_t));
+  sc_array_t *requested = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_gloidx_t));
+  sc_array_t *answers = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_msh_file_node_record_t));
+  sc_array_t *received = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_msh_file_node_record_t));
+  sc_array_t received_nodes;
+
+  /* Collect each needed node tag once */
+  sc_array_init (&needed_tags, sizeof (t8_gloidx_t));
+  for (size_t itree = 0; itree < trees->elem_count; ++itree) {
+    const t8_msh_file_tree_record_t *tree = (const t8_msh_file_tree_record_t *) sc_array_index (trees, itree);
+    for (int ivertex = 0; ivertex < t8_eclass_num_vertices[tree->eclass]; ++ivertex) {
+      *(t8_gloidx_t *) sc_array_push (&needed_tags) = tree->nodes[ivertex];
+    }
+  }
+  sc_array_sort (&needed_tags, t8_msh_file_gloidx_compare);
+  sc_array_uniq (&needed_tags, t8_msh_file_gloidx_compare);
+  /* Request them from their owners */
+  for (size_t itag = 0; itag < needed_tags.elem_count; ++itag) {
+    const t8_gloidx_t tag = *(t8_gloidx_t *) sc_array_index (&needed_tags, itag);
+    const int owner = t8_msh_file_node_owner (tag, node_tag_range[0], node_tag_range[1], mpisize);
+    *(t8_gloidx_t *) sc_array_push (requests + owner) = tag;
+  }
+  sc_array_reset (&needed_tags);
+  t8_msh_file_alltoall (comm, requests, requested);
+
+  /* Answer the requests for our nodes */
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    for (size_t itag = 0; itag < requested[iproc].elem_count; ++itag) {
+      t8_msh_file_node_record_t key;
+      key.tag = *(t8_gloidx_t *) sc_array_index (requested + iproc, itag);
+      const ssize_t index = sc_array_bsearch ((sc_array_t *) owned_nodes, &key, t8_msh_file_node_record_compare);
+      SC_CHECK_ABORTF (index >= 0, "Node %lli is not in the msh-file.\n", (long long) key.tag);
+      *(t8_msh_file_node_record_t *) sc_array_push (answers + iproc) = *(const t8_msh_file_node_record_t *)
+        sc_array_index ((sc_array_t *) owned_nodes, index);
+    }
+  }
+  t8_msh_file_alltoall (comm, answers, received);
+
+  /* Since we requested the tags in ascending order from processes with ascending ranks,
+   * the received nodes are sorted by tag. */
+  sc_array_init (&received_nodes, sizeof (t8_msh_file_node_record_t));
+  t8_msh_file_proc_arrays_concat (mpisize, received, &received_nodes);
+  for (size_t itree = 0; itree < trees->elem_count; ++itree) {
+    t8_msh_file_tree_record_t *tree = (t8_msh_file_tree_record_t *) sc_array_index (trees, itree);
+    const t8_eclass_t eclass = (t8_eclass_t) tree->eclass;
+    const int num_vertices = t8_eclass_num_vertices[eclass];
+    for (int ivertex = 0; ivertex < num_vertices; ++ivertex) {
+      t8_msh_file_node_record_t key;
+      key.tag = tree->nodes[ivertex];
+      const ssize_t index = sc_array_bsearch (&received_nodes, &key, t8_msh_file_node_record_compare);
+      T8_ASSERT (index >= 0);
+      memcpy (tree->vertices + 3 * ivertex,
+              ((t8_msh_file_node_record_t *) sc_array_index (&received_nodes, index))->coordinates,
+              3 * sizeof (double));
+    }
+    /* Detect and correct negative volumes. We switch the node tags as well,
+     * such that the faces are computed from the corrected vertices. */
+    if (t8_cmesh_tree_vertices_negative_volume (eclass, tree->vertices, num_vertices)) {
+      int switch_indices[4] = { 0 };
+      const int num_switches = t8_msh_file_negative_volume_switches (eclass, switch_indices);
+      t8_debugf ("Correcting negative volume of tree %lli\n", (long long) tree->gtree);
+      for (int iswitch = 0; iswitch < num_switches; ++iswitch) {
+        for (int idim = 0; idim < 3; ++idim) {
+          std::swap (tree->vertices[3 * iswitch + idim], tree->vertices[3 * switch_indices[iswitch] + idim]);
+        }
+        std::swap (tree->nodes[iswitch], tree->nodes[switch_indices[iswitch]]);
+      }
+      T8_ASSERT (!t8_cmesh_tree_vertices_negative_volume (eclass, tree->vertices, num_vertices));
+    }
+  }
+
+  sc_array_reset (&received_nodes);
+  t8_msh_file_proc_arrays_destroy (mpisize, requests);
+  t8_msh_file_proc_arrays_destroy (mpisize, requested);
+  t8_msh_file_proc_arrays_destroy (mpisize, answers);
+  t8_msh_file_proc_arrays_destroy (mpisize, received);
+}
+
+/* Find the face connections of the trees. Each face is sent to the owner of its
+ * smallest node tag, which matches equal faces and returns the connections to the
+ * owners of both trees. On output each tree stores all of its face connections. */
+static void
+t8_msh_file_find_neighbors_parallel (sc_MPI_Comm comm, const int mpisize, sc_array_t *trees,
+                                     const t8_gloidx_t first_tree, const t8_gloidx_t num_trees,
+                                     const t8_gloidx_t node_tag_range[2])
+{
+  sc_array_t *faces_send = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_msh_file_face_record_t));
+  sc_array_t *faces_recv = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_msh_file_face_record_t));
+  sc_array_t *joins_send = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_msh_file_join_t));
+  sc_array_t *joins_recv = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_msh_file_join_t));
+  sc_array_t faces;
+
+  for (size_t itree = 0; itree < trees->elem_count; ++itree) {
+    const t8_msh_file_tree_record_t *tree = (const t8_msh_file_tree_record_t *) sc_array_index (trees, itree);
+    const t8_eclass_t eclass = (t8_eclass_t) tree->eclass;
+    for (int iface = 0; iface < t8_eclass_num_faces[eclass]; ++iface) {
+      t8_msh_file_face_record_t face;
+      const int num_face_vertices = t8_eclass_num_vertices[t8_eclass_face_types[eclass][iface]];
+      for (int ivertex = 0; ivertex < T8_ECLASS_MAX_CORNERS_2D; ++ivertex) {
+        face.vertices[ivertex]
+          = ivertex < num_face_vertices ? tree->nodes[t8_face_vertex_to_tree_vertex[eclass][iface][ivertex]] : -1;
+        face.key[ivertex] = face.vertices[ivertex];
+      }
+      std::sort (face.key, face.key + num_face_vertices);
+      face.gtree = tree->gtree;
+      face.face = iface;
+      face.eclass = eclass;
+      const int owner = t8_msh_file_node_owner (face.key[0], node_tag_range[0], node_tag_range[1], mpisize);
+      *(t8_msh_file_face_record_t *) sc_array_push (faces_send + owner) = face;
+    }
+  }
+  t8_msh_file_alltoall (comm, faces_send, faces_recv);
+  t8_msh_file_proc_arrays_destroy (mpisize, faces_send);
+
+  /* Equal faces are adjacent after sorting */
+  sc_array_init (&faces, sizeof (t8_msh_file_face_record_t));
+  t8_msh_file_proc_arrays_concat (mpisize, faces_recv, &faces);
+  t8_msh_file_proc_arrays_destroy (mpisize, faces_recv);
+  sc_array_sort (&faces, t8_msh_file_face_record_compare);
+  for (size_t iface = 0; iface + 1 < faces.elem_count; ++iface) {
+    const t8_msh_file_face_record_t *face_a = (const t8_msh_file_face_record_t *) sc_array_index (&faces, iface);
+    const t8_msh_file_face_record_t *face_b = (const t8_msh_file_face_record_t *) sc_array_index (&faces, iface + 1);
+    if (memcmp (face_a->key, face_b->key, sizeof (face_a->key))) {
+      continue;
+    }
+    /* The two faces match. We compute the orientation as in the serial reader. */
+    long vertices_a[T8_ECLASS_MAX_CORNERS_2D], vertices_b[T8_ECLASS_MAX_CORNERS_2D];
+    t8_msh_file_face_t Face_a, Face_b;
+    for (int ivertex = 0; ivertex < T8_ECLASS_MAX_CORNERS_2D; ++ivertex) {
+      vertices_a[ivertex] = face_a->vertices[ivertex];
+      vertices_b[ivertex] = face_b->vertices[ivertex];
+    }
+    Face_a.face_number = face_a->face;
+    Face_a.vertices = vertices_a;
+    Face_b.face_number = face_b->face;
+    Face_b.vertices = vertices_b;
+    t8_msh_file_join_t join;
+    join.gtree1 = face_a->gtree;
+    join.gtree2 = face_b->gtree;
+    join.face1 = face_a->face;
+    join.face2 = face_b->face;
+    join.orientation
+      = t8_msh_file_face_orientation (&Face_a, &Face_b, (t8_eclass_t) face_a->eclass, (t8_eclass_t) face_b->eclass);
+    const int owner_a = t8_msh_file_tree_owner (join.gtree1, num_trees, mpisize);
+    const int owner_b = t8_msh_file_tree_owner (join.gtree2, num_trees, mpisize);
+    *(t8_msh_file_join_t *) sc_array_push (joins_send + owner_a) = join;
+    if (owner_b != owner_a) {
+      *(t8_msh_file_join_t *) sc_array_push (joins_send + owner_b) = join;
+    }
+    /* Skip the second face */
+    ++iface;
+  }
+  sc_array_reset (&faces);
+  t8_msh_file_alltoall (comm, joins_send, joins_recv);
+
+  /* Store the connections at their local trees */
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    for (size_t ijoin = 0; ijoin < joins_recv[iproc].elem_count; ++ijoin) {
+      const t8_msh_file_join_t *join = (const t8_msh_file_join_t *) sc_array_index (joins_recv + iproc, ijoin);
+      const t8_gloidx_t join_trees[2] = { join->gtree1, join->gtree2 };
+      for (int iside = 0; iside < 2; ++iside) {
+        const t8_gloidx_t ltree = join_trees[iside] - first_tree;
+        if (0 <= ltree && ltree < (t8_gloidx_t) trees->elem_count) {
+          t8_msh_file_tree_record_t *tree = (t8_msh_file_tree_record_t *) sc_array_index (trees, ltree);
+          T8_ASSERT (tree->num_joins < T8_ECLASS_MAX_FACES);
+          tree->joins[tree->num_joins++] = *join;
+        }
+      }
+    }
+  }
+  t8_msh_file_proc_arrays_destroy (mpisize, joins_send);
+  t8_msh_file_proc_arrays_destroy (mpisize, joins_recv);
+}
+
+/* Collect the ghost trees, that are all neighbor trees of local trees that are not local.
+ * The ghost trees are received from their owners together with their face connections. */
+static void
+t8_msh_file_get_ghosts (sc_MPI_Comm comm, const int mpisize, const sc_array_t *trees, const t8_gloidx_t first_tree,
+                        const t8_gloidx_t num_trees, sc_array_t *ghosts)
+{
+  sc_array_t ghost_ids;
+  sc_array_t *requests = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_gloidx_t));
+  sc_array_t *requested = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_gloidx_t));
+  sc_array_t *answers = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_msh_file_tree_record_t));
+  sc_array_t *received = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_msh_file_tree_record_t));
+  const t8_gloidx_t end_tree = first_tree + trees->elem_count;
+
+  sc_array_init (&ghost_ids, sizeof (t8_gloidx_t));
+  for (size_t itree = 0; itree < trees->elem_count; ++itree) {
+    const t8_msh_file_tree_record_t *tree = (const t8_msh_file_tree_record_t *) sc_array_index ((sc_array_t *) trees,
+                                                                                                itree);
+    for (int ijoin = 0; ijoin < tree->num_joins; ++ijoin) {
+      const t8_gloidx_t neighbor
+        = tree->joins[ijoin].gtree1 == tree->gtree ? tree->joins[ijoin].gtree2 : tree->joins[ijoin].gtree1;
+      if (neighbor < first_tree || neighbor >= end_tree) {
+        *(t8_gloidx_t *) sc_array_push (&ghost_ids) = neighbor;
+      }
+    }
+  }
+  sc_array_sort (&ghost_ids, t8_msh_file_gloidx_compare);
+  sc_array_uniq (&ghost_ids, t8_msh_file_gloidx_compare);
+  for (size_t ighost = 0; ighost < ghost_ids.elem_count; ++ighost) {
+    const t8_gloidx_t ghost_id = *(t8_gloidx_t *) sc_array_index (&ghost_ids, ighost);
+    *(t8_gloidx_t *) sc_array_push (requests + t8_msh_file_tree_owner (ghost_id, num_trees, mpisize)) = ghost_id;
+  }
+  sc_array_reset (&ghost_ids);
+  t8_msh_file_alltoall (comm, requests, requested);
+
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    for (size_t itree = 0; itree < requested[iproc].elem_count; ++itree) {
+      const t8_gloidx_t gtree = *(t8_gloidx_t *) sc_array_index (requested + iproc, itree);
+      T8_ASSERT (first_tree <= gtree && gtree < end_tree);
+      *(t8_msh_file_tree_record_t *) sc_array_push (answers + iproc)
+        = *(const t8_msh_file_tree_record_t *) sc_array_index ((sc_array_t *) trees, gtree - first_tree);
+    }
+  }
+  t8_msh_file_alltoall (comm, answers, received);
+  t8_msh_file_proc_arrays_concat (mpisize, received, ghosts);
+
+  t8_msh_file_proc_arrays_destroy (mpisize, requests);
+  t8_msh_file_proc_arrays_destroy (mpisize, requested);
+  t8_msh_file_proc_arrays_destroy (mpisize, answers);
+  t8_msh_file_proc_arrays_destroy (mpisize, received);
+}
+
+/* Read the layout of the file on one process and broadcast it.
+ * Return true if the layout was read successfully. */
+static int
+t8_msh_file_bcast_binary_layout (const char *filename, const int dim, sc_MPI_Comm comm, const int mpirank,
+                                 sc_array_t *node_blocks, sc_array_t *element_blocks, t8_gloidx_t node_tag_range[2])
+{
+  int mpiret;
+  /* Success, number of node blocks, number of element blocks */
+  int layout_info[3] = { 0, 0, 0 };
+
+  if (mpirank == 0) {
+    FILE *fp = fopen (filename, "rb");
+    if (fp == NULL) {
+      t8_global_errorf ("Could not open file %s\n", filename);
+    }
+    else {
+      layout_info[0] = t8_msh_file_read_binary_layout (fp, dim, node_blocks, element_blocks, node_tag_range);
+      layout_info[1] = node_blocks->elem_count;
+      layout_info[2] = element_blocks->elem_count;
+      fclose (fp);
+    }
+  }
+  mpiret = sc_MPI_Bcast (layout_info, 3, sc_MPI_INT, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  if (!layout_info[0]) {
+    return 0;
+  }
+  sc_array_resize (node_blocks, layout_info[1]);
+  sc_array_resize (element_blocks, layout_info[2]);
+  mpiret = sc_MPI_Bcast (node_tag_range, 2, T8_MPI_GLOIDX, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  if (layout_info[1] > 0) {
+    mpiret = sc_MPI_Bcast (node_blocks->array, layout_info[1] * sizeof (t8_msh_file_block_t), sc_MPI_BYTE, 0, comm);
+    SC_CHECK_MPI (mpiret);
+  }
+  if (layout_info[2] > 0) {
+    mpiret
+      = sc_MPI_Bcast (element_blocks->array, layout_info[2] * sizeof (t8_msh_file_block_t), sc_MPI_BYTE, 0, comm);
+    SC_CHECK_MPI (mpiret);
+  }
+  return 1;
+}
+
 /* This part should be callable from C */
 T8_EXTERN_C_BEGIN ();
 
@@ -1945,4 +2684,144 @@ t8_cmesh_from_msh_file (const char *fileprefix, const int partition, sc_MPI_Comm
   return cmesh;
 }
 
+t8_cmesh_t
+t8_cmesh_from_msh_file_parallel (const char *fileprefix, sc_MPI_Comm comm, const int dim)
+{
+  int mpirank, mpisize, mpiret;
+  char current_file[BUFSIZ];
+  t8_gloidx_t node_tag_range[2] = { 0, -1 };
+  sc_array_t node_blocks, element_blocks, trees, ghosts;
+  t8_cmesh_t cmesh;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  snprintf (current_file, BUFSIZ, "%s.msh", fileprefix);
+  sc_array_init (&node_blocks, sizeof (t8_msh_file_block_t));
+  sc_array_init (&element_blocks, sizeof (t8_msh_file_block_t));
+  if (!t8_msh_file_bcast_binary_layout (current_file, dim, comm, mpirank, &node_blocks, &element_blocks,
+                                        node_tag_range)) {
+    t8_debugf ("The reading process of the msh-file has failed.\n");
+    sc_array_reset (&node_blocks);
+    sc_array_reset (&element_blocks);
+    return NULL;
+  }
+
+  /* Count the nodes and trees in the file */
+  t8_gloidx_t num_nodes = 0, num_trees = 0;
+  for (size_t iblock = 0; iblock < node_blocks.elem_count; ++iblock) {
+    num_nodes += ((t8_msh_file_block_t *) sc_array_index (&node_blocks, iblock))->num_entries;
+  }
+  for (size_t iblock = 0; iblock < element_blocks.elem_count; ++iblock) {
+    num_trees += ((t8_msh_file_block_t *) sc_array_index (&element_blocks, iblock))->num_entries;
+  }
+  if (num_trees == 0) {
+    t8_global_errorf ("Warning: No %iD elements found in msh file.\n", dim);
+  }
+
+  /* Each process reads its range of nodes and trees */
+  const t8_gloidx_t first_tree = t8_msh_file_first_tree (mpirank, num_trees, mpisize);
+  const t8_gloidx_t end_tree = t8_msh_file_first_tree (mpirank + 1, num_trees, mpisize);
+  sc_array_t *nodes_send = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_msh_file_node_record_t));
+  sc_array_t *nodes_recv = t8_msh_file_proc_arrays_new (mpisize, sizeof (t8_msh_file_node_record_t));
+  sc_array_t read_nodes, owned_nodes;
+  sc_array_init (&read_nodes, sizeof (t8_msh_file_node_record_t));
+  sc_array_init (&owned_nodes, sizeof (t8_msh_file_node_record_t));
+  sc_array_init (&trees, sizeof (t8_msh_file_tree_record_t));
+  int read_successful = 0;
+  FILE *fp = fopen (current_file, "rb");
+  if (fp != NULL) {
+    read_successful = t8_msh_file_read_binary_nodes (fp, &node_blocks, num_nodes * mpirank / mpisize,
+                                                     num_nodes * (mpirank + 1) / mpisize, &read_nodes)
+                      && t8_msh_file_read_binary_trees (fp, &element_blocks, first_tree, end_tree, &trees);
+    fclose (fp);
+  }
+  if (!read_successful) {
+    t8_errorf ("Error while reading file %s\n", current_file);
+  }
+  sc_array_reset (&node_blocks);
+  sc_array_reset (&element_blocks);
+  int all_read_successful;
+  mpiret = sc_MPI_Allreduce (&read_successful, &all_read_successful, 1, sc_MPI_INT, sc_MPI_LAND, comm);
+  SC_CHECK_MPI (mpiret);
+  if (!all_read_successful) {
+    sc_array_reset (&read_nodes);
+    sc_array_reset (&trees);
+    sc_array_reset (&owned_nodes);
+    t8_msh_file_proc_arrays_destroy (mpisize, nodes_send);
+    t8_msh_file_proc_arrays_destroy (mpisize, nodes_recv);
+    return NULL;
+  }
+
+  /* Distribute the nodes to their owners */
+  for (size_t inode = 0; inode < read_nodes.elem_count; ++inode) {
+    const t8_msh_file_node_record_t *node = (t8_msh_file_node_record_t *) sc_array_index (&read_nodes, inode);
+    const int owner = t8_msh_file_node_owner (node->tag, node_tag_range[0], node_tag_range[1], mpisize);
+    *(t8_msh_file_node_record_t *) sc_array_push (nodes_send + owner) = *node;
+  }
+  sc_array_reset (&read_nodes);
+  t8_msh_file_alltoall (comm, nodes_send, nodes_recv);
+  t8_msh_file_proc_arrays_concat (mpisize, nodes_recv, &owned_nodes);
+  t8_msh_file_proc_arrays_destroy (mpisize, nodes_send);
+  t8_msh_file_proc_arrays_destroy (mpisize, nodes_recv);
+  sc_array_sort (&owned_nodes, t8_msh_file_node_record_compare);
+
+  /* Get the coordinates of the tree vertices and the face connections */
+  t8_msh_file_resolve_tree_vertices (comm, mpisize, &trees, &owned_nodes, node_tag_range);
+  sc_array_reset (&owned_nodes);
+  t8_msh_file_find_neighbors_parallel (comm, mpisize, &trees, first_tree, num_trees, node_tag_range);
+  sc_array_init (&ghosts, sizeof (t8_msh_file_tree_record_t));
+  t8_msh_file_get_ghosts (comm, mpisize, &trees, first_tree, num_trees, &ghosts);
+
+  /* Build the partitioned cmesh */
+  t8_cmesh_init (&cmesh);
+  t8_cmesh_set_dimension (cmesh, dim);
+  t8_cmesh_register_geometry<t8_geometry_linear> (cmesh, dim);
+  t8_cmesh_set_partition_range (cmesh, 3, first_tree, end_tree - 1);
+  for (size_t itree = 0; itree < trees.elem_count; ++itree) {
+    const t8_msh_file_tree_record_t *tree = (t8_msh_file_tree_record_t *) sc_array_index (&trees, itree);
+    const t8_eclass_t eclass = (t8_eclass_t) tree->eclass;
+    t8_cmesh_set_tree_class (cmesh, tree->gtree, eclass);
+    t8_cmesh_set_tree_vertices (cmesh, tree->gtree, tree->vertices, t8_eclass_num_vertices[eclass]);
+    for (int ijoin = 0; ijoin < tree->num_joins; ++ijoin) {
+      const t8_msh_file_join_t *join = tree->joins + ijoin;
+      const t8_gloidx_t neighbor = join->gtree1 == tree->gtree ? join->gtree2 : join->gtree1;
+      /* Set connections between local trees only once */
+      if (neighbor < first_tree || neighbor >= end_tree || tree->gtree == join->gtree1) {
+        t8_cmesh_set_join (cmesh, join->gtree1, join->gtree2, join->face1, join->face2, join->orientation);
+      }
+    }
+  }
+  for (size_t ighost = 0; ighost < ghosts.elem_count; ++ighost) {
+    const t8_msh_file_tree_record_t *ghost = (t8_msh_file_tree_record_t *) sc_array_index (&ghosts, ighost);
+    const t8_eclass_t eclass = (t8_eclass_t) ghost->eclass;
+    t8_cmesh_set_tree_class (cmesh, ghost->gtree, eclass);
+    t8_cmesh_set_tree_vertices (cmesh, ghost->gtree, ghost->vertices, t8_eclass_num_vertices[eclass]);
+    for (int ijoin = 0; ijoin < ghost->num_joins; ++ijoin) {
+      const t8_msh_file_join_t *join = ghost->joins + ijoin;
+      const t8_gloidx_t neighbor = join->gtree1 == ghost->gtree ? join->gtree2 : join->gtree1;
+      t8_msh_file_tree_record_t key;
+      key.gtree = neighbor;
+      if (first_tree <= neighbor && neighbor < end_tree) {
+        /* This connection was already set by the local tree */
+        continue;
+      }
+      if (ghost->gtree != join->gtree1 && sc_array_bsearch (&ghosts, &key, t8_msh_file_tree_record_compare) >= 0) {
+        /* The connection between two ghosts is set by the first ghost of the connection */
+        continue;
+      }
+      t8_cmesh_set_join (cmesh, join->gtree1, join->gtree2, join->face1, join->face2, join->orientation);
+    }
+  }
+  sc_array_reset (&trees);
+  sc_array_reset (&ghosts);
+
+  t8_cmesh_commit (cmesh, comm);
+  t8_global_productionf ("Read %lli %iD trees from %s on %i processes.\n", (long long) num_trees, dim, current_file,
+                         mpisize);
+  return cmesh;
+}
+
 T8_EXTERN_C_END ();
@@ -0,0 +1,392 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_cmesh_reorder.cxx
+ *
+ * Renumber the trees of a cmesh along a Morton space-filling curve through
+ * their centroids or by a reverse Cuthill-McKee ordering of their face graph.
+ */
+
+#include <t8_cmesh/t8_cmesh_reorder.h>
+#include <t8_cmesh/t8_cmesh_types.h>
+#include <t8_cmesh/t8_cmesh_stash.h>
+#include <t8_cmesh/t8_cmesh_offset.h>
+#include <vector>
+#include <algorithm>
+#include <numeric>
+#include <cfloat>
+
+/* The number of bits per coordinate direction of the Morton keys. */
+#define T8_CMESH_REORDER_SFC_BITS 21
+
+/* Interleave the bits of three integer coordinates to a Morton key. */
+static uint64_t
+t8_cmesh_reorder_morton_key (const uint32_t coords[T8_ECLASS_MAX_DIM])
+{
+  uint64_t key = 0;
+  for (int ibit = T8_CMESH_REORDER_SFC_BITS - 1; ibit >= 0; ibit--) {
+    for (int icoord = T8_ECLASS_MAX_DIM - 1; icoord >= 0; icoord--) {
+      key = (key << 1) | ((coords[icoord] >> ibit) & 1);
+    }
+  }
+  return key;
+}
+
+/* Compute the order of the local trees along a Morton curve through their centroids.
+ * Trees without vertices are treated as if their centroid was the origin. */
+static void
+t8_cmesh_reorder_sfc (const t8_stash_t stash, const t8_gloidx_t first_tree, const t8_locidx_t num_trees,
+                      std::vector<t8_locidx_t> &order)
+{
+  std::vector<double> centroids (T8_ECLASS_MAX_DIM * num_trees, 0);
+  double min_coord[T8_ECLASS_MAX_DIM], max_coord[T8_ECLASS_MAX_DIM];
+
+  /* Compute the centroids from the vertex attributes */
+  for (size_t iattribute = 0; iattribute < stash->attributes.elem_count; iattribute++) {
+    const t8_stash_attribute_struct_t *attribute
+      = (const t8_stash_attribute_struct_t *) sc_array_index (&stash->attributes, iattribute);
+    if (attribute->key == T8_CMESH_VERTICES_ATTRIBUTE_KEY && attribute->package_id == t8_get_package_id ()
+        && first_tree <= attribute->id && attribute->id < first_tree + num_trees) {
+      const double *vertices = (const double *) attribute->attr_data;
+      const int num_vertices = attribute->attr_size / (T8_ECLASS_MAX_DIM * sizeof (double));
+      double *centroid = &centroids[T8_ECLASS_MAX_DIM * (attribute->id - first_tree)];
+      for (int ivertex = 0; ivertex < num_vertices; ivertex++) {
+        for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+          centroid[icoord] += vertices[T8_ECLASS_MAX_DIM * ivertex + icoord] / num_vertices;
+        }
+      }
+    }
+  }
+
+  /* Compute the bounding box of the centroids */
+  for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+    min_coord[icoord] = DBL_MAX;
+    max_coord[icoord] = -DBL_MAX;
+  }
+  for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+    for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+      min_coord[icoord] = SC_MIN (min_coord[icoord], centroids[T8_ECLASS_MAX_DIM * itree + icoord]);
+      max_coord[icoord] = SC_MAX (max_coord[icoord], centroids[T8_ECLASS_MAX_DIM * itree + icoord]);
+    }
+  }
+
+  /* Sort the trees by the Morton keys of their centroids */
+  const double max_int = (double) ((1u << T8_CMESH_REORDER_SFC_BITS) - 1);
+  std::vector<uint64_t> keys (num_trees);
+  for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+    uint32_t coords[T8_ECLASS_MAX_DIM];
+    for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+      const double extent = max_coord[icoord] - min_coord[icoord];
+      const double centroid = centroids[T8_ECLASS_MAX_DIM * itree + icoord];
+      coords[icoord] = extent > 0 ? (uint32_t) ((centroid - min_coord[icoord]) / extent * max_int) : 0;
+    }
+    keys[itree] = t8_cmesh_reorder_morton_key (coords);
+  }
+  order.resize (num_trees);
+  std::iota (order.begin (), order.end (), 0);
+  std::stable_sort (order.begin (), order.end (),
+                    [&keys] (const t8_locidx_t a, const t8_locidx_t b) { return keys[a] < keys[b]; });
+}
+
+/* Compute the reverse Cuthill-McKee order of the graph of face connections between the local trees.
+ * Each connected component is started at an unvisited tree of minimal degree. */
+static void
+t8_cmesh_reorder_rcm (const t8_stash_t stash, const t8_gloidx_t first_tree, const t8_locidx_t num_trees,
+                      std::vector<t8_locidx_t> &order)
+{
+  /* Build the adjacency of the local trees in CSR format */
+  std::vector<t8_locidx_t> offsets (num_trees + 1, 0);
+  for (size_t ijoin = 0; ijoin < stash->joinfaces.elem_count; ijoin++) {
+    const t8_stash_joinface_struct_t *join
+      = (const t8_stash_joinface_struct_t *) sc_array_index (&stash->joinfaces, ijoin);
+    if (join->id1 != join->id2 && first_tree <= join->id1 && join->id2 < first_tree + num_trees) {
+      offsets[join->id1 - first_tree + 1]++;
+      offsets[join->id2 - first_tree + 1]++;
+    }
+  }
+  for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+    offsets[itree + 1] += offsets[itree];
+  }
+  std::vector<t8_locidx_t> neighbors (offsets[num_trees]);
+  std::vector<t8_locidx_t> fill (offsets.begin (), offsets.end () - 1);
+  for (size_t ijoin = 0; ijoin < stash->joinfaces.elem_count; ijoin++) {
+    const t8_stash_joinface_struct_t *join
+      = (const t8_stash_joinface_struct_t *) sc_array_index (&stash->joinfaces, ijoin);
+    if (join->id1 != join->id2 && first_tree <= join->id1 && join->id2 < first_tree + num_trees) {
+      const t8_locidx_t tree1 = join->id1 - first_tree;
+      const t8_locidx_t tree2 = join->id2 - first_tree;
+      neighbors[fill[tree1]++] = tree2;
+      neighbors[fill[tree2]++] = tree1;
+    }
+  }
+  auto by_degree = [&offsets] (const t8_locidx_t a, const t8_locidx_t b) {
+    return offsets[a + 1] - offsets[a] < offsets[b + 1] - offsets[b];
+  };
+
+  /* Breadth first search through each component, visiting the neighbors
+   * of a tree by increasing degree */
+  std::vector<t8_locidx_t> start_trees (num_trees);
+  std::iota (start_trees.begin (), start_trees.end (), 0);
+  std::stable_sort (start_trees.begin (), start_trees.end (), by_degree);
+  std::vector<char> visited (num_trees, 0);
+  order.clear ();
+  order.reserve (num_trees);
+  for (const t8_locidx_t start_tree : start_trees) {
+    if (visited[start_tree]) {
+      continue;
+    }
+    visited[start_tree] = 1;
+    order.push_back (start_tree);
+    for (size_t ihead = order.size () - 1; ihead < order.size (); ihead++) {
+      const t8_locidx_t tree = order[ihead];
+      const size_t first_new = order.size ();
+      for (t8_locidx_t ineigh = offsets[tree]; ineigh < offsets[tree + 1]; ineigh++) {
+        if (!visited[neighbors[ineigh]]) {
+          visited[neighbors[ineigh]] = 1;
+          order.push_back (neighbors[ineigh]);
+        }
+      }
+      std::stable_sort (order.begin () + first_new, order.end (), by_degree);
+    }
+  }
+  std::reverse (order.begin (), order.end ());
+}
+
+/* Send the ids in send[iproc] to process iproc and receive the ids
+ * from process iproc in recv[iproc]. */
+static void
+t8_cmesh_reorder_alltoall (std::vector<std::vector<t8_gloidx_t>> &send, std::vector<std::vector<t8_gloidx_t>> &recv,
+                           sc_MPI_Comm comm)
+{
+  int mpisize, mpirank, mpiret;
+  int num_requests = 0;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  std::vector<int> send_counts (mpisize), recv_counts (mpisize);
+  std::vector<sc_MPI_Request> requests (2 * mpisize);
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    send_counts[iproc] = send[iproc].size ();
+  }
+  mpiret = sc_MPI_Alltoall (send_counts.data (), 1, sc_MPI_INT, recv_counts.data (), 1, sc_MPI_INT, comm);
+  SC_CHECK_MPI (mpiret);
+
+  recv.resize (mpisize);
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    if (iproc == mpirank) {
+      /* Our own ids are copied. */
+      recv[iproc] = send[iproc];
+    }
+    else if (recv_counts[iproc] > 0) {
+      recv[iproc].resize (recv_counts[iproc]);
+      mpiret = sc_MPI_Irecv (recv[iproc].data (), recv_counts[iproc], T8_MPI_GLOIDX, iproc, T8_MPI_CMESH_REORDER, comm,
+                             &requests[num_requests++]);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    if (iproc != mpirank && send_counts[iproc] > 0) {
+      mpiret = sc_MPI_Isend (send[iproc].data (), send_counts[iproc], T8_MPI_GLOIDX, iproc, T8_MPI_CMESH_REORDER, comm,
+                             &requests[num_requests++]);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+  mpiret = sc_MPI_Waitall (num_requests, requests.data (), sc_MPI_STATUSES_IGNORE);
+  SC_CHECK_MPI (mpiret);
+}
+
+/* Request the new ids of all non-local trees in the stash from the processes owning them.
+ * On output, ghost_ids holds the pairs (old id, new id) sorted by old id. */
+static void
+t8_cmesh_reorder_ghost_ids (const t8_stash_t stash, const t8_gloidx_t first_tree, const t8_locidx_t num_trees,
+                            const std::vector<t8_gloidx_t> &new_ids,
+                            std::vector<std::pair<t8_gloidx_t, t8_gloidx_t>> &ghost_ids, sc_MPI_Comm comm)
+{
+  int mpisize, mpiret;
+
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  /* Collect the ids of all non-local trees in the stash */
+  std::vector<t8_gloidx_t> ghosts;
+  auto add_ghost = [&] (const t8_gloidx_t id) {
+    if (id < first_tree || first_tree + num_trees <= id) {
+      ghosts.push_back (id);
+    }
+  };
+  for (size_t iclass = 0; iclass < stash->classes.elem_count; iclass++) {
+    add_ghost (((const t8_stash_class_struct_t *) sc_array_index (&stash->classes, iclass))->id);
+  }
+  for (size_t ijoin = 0; ijoin < stash->joinfaces.elem_count; ijoin++) {
+    const t8_stash_joinface_struct_t *join
+      = (const t8_stash_joinface_struct_t *) sc_array_index (&stash->joinfaces, ijoin);
+    add_ghost (join->id1);
+    add_ghost (join->id2);
+  }
+  for (size_t iattribute = 0; iattribute < stash->attributes.elem_count; iattribute++) {
+    add_ghost (((const t8_stash_attribute_struct_t *) sc_array_index (&stash->attributes, iattribute))->id);
+  }
+  std::sort (ghosts.begin (), ghosts.end ());
+  ghosts.erase (std::unique (ghosts.begin (), ghosts.end ()), ghosts.end ());
+
+  /* Gather the range of local trees of each process */
+  t8_gloidx_t range[2] = { first_tree, num_trees };
+  std::vector<t8_gloidx_t> ranges (2 * mpisize);
+  mpiret = sc_MPI_Allgather (range, 2, T8_MPI_GLOIDX, ranges.data (), 2, T8_MPI_GLOIDX, comm);
+  SC_CHECK_MPI (mpiret);
+  std::vector<std::pair<t8_gloidx_t, int>> first_trees;
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    if (ranges[2 * iproc + 1] > 0) {
+      first_trees.push_back (std::make_pair (ranges[2 * iproc], iproc));
+    }
+  }
+  std::sort (first_trees.begin (), first_trees.end ());
+
+  /* Ask the owner of each ghost for its new id */
+  std::vector<std::vector<t8_gloidx_t>> requests (mpisize), requested, answers (mpisize), answered;
+  for (const t8_gloidx_t ghost : ghosts) {
+    auto owner = std::upper_bound (first_trees.begin (), first_trees.end (), std::make_pair (ghost, mpisize));
+    SC_CHECK_ABORTF (owner != first_trees.begin (), "Tree %lli is not a local tree of any process.\n",
+                     (long long) ghost);
+    const int iproc = (owner - 1)->second;
+    SC_CHECK_ABORTF (ghost < ranges[2 * iproc] + ranges[2 * iproc + 1],
+                     "Tree %lli is not a local tree of any process.\n", (long long) ghost);
+    requests[iproc].push_back (ghost);
+  }
+  t8_cmesh_reorder_alltoall (requests, requested, comm);
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    for (const t8_gloidx_t tree : requested[iproc]) {
+      T8_ASSERT (first_tree <= tree && tree < first_tree + num_trees);
+      answers[iproc].push_back (new_ids[tree - first_tree]);
+    }
+  }
+  t8_cmesh_reorder_alltoall (answers, answered, comm);
+
+  /* The requests were sent in ascending order, thus the pairs are sorted after this loop */
+  ghost_ids.clear ();
+  for (int iproc = 0; iproc < mpisize; ++iproc) {
+    T8_ASSERT (answered[iproc].size () == requests[iproc].size ());
+    for (size_t iid = 0; iid < requests[iproc].size (); iid++) {
+      ghost_ids.push_back (std::make_pair (requests[iproc][iid], answered[iproc][iid]));
+    }
+  }
+  std::sort (ghost_ids.begin (), ghost_ids.end ());
+}
+
+void
+t8_cmesh_reorder_stash (t8_cmesh_t cmesh, sc_MPI_Comm comm)
+{
+  const t8_stash_t stash = cmesh->stash;
+  t8_gloidx_t first_tree;
+  t8_locidx_t num_trees;
+  int mpiret;
+
+  T8_ASSERT (cmesh != NULL && !cmesh->committed);
+  T8_ASSERT (cmesh->set_from == NULL);
+  T8_ASSERT (cmesh->set_reorder != T8_CMESH_REORDER_NONE);
+
+  /* Determine the range of local trees */
+  if (!cmesh->set_partition) {
+    first_tree = 0;
+    num_trees = stash->classes.elem_count;
+  }
+  else {
+    if (cmesh->tree_offsets != NULL) {
+      const t8_gloidx_t *tree_offsets = t8_shmem_array_get_gloidx_array (cmesh->tree_offsets);
+      first_tree = t8_offset_first (cmesh->mpirank, tree_offsets);
+      num_trees = t8_offset_num_trees (cmesh->mpirank, tree_offsets);
+      cmesh->first_tree_shared = t8_shmem_array_get_gloidx (cmesh->tree_offsets, cmesh->mpirank) < 0;
+    }
+    else {
+      first_tree = cmesh->first_tree;
+      num_trees = cmesh->num_local_trees;
+    }
+    /* A shared tree is local on several processes and cannot be renumbered by one of them */
+    int has_shared = cmesh->first_tree_shared > 0, any_shared;
+    mpiret = sc_MPI_Allreduce (&has_shared, &any_shared, 1, sc_MPI_INT, sc_MPI_MAX, comm);
+    SC_CHECK_MPI (mpiret);
+    SC_CHECK_ABORT (!any_shared, "Reordering a partitioned cmesh requires a partition without shared trees.\n");
+  }
+
+  /* Compute the new order of the local trees */
+  std::vector<t8_locidx_t> order;
+  switch (cmesh->set_reorder) {
+  case T8_CMESH_REORDER_SFC:
+    t8_cmesh_reorder_sfc (stash, first_tree, num_trees, order);
+    break;
+  case T8_CMESH_REORDER_RCM:
+    t8_cmesh_reorder_rcm (stash, first_tree, num_trees, order);
+    break;
+  default:
+    SC_ABORT_NOT_REACHED ();
+  }
+  T8_ASSERT ((t8_locidx_t) order.size () == num_trees);
+  std::vector<t8_gloidx_t> new_ids (num_trees);
+  for (t8_locidx_t ipos = 0; ipos < num_trees; ipos++) {
+    new_ids[order[ipos]] = first_tree + ipos;
+  }
+
+  /* The new ids of the ghosts are known by their owners */
+  std::vector<std::pair<t8_gloidx_t, t8_gloidx_t>> ghost_ids;
+  if (cmesh->set_partition) {
+    t8_cmesh_reorder_ghost_ids (stash, first_tree, num_trees, new_ids, ghost_ids, comm);
+  }
+  auto new_id = [&] (const t8_gloidx_t id) {
+    if (first_tree <= id && id < first_tree + num_trees) {
+      return new_ids[id - first_tree];
+    }
+    auto ghost = std::lower_bound (ghost_ids.begin (), ghost_ids.end (), std::make_pair (id, (t8_gloidx_t) -1));
+    T8_ASSERT (ghost != ghost_ids.end () && ghost->first == id);
+    return ghost->second;
+  };
+
+  /* Renumber all entries of the stash */
+  for (size_t iclass = 0; iclass < stash->classes.elem_count; iclass++) {
+    t8_stash_class_struct_t *entry = (t8_stash_class_struct_t *) sc_array_index (&stash->classes, iclass);
+    entry->id = new_id (entry->id);
+  }
+  for (size_t iattribute = 0; iattribute < stash->attributes.elem_count; iattribute++) {
+    t8_stash_attribute_struct_t *attribute
+      = (t8_stash_attribute_struct_t *) sc_array_index (&stash->attributes, iattribute);
+    attribute->id = new_id (attribute->id);
+  }
+  for (size_t ijoin = 0; ijoin < stash->joinfaces.elem_count; ijoin++) {
+    t8_stash_joinface_struct_t *join = (t8_stash_joinface_struct_t *) sc_array_index (&stash->joinfaces, ijoin);
+    const t8_gloidx_t id1 = new_id (join->id1);
+    const t8_gloidx_t id2 = new_id (join->id2);
+    /* Keep the smaller id first, the orientation does not depend on the order */
+    if (id1 <= id2) {
+      join->id1 = id1;
+      join->id2 = id2;
+    }
+    else {
+      const int face1 = join->face1;
+      join->id1 = id2;
+      join->id2 = id1;
+      join->face1 = join->face2;
+      join->face2 = face1;
+    }
+  }
+}
@@ -0,0 +1,52 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_cmesh_reorder.h
+ *
+ * Renumber the trees of a cmesh during commit, such that neighboring trees
+ * get close tree ids. See \ref t8_cmesh_set_reorder.
+ */
+
+#ifndef T8_CMESH_REORDER_H
+#define T8_CMESH_REORDER_H
+
+#include <t8.h>
+#include <t8_cmesh.h>
+
+T8_EXTERN_C_BEGIN ();
+
+/** Renumber the trees in the stash of an uncommitted cmesh according to the
+ * reordering set with \ref t8_cmesh_set_reorder.
+ * The tree ids of all classes, face connections and attributes in the stash are changed.
+ * For a replicated cmesh all trees are renumbered. For a partitioned cmesh each process
+ * renumbers its local trees within its range of tree ids, and the new ids of the ghost
+ * trees are requested from their owners.
+ * This function is collective and is called by \ref t8_cmesh_commit.
+ * \param [in,out] cmesh        An uncommitted cmesh that is not derived.
+ * \param [in]     comm         The communicator of the cmesh.
+ */
+void
+t8_cmesh_reorder_stash (t8_cmesh_t cmesh, sc_MPI_Comm comm);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_CMESH_REORDER_H */
@@ -38,6 +38,10 @@
 #include <t8_geometry/t8_geometry_base.h>
 #include <t8_geometry/t8_geometry_handler.hxx>
 #include <t8_geometry/t8_geometry_implementations/t8_geometry_linear.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
 
 /* This macro is called to check a condition and if not fulfilled
  * close the file and exit the function */
@@ -511,12 +515,24 @@ t8_cmesh_load_header (const t8_cmesh_t cmesh, FILE *fp)
   return 1;
 }
 
+/* Check that the only registered geometry is the linear geometry and
+ * that this geometry is used for all trees. */
+static int
+t8_cmesh_save_has_linear_geometry (const t8_cmesh_t cmesh)
+{
+  if (cmesh->geometry_handler->get_num_geometries () == 1) {
+    /* Get the stored geometry and the linear geometry and compare their names. */
+    const t8_geometry *geom = cmesh->geometry_handler->get_unique_geometry ();
+    return geom->t8_geom_get_type () == T8_GEOMETRY_TYPE_LINEAR;
+  }
+  return 0;
+}
+
 int
 t8_cmesh_save (const t8_cmesh_t cmesh, const char *fileprefix)
 {
   FILE *fp;
   char filename[BUFSIZ];
-  int has_linear_geom = 0;
 
   T8_ASSERT (t8_cmesh_is_committed (cmesh));
   if (!cmesh->set_partition && cmesh->mpirank != 0) {
@@ -524,14 +540,7 @@ t8_cmesh_save (const t8_cmesh_t cmesh, const char *fileprefix)
     return 1;
   }
 
-  /* Check that the only registered geometry is the linear geometry and
-   * that this geometry is used for all trees. */
-  if (cmesh->geometry_handler->get_num_geometries () == 1) {
-    /* Get the stored geometry and the linear geometry and compare their names. */
-    const t8_geometry *geom = cmesh->geometry_handler->get_unique_geometry ();
-    has_linear_geom = geom->t8_geom_get_type () == T8_GEOMETRY_TYPE_LINEAR;
-  }
-  if (!has_linear_geom) {
+  if (!t8_cmesh_save_has_linear_geometry (cmesh)) {
     /* This cmesh does not have the linear geometry for all trees. */
     t8_errorf ("Error when saving cmesh. Cmesh has more than one geometry or the geometry is not linear.\n");
     return 0;
@@ -902,3 +911,401 @@ t8_cmesh_load_and_distribute (const char *fileprefix, const int num_files, sc_MP
   T8_ASSERT (t8_cmesh_is_committed (cmesh));
   return cmesh;
 }
+
+/* The binary cmesh file consists of a header, an index with one entry per
+ * saved process and one block per saved process.
+ * Each block starts with a table of its parts, followed by the tree_to_proc and
+ * ghost_to_proc arrays and the data of the parts as they are stored in memory.
+ * Blocks and parts start at multiples of T8_CMESH_BINARY_ALIGNMENT bytes. */
+#define T8_CMESH_BINARY_ALIGNMENT 64
+#define T8_CMESH_BINARY_ALIGN(bytes) \
+  (((bytes) + T8_CMESH_BINARY_ALIGNMENT - 1) / T8_CMESH_BINARY_ALIGNMENT * T8_CMESH_BINARY_ALIGNMENT)
+/* Written to the header to detect files of a different byte order */
+#define T8_CMESH_BINARY_ENDIAN_CHECK 0x01020304
+
+/* The header of a binary cmesh file */
+typedef struct
+{
+  char magic[8];                                 /* T8_CMESH_BINARY_MAGIC */
+  int32_t format;                                /* T8_CMESH_BINARY_FORMAT */
+  int32_t endian_check;                          /* T8_CMESH_BINARY_ENDIAN_CHECK */
+  int32_t locidx_bytes;                          /* sizeof (t8_locidx_t) */
+  int32_t gloidx_bytes;                          /* sizeof (t8_gloidx_t) */
+  int32_t ctree_bytes;                           /* sizeof (t8_ctree_struct_t) */
+  int32_t cghost_bytes;                          /* sizeof (t8_cghost_struct_t) */
+  int32_t dimension;                             /* The dimension of the cmesh */
+  int32_t set_partition;                         /* True if the cmesh is partitioned */
+  int32_t num_blocks;                            /* The number of blocks (saved processes) */
+  int32_t padding;                               /* Unused */
+  int64_t num_trees;                             /* The global number of trees */
+  int64_t num_trees_per_eclass[T8_ECLASS_COUNT]; /* The global number of trees per eclass */
+} t8_cmesh_binary_header_t;
+
+/* Set the position of an opened file to a byte offset from its beginning.
+ * fseek takes a long, which has 32 bits on some platforms, hence we use fseeko
+ * with off_t or _fseeki64 on Windows to address files larger than 2 GiB.
+ * Return 0 on success and nonzero otherwise. */
+static int
+t8_cmesh_binary_seek (FILE *fp, const int64_t offset)
+{
+#ifndef _WIN32
+  if ((int64_t) (off_t) offset != offset) {
+    /* off_t is too small for this offset */
+    return -1;
+  }
+  return fseeko (fp, (off_t) offset, SEEK_SET);
+#else
+  return _fseeki64 (fp, offset, SEEK_SET);
+#endif
+}
+
+/* An entry of the index of a binary cmesh file, one per block */
+typedef struct
+{
+  int64_t offset;                                      /* The offset of the block in the file */
+  int64_t num_bytes;                                   /* The number of bytes of the block */
+  int64_t first_tree;                                  /* The global id of the first local tree */
+  int32_t first_tree_shared;                           /* True if the first tree is shared */
+  int32_t num_local_trees;                             /* The number of local trees */
+  int32_t num_ghosts;                                  /* The number of ghosts */
+  int32_t num_parts;                                   /* The number of parts of the trees structure */
+  int32_t num_local_trees_per_eclass[T8_ECLASS_COUNT]; /* The number of local trees per eclass */
+} t8_cmesh_binary_index_t;
+
+/* An entry of the part table at the beginning of a block */
+typedef struct
+{
+  int64_t offset;         /* The offset of the part's data in the block */
+  int64_t num_bytes;      /* The number of bytes of the part's data */
+  int32_t first_tree_id;  /* The part's first_tree_id */
+  int32_t first_ghost_id; /* The part's first_ghost_id */
+  int32_t num_trees;      /* The part's number of trees */
+  int32_t num_ghosts;     /* The part's number of ghosts */
+} t8_cmesh_binary_part_t;
+
+/* Fill the index entry of this process and allocate and fill its block.
+ * The offset of the entry is not set. */
+static char *
+t8_cmesh_save_binary_block (const t8_cmesh_t cmesh, t8_cmesh_binary_index_t *entry)
+{
+  const int num_parts = t8_cmesh_trees_get_numproc (cmesh->trees);
+  t8_cmesh_binary_part_t *parts;
+  t8_part_tree_t part;
+  size_t num_bytes;
+  char *block;
+  int ipart, ieclass;
+
+  entry->first_tree = cmesh->first_tree;
+  entry->first_tree_shared = cmesh->first_tree_shared;
+  entry->num_local_trees = cmesh->num_local_trees;
+  entry->num_ghosts = cmesh->num_ghosts;
+  entry->num_parts = num_parts;
+  for (ieclass = T8_ECLASS_ZERO; ieclass < T8_ECLASS_COUNT; ieclass++) {
+    entry->num_local_trees_per_eclass[ieclass] = cmesh->num_local_trees_per_eclass[ieclass];
+  }
+
+  /* Compute the layout of the block */
+  parts = T8_ALLOC_ZERO (t8_cmesh_binary_part_t, num_parts);
+  num_bytes = num_parts * sizeof (t8_cmesh_binary_part_t)
+              + (cmesh->num_local_trees + cmesh->num_ghosts) * sizeof (int);
+  for (ipart = 0; ipart < num_parts; ipart++) {
+    part = t8_cmesh_trees_get_part (cmesh->trees, ipart);
+    num_bytes = T8_CMESH_BINARY_ALIGN (num_bytes);
+    parts[ipart].offset = num_bytes;
+    parts[ipart].num_bytes = t8_cmesh_trees_get_part_bytes (cmesh->trees, ipart);
+    parts[ipart].first_tree_id = part->first_tree_id;
+    parts[ipart].first_ghost_id = part->first_ghost_id;
+    parts[ipart].num_trees = part->num_trees;
+    parts[ipart].num_ghosts = part->num_ghosts;
+    num_bytes += parts[ipart].num_bytes;
+  }
+  entry->num_bytes = num_bytes;
+
+  /* Copy the part table, the tree_to_proc and ghost_to_proc arrays and the parts */
+  block = T8_ALLOC_ZERO (char, num_bytes);
+  memcpy (block, parts, num_parts * sizeof (t8_cmesh_binary_part_t));
+  num_bytes = num_parts * sizeof (t8_cmesh_binary_part_t);
+  memcpy (block + num_bytes, cmesh->trees->tree_to_proc, cmesh->num_local_trees * sizeof (int));
+  num_bytes += cmesh->num_local_trees * sizeof (int);
+  memcpy (block + num_bytes, cmesh->trees->ghost_to_proc, cmesh->num_ghosts * sizeof (int));
+  for (ipart = 0; ipart < num_parts; ipart++) {
+    part = t8_cmesh_trees_get_part (cmesh->trees, ipart);
+    memcpy (block + parts[ipart].offset, part->first_tree, parts[ipart].num_bytes);
+  }
+  T8_FREE (parts);
+  return block;
+}
+
+int
+t8_cmesh_save_binary (const t8_cmesh_t cmesh, const char *filename, sc_MPI_Comm comm)
+{
+  t8_cmesh_binary_header_t header;
+  t8_cmesh_binary_index_t entry, *index;
+  char *block = NULL;
+  FILE *fp;
+  int64_t offset;
+  int num_blocks, iblock, ieclass;
+  int writes_block, success, global_success;
+  int mpiret;
+
+  T8_ASSERT (t8_cmesh_is_committed (cmesh));
+  T8_ASSERT (t8_cmesh_comm_is_valid (cmesh, comm));
+
+  if (!t8_cmesh_save_has_linear_geometry (cmesh)) {
+    /* This cmesh does not have the linear geometry for all trees. */
+    t8_errorf ("Error when saving cmesh. Cmesh has more than one geometry or the geometry is not linear.\n");
+    return 0;
+  }
+
+  /* A replicated cmesh is written by rank 0 only */
+  num_blocks = cmesh->set_partition ? cmesh->mpisize : 1;
+  writes_block = cmesh->set_partition || cmesh->mpirank == 0;
+  memset (&entry, 0, sizeof (entry));
+  if (writes_block) {
+    block = t8_cmesh_save_binary_block (cmesh, &entry);
+  }
+
+  /* Gather the index and compute the offsets of the blocks */
+  index = T8_ALLOC (t8_cmesh_binary_index_t, cmesh->mpisize);
+  mpiret = sc_MPI_Allgather (&entry, sizeof (entry), sc_MPI_BYTE, index, sizeof (entry), sc_MPI_BYTE, comm);
+  SC_CHECK_MPI (mpiret);
+  offset = T8_CMESH_BINARY_ALIGN (sizeof (header) + num_blocks * sizeof (t8_cmesh_binary_index_t));
+  for (iblock = 0; iblock < num_blocks; iblock++) {
+    index[iblock].offset = offset;
+    offset = T8_CMESH_BINARY_ALIGN (offset + index[iblock].num_bytes);
+  }
+
+  /* Rank 0 creates the file and writes the header and the index */
+  success = 1;
+  if (cmesh->mpirank == 0) {
+    memset (&header, 0, sizeof (header));
+    memcpy (header.magic, T8_CMESH_BINARY_MAGIC, sizeof (header.magic));
+    header.format = T8_CMESH_BINARY_FORMAT;
+    header.endian_check = T8_CMESH_BINARY_ENDIAN_CHECK;
+    header.locidx_bytes = sizeof (t8_locidx_t);
+    header.gloidx_bytes = sizeof (t8_gloidx_t);
+    header.ctree_bytes = sizeof (t8_ctree_struct_t);
+    header.cghost_bytes = sizeof (t8_cghost_struct_t);
+    header.dimension = cmesh->dimension;
+    header.set_partition = cmesh->set_partition;
+    header.num_blocks = num_blocks;
+    header.num_trees = cmesh->num_trees;
+    for (ieclass = T8_ECLASS_ZERO; ieclass < T8_ECLASS_COUNT; ieclass++) {
+      header.num_trees_per_eclass[ieclass] = cmesh->num_trees_per_eclass[ieclass];
+    }
+    fp = fopen (filename, "wb");
+    if (fp == NULL) {
+      t8_errorf ("Error when opening file %s.\n", filename);
+      success = 0;
+    }
+    else {
+      success = fwrite (&header, sizeof (header), 1, fp) == 1
+                && fwrite (index, sizeof (t8_cmesh_binary_index_t), num_blocks, fp) == (size_t) num_blocks;
+      success = !fclose (fp) && success;
+    }
+  }
+  mpiret = sc_MPI_Bcast (&success, 1, sc_MPI_INT, 0, comm);
+  SC_CHECK_MPI (mpiret);
+
+  /* Each writing process writes its block at its offset */
+  if (success && writes_block && entry.num_bytes > 0) {
+    fp = fopen (filename, "r+b");
+    if (fp == NULL) {
+      t8_errorf ("Error when opening file %s.\n", filename);
+      success = 0;
+    }
+    else {
+      success = !t8_cmesh_binary_seek (fp, index[cmesh->mpirank].offset) && fwrite (block, entry.num_bytes, 1, fp) == 1;
+      success = !fclose (fp) && success;
+    }
+  }
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_MIN, comm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_global_errorf ("Error when writing file %s.\n", filename);
+  }
+
+  T8_FREE (block);
+  T8_FREE (index);
+  return global_success;
+}
+
+/* Check whether the header of a binary cmesh file can be read by this build */
+static int
+t8_cmesh_load_binary_check_header (const t8_cmesh_binary_header_t *header)
+{
+  if (memcmp (header->magic, T8_CMESH_BINARY_MAGIC, sizeof (header->magic))) {
+    t8_errorf ("Input file is not a binary cmesh file.\n");
+    return 0;
+  }
+  if (header->format != T8_CMESH_BINARY_FORMAT) {
+    t8_errorf ("Input file is in a binary format (version %i) that we cannot read.\n", (int) header->format);
+    return 0;
+  }
+  if (header->endian_check != T8_CMESH_BINARY_ENDIAN_CHECK || header->locidx_bytes != sizeof (t8_locidx_t)
+      || header->gloidx_bytes != sizeof (t8_gloidx_t) || header->ctree_bytes != sizeof (t8_ctree_struct_t)
+      || header->cghost_bytes != sizeof (t8_cghost_struct_t)) {
+    t8_errorf ("Input file was written on a machine with a different data layout.\n");
+    return 0;
+  }
+  return 0 <= header->dimension && header->dimension <= 3 && header->num_blocks > 0
+         && (header->set_partition || header->num_blocks == 1);
+}
+
+/* Map num_bytes bytes of an opened file starting at offset into memory.
+ * Return a pointer to the first mapped byte and set mapped_data and mapped_bytes
+ * to the region that must be released.
+ * Without mmap, the bytes are read into allocated memory instead. */
+static char *
+t8_cmesh_load_binary_map (FILE *fp, const int64_t offset, const size_t num_bytes, char **mapped_data,
+                          size_t *mapped_bytes)
+{
+#ifndef _WIN32
+  /* The offset of a mapping must be a multiple of the page size */
+  const int64_t page_size = sysconf (_SC_PAGESIZE);
+  const int64_t map_offset = offset - offset % page_size;
+  void *data;
+
+  *mapped_bytes = num_bytes + (offset - map_offset);
+  SC_CHECK_ABORT ((int64_t) (off_t) map_offset == map_offset, "Binary cmesh file too large for this build.");
+  data = mmap (NULL, *mapped_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno (fp), (off_t) map_offset);
+  SC_CHECK_ABORT (data != MAP_FAILED, "Could not map binary cmesh file.");
+  *mapped_data = (char *) data;
+  return *mapped_data + (offset - map_offset);
+#else
+  *mapped_bytes = num_bytes;
+  *mapped_data = T8_ALLOC (char, num_bytes);
+  SC_CHECK_ABORT (!t8_cmesh_binary_seek (fp, offset) && fread (*mapped_data, num_bytes, 1, fp) == 1,
+                  "Could not read binary cmesh file.");
+  return *mapped_data;
+#endif
+}
+
+/* Set up the trees of a cmesh from a mapped block */
+static void
+t8_cmesh_load_binary_block (t8_cmesh_t cmesh, const t8_cmesh_binary_index_t *entry, char *block,
+                            char *mapped_data, const size_t mapped_bytes)
+{
+  const t8_cmesh_binary_part_t *parts = (const t8_cmesh_binary_part_t *) block;
+  t8_part_tree_t part;
+  size_t offset;
+  int ipart, ieclass;
+
+  cmesh->first_tree = entry->first_tree;
+  cmesh->first_tree_shared = entry->first_tree_shared;
+  cmesh->num_local_trees = entry->num_local_trees;
+  cmesh->num_ghosts = entry->num_ghosts;
+  for (ieclass = T8_ECLASS_ZERO; ieclass < T8_ECLASS_COUNT; ieclass++) {
+    cmesh->num_local_trees_per_eclass[ieclass] = entry->num_local_trees_per_eclass[ieclass];
+  }
+
+  t8_cmesh_trees_init (&cmesh->trees, entry->num_parts, cmesh->num_local_trees, cmesh->num_ghosts);
+  /* The parts use the mapped memory in place */
+  for (ipart = 0; ipart < entry->num_parts; ipart++) {
+    part = t8_cmesh_trees_get_part (cmesh->trees, ipart);
+    part->first_tree = block + parts[ipart].offset;
+    part->first_tree_id = parts[ipart].first_tree_id;
+    part->first_ghost_id = parts[ipart].first_ghost_id;
+    part->num_trees = parts[ipart].num_trees;
+    part->num_ghosts = parts[ipart].num_ghosts;
+  }
+  cmesh->trees->mapped_data = mapped_data;
+  cmesh->trees->mapped_bytes = mapped_bytes;
+  offset = entry->num_parts * sizeof (t8_cmesh_binary_part_t);
+  if (cmesh->num_local_trees > 0) {
+    memcpy (cmesh->trees->tree_to_proc, block + offset, cmesh->num_local_trees * sizeof (int));
+    offset += cmesh->num_local_trees * sizeof (int);
+  }
+  if (cmesh->num_ghosts > 0) {
+    memcpy (cmesh->trees->ghost_to_proc, block + offset, cmesh->num_ghosts * sizeof (int));
+  }
+  t8_cmesh_trees_build_ghost_hash (cmesh->trees, cmesh->num_local_trees, cmesh->num_ghosts);
+}
+
+t8_cmesh_t
+t8_cmesh_load_binary (const char *filename, sc_MPI_Comm comm)
+{
+  t8_cmesh_binary_header_t header;
+  t8_cmesh_binary_index_t *index;
+  t8_cmesh_t cmesh;
+  FILE *fp;
+  char *block, *mapped_data;
+  size_t mapped_bytes;
+  int iblock, ieclass;
+  int mpirank, mpisize, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  /* Each process reads the header and the index */
+  fp = fopen (filename, "rb");
+  if (fp == NULL) {
+    t8_errorf ("Error when opening file %s.\n", filename);
+    return NULL;
+  }
+  if (fread (&header, sizeof (header), 1, fp) != 1 || !t8_cmesh_load_binary_check_header (&header)) {
+    t8_errorf ("Error when reading the header of file %s.\n", filename);
+    fclose (fp);
+    return NULL;
+  }
+  if (header.set_partition && mpisize < header.num_blocks) {
+    t8_errorf ("Cannot load file %s saved on %i processes on %i processes.\n", filename, (int) header.num_blocks,
+               mpisize);
+    fclose (fp);
+    return NULL;
+  }
+  index = T8_ALLOC (t8_cmesh_binary_index_t, header.num_blocks);
+  if (fread (index, sizeof (t8_cmesh_binary_index_t), header.num_blocks, fp) != (size_t) header.num_blocks) {
+    t8_errorf ("Error when reading the index of file %s.\n", filename);
+    T8_FREE (index);
+    fclose (fp);
+    return NULL;
+  }
+
+  t8_cmesh_init (&cmesh);
+  cmesh->set_partition = header.set_partition;
+  cmesh->dimension = header.dimension;
+  cmesh->num_trees = header.num_trees;
+  for (ieclass = T8_ECLASS_ZERO; ieclass < T8_ECLASS_COUNT; ieclass++) {
+    cmesh->num_trees_per_eclass[ieclass] = header.num_trees_per_eclass[ieclass];
+  }
+
+  /* A replicated cmesh is mapped by every process, a partitioned cmesh
+   * block by block. Processes beyond the saved ones get no trees. */
+  iblock = !header.set_partition ? 0 : mpirank < header.num_blocks ? mpirank : -1;
+  if (iblock >= 0) {
+    mapped_data = NULL;
+    mapped_bytes = 0;
+    block = NULL;
+    if (index[iblock].num_bytes > 0) {
+      block = t8_cmesh_load_binary_map (fp, index[iblock].offset, index[iblock].num_bytes, &mapped_data, &mapped_bytes);
+    }
+    t8_cmesh_load_binary_block (cmesh, index + iblock, block, mapped_data, mapped_bytes);
+  }
+  else {
+    t8_cmesh_trees_init (&cmesh->trees, 0, 0, 0);
+    /* There are no faces, so we know all about them */
+    cmesh->face_knowledge = 3;
+    cmesh->first_tree = cmesh->num_trees;
+    cmesh->first_tree_shared = 0;
+    cmesh->num_local_trees = 0;
+  }
+  /* The mapping stays valid after the file is closed */
+  fclose (fp);
+  T8_FREE (index);
+
+  cmesh->committed = 1;
+  cmesh->mpirank = mpirank;
+  cmesh->mpisize = mpisize;
+  t8_stash_destroy (&cmesh->stash);
+  if (cmesh->set_partition) {
+    /* Build the tree offsets of the partition */
+    t8_shmem_init (comm);
+    t8_shmem_set_type (comm, T8_SHMEM_BEST_TYPE);
+    t8_cmesh_gather_treecount (cmesh, comm);
+  }
+  T8_ASSERT (t8_cmesh_is_committed (cmesh));
+  return cmesh;
+}
@@ -28,6 +28,9 @@
 #include <vector>
 #include <algorithm>
 #include <iostream>
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 #include "t8_cmesh_stash.h"
 #include "t8_cmesh_trees.h"
 
@@ -86,6 +89,8 @@ t8_cmesh_trees_init (t8_cmesh_trees_t *ptrees, const int num_procs, const t8_loc
   /* Initialize the global_id hash table */
   trees->ghost_globalid_to_local_id
     = sc_hash_new (t8_cmesh_trees_glo_lo_hash_func, t8_cmesh_trees_glo_lo_hash_equal, NULL, NULL);
+  trees->mapped_data = NULL;
+  trees->mapped_bytes = 0;
 }
 
 void
@@ -513,6 +518,36 @@ t8_cmesh_trees_get_part_alloc (const t8_cmesh_trees_t trees, const t8_part_tree_
   return byte_alloc;
 }
 
+size_t
+t8_cmesh_trees_get_part_bytes (const t8_cmesh_trees_t trees, const int proc)
+{
+  return t8_cmesh_trees_get_part_alloc (trees, t8_cmesh_trees_get_part (trees, proc));
+}
+
+void
+t8_cmesh_trees_build_ghost_hash (const t8_cmesh_trees_t trees, const t8_locidx_t num_local_trees,
+                                 const t8_locidx_t num_ghosts)
+{
+  t8_trees_glo_lo_hash_t *hash_entry;
+  t8_locidx_t lghost;
+#ifdef T8_ENABLE_DEBUG
+  int ret;
+#endif
+
+  T8_ASSERT (trees != NULL);
+  T8_ASSERT (trees->ghost_globalid_to_local_id->elem_count == 0);
+  for (lghost = 0; lghost < num_ghosts; lghost++) {
+    hash_entry = (t8_trees_glo_lo_hash_t *) sc_mempool_alloc (trees->global_local_mempool);
+    hash_entry->global_id = t8_cmesh_trees_get_ghost (trees, lghost)->treeid;
+    hash_entry->local_id = lghost + num_local_trees;
+#ifdef T8_ENABLE_DEBUG
+    ret =
+#endif
+      sc_hash_insert_unique (trees->ghost_globalid_to_local_id, hash_entry, NULL);
+    T8_ASSERT (ret);
+  }
+}
+
 void
 t8_cmesh_trees_get_part_data (const t8_cmesh_trees_t trees, const int proc, t8_locidx_t *first_tree,
                               t8_locidx_t *num_trees, t8_locidx_t *first_ghost, t8_locidx_t *num_ghosts)
@@ -1278,9 +1313,19 @@ t8_cmesh_trees_destroy (t8_cmesh_trees_t *ptrees)
   t8_cmesh_trees_t trees = *ptrees;
   t8_part_tree_t part;
 
-  for (proc = 0; proc < trees->from_proc->elem_count; proc++) {
-    part = t8_cmesh_trees_get_part (trees, proc);
-    T8_FREE (part->first_tree);
+  if (trees->mapped_data != NULL) {
+    /* The parts point into one mapped region of a binary cmesh file */
+#ifndef _WIN32
+    munmap (trees->mapped_data, trees->mapped_bytes);
+#else
+    T8_FREE (trees->mapped_data);
+#endif
+  }
+  else {
+    for (proc = 0; proc < trees->from_proc->elem_count; proc++) {
+      part = t8_cmesh_trees_get_part (trees, proc);
+      T8_FREE (part->first_tree);
+    }
   }
   T8_FREE (trees->ghost_to_proc);
   T8_FREE (trees->tree_to_proc);
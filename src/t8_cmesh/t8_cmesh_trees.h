@@ -246,6 +246,28 @@ t8_cmesh_trees_copy_toproc (t8_cmesh_trees_t trees_dest, t8_cmesh_trees_t trees_
 void
 t8_cmesh_trees_copy_part (t8_cmesh_trees_t trees_dest, int part_dest, t8_cmesh_trees_t trees_src, int part_src);
 
+/** Return the number of bytes of a part's data, that is of its trees, ghosts,
+ * face neighbors and attributes.
+ * \param [in]          trees         The trees structure.
+ * \param [in]          proc          The index of the part.
+ *                                    Must be a valid part, thus \ref t8_cmesh_trees_finish_part
+ *                                    must have been called.
+ * \return                            The number of bytes stored at the part's first_tree.
+ */
+size_t
+t8_cmesh_trees_get_part_bytes (t8_cmesh_trees_t trees, int proc);
+
+/** Fill the hash table mapping the global ids of the ghosts to their local ids.
+ * This is only needed if the parts were not built with \ref t8_cmesh_trees_add_ghost,
+ * for example if their data was read from a binary file.
+ * \param [in,out]      trees           The trees structure. Its ghosts and ghost_to_proc
+ *                                      must be set and its hash table must be empty.
+ * \param [in]          num_local_trees The number of local trees.
+ * \param [in]          num_ghosts      The number of ghosts.
+ */
+void
+t8_cmesh_trees_build_ghost_hash (t8_cmesh_trees_t trees, t8_locidx_t num_local_trees, t8_locidx_t num_ghosts);
+
 /** Add a tree to a trees structure.
  * \param [in,out]  trees The trees structure to be updated.
  * \param [in]      tree_id The local id of the tree to be inserted.
@@ -100,6 +100,7 @@ typedef struct t8_cmesh
                                                 the scheme that describes the refinement pattern. See \ref t8_cmesh_set_partition. */
   int8_t set_partition_level;  /**< Non-negative if the cmesh should be partitioned from an already existing cmesh
                                          with an assumed \a level uniform mesh underneath. */
+  int8_t set_reorder;          /**< The ordering of the trees that is applied at commit. \ref t8_cmesh_set_reorder */
   struct t8_cmesh *set_from;   /**< If this cmesh shall be derived from an
                                   existing cmesh by copy or more elaborate
                                   modification, we store a pointer to this
@@ -235,6 +236,10 @@ typedef struct t8_cmesh_trees
                                                            global_id -> local_id for the ghost trees.
                                                            The local_id is the local ghost id starting at num_local_trees  */
   sc_mempool_t *global_local_mempool;    /* Memory pool for the entries in the hash table */
+  char *mapped_data;                     /* If not NULL, the data of all parts lies in this region,
+                                                           which was mapped from a binary cmesh file. The parts
+                                                           are then not freed one by one. */
+  size_t mapped_bytes;                   /* The number of bytes of mapped_data */
 } t8_cmesh_trees_struct_t;
 
 /* TODO: document */
@@ -34,6 +34,7 @@
 
 /* The supported .msh file versions.
  * Currently, we support gmsh's file version 2 and 4 in ASCII format.
+ * Binary files of version 4.1 are supported by \ref t8_cmesh_from_msh_file_parallel.
  */
 #define T8_CMESH_N_SUPPORTED_MSH_FILE_VERSIONS 2
 
@@ -96,6 +97,24 @@ t8_cmesh_t
 t8_cmesh_from_msh_file (const char *fileprefix, int partition, sc_MPI_Comm comm, int dim, int master,
                         int use_cad_geometry);
 
+/** Read a binary .msh file of version 4.1 in parallel and create a partitioned cmesh from it.
+ * Each process reads a part of the nodes and the trees directly from the file.
+ * The node coordinates of the trees and the face connections are resolved by
+ * communication, such that no process needs to store the whole mesh.
+ * The trees are uniformly partitioned among the processes in the order of the file.
+ * \param [in]    fileprefix        The prefix of the mesh file.
+ *                                  The file fileprefix.msh is read.
+ * \param [in]    comm              The MPI communicator with which the cmesh is to be committed.
+ * \param [in]    dim               The dimension to read from the .msh files. The .msh format
+ *                                  can store several dimensions of the mesh and therefore the
+ *                                  dimension to read has to be set manually.
+ * \return        A committed and partitioned cmesh holding the mesh of dimension \a dim in the
+ *                specified .msh file with a linear geometry, or NULL if reading failed.
+ * \note Parametric nodes are read, but their parameters are ignored. Thus, the cad geometry is not supported.
+ */
+t8_cmesh_t
+t8_cmesh_from_msh_file_parallel (const char *fileprefix, sc_MPI_Comm comm, int dim);
+
 T8_EXTERN_C_END ();
 
 #endif /* !T8_CMESH_READMSHFILE_H */
@@ -0,0 +1,121 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_element_buffer.hxx
+ * A small buffer for temporary elements that lives on the stack.
+ * Algorithms that need a few elements for intermediate computations, such as
+ * the parent or a face neighbor of an element, can use this buffer instead of
+ * \ref t8_eclass_scheme::t8_element_new and \ref t8_eclass_scheme::t8_element_destroy.
+ * All elements of the buffer are released at once when the buffer goes out of scope.
+ * Since no scheme allocator is involved, the buffer can safely be used by multiple threads.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <t8_element.hxx>
+
+/** The number of bytes that are reserved on the stack per element of a \ref t8_element_buffer.
+ * This is large enough for all elements of the default schemes.
+ * Schemes with larger elements fall back to \ref t8_eclass_scheme::t8_element_new. */
+#define T8_ELEMENT_BUFFER_BYTES_PER_ELEMENT 64
+
+/** A buffer of at most \a N temporary elements of one scheme.
+ * The elements are initialized with \ref t8_eclass_scheme::t8_element_init on construction
+ * and deinitialized on destruction.
+ * \tparam N   The maximum number of elements in the buffer.
+ *
+ * Example:
+ *   t8_element_buffer<2> buffer (ts);
+ *   ts->t8_element_parent (element, buffer[0]);
+ *   ts->t8_element_nca (buffer[0], other, buffer[1]);
+ */
+template <int N>
+class t8_element_buffer {
+ public:
+  /** Construct a buffer of \a count initialized elements.
+   * \param [in] ts           The scheme of the elements.
+   * \param [in] count        The number of elements, 0 < \a count <= \a N.
+   */
+  explicit t8_element_buffer (const t8_eclass_scheme_c *ts, const int count = N)
+    : scheme (ts), num_elements (count),
+      on_stack (ts->t8_element_size () <= T8_ELEMENT_BUFFER_BYTES_PER_ELEMENT)
+  {
+    T8_ASSERT (0 < num_elements && num_elements <= N);
+    if (on_stack) {
+      const size_t element_size = ts->t8_element_size ();
+      for (int ielem = 0; ielem < num_elements; ++ielem) {
+        elements[ielem] = (t8_element_t *) (storage + ielem * element_size);
+      }
+      ts->t8_element_init (num_elements, elements[0]);
+    }
+    else {
+      ts->t8_element_new (num_elements, elements);
+    }
+  }
+
+  /** Release all elements of the buffer. */
+  ~t8_element_buffer ()
+  {
+    if (on_stack) {
+      scheme->t8_element_deinit (num_elements, elements[0]);
+    }
+    else {
+      scheme->t8_element_destroy (num_elements, elements);
+    }
+  }
+
+  t8_element_buffer (const t8_element_buffer &) = delete;
+  t8_element_buffer &
+  operator= (const t8_element_buffer &)
+    = delete;
+
+  /** Return the element at position \a ielem. */
+  t8_element_t *
+  operator[] (const int ielem) const
+  {
+    T8_ASSERT (0 <= ielem && ielem < num_elements);
+    return elements[ielem];
+  }
+
+  /** Return the array of element pointers, suitable for functions such as
+   * \ref t8_eclass_scheme::t8_element_children. */
+  t8_element_t **
+  data ()
+  {
+    return elements;
+  }
+
+  /** Return the number of elements in the buffer. */
+  int
+  size () const
+  {
+    return num_elements;
+  }
+
+ private:
+  const t8_eclass_scheme_c *scheme; /**< The scheme of the elements. */
+  const int num_elements;           /**< The number of elements in the buffer. */
+  const bool on_stack;              /**< True if the elements are stored in \a storage. */
+  t8_element_t *elements[N];        /**< Pointers to the elements. */
+  alignas (std::max_align_t) char storage[N * T8_ELEMENT_BUFFER_BYTES_PER_ELEMENT]; /**< The element memory. */
+};
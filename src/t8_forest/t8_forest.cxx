@@ -29,12 +29,15 @@
 #include <t8_forest/t8_forest_partition.h>
 #include <t8_forest/t8_forest_private.h>
 #include <t8_forest/t8_forest_ghost.h>
+#include <t8_forest/t8_forest_iterate.h>
 #include <t8_forest/t8_forest_balance.h>
 #include <t8_element.hxx>
+#include <t8_element_buffer.hxx>
 #include <t8_element_c_interface.h>
 #include <t8_cmesh/t8_cmesh_trees.h>
 #include <t8_cmesh/t8_cmesh_offset.h>
 #include <t8_forest/t8_forest_profiling.h>
+#include <t8_forest/t8_forest_timers.h>
 #include <t8_forest/t8_forest_io.h>
 #include <t8_forest/t8_forest_adapt.h>
 #include <t8_vtk/t8_vtk_writer.h>
@@ -69,10 +72,9 @@ t8_forest_is_incomplete_family (const t8_forest_t forest, const t8_locidx_t ltre
   T8_ASSERT (el_considered < t8_forest_get_tree_element_count (tree));
 
   /* Buffer for elements */
-  t8_element_t *element_parent_current;
-  t8_element_t *element_compare;
-  tscheme->t8_element_new (1, &element_parent_current);
-  tscheme->t8_element_new (1, &element_compare);
+  t8_element_buffer<2> buffer (tscheme);
+  t8_element_t *element_parent_current = buffer[0];
+  t8_element_t *element_compare = buffer[1];
 
   /* We first assume that we have an (in)complete family with the size of array elements. 
    * In the following we try to disprove this. */
@@ -100,8 +102,6 @@ t8_forest_is_incomplete_family (const t8_forest_t forest, const t8_locidx_t ltre
       /* Level_current-1 is level of element_parent_current */
       T8_ASSERT (level_compare <= level_current - 1);
       if (level_compare == level_current - 1) {
-        tscheme->t8_element_destroy (1, &element_parent_current);
-        tscheme->t8_element_destroy (1, &element_compare);
         return 0;
       }
     }
@@ -140,17 +140,11 @@ t8_forest_is_incomplete_family (const t8_forest_t forest, const t8_locidx_t ltre
       const int level_compare = tscheme->t8_element_level (element_compare);
       T8_ASSERT (level_compare <= level_current - 1);
       if (level_compare == level_current - 1) {
-        tscheme->t8_element_destroy (1, &element_parent_current);
-        tscheme->t8_element_destroy (1, &element_compare);
         return 0;
       }
     }
   }
 
-  /* clean up */
-  tscheme->t8_element_destroy (1, &element_parent_current);
-  tscheme->t8_element_destroy (1, &element_compare);
-
 #if T8_ENABLE_MPI
   const int num_siblings = tscheme->t8_element_num_siblings (elements[0]);
   T8_ASSERT (family_size <= num_siblings);
@@ -451,6 +445,95 @@ t8_forest_element_from_ref_coords (t8_forest_t forest, t8_locidx_t ltreeid, cons
   t8_forest_element_from_ref_coords_ext (forest, ltreeid, element, ref_coords, num_coords, coords_out, NULL);
 }
 
+void
+t8_forest_element_batch_from_ref_coords (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t **elements,
+                                         const size_t num_elements, const double *ref_coords, const size_t num_coords,
+                                         double *coords_out)
+{
+  const t8_eclass_t tree_class = t8_forest_get_tree_class (forest, ltreeid);
+  const int tree_dim = t8_eclass_to_dimension[tree_class];
+  const int ref_dim = tree_dim == 0 ? 1 : tree_dim;
+  const t8_eclass_scheme_c *scheme = t8_forest_get_eclass_scheme (forest, tree_class);
+  const t8_cmesh_t cmesh = t8_forest_get_cmesh (forest);
+  const t8_gloidx_t gtreeid = t8_forest_global_tree_id (forest, ltreeid);
+
+  /* Transform the points of all elements to tree reference coordinates and
+   * evaluate the geometry for all of them at once. */
+  double *tree_ref_coords = T8_ALLOC (double, ref_dim * num_coords * num_elements);
+  for (size_t ielem = 0; ielem < num_elements; ++ielem) {
+    scheme->t8_element_reference_coords (elements[ielem], ref_coords, num_coords,
+                                         tree_ref_coords + ielem * ref_dim * num_coords);
+  }
+  t8_geometry_evaluate (cmesh, gtreeid, tree_ref_coords, num_coords * num_elements, coords_out);
+
+  T8_FREE (tree_ref_coords);
+}
+
+void
+t8_forest_element_batch_jacobian (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t **elements,
+                                  const size_t num_elements, const double *ref_coords, const size_t num_coords,
+                                  double *jacobian_out)
+{
+  const t8_eclass_t tree_class = t8_forest_get_tree_class (forest, ltreeid);
+  const int tree_dim = t8_eclass_to_dimension[tree_class];
+  const t8_eclass_scheme_c *scheme = t8_forest_get_eclass_scheme (forest, tree_class);
+  const t8_cmesh_t cmesh = t8_forest_get_cmesh (forest);
+  const t8_gloidx_t gtreeid = t8_forest_global_tree_id (forest, ltreeid);
+  /* The vertices 0, e_0, e_0 + e_1, e_0 + e_1 + e_2 lie in the reference domain of each element shape.
+   * Their differences are the unit vectors. */
+  const double staircase[4][3] = { { 0, 0, 0 }, { 1, 0, 0 }, { 1, 1, 0 }, { 1, 1, 1 } };
+  double staircase_ref[4 * 3], staircase_tree[4 * 3];
+
+  if (tree_dim == 0) {
+    /* A vertex has no reference coordinates, the jacobian is empty. */
+    return;
+  }
+  for (int ipoint = 0; ipoint <= tree_dim; ++ipoint) {
+    for (int idim = 0; idim < tree_dim; ++idim) {
+      staircase_ref[ipoint * tree_dim + idim] = staircase[ipoint][idim];
+    }
+  }
+
+  /* Transform the points of all elements to tree reference coordinates and
+   * evaluate the jacobian of the tree geometry for all of them at once. */
+  const size_t num_points = num_coords * num_elements;
+  double *tree_ref_coords = T8_ALLOC (double, tree_dim * num_points);
+  double *tree_jacobian = T8_ALLOC (double, tree_dim * T8_ECLASS_MAX_DIM * num_points);
+  for (size_t ielem = 0; ielem < num_elements; ++ielem) {
+    scheme->t8_element_reference_coords (elements[ielem], ref_coords, num_coords,
+                                         tree_ref_coords + ielem * tree_dim * num_coords);
+  }
+  t8_geometry_jacobian (cmesh, gtreeid, tree_ref_coords, num_points, tree_jacobian);
+
+  for (size_t ielem = 0; ielem < num_elements; ++ielem) {
+    /* The map from element to tree reference coordinates is affine.
+     * Its matrix has the columns element_map[j] = d tree_ref / d ref_j. */
+    double element_map[3][3];
+    scheme->t8_element_reference_coords (elements[ielem], staircase_ref, tree_dim + 1, staircase_tree);
+    for (int icol = 0; icol < tree_dim; ++icol) {
+      for (int irow = 0; irow < tree_dim; ++irow) {
+        element_map[icol][irow] = staircase_tree[(icol + 1) * tree_dim + irow] - staircase_tree[icol * tree_dim + irow];
+      }
+    }
+    /* Apply the chain rule at each point of this element */
+    for (size_t icoord = 0; icoord < num_coords; ++icoord) {
+      const size_t offset = (ielem * num_coords + icoord) * tree_dim * T8_ECLASS_MAX_DIM;
+      for (int icol = 0; icol < tree_dim; ++icol) {
+        for (int idim = 0; idim < T8_ECLASS_MAX_DIM; ++idim) {
+          double entry = 0;
+          for (int k = 0; k < tree_dim; ++k) {
+            entry += tree_jacobian[offset + k * T8_ECLASS_MAX_DIM + idim] * element_map[icol][k];
+          }
+          jacobian_out[offset + icol * T8_ECLASS_MAX_DIM + idim] = entry;
+        }
+      }
+    }
+  }
+
+  T8_FREE (tree_ref_coords);
+  T8_FREE (tree_jacobian);
+}
+
 /* Compute the diameter of an element. */
 double
 t8_forest_element_diam (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *element)
@@ -1547,7 +1630,6 @@ t8_forest_element_face_neighbor (t8_forest_t forest, t8_locidx_t ltreeid, const
     /* The neighbor does not lie inside the current tree. The content of neigh is undefined right now. */
     t8_eclass_scheme_c *boundary_scheme, *neighbor_scheme;
     t8_eclass_t neigh_eclass, boundary_class;
-    t8_element_t *face_element;
     t8_cmesh_t cmesh;
     t8_locidx_t lctree_id, lcneigh_id;
     t8_locidx_t *face_neighbor;
@@ -1571,8 +1653,9 @@ t8_forest_element_face_neighbor (t8_forest_t forest, t8_locidx_t ltreeid, const
     /* Get the eclass scheme for the boundary */
     boundary_class = (t8_eclass_t) t8_eclass_face_types[eclass][tree_face];
     boundary_scheme = t8_forest_get_eclass_scheme (forest, boundary_class);
-    /* Allocate the face element */
-    boundary_scheme->t8_element_new (1, &face_element);
+    /* Allocate the face element on the stack */
+    t8_element_buffer<1> buffer (boundary_scheme);
+    t8_element_t *face_element = buffer[0];
     /* Compute the face element. */
     ts->t8_element_boundary_face (elem, face, face_element, boundary_scheme);
     /* Get the coarse tree that contains elem.
@@ -1633,8 +1716,6 @@ t8_forest_element_face_neighbor (t8_forest_t forest, t8_locidx_t ltreeid, const
     /* And now we extrude the face to the new neighbor element */
     neighbor_scheme = forest->scheme_cxx->eclass_schemes[neigh_eclass];
     *neigh_face = neighbor_scheme->t8_element_extrude_face (face_element, boundary_scheme, neigh, tree_neigh_face);
-    /* Free the face_element */
-    boundary_scheme->t8_element_destroy (1, &face_element);
 
     return global_neigh_id;
   }
@@ -1722,6 +1803,208 @@ t8_forest_leaf_face_orientation (t8_forest_t forest, const t8_locidx_t ltreeid,
   return orientation;
 }
 
+/* Collect all leaves in a sorted array of descendants of element that touch a face of element.
+ * For each such leaf a copy, the face of the leaf that lies on the face and its index
+ * (the index of the first leaf in the array plus index_offset) are appended to the arrays.
+ * This is the same top-down recursion as in t8_forest_iterate_faces, but it does not
+ * require the leaves to belong to a local tree, such that it also works on ghosts. */
+static void
+t8_forest_leaf_face_neighbors_collect (t8_eclass_scheme_c *ts, const t8_element_t *element, const int face,
+                                       t8_element_array_t *leaf_elements, const t8_locidx_t index_offset,
+                                       sc_array_t *neighbors, sc_array_t *dual_faces, sc_array_t *element_indices)
+{
+  t8_element_t **face_children;
+  t8_element_array_t face_child_leaves;
+  size_t *split_offsets, indexa, indexb;
+  int *child_indices, num_face_children, iface;
+
+  const size_t elem_count = t8_element_array_get_count (leaf_elements);
+  if (elem_count == 0) {
+    /* No leaves touch this part of the face */
+    return;
+  }
+  if (elem_count == 1) {
+    const t8_element_t *leaf = t8_element_array_index_locidx (leaf_elements, 0);
+    if (ts->t8_element_equal (element, leaf)) {
+      /* The element is a leaf, we store it */
+      t8_element_t **neighbor = (t8_element_t **) sc_array_push (neighbors);
+      ts->t8_element_new (1, neighbor);
+      ts->t8_element_copy (leaf, *neighbor);
+      *(int *) sc_array_push (dual_faces) = face;
+      *(t8_locidx_t *) sc_array_push (element_indices) = index_offset;
+      return;
+    }
+  }
+  T8_ASSERT (ts->t8_element_level (element)
+             < ts->t8_element_level (t8_element_array_index_locidx (leaf_elements, 0)));
+
+  /* Split the leaves among the children of element and continue with the children at the face */
+  num_face_children = ts->t8_element_num_face_children (element, face);
+  face_children = T8_ALLOC (t8_element_t *, num_face_children);
+  ts->t8_element_new (num_face_children, face_children);
+  child_indices = T8_ALLOC (int, num_face_children);
+  split_offsets = T8_ALLOC (size_t, ts->t8_element_num_children (element) + 1);
+  ts->t8_element_children_at_face (element, face, face_children, num_face_children, child_indices);
+  t8_forest_split_array (element, leaf_elements, split_offsets);
+  for (iface = 0; iface < num_face_children; iface++) {
+    indexa = split_offsets[child_indices[iface]];
+    indexb = split_offsets[child_indices[iface] + 1];
+    if (indexa < indexb) {
+      t8_element_array_init_view (&face_child_leaves, leaf_elements, indexa, indexb - indexa);
+      const int child_face = ts->t8_element_face_child_face (element, face, iface);
+      t8_forest_leaf_face_neighbors_collect (ts, face_children[iface], child_face, &face_child_leaves,
+                                             index_offset + indexa, neighbors, dual_faces, element_indices);
+    }
+  }
+  ts->t8_element_destroy (num_face_children, face_children);
+  T8_FREE (face_children);
+  T8_FREE (child_indices);
+  T8_FREE (split_offsets);
+}
+
+/* Compute the leaf face neighbors of a leaf in a forest that is not necessarily balanced.
+ * We compute the same level face neighbor of the leaf and search the leaf arrays of the
+ * neighbor tree (local and ghost) for a leaf that is an ancestor of it or equal to it.
+ * If there is none, the neighbor is refined and the neighbor leaves are all its descendant
+ * leaves that touch its dual face, at any level. */
+static void
+t8_forest_leaf_face_neighbors_unbalanced (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *leaf,
+                                          t8_element_t **pneighbor_leaves[], int face, int *dual_faces[],
+                                          int *num_neighbors, t8_locidx_t **pelement_indices,
+                                          t8_eclass_scheme_c **pneigh_scheme, t8_gloidx_t *gneigh_tree,
+                                          int *orientation)
+{
+  t8_eclass_scheme_c *ts, *neigh_scheme;
+  t8_eclass_t eclass, neigh_class;
+  t8_element_t *neighbor, *desc;
+  t8_gloidx_t gneigh_treeid;
+  t8_linearidx_t first_desc_id, last_desc_id;
+  const t8_element_array_t *element_arrays[2];
+  t8_locidx_t index_offsets[2];
+  t8_locidx_t first_index, last_index, ltree_or_ghost;
+  sc_array_t neighbors, neigh_dual_faces, element_indices;
+  int neigh_face, neigh_level, num_arrays, iarray;
+
+  eclass = t8_forest_get_tree_class (forest, ltreeid);
+  ts = t8_forest_get_eclass_scheme (forest, eclass);
+  if (orientation) {
+    *orientation = t8_forest_leaf_face_orientation (forest, ltreeid, ts, leaf, face);
+  }
+
+  /* Compute the same level face neighbor of leaf */
+  neigh_class = t8_forest_element_neighbor_eclass (forest, ltreeid, leaf, face);
+  neigh_scheme = *pneigh_scheme = t8_forest_get_eclass_scheme (forest, neigh_class);
+  neigh_scheme->t8_element_new (1, &neighbor);
+  gneigh_treeid = t8_forest_element_face_neighbor (forest, ltreeid, leaf, neighbor, neigh_scheme, face, &neigh_face);
+  if (gneigh_tree) {
+    *gneigh_tree = gneigh_treeid;
+  }
+  *num_neighbors = 0;
+  *pneighbor_leaves = NULL;
+  *dual_faces = NULL;
+  *pelement_indices = NULL;
+  if (gneigh_treeid < 0) {
+    /* There exists no face neighbor across this face */
+    neigh_scheme->t8_element_destroy (1, &neighbor);
+    return;
+  }
+  T8_ASSERT (gneigh_treeid < forest->global_num_trees);
+
+  /* The neighbor leaves are local leaves of the neighbor tree or ghosts. */
+  num_arrays = 0;
+  ltree_or_ghost = t8_forest_get_local_id (forest, gneigh_treeid);
+  if (ltree_or_ghost >= 0) {
+    element_arrays[num_arrays] = t8_forest_get_tree_element_array (forest, ltree_or_ghost);
+    index_offsets[num_arrays++] = t8_forest_get_tree_element_offset (forest, ltree_or_ghost);
+  }
+  if (forest->ghosts != NULL && (ltree_or_ghost = t8_forest_ghost_get_ghost_treeid (forest, gneigh_treeid)) >= 0) {
+    element_arrays[num_arrays] = t8_forest_ghost_get_tree_elements (forest, ltree_or_ghost);
+    index_offsets[num_arrays++] = t8_forest_get_local_num_elements (forest)
+                                  + t8_forest_ghost_get_tree_element_offset (forest, ltree_or_ghost);
+  }
+
+  /* The range of linear ids at maxlevel that the neighbor covers */
+  neigh_scheme->t8_element_new (1, &desc);
+  neigh_level = neigh_scheme->t8_element_level (neighbor);
+  first_desc_id = neigh_scheme->t8_element_get_linear_id (neighbor, forest->maxlevel);
+  neigh_scheme->t8_element_last_descendant (neighbor, desc, forest->maxlevel);
+  last_desc_id = neigh_scheme->t8_element_get_linear_id (desc, forest->maxlevel);
+
+  sc_array_init (&neighbors, sizeof (t8_element_t *));
+  sc_array_init (&neigh_dual_faces, sizeof (int));
+  sc_array_init (&element_indices, sizeof (t8_locidx_t));
+  for (iarray = 0; iarray < num_arrays; iarray++) {
+    const t8_element_array_t *element_array = element_arrays[iarray];
+    if (t8_element_array_get_count (element_array) == 0) {
+      continue;
+    }
+    /* The last leaf that starts before or at the neighbor */
+    first_index = t8_forest_bin_search_lower (element_array, first_desc_id, forest->maxlevel);
+    if (first_index >= 0) {
+      const t8_element_t *found = t8_element_array_index_locidx (element_array, first_index);
+      const int found_level = neigh_scheme->t8_element_level (found);
+      neigh_scheme->t8_element_last_descendant (found, desc, forest->maxlevel);
+      if (found_level <= neigh_level
+          && neigh_scheme->t8_element_get_linear_id (desc, forest->maxlevel) >= first_desc_id) {
+        /* The leaf is the neighbor or an ancestor of it and thus the only neighbor leaf.
+         * Its dual face is the face of the ancestor that contains the neighbor's dual face. */
+        T8_ASSERT (*num_neighbors == 0);
+        while (neigh_scheme->t8_element_level (neighbor) > found_level) {
+          neigh_face = neigh_scheme->t8_element_face_parent_face (neighbor, neigh_face);
+          T8_ASSERT (neigh_face >= 0);
+          neigh_scheme->t8_element_parent (neighbor, neighbor);
+        }
+        neigh_scheme->t8_element_copy (found, neighbor);
+        *num_neighbors = 1;
+        *pneighbor_leaves = T8_ALLOC (t8_element_t *, 1);
+        (*pneighbor_leaves)[0] = neighbor;
+        *dual_faces = T8_ALLOC (int, 1);
+        (*dual_faces)[0] = neigh_face;
+        *pelement_indices = T8_ALLOC (t8_locidx_t, 1);
+        (*pelement_indices)[0] = index_offsets[iarray] + first_index;
+        neigh_scheme->t8_element_destroy (1, &desc);
+        sc_array_reset (&neighbors);
+        sc_array_reset (&neigh_dual_faces);
+        sc_array_reset (&element_indices);
+        return;
+      }
+      if (neigh_scheme->t8_element_get_linear_id (found, forest->maxlevel) < first_desc_id) {
+        /* The found leaf lies before the neighbor */
+        first_index++;
+      }
+    }
+    else {
+      first_index = 0;
+    }
+    /* All leaves from first_index to last_index are descendants of the neighbor */
+    last_index = t8_forest_bin_search_lower (element_array, last_desc_id, forest->maxlevel);
+    if (first_index <= last_index) {
+      t8_element_array_t descendants;
+      t8_element_array_init_view (&descendants, (t8_element_array_t *) element_array, first_index,
+                                  last_index - first_index + 1);
+      t8_forest_leaf_face_neighbors_collect (neigh_scheme, neighbor, neigh_face, &descendants,
+                                             index_offsets[iarray] + first_index, &neighbors, &neigh_dual_faces,
+                                             &element_indices);
+    }
+  }
+  neigh_scheme->t8_element_destroy (1, &desc);
+  neigh_scheme->t8_element_destroy (1, &neighbor);
+
+  /* Copy the collected neighbors to the output arrays */
+  *num_neighbors = (int) neighbors.elem_count;
+  if (*num_neighbors > 0) {
+    *pneighbor_leaves = T8_ALLOC (t8_element_t *, *num_neighbors);
+    memcpy (*pneighbor_leaves, neighbors.array, neighbors.elem_count * neighbors.elem_size);
+    *dual_faces = T8_ALLOC (int, *num_neighbors);
+    memcpy (*dual_faces, neigh_dual_faces.array, neigh_dual_faces.elem_count * neigh_dual_faces.elem_size);
+    *pelement_indices = T8_ALLOC (t8_locidx_t, *num_neighbors);
+    memcpy (*pelement_indices, element_indices.array, element_indices.elem_count * element_indices.elem_size);
+  }
+  sc_array_reset (&neighbors);
+  sc_array_reset (&neigh_dual_faces);
+  sc_array_reset (&element_indices);
+}
+
 void
 t8_forest_leaf_face_neighbors_ext (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *leaf,
                                    t8_element_t **pneighbor_leaves[], int face, int *dual_faces[], int *num_neighbors,
@@ -1742,8 +2025,6 @@ t8_forest_leaf_face_neighbors_ext (t8_forest_t forest, t8_locidx_t ltreeid, cons
   T8_ASSERT (t8_forest_is_committed (forest));
   T8_ASSERT (t8_forest_element_is_leaf (forest, leaf, ltreeid));
   T8_ASSERT (!forest_is_balanced || t8_forest_is_balanced (forest));
-  SC_CHECK_ABORT (forest_is_balanced, "leaf face neighbors is not implemented "
-                                      "for unbalanced forests.\n"); /* TODO: write version for unbalanced forests */
   SC_CHECK_ABORT (forest->mpisize == 1 || forest->ghosts != NULL,
                   "Ghost structure is needed for t8_forest_leaf_face_neighbors "
                   "but was not found in forest.\n");
@@ -1957,8 +2238,8 @@ t8_forest_leaf_face_neighbors_ext (t8_forest_t forest, t8_locidx_t ltreeid, cons
     T8_FREE (owners);
   }
   else {
-    /* TODO: implement unbalanced version */
-    SC_ABORT_NOT_REACHED ();
+    t8_forest_leaf_face_neighbors_unbalanced (forest, ltreeid, leaf, pneighbor_leaves, face, dual_faces, num_neighbors,
+                                              pelement_indices, pneigh_scheme, gneigh_tree, orientation);
   }
 }
 
@@ -2219,13 +2500,14 @@ t8_forest_element_find_owner_ext (t8_forest_t forest, t8_gloidx_t gtreeid, t8_el
     return upper_bound;
   }
   ts = t8_forest_get_eclass_scheme (forest, eclass);
+  t8_element_buffer<1> buffer (ts);
   if (element_is_desc) {
     /* The element is already its own first_descendant */
     first_desc = element;
   }
   else {
     /* Build the first descendant of element */
-    ts->t8_element_new (1, &first_desc);
+    first_desc = buffer[0];
     ts->t8_element_first_descendant (element, first_desc, forest->maxlevel);
   }
 
@@ -2333,10 +2615,6 @@ t8_forest_element_find_owner_ext (t8_forest_t forest, t8_gloidx_t gtreeid, t8_el
     }
   }
 
-  /* clean-up */
-  if (!element_is_desc) {
-    ts->t8_element_destroy (1, &first_desc);
-  }
   T8_ASSERT (t8_forest_element_check_owner (forest, element, gtreeid, eclass, guess, element_is_desc));
   return guess;
 }
@@ -2593,7 +2871,6 @@ t8_forest_element_owners_bounds (t8_forest_t forest, t8_gloidx_t gtreeid, const
                                  t8_eclass_t eclass, int *lower, int *upper)
 {
   t8_eclass_scheme_c *ts;
-  t8_element_t *first_desc, *last_desc;
 
   if (*lower >= *upper) {
     /* Either there is no owner or it is unique. */
@@ -2602,16 +2879,15 @@ t8_forest_element_owners_bounds (t8_forest_t forest, t8_gloidx_t gtreeid, const
 
   /* Compute the first and last descendant of element */
   ts = t8_forest_get_eclass_scheme (forest, eclass);
-  ts->t8_element_new (1, &first_desc);
+  t8_element_buffer<2> buffer (ts);
+  t8_element_t *first_desc = buffer[0];
+  t8_element_t *last_desc = buffer[1];
   ts->t8_element_first_descendant (element, first_desc, forest->maxlevel);
-  ts->t8_element_new (1, &last_desc);
   ts->t8_element_last_descendant (element, last_desc, forest->maxlevel);
 
   /* Compute their owners as bounds for all of element's owners */
   *lower = t8_forest_element_find_owner_ext (forest, gtreeid, first_desc, eclass, *lower, *upper, *lower, 1);
   *upper = t8_forest_element_find_owner_ext (forest, gtreeid, last_desc, eclass, *lower, *upper, *upper, 1);
-  ts->t8_element_destroy (1, &first_desc);
-  ts->t8_element_destroy (1, &last_desc);
 }
 
 void
@@ -2619,7 +2895,6 @@ t8_forest_element_owners_at_face_bounds (t8_forest_t forest, t8_gloidx_t gtreeid
                                          t8_eclass_t eclass, int face, int *lower, int *upper)
 {
   t8_eclass_scheme_c *ts;
-  t8_element_t *first_face_desc, *last_face_desc;
 
   if (*lower >= *upper) {
     /* Either there is no owner or it is unique. */
@@ -2627,16 +2902,15 @@ t8_forest_element_owners_at_face_bounds (t8_forest_t forest, t8_gloidx_t gtreeid
   }
 
   ts = t8_forest_get_eclass_scheme (forest, eclass);
-  ts->t8_element_new (1, &first_face_desc);
+  t8_element_buffer<2> buffer (ts);
+  t8_element_t *first_face_desc = buffer[0];
+  t8_element_t *last_face_desc = buffer[1];
   ts->t8_element_first_descendant_face (element, face, first_face_desc, forest->maxlevel);
-  ts->t8_element_new (1, &last_face_desc);
   ts->t8_element_last_descendant_face (element, face, last_face_desc, forest->maxlevel);
 
   /* owner of first and last descendants */
   *lower = t8_forest_element_find_owner_ext (forest, gtreeid, first_face_desc, eclass, *lower, *upper, *lower, 1);
   *upper = t8_forest_element_find_owner_ext (forest, gtreeid, last_face_desc, eclass, *lower, *upper, *upper, 1);
-  ts->t8_element_destroy (1, &first_face_desc);
-  ts->t8_element_destroy (1, &last_face_desc);
 }
 
 void
@@ -2645,16 +2919,16 @@ t8_forest_element_owners_at_neigh_face (t8_forest_t forest, t8_locidx_t ltreeid,
 {
   t8_eclass_scheme_c *neigh_scheme;
   t8_eclass_t neigh_class;
-  t8_element_t *face_neighbor;
   int dual_face;
   t8_gloidx_t neigh_tree;
 
   /* Find out the eclass of the face neighbor tree and allocate memory for
-   * the neighbor element */
+   * the neighbor element on the stack */
   neigh_class = t8_forest_element_neighbor_eclass (forest, ltreeid, element, face);
   T8_ASSERT (T8_ECLASS_ZERO <= neigh_class && neigh_class < T8_ECLASS_COUNT);
   neigh_scheme = t8_forest_get_eclass_scheme (forest, neigh_class);
-  neigh_scheme->t8_element_new (1, &face_neighbor);
+  t8_element_buffer<1> buffer (neigh_scheme);
+  t8_element_t *face_neighbor = buffer[0];
   /* clang-format off */
   neigh_tree = t8_forest_element_face_neighbor (forest, ltreeid, element, face_neighbor,
                                                 neigh_scheme, face, &dual_face);
@@ -2667,7 +2941,6 @@ t8_forest_element_owners_at_neigh_face (t8_forest_t forest, t8_locidx_t ltreeid,
     /* There is no face neighbor, we indicate this by setting the array to 0 */
     sc_array_resize (owners, 0);
   }
-  neigh_scheme->t8_element_destroy (1, &face_neighbor);
 }
 
 void
@@ -2676,7 +2949,6 @@ t8_forest_element_owners_at_neigh_face_bounds (t8_forest_t forest, t8_locidx_t l
 {
   t8_eclass_scheme_c *neigh_scheme;
   t8_eclass_t neigh_class;
-  t8_element_t *face_neighbor;
   int dual_face;
   t8_gloidx_t neigh_tree;
 
@@ -2684,10 +2956,11 @@ t8_forest_element_owners_at_neigh_face_bounds (t8_forest_t forest, t8_locidx_t l
     /* There is no owner or it is unique */
     return;
   }
-  /* Find out the eclass of the face neighbor tree and allocate memory for the neighbor element */
+  /* Find out the eclass of the face neighbor tree and allocate memory for the neighbor element on the stack */
   neigh_class = t8_forest_element_neighbor_eclass (forest, ltreeid, element, face);
   neigh_scheme = t8_forest_get_eclass_scheme (forest, neigh_class);
-  neigh_scheme->t8_element_new (1, &face_neighbor);
+  t8_element_buffer<1> buffer (neigh_scheme);
+  t8_element_t *face_neighbor = buffer[0];
   neigh_tree
     = t8_forest_element_face_neighbor (forest, ltreeid, element, face_neighbor, neigh_scheme, face, &dual_face);
   if (neigh_tree >= 0) {
@@ -2699,7 +2972,6 @@ t8_forest_element_owners_at_neigh_face_bounds (t8_forest_t forest, t8_locidx_t l
     *lower = 1;
     *upper = 0;
   }
-  neigh_scheme->t8_element_destroy (1, &face_neighbor);
 }
 
 int
@@ -2707,7 +2979,6 @@ t8_forest_element_has_leaf_desc (t8_forest_t forest, t8_gloidx_t gtreeid, const
                                  t8_eclass_scheme_c *ts)
 {
   t8_locidx_t ltreeid;
-  t8_element_t *last_desc;
   t8_locidx_t ghost_treeid;
   t8_linearidx_t last_desc_id, elem_id;
   int index, level, level_found;
@@ -2718,7 +2989,8 @@ t8_forest_element_has_leaf_desc (t8_forest_t forest, t8_gloidx_t gtreeid, const
    * We then check whether the forest has any element with id between
    * the id of element and the id of the last descendant */
   /* TODO: element interface function t8_element_last_desc_id */
-  ts->t8_element_new (1, &last_desc);
+  t8_element_buffer<1> buffer (ts);
+  t8_element_t *last_desc = buffer[0];
   /* TODO: set level in last_descendant */
   ts->t8_element_last_descendant (element, last_desc, forest->maxlevel);
   last_desc_id = ts->t8_element_get_linear_id (last_desc, forest->maxlevel);
@@ -2743,8 +3015,6 @@ t8_forest_element_has_leaf_desc (t8_forest_t forest, t8_gloidx_t gtreeid, const
         /* The element is a true descendant */
         T8_ASSERT (ts->t8_element_level (elem_found) > ts->t8_element_level (element));
         T8_ASSERT (t8_forest_element_is_leaf (forest, elem_found, ltreeid));
-        /* clean-up */
-        ts->t8_element_destroy (1, &last_desc);
         return 1;
       }
     }
@@ -2765,14 +3035,11 @@ t8_forest_element_has_leaf_desc (t8_forest_t forest, t8_gloidx_t gtreeid, const
         if (ts->t8_element_get_linear_id (element, forest->maxlevel) <= elem_id && level < level_found) {
           /* The element is a true descendant */
           T8_ASSERT (ts->t8_element_level (elem_found) > ts->t8_element_level (element));
-          /* clean-up */
-          ts->t8_element_destroy (1, &last_desc);
           return 1;
         }
       }
     }
   }
-  ts->t8_element_destroy (1, &last_desc);
   return 0;
 }
 
@@ -2800,6 +3067,8 @@ t8_forest_init (t8_forest_t *pforest)
   forest->maxlevel_existing = -1;
   forest->stats_computed = 0;
   forest->incomplete_trees = -1;
+  forest->num_threads = 1;
+  forest->compact_transfer = 0;
 }
 
 int
@@ -2867,6 +3136,23 @@ t8_forest_set_scheme (t8_forest_t forest, t8_scheme_cxx_t *scheme)
   forest->scheme_cxx = scheme;
 }
 
+void
+t8_forest_set_load (t8_forest_t forest, const char *fileprefix, sc_MPI_Comm comm)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (forest->rc.refcount > 0);
+  T8_ASSERT (!forest->committed);
+  T8_ASSERT (forest->cmesh == NULL);
+  T8_ASSERT (forest->set_from == NULL);
+  T8_ASSERT (forest->set_load == NULL);
+
+  T8_ASSERT (fileprefix != NULL);
+
+  forest->set_load = T8_ALLOC (char, strlen (fileprefix) + 1);
+  strcpy (forest->set_load, fileprefix);
+  t8_forest_set_mpicomm (forest, comm, 0);
+}
+
 void
 t8_forest_set_level (t8_forest_t forest, int level)
 {
@@ -2987,6 +3273,84 @@ t8_forest_set_ghost (t8_forest_t forest, int do_ghost, t8_ghost_type_t ghost_typ
   t8_forest_set_ghost_ext (forest, do_ghost, ghost_type, 3);
 }
 
+void
+t8_forest_set_partition_weights (t8_forest_t forest, t8_forest_partition_weight_t weight_fn)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest));
+
+  forest->set_partition_weight_fn = weight_fn;
+  forest->set_partition_weights = NULL;
+}
+
+void
+t8_forest_set_partition_weights_array (t8_forest_t forest, const double *weights)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest));
+
+  forest->set_partition_weights = weights;
+  forest->set_partition_weight_fn = NULL;
+}
+
+void
+t8_forest_set_face_connectivity (t8_forest_t forest, int do_face_connectivity)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest));
+
+  forest->do_face_connectivity = (do_face_connectivity != 0);
+  if (forest->do_face_connectivity && !forest->do_ghost) {
+    /* The face neighbors on other processes are needed as ghosts */
+    t8_forest_set_ghost (forest, 1, T8_GHOST_FACES);
+  }
+}
+
+void
+t8_forest_set_element_metrics (t8_forest_t forest, int do_element_metrics)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest));
+
+  forest->do_element_metrics = (do_element_metrics != 0);
+}
+
+void
+t8_forest_set_num_threads (t8_forest_t forest, int num_threads)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest) || t8_forest_is_committed (forest));
+  T8_ASSERT (num_threads >= 1);
+
+#if T8_ENABLE_OPENMP
+#ifndef SC_ENABLE_PTHREAD
+  if (num_threads > 1) {
+    t8_global_errorf ("WARNING: libsc was built without pthread support. Its memory allocation "
+                      "is not thread safe, the forest uses 1 thread.\n");
+    num_threads = 1;
+  }
+#endif
+#endif
+  forest->num_threads = num_threads;
+}
+
+int
+t8_forest_get_num_threads (const t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest) || t8_forest_is_committed (forest));
+  return forest->num_threads;
+}
+
+void
+t8_forest_set_compact_transfer (t8_forest_t forest, int compact_transfer)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest) || t8_forest_is_committed (forest));
+
+  forest->compact_transfer = (compact_transfer != 0);
+}
+
+int
+t8_forest_get_compact_transfer (const t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_initialized (forest) || t8_forest_is_committed (forest));
+  return forest->compact_transfer;
+}
+
 void
 t8_forest_set_adapt (t8_forest_t forest, const t8_forest_t set_from, t8_forest_adapt_t adapt_fn, int recursive)
 {
@@ -3158,6 +3522,8 @@ t8_forest_commit (t8_forest_t forest)
   int mpiret;
   int partitioned = 0;
   sc_MPI_Comm comm_dup;
+  t8_forest_t forest_face_connectivity_from = NULL;
+  t8_forest_t forest_element_metrics_from = NULL;
 
   T8_ASSERT (forest != NULL);
   T8_ASSERT (forest->rc.refcount > 0);
@@ -3166,8 +3532,38 @@ t8_forest_commit (t8_forest_t forest)
     /* If profiling is enabled, we measure the runtime of commit */
     forest->profile->commit_runtime = sc_MPI_Wtime ();
   }
+  t8_forest_timers_begin_commit (forest);
+
+  if (forest->set_load != NULL) {
+    /* This forest is loaded from a file */
+    T8_ASSERT (forest->mpicomm != sc_MPI_COMM_NULL);
+    T8_ASSERT (forest->cmesh == NULL);
+    T8_ASSERT (forest->scheme_cxx != NULL);
+    T8_ASSERT (forest->set_from == NULL);
+    T8_ASSERT (forest->from_method == T8_FOREST_FROM_LAST);
 
-  if (forest->set_from == NULL) {
+    /* dup communicator if requested */
+    if (forest->do_dup) {
+      mpiret = sc_MPI_Comm_dup (forest->mpicomm, &comm_dup);
+      SC_CHECK_MPI (mpiret);
+      forest->mpicomm = comm_dup;
+    }
+    /* Set mpirank and mpisize */
+    mpiret = sc_MPI_Comm_size (forest->mpicomm, &forest->mpisize);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Comm_rank (forest->mpicomm, &forest->mpirank);
+    SC_CHECK_MPI (mpiret);
+    /* Load the cmesh and the elements of this process. If the elements were
+     * repartitioned, the cmesh must be repartitioned accordingly. */
+    partitioned = t8_forest_load_trees (forest, forest->set_load);
+    forest->dimension = forest->cmesh->dimension;
+    /* Compute the maximum allowed refinement level */
+    t8_forest_compute_maxlevel (forest);
+    forest->global_num_trees = t8_cmesh_get_num_trees (forest->cmesh);
+    T8_FREE (forest->set_load);
+    forest->set_load = NULL;
+  }
+  else if (forest->set_from == NULL) {
     /* This forest is constructed solely from its cmesh as a uniform
      * forest */
     T8_ASSERT (forest->mpicomm != sc_MPI_COMM_NULL);
@@ -3209,6 +3605,21 @@ t8_forest_commit (t8_forest_t forest)
     T8_ASSERT (forest->mpicomm == sc_MPI_COMM_NULL);
     T8_ASSERT (forest->cmesh == NULL);
     T8_ASSERT (forest->scheme_cxx == NULL);
+
+    if (forest->do_face_connectivity && forest->from_method == T8_FOREST_FROM_ADAPT
+        && forest_from->face_connectivity != NULL) {
+      /* The face connectivity of the unchanged trees can be copied from forest_from.
+       * We keep it alive until the connectivity is built. */
+      t8_forest_ref (forest_from);
+      forest_face_connectivity_from = forest_from;
+    }
+    if (forest->do_element_metrics && forest->from_method == T8_FOREST_FROM_ADAPT && !forest->set_adapt_recursive
+        && forest_from->element_metrics != NULL) {
+      /* The metrics of the unchanged leaves can be copied from forest_from.
+       * We keep it alive until the metrics are computed. */
+      t8_forest_ref (forest_from);
+      forest_element_metrics_from = forest_from;
+    }
     T8_ASSERT (!forest->do_dup);
     T8_ASSERT (forest->from_method >= T8_FOREST_FROM_FIRST && forest->from_method < T8_FOREST_FROM_LAST);
     T8_ASSERT (forest->set_from->incomplete_trees > -1);
@@ -3251,6 +3662,8 @@ t8_forest_commit (t8_forest_t forest)
     /* T8_ASSERT (forest->from_method == T8_FOREST_FROM_COPY); */
     if (forest->from_method & T8_FOREST_FROM_ADAPT) {
       SC_CHECK_ABORT (forest->set_adapt_fn != NULL, "No adapt function specified");
+      SC_CHECK_ABORT (forest->set_partition_weights == NULL,
+                      "Partition weights given as array cannot be combined with adapt. Use a weight function.");
       forest->from_method -= T8_FOREST_FROM_ADAPT;
       if (forest->from_method > 0) {
         /* The forest should also be partitioned/balanced.
@@ -3266,6 +3679,8 @@ t8_forest_commit (t8_forest_t forest)
         t8_forest_set_adapt (forest_adapt, forest->set_from, forest->set_adapt_fn, forest->set_adapt_recursive);
         /* Set profiling if enabled */
         t8_forest_set_profiling (forest_adapt, forest->profile != NULL);
+        /* Adapt with the same number of threads */
+        t8_forest_set_num_threads (forest_adapt, forest->num_threads);
         t8_forest_commit (forest_adapt);
         /* The new forest will be partitioned/balanced from forest_adapt */
         forest->set_from = forest_adapt;
@@ -3274,6 +3689,7 @@ t8_forest_commit (t8_forest_t forest)
         /* If profiling is enabled copy the runtime of adapt. */
         if (forest->profile != NULL) {
           forest->profile->adapt_runtime = forest_adapt->profile->adapt_runtime;
+          t8_forest_timers_merge (forest, forest_adapt);
         }
       }
       else {
@@ -3297,8 +3713,18 @@ t8_forest_commit (t8_forest_t forest)
           t8_forest_ref (forest->set_from);
         }
         t8_forest_set_partition (forest_partition, forest->set_from, forest->set_for_coarsening);
+        /* Partition with the weights of this forest */
+        t8_forest_set_user_data (forest_partition, t8_forest_get_user_data (forest));
+        if (forest->set_partition_weight_fn != NULL) {
+          t8_forest_set_partition_weights (forest_partition, forest->set_partition_weight_fn);
+        }
+        else if (forest->set_partition_weights != NULL) {
+          t8_forest_set_partition_weights_array (forest_partition, forest->set_partition_weights);
+        }
         /* activate profiling, if this forest has profiling */
         t8_forest_set_profiling (forest_partition, forest->profile != NULL);
+        /* Send the elements in the same format as this forest */
+        t8_forest_set_compact_transfer (forest_partition, forest->compact_transfer);
         /* Commit the partitioned forest */
         t8_forest_commit (forest_partition);
         forest->set_from = forest_partition;
@@ -3308,6 +3734,7 @@ t8_forest_commit (t8_forest_t forest)
           forest->profile->partition_elements_shipped = forest_partition->profile->partition_elements_shipped;
           forest->profile->partition_procs_sent = forest_partition->profile->partition_procs_sent;
           forest->profile->partition_runtime = forest_partition->profile->partition_runtime;
+          t8_forest_timers_merge (forest, forest_partition);
         }
       }
       else {
@@ -3409,6 +3836,30 @@ t8_forest_commit (t8_forest_t forest)
     }
     forest->do_ghost = 0;
   }
+
+  if (forest->do_face_connectivity) {
+    /* Build the face neighbor table, reusing the table of the source forest if possible */
+    t8_forest_profile_timer_start (forest, "face_connectivity");
+    t8_forest_face_connectivity_build (forest, forest_face_connectivity_from);
+    t8_forest_profile_timer_stop (forest, "face_connectivity");
+    if (forest_face_connectivity_from != NULL) {
+      t8_forest_unref (&forest_face_connectivity_from);
+    }
+    forest->do_face_connectivity = 0;
+  }
+
+  if (forest->do_element_metrics) {
+    /* Compute the element metrics, reusing the metrics of the source forest if possible */
+    t8_forest_profile_timer_start (forest, "element_metrics");
+    t8_forest_element_metrics_build (forest, forest_element_metrics_from);
+    t8_forest_profile_timer_stop (forest, "element_metrics");
+    if (forest_element_metrics_from != NULL) {
+      t8_forest_unref (&forest_element_metrics_from);
+    }
+    forest->do_element_metrics = 0;
+  }
+  /* Record the timers of this commit */
+  t8_forest_timers_commit (forest);
 #ifdef T8_ENABLE_DEBUG
   t8_forest_partition_test_boundary_element (forest);
 #endif
@@ -3905,11 +4356,13 @@ t8_forest_set_profiling (t8_forest_t forest, int set_profiling)
     if (forest->profile == NULL) {
       /* Only do something if profiling is not enabled already */
       forest->profile = T8_ALLOC_ZERO (t8_profile_struct_t, 1);
+      forest->profile->timers = t8_forest_timers_new ();
     }
   }
   else {
     /* Free any profile that is already set */
     if (forest->profile != NULL) {
+      t8_forest_timers_destroy (&forest->profile->timers);
       T8_FREE (forest->profile);
     }
   }
@@ -3939,6 +4392,8 @@ t8_forest_compute_profile (t8_forest_t forest)
     sc_stats_set1 (&forest->stats[11], profile->ghost_waittime, "forest: Ghost waittime.");
     sc_stats_set1 (&forest->stats[12], profile->balance_runtime, "forest: Balance runtime.");
     sc_stats_set1 (&forest->stats[13], profile->balance_rounds, "forest: Balance rounds.");
+    sc_stats_set1 (&forest->stats[14], profile->ghost_remote_runtime, "forest: Ghost remote detection runtime.");
+    sc_stats_set1 (&forest->stats[15], profile->ghost_comm_runtime, "forest: Ghost communication runtime.");
     /* compute stats */
     sc_stats_compute (sc_MPI_COMM_WORLD, T8_PROFILE_NUM_STATS, forest->stats);
     forest->stats_computed = 1;
@@ -4058,6 +4513,18 @@ t8_forest_profile_get_ghost_time (t8_forest_t forest, t8_locidx_t *ghosts_sent)
   return 0;
 }
 
+double
+t8_forest_profile_get_ghost_remote_time (t8_forest_t forest, double *comm_time)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  if (forest->profile != NULL) {
+    *comm_time = forest->profile->ghost_comm_runtime;
+    return forest->profile->ghost_remote_runtime;
+  }
+  *comm_time = 0;
+  return 0;
+}
+
 double
 t8_forest_profile_get_ghostexchange_waittime (t8_forest_t forest)
 {
@@ -4140,6 +4607,20 @@ t8_forest_write_vtk_ext (t8_forest_t forest, const char *fileprefix, const int w
   }
 }
 
+int
+t8_forest_write_vtk_format (t8_forest_t forest, const char *fileprefix, const t8_vtk_format_t format,
+                            const int write_treeid, const int write_mpirank, const int write_level,
+                            const int write_element_id, const int write_ghosts, const int write_shared_points,
+                            const int num_data, t8_vtk_data_field_t *data)
+{
+  T8_ASSERT (forest != NULL);
+  T8_ASSERT (forest->rc.refcount > 0);
+  T8_ASSERT (forest->committed);
+
+  return t8_forest_vtk_write_file_format (forest, fileprefix, format, write_treeid, write_mpirank, write_level,
+                                          write_element_id, write_ghosts, write_shared_points, num_data, data);
+}
+
 int
 t8_forest_write_vtk (t8_forest_t forest, const char *fileprefix)
 {
@@ -4249,6 +4730,9 @@ t8_forest_reset (t8_forest_t *pforest)
       /* in this case we have taken ownership and not released it yet */
       t8_forest_unref (&forest->set_from);
     }
+    if (forest->set_load != NULL) {
+      T8_FREE (forest->set_load);
+    }
   }
   else {
     T8_ASSERT (forest->set_from == NULL);
@@ -4267,6 +4751,14 @@ t8_forest_reset (t8_forest_t *pforest)
   if (forest->ghosts != NULL) {
     t8_forest_ghost_unref (&forest->ghosts);
   }
+  /* Destroy the face connectivity table if it exists */
+  if (forest->face_connectivity != NULL) {
+    t8_forest_face_connectivity_destroy (forest);
+  }
+  /* Destroy the element metrics if they exist */
+  if (forest->element_metrics != NULL) {
+    t8_forest_element_metrics_destroy (forest);
+  }
   /* we have taken ownership on calling t8_forest_set_* */
   if (forest->scheme_cxx != NULL) {
     t8_scheme_cxx_unref (&forest->scheme_cxx);
@@ -4288,6 +4780,7 @@ t8_forest_reset (t8_forest_t *pforest)
     t8_shmem_array_destroy (&forest->tree_offsets);
   }
   if (forest->profile != NULL) {
+    t8_forest_timers_destroy (&forest->profile->timers);
     T8_FREE (forest->profile);
   }
   T8_FREE (forest);
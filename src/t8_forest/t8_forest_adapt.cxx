@@ -24,8 +24,12 @@
 #include <t8_forest/t8_forest_types.h>
 #include <t8_forest/t8_forest_private.h>
 #include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_profiling.h>
 #include <t8_data/t8_containers.h>
 #include <t8_element.hxx>
+#if T8_ENABLE_OPENMP
+#include <omp.h>
+#endif
 
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
@@ -362,9 +366,21 @@ t8_forest_adapt_refine_recursive (t8_forest_t forest, t8_locidx_t ltreeid, t8_lo
   } /* End while loop */
 }
 
-/* TODO: optimize this when we own forest_from */
-void
-t8_forest_adapt (t8_forest_t forest)
+/** Adapt a single local tree of a forest.
+ * The new elements of the tree are built from the elements of the same tree in
+ * forest->set_from. Since no other tree is touched, this function may be called
+ * concurrently for different trees, as long as the adapt callback is thread safe.
+ * \param [in,out] forest          The forest that is adapted.
+ * \param [in]     ltree_id        The local id of the tree to adapt.
+ * \param [in,out] refine_list     If the adaptation is recursive an empty list that is used
+ *                                 as buffer, NULL otherwise.
+ * \param [in,out] element_removed Set to true if an element of this tree was removed.
+ *                                 Not changed otherwise.
+ * \return                         The number of elements in the new tree.
+ * \note The element offset of the tree is not set by this function.
+ */
+static t8_locidx_t
+t8_forest_adapt_tree (t8_forest_t forest, const t8_locidx_t ltree_id, sc_list_t *refine_list, int *element_removed)
 {
   t8_forest_t forest_from;
   t8_eclass_scheme_c *tscheme;
@@ -372,16 +388,12 @@ t8_forest_adapt (t8_forest_t forest)
   t8_element_array_t *telements_from;
   t8_element_t **elements;
   t8_element_t **elements_from;
-  t8_locidx_t ltree_id;
-  t8_locidx_t num_trees;
   t8_locidx_t num_el_from;
   t8_locidx_t el_considered;
-  t8_locidx_t el_inserted;
+  t8_locidx_t el_inserted = 0;
   t8_locidx_t el_coarsen;
-  t8_locidx_t el_offset;
   t8_tree_t tree;
   t8_tree_t tree_from;
-  sc_list_t *refine_list = NULL; /* This is only needed when we adapt recursively */
   int num_children;
   int num_siblings;
   int curr_size_elements_from;
@@ -391,6 +403,296 @@ t8_forest_adapt (t8_forest_t forest)
   int ci;
   int refine;
   int is_family;
+
+  forest_from = forest->set_from;
+  /* Get the new and old tree and the new and old element arrays */
+  tree = t8_forest_get_tree (forest, ltree_id);
+  tree_from = t8_forest_get_tree (forest_from, ltree_id);
+  telements = &tree->elements;
+  telements_from = &tree_from->elements;
+  /* Number of elements in the old tree */
+  num_el_from = (t8_locidx_t) t8_element_array_get_count (telements_from);
+  T8_ASSERT (num_el_from == t8_forest_get_tree_num_elements (forest_from, ltree_id));
+  /* Continue only if tree_from is not empty.
+   * Otherwise there is nothing to adapt, since elements can't be inserted. */
+  if (num_el_from > 0) {
+    const t8_element_t *first_element_from = t8_element_array_index_locidx (telements_from, 0);
+    /* Get the element scheme for this tree */
+    tscheme = t8_forest_get_eclass_scheme (forest_from, tree->eclass);
+    /* Index of the element we currently consider for refinement/coarsening. */
+    el_considered = 0;
+    /* Index into the newly inserted elements */
+    el_inserted = 0;
+    /* el_coarsen is the index of the first element in the new element
+     * array which could be coarsened recursively. */
+    el_coarsen = 0;
+    num_children = tscheme->t8_element_num_children (first_element_from);
+    curr_size_elements = num_children;
+    curr_size_elements_from = tscheme->t8_element_num_siblings (first_element_from);
+    /* Buffer for a family of new elements */
+    elements = T8_ALLOC (t8_element_t *, num_children);
+    /* Buffer for a family of old elements */
+    elements_from = T8_ALLOC (t8_element_t *, curr_size_elements_from);
+    /* We now iterate over all elements in this tree and check them for refinement/coarsening. */
+    while (el_considered < num_el_from) {
+      /* Load the current element and at most num_siblings-1 many others into
+       * the elements_from buffer. Stop when we are certain that they cannot from
+       * a family.
+       * At the end is_family will be true, if these elements form a family.
+       */
+
+      num_siblings = tscheme->t8_element_num_siblings (t8_element_array_index_locidx (telements_from, el_considered));
+
+      if (num_siblings > curr_size_elements_from) {
+        /* Enlarge the elements_from buffer if required */
+        elements_from = T8_REALLOC (elements_from, t8_element_t *, num_siblings);
+        curr_size_elements_from = num_siblings;
+      }
+#if T8_ENABLE_DEBUG
+      for (zz = 0; zz < num_siblings; zz++) {
+        elements_from[zz] = NULL;
+      }
+#endif
+      for (zz = 0; zz < num_siblings && el_considered + (t8_locidx_t) zz < num_el_from; zz++) {
+        /* TODO: In a future version elements_from[zz] should be const and we should call
+         * t8_element_array_index_locidx (the const version). */
+        elements_from[zz] = t8_element_array_index_locidx_mutable (telements_from, el_considered + (t8_locidx_t) zz);
+        /* This is a quick check whether we build up a family here and could
+         * abort early if not.
+         * If the child id of the current element is not zz, then it cannot
+         * be part of a family (Since we can only have a family if child ids
+         * are 0, 1, 2, ... zz, ... num_siblings-1).
+         * This check is however not sufficient - therefore, we call is_family later. */
+        if (!forest_from->incomplete_trees && tscheme->t8_element_child_id (elements_from[zz]) != zz) {
+          break;
+        }
+      }
+
+      /* We assume that the elements do not form a family.
+       * So we will only pass the first element to the adapt callback. */
+      is_family = 0;
+      num_elements_to_adapt_callback = 1;
+      if (forest_from->incomplete_trees) {
+        is_family = t8_forest_is_incomplete_family (forest_from, ltree_id, el_considered, tscheme, elements_from, zz);
+        if (is_family > 0) {
+          /* We will pass a (in)complete family to the adapt callback */
+          num_elements_to_adapt_callback = is_family;
+          is_family = 1;
+        }
+      }
+      else if (zz == num_siblings && tscheme->t8_element_is_family (elements_from)) {
+        /* We will pass a full family to the adapt callback */
+        is_family = 1;
+        num_elements_to_adapt_callback = num_siblings;
+      }
+      T8_ASSERT (num_elements_to_adapt_callback <= num_siblings);
+#if T8_ENABLE_DEBUG
+      if (forest_from->incomplete_trees) {
+        T8_ASSERT (forest_from->incomplete_trees == 1);
+        T8_ASSERT (!is_family
+                   || t8_forest_is_family_callback (tscheme, num_elements_to_adapt_callback, elements_from));
+      }
+      else {
+        T8_ASSERT (forest_from->incomplete_trees == 0);
+        T8_ASSERT (!is_family || tscheme->t8_element_is_family (elements_from));
+      }
+#endif
+      /* Pass the element, or the family to the adapt callback.
+       * The output will be  1 if the element should be refined
+       *                     0 if the element should remain as is
+       *                    -1 if we passed a family and it should get coarsened
+       *                    -2 if the element should be removed.
+       */
+      refine = forest->set_adapt_fn (forest, forest->set_from, ltree_id, el_considered, tscheme, is_family,
+                                     num_elements_to_adapt_callback, elements_from);
+
+      T8_ASSERT (is_family || refine != -1);
+      if (refine > 0 && tscheme->t8_element_level (elements_from[0]) >= forest->maxlevel) {
+        /* Only refine an element if it does not exceed the maximum level */
+        refine = 0;
+      }
+      if (refine == 1) {
+        /* The first element is to be refined */
+        num_children = tscheme->t8_element_num_children (elements_from[0]);
+        if (num_children > curr_size_elements) {
+          elements = T8_REALLOC (elements, t8_element_t *, num_children);
+          curr_size_elements = num_children;
+        }
+        if (forest->set_adapt_recursive) {
+          /* Create the children of this element */
+          tscheme->t8_element_new (num_children, elements);
+          tscheme->t8_element_children (elements_from[0], num_children, elements);
+          for (ci = num_children - 1; ci >= 0; ci--) {
+            /* Prepend the children to the refine_list.
+             * These should now be the only elements in the list.
+             */
+            (void) sc_list_prepend (refine_list, elements[ci]);
+          }
+          /* We now recursively check the newly created elements for refinement. */
+          t8_forest_adapt_refine_recursive (forest, ltree_id, el_considered, tscheme, refine_list, telements,
+                                            &el_inserted, elements, element_removed);
+          el_coarsen = el_inserted;
+        }
+        else {
+          (void) t8_element_array_push_count (telements, num_children);
+          for (zz = 0; zz < num_children; zz++) {
+            /* TODO: In a future version elements_from[zz] should be const and we should call
+             * t8_element_array_index_locidx (the const version). */
+            elements[zz] = t8_element_array_index_locidx_mutable (telements, el_inserted + zz);
+          }
+          tscheme->t8_element_children (elements_from[0], num_children, elements);
+          el_inserted += (t8_locidx_t) num_children;
+        }
+        el_considered++;
+      }
+      else if (refine == -1) {
+        /* The elements form a family and are to be coarsened. */
+        /* Make room for one more new element. */
+        elements[0] = t8_element_array_push (telements);
+        /* Compute the parent of the current family.
+         * This parent is now inserted in telements. */
+        T8_ASSERT (tscheme->t8_element_level (elements_from[0]) > 0);
+        tscheme->t8_element_parent (elements_from[0], elements[0]);
+        /* num_siblings is now equivalent to the number of children of elements[0],
+         * as num_siblings is always associated with elements_from*/
+        num_children = num_siblings;
+        el_inserted++;
+        if (num_children > curr_size_elements) {
+          elements = T8_REALLOC (elements, t8_element_t *, num_children);
+          curr_size_elements = num_children;
+        }
+        if (forest->set_adapt_recursive) {
+          /* Adaptation is recursive.
+           * We check whether the just generated parent is the last in its
+           * family (and not the only one).
+           * If so, we check this family for recursive coarsening. */
+          const int child_id = tscheme->t8_element_child_id (elements[0]);
+          if (child_id > 0 && child_id == num_children - 1) {
+            t8_forest_adapt_coarsen_recursive (forest, ltree_id, el_considered, tscheme, telements, el_coarsen,
+                                               &el_inserted, elements);
+          }
+        }
+        el_considered += (t8_locidx_t) num_elements_to_adapt_callback;
+      }
+      else if (refine == 0) {
+        /* The considered elements are neither to be coarsened nor is the first
+         * one to be refined.
+         * We copy the element to the new element array. */
+        elements[0] = t8_element_array_push (telements);
+        tscheme->t8_element_copy (elements_from[0], elements[0]);
+        el_inserted++;
+        if (forest->set_adapt_recursive) {
+          /* Adaptation is recursive.
+           * If adaptation is recursive and this was the last element in its family
+           * (and not the only one), we need to check for recursive coarsening. */
+          const int child_id = tscheme->t8_element_child_id (elements[0]);
+          if (child_id > 0 && child_id == num_children - 1) {
+            t8_forest_adapt_coarsen_recursive (forest, ltree_id, el_considered, tscheme, telements, el_coarsen,
+                                               &el_inserted, elements);
+          }
+        }
+        el_considered++;
+      }
+      else {
+        /* Remove the element */
+        T8_ASSERT (refine == -2);
+        *element_removed = 1;
+        el_considered++;
+      }
+    } /* End element loop */
+
+    /* Check that if we had recursive adaptation, the refine list is now empty. */
+    T8_ASSERT (!forest->set_adapt_recursive || refine_list->elem_count == 0);
+
+    /* Possibly shrink the telements array to the correct size */
+    t8_element_array_resize (telements, el_inserted);
+
+    /* It is not supported to delete all elements from a tree.
+     * In this case, we will abort. */
+    SC_CHECK_ABORTF (el_inserted != 0,
+                     "ERROR: All elements of tree %i were removed. Removing all elements of a tree "
+                     "is currently not supported. See also https://github.com/DLR-AMR/t8code/issues/1137.",
+                     ltree_id);
+
+    /* clean up */
+    T8_FREE (elements);
+    T8_FREE (elements_from);
+  } /* End if (num_el_from > 0) */
+  return el_inserted;
+}
+
+/** Query whether the trees of a forest can be adapted concurrently.
+ * This is the case if the forest is configured to use more than one thread.
+ * \param [in] forest    The forest that is adapted.
+ * \return               True if \ref t8_forest_adapt_tree may be called in parallel.
+ */
+static int
+t8_forest_adapt_is_threadable (const t8_forest_t forest)
+{
+#if T8_ENABLE_OPENMP
+  return forest->num_threads > 1;
+#else
+  return 0;
+#endif
+}
+
+#if T8_ENABLE_OPENMP
+/** Adapt all local trees of a forest with multiple threads.
+ * The trees are split into contiguous ranges with roughly the same number of
+ * elements in the source forest, one range per thread.
+ * \param [in,out] forest          The forest that is adapted.
+ * \param [in,out] element_removed Set to true if any element was removed.
+ */
+static void
+t8_forest_adapt_trees_threaded (t8_forest_t forest, int *element_removed)
+{
+  const t8_locidx_t num_trees = t8_forest_get_num_local_trees (forest);
+  t8_locidx_t *first_tree = NULL;
+  int removed = 0;
+
+#pragma omp parallel num_threads (SC_MIN (forest->num_threads, SC_MAX (num_trees, 1))) reduction (| : removed)
+  {
+    /* The runtime may give us fewer threads than requested. */
+    const int num_threads = omp_get_num_threads ();
+    const int thread_id = omp_get_thread_num ();
+    sc_list_t *refine_list = NULL;
+
+#pragma omp single
+    {
+      /* Compute for each thread the first tree that it adapts, such that each
+       * thread gets about the same number of elements of the source forest. */
+      first_tree = T8_ALLOC (t8_locidx_t, num_threads + 1);
+      t8_forest_split_local_trees (forest->set_from, num_threads, first_tree);
+    } /* Implicit barrier */
+
+    if (forest->set_adapt_recursive) {
+      refine_list = sc_list_new (NULL);
+    }
+    for (t8_locidx_t itree = first_tree[thread_id]; itree < first_tree[thread_id + 1]; itree++) {
+      t8_forest_adapt_tree (forest, itree, refine_list, &removed);
+    }
+    if (forest->set_adapt_recursive) {
+      sc_list_destroy (refine_list);
+    }
+  }
+  T8_FREE (first_tree);
+  if (removed) {
+    *element_removed = 1;
+  }
+}
+#endif
+
+/* TODO: optimize this when we own forest_from */
+void
+t8_forest_adapt (t8_forest_t forest)
+{
+  t8_forest_t forest_from;
+  t8_locidx_t ltree_id;
+  t8_locidx_t num_trees;
+  t8_locidx_t el_inserted;
+  t8_locidx_t el_offset;
+  t8_tree_t tree;
+  sc_list_t *refine_list = NULL; /* This is only needed when we adapt recursively */
   int element_removed = 0;
 
   T8_ASSERT (forest != NULL);
@@ -417,234 +719,41 @@ t8_forest_adapt (t8_forest_t forest)
    * Will we do this here or in an extra function? */
   T8_ASSERT (forest->trees->elem_count == forest_from->trees->elem_count);
 
-  if (forest->set_adapt_recursive) {
-    refine_list = sc_list_new (NULL);
+  t8_forest_profile_timer_start (forest, "adapt");
+  num_trees = t8_forest_get_num_local_trees (forest);
+  if (t8_forest_adapt_is_threadable (forest)) {
+#if T8_ENABLE_OPENMP
+    /* Build the new element arrays of the trees concurrently */
+    t8_forest_adapt_trees_threaded (forest, &element_removed);
+#endif
+  }
+  else {
+    if (forest->set_adapt_recursive) {
+      refine_list = sc_list_new (NULL);
+    }
+    /* Iterate over the trees and build the new element arrays for each one. */
+    for (ltree_id = 0; ltree_id < num_trees; ltree_id++) {
+      t8_forest_adapt_tree (forest, ltree_id, refine_list, &element_removed);
+    }
+    if (forest->set_adapt_recursive) {
+      /* clean up */
+      sc_list_destroy (refine_list);
+    }
   }
+
+  /* Compute the element offsets of the trees and the new number of local elements. */
   forest->local_num_elements = 0;
   el_offset = 0;
-  num_trees = t8_forest_get_num_local_trees (forest);
-  /* Iterate over the trees and build the new element arrays for each one. */
   for (ltree_id = 0; ltree_id < num_trees; ltree_id++) {
-    /* Get the new and old tree and the new and old element arrays */
     tree = t8_forest_get_tree (forest, ltree_id);
-    tree_from = t8_forest_get_tree (forest_from, ltree_id);
-    telements = &tree->elements;
-    telements_from = &tree_from->elements;
-    /* Number of elements in the old tree */
-    num_el_from = (t8_locidx_t) t8_element_array_get_count (telements_from);
-    T8_ASSERT (num_el_from == t8_forest_get_tree_num_elements (forest_from, ltree_id));
-    /* Continue only if tree_from is not empty.
-     * Otherwise there is nothing to adapt, since elements can't be inserted. */
-    if (num_el_from > 0) {
-      const t8_element_t *first_element_from = t8_element_array_index_locidx (telements_from, 0);
-      /* Get the element scheme for this tree */
-      tscheme = t8_forest_get_eclass_scheme (forest_from, tree->eclass);
-      /* Index of the element we currently consider for refinement/coarsening. */
-      el_considered = 0;
-      /* Index into the newly inserted elements */
-      el_inserted = 0;
-      /* el_coarsen is the index of the first element in the new element
-       * array which could be coarsened recursively. */
-      el_coarsen = 0;
-      num_children = tscheme->t8_element_num_children (first_element_from);
-      curr_size_elements = num_children;
-      curr_size_elements_from = tscheme->t8_element_num_siblings (first_element_from);
-      /* Buffer for a family of new elements */
-      elements = T8_ALLOC (t8_element_t *, num_children);
-      /* Buffer for a family of old elements */
-      elements_from = T8_ALLOC (t8_element_t *, curr_size_elements_from);
-      /* We now iterate over all elements in this tree and check them for refinement/coarsening. */
-      while (el_considered < num_el_from) {
-        /* Load the current element and at most num_siblings-1 many others into
-         * the elements_from buffer. Stop when we are certain that they cannot from
-         * a family.
-         * At the end is_family will be true, if these elements form a family.
-         */
-
-        num_siblings = tscheme->t8_element_num_siblings (t8_element_array_index_locidx (telements_from, el_considered));
-
-        if (num_siblings > curr_size_elements_from) {
-          /* Enlarge the elements_from buffer if required */
-          elements_from = T8_REALLOC (elements_from, t8_element_t *, num_siblings);
-          curr_size_elements_from = num_siblings;
-        }
-#if T8_ENABLE_DEBUG
-        for (zz = 0; zz < num_siblings; zz++) {
-          elements_from[zz] = NULL;
-        }
-#endif
-        for (zz = 0; zz < num_siblings && el_considered + (t8_locidx_t) zz < num_el_from; zz++) {
-          /* TODO: In a future version elements_from[zz] should be const and we should call t8_element_array_index_locidx (the const version). */
-          elements_from[zz] = t8_element_array_index_locidx_mutable (telements_from, el_considered + (t8_locidx_t) zz);
-          /* This is a quick check whether we build up a family here and could
-           * abort early if not.
-           * If the child id of the current element is not zz, then it cannot
-           * be part of a family (Since we can only have a family if child ids
-           * are 0, 1, 2, ... zz, ... num_siblings-1).
-           * This check is however not sufficient - therefore, we call is_family later. */
-          if (!forest_from->incomplete_trees && tscheme->t8_element_child_id (elements_from[zz]) != zz) {
-            break;
-          }
-        }
-
-        /* We assume that the elements do not form a family.
-         * So we will only pass the first element to the adapt callback. */
-        is_family = 0;
-        num_elements_to_adapt_callback = 1;
-        if (forest_from->incomplete_trees) {
-          is_family = t8_forest_is_incomplete_family (forest_from, ltree_id, el_considered, tscheme, elements_from, zz);
-          if (is_family > 0) {
-            /* We will pass a (in)complete family to the adapt callback */
-            num_elements_to_adapt_callback = is_family;
-            is_family = 1;
-          }
-        }
-        else if (zz == num_siblings && tscheme->t8_element_is_family (elements_from)) {
-          /* We will pass a full family to the adapt callback */
-          is_family = 1;
-          num_elements_to_adapt_callback = num_siblings;
-        }
-        T8_ASSERT (num_elements_to_adapt_callback <= num_siblings);
-#if T8_ENABLE_DEBUG
-        if (forest_from->incomplete_trees) {
-          T8_ASSERT (forest_from->incomplete_trees == 1);
-          T8_ASSERT (!is_family
-                     || t8_forest_is_family_callback (tscheme, num_elements_to_adapt_callback, elements_from));
-        }
-        else {
-          T8_ASSERT (forest_from->incomplete_trees == 0);
-          T8_ASSERT (!is_family || tscheme->t8_element_is_family (elements_from));
-        }
-#endif
-        /* Pass the element, or the family to the adapt callback.
-         * The output will be  1 if the element should be refined
-         *                     0 if the element should remain as is
-         *                    -1 if we passed a family and it should get coarsened
-         *                    -2 if the element should be removed.
-         */
-        refine = forest->set_adapt_fn (forest, forest->set_from, ltree_id, el_considered, tscheme, is_family,
-                                       num_elements_to_adapt_callback, elements_from);
-
-        T8_ASSERT (is_family || refine != -1);
-        if (refine > 0 && tscheme->t8_element_level (elements_from[0]) >= forest->maxlevel) {
-          /* Only refine an element if it does not exceed the maximum level */
-          refine = 0;
-        }
-        if (refine == 1) {
-          /* The first element is to be refined */
-          num_children = tscheme->t8_element_num_children (elements_from[0]);
-          if (num_children > curr_size_elements) {
-            elements = T8_REALLOC (elements, t8_element_t *, num_children);
-            curr_size_elements = num_children;
-          }
-          if (forest->set_adapt_recursive) {
-            /* Create the children of this element */
-            tscheme->t8_element_new (num_children, elements);
-            tscheme->t8_element_children (elements_from[0], num_children, elements);
-            for (ci = num_children - 1; ci >= 0; ci--) {
-              /* Prepend the children to the refine_list.
-               * These should now be the only elements in the list.
-               */
-              (void) sc_list_prepend (refine_list, elements[ci]);
-            }
-            /* We now recursively check the newly created elements for refinement. */
-            t8_forest_adapt_refine_recursive (forest, ltree_id, el_considered, tscheme, refine_list, telements,
-                                              &el_inserted, elements, &element_removed);
-            el_coarsen = el_inserted;
-          }
-          else {
-            (void) t8_element_array_push_count (telements, num_children);
-            for (zz = 0; zz < num_children; zz++) {
-              /* TODO: In a future version elements_from[zz] should be const and we should call t8_element_array_index_locidx (the const version). */
-              elements[zz] = t8_element_array_index_locidx_mutable (telements, el_inserted + zz);
-            }
-            tscheme->t8_element_children (elements_from[0], num_children, elements);
-            el_inserted += (t8_locidx_t) num_children;
-          }
-          el_considered++;
-        }
-        else if (refine == -1) {
-          /* The elements form a family and are to be coarsened. */
-          /* Make room for one more new element. */
-          elements[0] = t8_element_array_push (telements);
-          /* Compute the parent of the current family.
-           * This parent is now inserted in telements. */
-          T8_ASSERT (tscheme->t8_element_level (elements_from[0]) > 0);
-          tscheme->t8_element_parent (elements_from[0], elements[0]);
-          /* num_siblings is now equivalent to the number of children of elements[0],
-           * as num_siblings is always associated with elements_from*/
-          num_children = num_siblings;
-          el_inserted++;
-          if (num_children > curr_size_elements) {
-            elements = T8_REALLOC (elements, t8_element_t *, num_children);
-            curr_size_elements = num_children;
-          }
-          if (forest->set_adapt_recursive) {
-            /* Adaptation is recursive.
-             * We check whether the just generated parent is the last in its
-             * family (and not the only one).
-             * If so, we check this family for recursive coarsening. */
-            const int child_id = tscheme->t8_element_child_id (elements[0]);
-            if (child_id > 0 && child_id == num_children - 1) {
-              t8_forest_adapt_coarsen_recursive (forest, ltree_id, el_considered, tscheme, telements, el_coarsen,
-                                                 &el_inserted, elements);
-            }
-          }
-          el_considered += (t8_locidx_t) num_elements_to_adapt_callback;
-        }
-        else if (refine == 0) {
-          /* The considered elements are neither to be coarsened nor is the first
-           * one to be refined.
-           * We copy the element to the new element array. */
-          elements[0] = t8_element_array_push (telements);
-          tscheme->t8_element_copy (elements_from[0], elements[0]);
-          el_inserted++;
-          if (forest->set_adapt_recursive) {
-            /* Adaptation is recursive.
-             * If adaptation is recursive and this was the last element in its family
-             * (and not the only one), we need to check for recursive coarsening. */
-            const int child_id = tscheme->t8_element_child_id (elements[0]);
-            if (child_id > 0 && child_id == num_children - 1) {
-              t8_forest_adapt_coarsen_recursive (forest, ltree_id, el_considered, tscheme, telements, el_coarsen,
-                                                 &el_inserted, elements);
-            }
-          }
-          el_considered++;
-        }
-        else {
-          /* Remove the element */
-          T8_ASSERT (refine == -2);
-          element_removed = 1;
-          el_considered++;
-        }
-      } /* End element loop */
-
-      /* Check that if we had recursive adaptation, the refine list is now empty. */
-      T8_ASSERT (!forest->set_adapt_recursive || refine_list->elem_count == 0);
-
+    el_inserted = t8_element_array_get_count (&tree->elements);
+    if (t8_forest_get_tree_num_elements (forest_from, ltree_id) > 0) {
       /* Set the new element offset of this tree */
       tree->elements_offset = el_offset;
       el_offset += el_inserted;
       /* Add to the new number of local elements. */
       forest->local_num_elements += el_inserted;
-      /* Possibly shrink the telements array to the correct size */
-      t8_element_array_resize (telements, el_inserted);
-
-      /* It is not supported to delete all elements from a tree.
-       * In this case, we will abort. */
-      SC_CHECK_ABORTF (el_inserted != 0,
-                       "ERROR: All elements of tree %i were removed. Removing all elements of a tree "
-                       "is currently not supported. See also https://github.com/DLR-AMR/t8code/issues/1137.",
-                       ltree_id);
-
-      /* clean up */
-      T8_FREE (elements);
-      T8_FREE (elements_from);
-    } /* End if (num_el_from > 0) */
-  }   /* End tree loop */
-  if (forest->set_adapt_recursive) {
-    /* clean up */
-    sc_list_destroy (refine_list);
+    }
   }
 
   /* We now adapted all local trees */
@@ -668,6 +777,8 @@ t8_forest_adapt (t8_forest_t forest)
   }
 
   t8_global_productionf ("Done t8_forest_adapt with %lld total elements\n", (long long) forest->global_num_elements);
+  t8_forest_profile_count (forest, "elements", forest->local_num_elements);
+  t8_forest_profile_timer_stop (forest, "adapt");
 
   /* if profiling is enabled, measure runtime */
   if (forest->profile != NULL) {
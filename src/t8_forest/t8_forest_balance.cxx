@@ -25,31 +25,71 @@
 #include <t8_forest/t8_forest_types.h>
 #include <t8_forest/t8_forest_private.h>
 #include <t8_forest/t8_forest_ghost.h>
+#include <t8_forest/t8_forest_partition.h>
 #include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_iterate.hxx>
 #include <t8_forest/t8_forest_profiling.h>
+#include <t8_forest/t8_forest_timers.h>
 #include <t8_element.hxx>
+#include <t8_element_buffer.hxx>
 
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
 
-/* This is the adapt function called during one round of balance.
+/* The maximum number of half face neighbors of an element at one face. */
+#define T8_FOREST_BALANCE_MAX_HALF_NEIGHBORS 4
+
+/* The state of a balance pass, stored in t8code_data of the adapted forest. */
+typedef struct
+{
+  int done;             /* 0 if any element was refined in this pass, 1 otherwise. */
+  int boundary_refined; /* True if an element with a face neighbor on another process was refined. */
+} t8_forest_balance_data_t;
+
+/* Record that an element of forest_from is refined during balance.
+ * If the element has a face neighbor on another process, the refinement changes
+ * the ghost layer of that process and the next balance round has to consider it. */
+static void
+t8_forest_balance_element_refined (t8_forest_t forest_from, t8_locidx_t ltree_id, const t8_element_t *element,
+                                   t8_eclass_scheme_c *ts, t8_forest_balance_data_t *balance_data)
+{
+  balance_data->done = 0;
+  if (balance_data->boundary_refined || forest_from->mpisize == 1) {
+    /* There is nothing more to find out */
+    return;
+  }
+  const int num_faces = ts->t8_element_num_faces (element);
+  for (int iface = 0; iface < num_faces; iface++) {
+    int lower = 0;
+    int upper = forest_from->mpisize - 1;
+    t8_forest_element_owners_at_neigh_face_bounds (forest_from, ltree_id, element, iface, &lower, &upper);
+    if (lower <= upper && (lower != forest_from->mpirank || upper != forest_from->mpirank)) {
+      /* The neighbor at this face is (partially) owned by another process */
+      balance_data->boundary_refined = 1;
+      return;
+    }
+  }
+}
+
+/* This is the adapt function called during balance.
  * We refine an element if it has any face neighbor with a level larger
  * than the element's level + 1.
+ * The neighbors are always looked up in forest_from. This is also valid if we
+ * refine recursively: A child that is created during adapt is refined again
+ * if forest_from has a leaf at its face that is more than one level finer.
+ * Thus, the level difference to each leaf of forest_from is resolved in a single
+ * adapt pass. Only the ripple effect of the newly created elements requires another pass.
  */
-/* TODO: We currently do not adapt recursively since some functions such
- * as half neighbor computation require the forest to be committed. Thus,
- * we pass forest_from as a parameter. But doing so is not valid anymore
- * if we refine recursively. */
 static int
 t8_forest_balance_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t ltree_id, t8_locidx_t lelement_id,
                          t8_eclass_scheme_c *ts, const int is_family, const int num_elements, t8_element_t *elements[])
 {
-  int *pdone, iface, num_faces, num_half_neighbors, ineigh;
+  t8_forest_balance_data_t *balance_data;
+  int iface, num_faces, num_half_neighbors, ineigh;
   t8_gloidx_t neighbor_tree;
   t8_eclass_t neigh_class;
   t8_eclass_scheme_c *neigh_scheme;
   const t8_element_t *element = elements[0];
-  t8_element_t **half_neighbors;
 
   /* We only need to check an element, if its level is smaller then the maximum
    * level in the forest minus 2.
@@ -60,19 +100,19 @@ t8_forest_balance_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_
 
   if (forest_from->maxlevel_existing <= 0 || ts->t8_element_level (element) <= forest_from->maxlevel_existing - 2) {
 
-    pdone = (int *) forest->t8code_data;
+    balance_data = (t8_forest_balance_data_t *) forest->t8code_data;
 
     num_faces = ts->t8_element_num_faces (element);
     for (iface = 0; iface < num_faces; iface++) {
       /* Get the element class and scheme of the face neighbor */
       neigh_class = t8_forest_element_neighbor_eclass (forest_from, ltree_id, element, iface);
       neigh_scheme = t8_forest_get_eclass_scheme (forest_from, neigh_class);
-      /* Allocate memory for the number of half face neighbors */
       num_half_neighbors = ts->t8_element_num_face_children (element, iface);
-      half_neighbors = T8_ALLOC (t8_element_t *, num_half_neighbors);
-      neigh_scheme->t8_element_new (num_half_neighbors, half_neighbors);
+      T8_ASSERT (num_half_neighbors <= T8_FOREST_BALANCE_MAX_HALF_NEIGHBORS);
+      /* The half face neighbors live on the stack, we do not allocate them per face */
+      t8_element_buffer<T8_FOREST_BALANCE_MAX_HALF_NEIGHBORS> half_neighbors (neigh_scheme, num_half_neighbors);
       /* Compute the half face neighbors of element at this face */
-      neighbor_tree = t8_forest_element_half_face_neighbors (forest_from, ltree_id, element, half_neighbors,
+      neighbor_tree = t8_forest_element_half_face_neighbors (forest_from, ltree_id, element, half_neighbors.data (),
                                                              neigh_scheme, iface, num_half_neighbors, NULL);
       if (neighbor_tree >= 0) {
         /* The face neighbors do exist, check for each one, whether it has
@@ -81,17 +121,11 @@ t8_forest_balance_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_
         for (ineigh = 0; ineigh < num_half_neighbors; ineigh++) {
           if (t8_forest_element_has_leaf_desc (forest_from, neighbor_tree, half_neighbors[ineigh], neigh_scheme)) {
             /* This element should be refined */
-            *pdone = 0;
-            /* clean-up */
-            neigh_scheme->t8_element_destroy (num_half_neighbors, half_neighbors);
-            T8_FREE (half_neighbors);
+            t8_forest_balance_element_refined (forest_from, ltree_id, element, ts, balance_data);
             return 1;
           }
         }
       }
-      /* clean-up */
-      neigh_scheme->t8_element_destroy (num_half_neighbors, half_neighbors);
-      T8_FREE (half_neighbors);
     }
   }
 
@@ -102,37 +136,104 @@ t8_forest_balance_adapt (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_
 static void
 t8_forest_compute_max_element_level (t8_forest_t forest)
 {
-  t8_locidx_t ielement, elem_in_tree;
-  t8_locidx_t itree, num_trees;
-  t8_eclass_scheme_c *scheme;
-  int local_max_level = 0, elem_level;
+  int local_max_level = 0;
+
+  /* Iterate over all local elements and compute the maximum occurring level */
+  t8_forest_for_each_element (forest, [&local_max_level] (const auto *scheme, t8_locidx_t ltreeid,
+                                                          t8_locidx_t ielement, t8_locidx_t element_index,
+                                                          const t8_element_t *element) {
+    local_max_level = SC_MAX (local_max_level, scheme->t8_element_level (element));
+  });
+  /* Communicate the local maximum levels */
+  sc_MPI_Allreduce (&local_max_level, &forest->maxlevel_existing, 1, sc_MPI_INT, sc_MPI_MAX, forest->mpicomm);
+}
 
-  /* Iterate over all local trees and all local elements and comupte the maximum occurring level */
-  num_trees = t8_forest_get_num_local_trees (forest);
-  for (itree = 0; itree < num_trees; itree++) {
-    elem_in_tree = t8_forest_get_tree_num_elements (forest, itree);
-    scheme = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
-    for (ielement = 0; ielement < elem_in_tree; ielement++) {
-      /* Get the element and compute its level */
-      const t8_element_t *elem = t8_forest_get_element_in_tree (forest, itree, ielement);
-      elem_level = scheme->t8_element_level (elem);
-      local_max_level = SC_MAX (local_max_level, elem_level);
+/* Perform one adapt pass of balance of \a forest from forest_from.
+ * All elements are refined recursively until they are balanced with respect to
+ * the local and ghost leaves of forest_from.
+ * On output \a balance_data->done is 0 if any local element was refined and 1 otherwise.
+ * \a balance_data->boundary_refined is set to true if a refined element has a neighbor
+ * on another process and left unchanged otherwise.
+ * If profiling is enabled, the timers of the pass are merged into \a forest.
+ * This function takes ownership of a reference of forest_from. */
+static t8_forest_t
+t8_forest_balance_pass (t8_forest_t forest, t8_forest_t forest_from, t8_forest_balance_data_t *balance_data,
+                        int profiling, double *adapt_runtime)
+{
+  t8_forest_t forest_pass;
+
+  balance_data->done = 1;
+  T8_ASSERT (forest_from->maxlevel_existing >= 0);
+  if (forest_from->mpisize > 1) {
+    /* The owners of refined elements are looked up in forest_from during adapt.
+     * Since not every process refines, we create the collective partition offsets beforehand. */
+    if (forest_from->tree_offsets == NULL) {
+      t8_forest_partition_create_tree_offsets (forest_from);
+    }
+    if (forest_from->global_first_desc == NULL) {
+      t8_forest_partition_create_first_desc (forest_from);
     }
   }
-  /* Communicate the local maximum levels */
-  sc_MPI_Allreduce (&local_max_level, &forest->maxlevel_existing, 1, sc_MPI_INT, sc_MPI_MAX, forest->mpicomm);
+  t8_forest_init (&forest_pass);
+  /* Update the maximum occurring level */
+  forest_pass->maxlevel_existing = forest_from->maxlevel_existing;
+  t8_forest_set_adapt (forest_pass, forest_from, t8_forest_balance_adapt, 1);
+  forest_pass->t8code_data = balance_data;
+  /* If profiling is enabled, measure the adapt rumtime */
+  if (profiling) {
+    t8_forest_set_profiling (forest_pass, 1);
+  }
+  t8_forest_commit (forest_pass);
+  if (profiling) {
+    *adapt_runtime = forest_pass->profile->adapt_runtime;
+    t8_forest_timers_merge (forest, forest_pass);
+  }
+  return forest_pass;
 }
 
+/* Grow the statistics arrays of balance such that they can store
+ * at least num_stats + 1 entries (the extra entry is required for the total sum). */
+static void
+t8_forest_balance_grow_stats (const int num_stats, int *num_stats_allocated, sc_statinfo_t **adap_stats,
+                              sc_statinfo_t **ghost_stats, sc_statinfo_t **partition_stats)
+{
+  const int stat_alloc_chunk_size = 10; /* How many stats we add if we need more */
+
+  if (num_stats + 1 < *num_stats_allocated) {
+    return;
+  }
+  *num_stats_allocated += stat_alloc_chunk_size;
+  *adap_stats = T8_REALLOC (*adap_stats, sc_statinfo_t, *num_stats_allocated);
+  *ghost_stats = T8_REALLOC (*ghost_stats, sc_statinfo_t, *num_stats_allocated);
+  if (*partition_stats != NULL) {
+    *partition_stats = T8_REALLOC (*partition_stats, sc_statinfo_t, *num_stats_allocated);
+  }
+}
+
+/* Balance a forest in rounds. Each round consists of
+ *  - one adapt pass with respect to the local and ghost leaves. Since we refine
+ *    recursively, all level differences to the existing leaves are resolved at once.
+ *  - further adapt passes without ghost layer until the ripple effect of the new
+ *    elements is resolved on each process. These passes only need the collective
+ *    element count of commit and no neighbor communication.
+ *  - one ghost exchange (and optionally a partition) to make the new elements
+ *    at the process boundaries known.
+ * Thus, another round is only needed if the refinement ripples across a process
+ * boundary and the number of rounds does not depend on the level differences
+ * in the forest. If no process refined an element at a process boundary, the
+ * ghost layers do not change and we stop without a confirming round. */
 void
 t8_forest_balance (t8_forest_t forest, int repartition)
 {
   t8_forest_t forest_temp, forest_from, forest_partition;
-  int done = 0, done_global = 0;
-  int count_rounds = 0;
+  t8_forest_balance_data_t balance_data;
+  int done_global = 0, boundary_refined_global = 0;
+  int count_rounds = 0, count_local_passes = 0;
+  const int profiling = forest->profile != NULL;
   /* The following variables are only required if profiling is
    * enabled. */
   int num_stats_allocated, istats;
-  const int stat_alloc_chunk_size = 10; /* How many stats we allocate (and add if we need more) */
+  const int stat_alloc_chunk_size = 10; /* How many stats we allocate initially */
   int count_adapt_stats = 0, count_ghost_stats = 0;
   int count_partition_stats = 0;
   double ada_time, ghost_time, part_time;
@@ -144,14 +245,16 @@ t8_forest_balance (t8_forest_t forest, int repartition)
 
   /* Set default value to prevent compiler warning */
   adap_stats = ghost_stats = partition_stats = NULL;
+  num_stats_allocated = 0;
+  ada_time = 0;
 
-  if (forest->profile != NULL) {
+  if (profiling) {
     /* Profiling is enable, so we measure the runtime of balance */
     forest->profile->balance_runtime = -sc_MPI_Wtime ();
     /* We store the individual adapt, ghost, and partition runtimes */
-    /* We reserve memory for stat_alloc_chunk_size - 1 many balance rounds
+    /* We reserve memory for stat_alloc_chunk_size - 1 many adapt passes
      * (the extra entry is required for the total sum).
-     * We will grow the statistics arrays dynamically if more rounds are required. */
+     * We will grow the statistics arrays dynamically if more passes are required. */
     T8_ASSERT (stat_alloc_chunk_size > 0);
     num_stats_allocated = stat_alloc_chunk_size;
     adap_stats = T8_ALLOC_ZERO (sc_statinfo_t, num_stats_allocated);
@@ -160,6 +263,7 @@ t8_forest_balance (t8_forest_t forest, int repartition)
       partition_stats = T8_ALLOC_ZERO (sc_statinfo_t, num_stats_allocated);
     }
   }
+  t8_forest_profile_timer_start (forest, "balance");
 
   /* Compute the maximum occurring refinement level in the forest */
   t8_forest_compute_max_element_level (forest->set_from);
@@ -174,83 +278,102 @@ t8_forest_balance (t8_forest_t forest, int repartition)
     t8_forest_ghost_create_topdown (forest->set_from);
   }
 
-  while (!done_global) {
-    done = 1;
-
-    T8_ASSERT (forest_from->maxlevel_existing >= 0);
-    /* Initialize the temp forest to be adapted from forest_from */
-    t8_forest_init (&forest_temp);
-    /* Update the maximum occurring level */
-    forest_temp->maxlevel_existing = forest_from->maxlevel_existing;
-    /* Adapt the forest */
-    t8_forest_set_adapt (forest_temp, forest_from, t8_forest_balance_adapt, 0);
-    if (!repartition) {
-      t8_forest_set_ghost (forest_temp, 1, T8_GHOST_FACES);
-    }
-    forest_temp->t8code_data = &done;
-    /* If profiling is enabled, measure ghost/adapt rumtimes */
-    if (forest->profile != NULL) {
-      t8_forest_set_profiling (forest_temp, 1);
-    }
-    t8_global_productionf ("Profiling: %i\n", forest->profile != NULL);
-    /* Adapt the forest */
-    t8_forest_commit (forest_temp);
-    /* Store the runtimes of adapt and ghost */
-    if (forest->profile != NULL) {
-      if (count_rounds > num_stats_allocated - 2) {
-        T8_ASSERT (count_adapt_stats <= count_rounds);
-        T8_ASSERT (count_ghost_stats <= count_rounds);
-        T8_ASSERT (count_partition_stats <= count_rounds);
-        /* re-allocate memory for stats */
-        num_stats_allocated += stat_alloc_chunk_size;
-        adap_stats = T8_REALLOC (adap_stats, sc_statinfo_t, num_stats_allocated);
-        ghost_stats = T8_REALLOC (ghost_stats, sc_statinfo_t, num_stats_allocated);
-        if (repartition) {
-          partition_stats = T8_REALLOC (partition_stats, sc_statinfo_t, num_stats_allocated);
-        }
-      }
-      sc_stats_set1 (&adap_stats[count_adapt_stats], forest_temp->profile->adapt_runtime, "forest balance: Adapt time");
+  for (;;) {
+    t8_forest_profile_timer_start (forest, "round");
+    /* forest_from has a ghost layer. Balance all elements with respect to
+     * the local and ghost leaves of forest_from. */
+    balance_data.boundary_refined = 0;
+    forest_temp = t8_forest_balance_pass (forest, forest_from, &balance_data, profiling, &ada_time);
+    count_rounds++;
+    if (profiling) {
+      t8_forest_balance_grow_stats (count_adapt_stats, &num_stats_allocated, &adap_stats, &ghost_stats,
+                                    &partition_stats);
+      sc_stats_set1 (&adap_stats[count_adapt_stats], ada_time, "forest balance: Adapt time");
       count_adapt_stats++;
-      if (!repartition) {
-        sc_stats_set1 (&ghost_stats[count_ghost_stats], forest_temp->profile->ghost_runtime,
-                       "forest balance: Ghost time");
-        count_ghost_stats++;
-      }
     }
-
     /* Compute the logical and of all process local done values, if this results
      * in 1 then all processes are finished */
-    sc_MPI_Allreduce (&done, &done_global, 1, sc_MPI_INT, sc_MPI_LAND, forest->mpicomm);
+    sc_MPI_Allreduce (&balance_data.done, &done_global, 1, sc_MPI_INT, sc_MPI_LAND, forest->mpicomm);
+    if (done_global) {
+      /* No element was refined, forest_temp is balanced */
+      t8_forest_profile_timer_stop (forest, "round");
+      break;
+    }
 
-    if (repartition && !done_global) {
+    /* Resolve the ripple effect of the new elements without ghost layer.
+     * Neighbors on other processes are considered again in the next round. */
+    do {
+      forest_from = forest_temp;
+      forest_temp = t8_forest_balance_pass (forest, forest_from, &balance_data, profiling, &ada_time);
+      count_local_passes++;
+      if (profiling) {
+        t8_forest_balance_grow_stats (count_adapt_stats, &num_stats_allocated, &adap_stats, &ghost_stats,
+                                      &partition_stats);
+        sc_stats_set1 (&adap_stats[count_adapt_stats], ada_time, "forest balance: Adapt time");
+        count_adapt_stats++;
+      }
+      sc_MPI_Allreduce (&balance_data.done, &done_global, 1, sc_MPI_INT, sc_MPI_LAND, forest->mpicomm);
+    } while (!done_global);
+
+    /* If no element at a process boundary was refined, the other processes
+     * are already balanced against our new elements and forest_temp is balanced. */
+    sc_MPI_Allreduce (&balance_data.boundary_refined, &boundary_refined_global, 1, sc_MPI_INT, sc_MPI_LOR,
+                      forest->mpicomm);
+
+    /* Exchange the new elements at the process boundaries */
+    if (profiling) {
+      t8_forest_balance_grow_stats (SC_MAX (count_ghost_stats, count_partition_stats), &num_stats_allocated,
+                                    &adap_stats, &ghost_stats, &partition_stats);
+    }
+    if (repartition) {
       /* If repartitioning is used, we partition the forest */
       t8_forest_init (&forest_partition);
       /* Update the maximum occurring level */
       forest_partition->maxlevel_existing = forest_temp->maxlevel_existing;
       t8_forest_set_partition (forest_partition, forest_temp, 0);
-      t8_forest_set_ghost (forest_partition, 1, T8_GHOST_FACES);
+      if (boundary_refined_global) {
+        t8_forest_set_ghost (forest_partition, 1, T8_GHOST_FACES);
+      }
+      t8_forest_set_compact_transfer (forest_partition, forest->compact_transfer);
       /* If profiling is enabled, measure partition rumtimes */
-      if (forest->profile != NULL) {
+      if (profiling) {
         t8_forest_set_profiling (forest_partition, 1);
       }
       t8_forest_commit (forest_partition);
 
       /* Store the runtimes of partition */
-      if (forest->profile != NULL) {
+      if (profiling) {
         sc_stats_set1 (&partition_stats[count_partition_stats], forest_partition->profile->partition_runtime,
                        "forest balance: Partition time");
         count_partition_stats++;
         sc_stats_set1 (&ghost_stats[count_ghost_stats], forest_partition->profile->ghost_runtime,
                        "forest balance: Ghost time");
         count_ghost_stats++;
+        /* Collect the partition and ghost timers of this round */
+        t8_forest_timers_merge (forest, forest_partition);
       }
 
       forest_temp = forest_partition;
       forest_partition = NULL;
     }
-    /* Adapt forest_temp in the next round */
+    else if (boundary_refined_global) {
+      ghost_time = -sc_MPI_Wtime ();
+      forest_temp->ghost_type = T8_GHOST_FACES;
+      forest_temp->compact_transfer = forest->compact_transfer;
+      t8_forest_ghost_create_topdown (forest_temp);
+      ghost_time += sc_MPI_Wtime ();
+      if (profiling) {
+        sc_stats_set1 (&ghost_stats[count_ghost_stats], ghost_time, "forest balance: Ghost time");
+        count_ghost_stats++;
+      }
+    }
+    t8_forest_profile_timer_stop (forest, "round");
+    if (!boundary_refined_global) {
+      /* The next round would not refine any element */
+      break;
+    }
+    /* Balance forest_temp in the next round */
     forest_from = forest_temp;
-    count_rounds++;
   }
 
   T8_ASSERT (t8_forest_is_balanced (forest_temp));
@@ -261,11 +384,13 @@ t8_forest_balance (t8_forest_t forest, int repartition)
   t8_log_indent_pop ();
   t8_global_productionf ("Done t8_forest_balance with %lli global elements.\n",
                          (long long) t8_forest_get_global_num_elements (forest_temp));
-  t8_debugf ("t8_forest_balance needed %i rounds.\n", count_rounds);
+  t8_debugf ("t8_forest_balance needed %i rounds and %i local passes.\n", count_rounds, count_local_passes);
   /* clean-up */
   t8_forest_unref (&forest_temp);
+  t8_forest_profile_timer_stop (forest, "balance");
+  t8_forest_profile_count (forest, "rounds", count_rounds);
 
-  if (forest->profile != NULL) {
+  if (profiling) {
     /* Profiling is enabled, so we measure the runtime of balance. */
     forest->profile->balance_runtime += sc_MPI_Wtime ();
     forest->profile->balance_rounds = count_rounds;
@@ -290,7 +415,7 @@ t8_forest_balance (t8_forest_t forest, int repartition)
     }
 
     /* Compute and print the intermediate stats */
-    T8_ASSERT (count_rounds + 1 <= num_stats_allocated);
+    T8_ASSERT (count_adapt_stats + 1 <= num_stats_allocated);
     sc_stats_compute (forest->mpicomm, count_adapt_stats + 1, adap_stats);
     sc_stats_compute (forest->mpicomm, count_ghost_stats + 1, ghost_stats);
     if (repartition) {
@@ -318,7 +443,7 @@ t8_forest_is_balanced (t8_forest_t forest)
   t8_locidx_t itree, ielem;
   t8_eclass_scheme_c *ts;
   void *data_temp;
-  int dummy_int;
+  t8_forest_balance_data_t dummy_data;
 
   T8_ASSERT (t8_forest_is_committed (forest));
 
@@ -329,7 +454,10 @@ t8_forest_is_balanced (t8_forest_t forest)
 
   /* temporarily save forest t8code_data */
   data_temp = forest->t8code_data;
-  forest->t8code_data = &dummy_int;
+  dummy_data.done = 1;
+  /* is_balanced is not collective, thus we do not look up the owners of refined elements */
+  dummy_data.boundary_refined = 1;
+  forest->t8code_data = &dummy_data;
 
   num_trees = t8_forest_get_num_local_trees (forest);
   /* Iterate over all trees */
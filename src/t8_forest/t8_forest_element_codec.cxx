@@ -0,0 +1,135 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest/t8_forest_element_codec.hxx>
+
+/* The maximum number of bytes of a 64 bit integer in variable length encoding */
+#define T8_ELEMENT_CODEC_MAX_VARINT_BYTES 10
+
+/* Return the element at position ielem of a contiguous element array */
+static inline const t8_element_t *
+t8_forest_element_codec_index (const t8_element_t *elements, const size_t element_size, const size_t ielem)
+{
+  return (const t8_element_t *) ((const char *) elements + ielem * element_size);
+}
+
+/* Write a signed integer in zigzag and variable length encoding.
+ * Returns the number of bytes written. */
+static inline size_t
+t8_forest_element_codec_write (char *buffer, const int64_t value)
+{
+  uint64_t zigzag = ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+  size_t num_bytes = 0;
+  while (zigzag >= 0x80) {
+    buffer[num_bytes++] = (char) ((zigzag & 0x7f) | 0x80);
+    zigzag >>= 7;
+  }
+  buffer[num_bytes++] = (char) zigzag;
+  return num_bytes;
+}
+
+/* Read a signed integer written by t8_forest_element_codec_write.
+ * Returns the number of bytes read. */
+static inline size_t
+t8_forest_element_codec_read (const char *buffer, int64_t *value)
+{
+  uint64_t zigzag = 0;
+  size_t num_bytes = 0;
+  int shift = 0;
+  uint8_t byte;
+  do {
+    T8_ASSERT (num_bytes < T8_ELEMENT_CODEC_MAX_VARINT_BYTES);
+    byte = (uint8_t) buffer[num_bytes++];
+    zigzag |= (uint64_t) (byte & 0x7f) << shift;
+    shift += 7;
+  } while (byte & 0x80);
+  *value = (int64_t) (zigzag >> 1) ^ -(int64_t) (zigzag & 1);
+  return num_bytes;
+}
+
+/* Return the maximum number of bytes that one element of a scheme needs in the encoding. */
+static size_t
+t8_forest_element_codec_element_bound (const t8_eclass_scheme_c *ts)
+{
+  /* The linear ids at the maximum level have at most dim * maxlevel bits. We add two bits,
+   * since a pyramid has more descendants than a hex, and one bit for the sign of the delta. */
+  const int num_bits
+    = SC_MIN (t8_eclass_to_dimension[ts->eclass] * ts->t8_element_maxlevel () + 3, 8 * (int) sizeof (uint64_t));
+  /* One byte for the level and the delta of the linear id in variable length encoding */
+  return 1 + (num_bits + 6) / 7;
+}
+
+size_t
+t8_forest_element_encode_bound (const t8_eclass_scheme_c *ts, const size_t num_elements)
+{
+  return num_elements * t8_forest_element_codec_element_bound (ts);
+}
+
+int
+t8_forest_element_codec_is_compact (const t8_eclass_scheme_c *ts)
+{
+  return t8_forest_element_codec_element_bound (ts) < ts->t8_element_size ();
+}
+
+size_t
+t8_forest_element_encode (const t8_eclass_scheme_c *ts, const t8_element_t *elements, const size_t num_elements,
+                          char *buffer)
+{
+  const size_t element_size = ts->t8_element_size ();
+  const t8_element_t *previous = NULL;
+  size_t num_bytes = 0;
+
+  for (size_t ielem = 0; ielem < num_elements; ielem++) {
+    const t8_element_t *element = t8_forest_element_codec_index (elements, element_size, ielem);
+    const int level = ts->t8_element_level (element);
+    T8_ASSERT (0 <= level && level <= UINT8_MAX);
+    const t8_linearidx_t id = ts->t8_element_get_linear_id (element, level);
+    /* The previous element at the same level is a good prediction of the id,
+     * since the elements are usually in space-filling curve order. */
+    const t8_linearidx_t predicted = previous != NULL ? ts->t8_element_get_linear_id (previous, level) : 0;
+    buffer[num_bytes++] = (char) level;
+    num_bytes += t8_forest_element_codec_write (buffer + num_bytes, (int64_t) (id - predicted));
+    previous = element;
+  }
+  T8_ASSERT (num_bytes <= t8_forest_element_encode_bound (ts, num_elements));
+  return num_bytes;
+}
+
+size_t
+t8_forest_element_decode (const t8_eclass_scheme_c *ts, const char *buffer, const size_t num_elements,
+                          t8_element_t *elements)
+{
+  const size_t element_size = ts->t8_element_size ();
+  const t8_element_t *previous = NULL;
+  size_t num_bytes = 0;
+
+  for (size_t ielem = 0; ielem < num_elements; ielem++) {
+    t8_element_t *element = (t8_element_t *) t8_forest_element_codec_index (elements, element_size, ielem);
+    const int level = (uint8_t) buffer[num_bytes++];
+    int64_t delta;
+    num_bytes += t8_forest_element_codec_read (buffer + num_bytes, &delta);
+    const t8_linearidx_t predicted = previous != NULL ? ts->t8_element_get_linear_id (previous, level) : 0;
+    ts->t8_element_set_linear_id (element, level, predicted + (t8_linearidx_t) delta);
+    previous = element;
+  }
+  return num_bytes;
+}
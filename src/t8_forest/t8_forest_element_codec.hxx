@@ -0,0 +1,79 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_forest_element_codec.hxx
+ * A compact encoding of elements for sending them to other processes.
+ * Instead of the full element structs, each element is stored as its level and
+ * its linear id at that level. The linear id is delta coded against the previous
+ * element of the same sequence and written as a variable length integer.
+ * For elements that are in space-filling curve order, this needs only a few bytes
+ * per element. The encoding only uses \ref t8_eclass_scheme::t8_element_get_linear_id
+ * and \ref t8_eclass_scheme::t8_element_set_linear_id of the scheme.
+ */
+
+#ifndef T8_FOREST_ELEMENT_CODEC_HXX
+#define T8_FOREST_ELEMENT_CODEC_HXX
+
+#include <t8.h>
+#include <t8_element.hxx>
+
+/** Return an upper bound for the number of bytes that encoding a number of elements needs.
+ * \param [in] ts           The scheme of the elements.
+ * \param [in] num_elements The number of elements.
+ * \return                  The maximum number of bytes that \ref t8_forest_element_encode writes.
+ */
+size_t
+t8_forest_element_encode_bound (const t8_eclass_scheme_c *ts, const size_t num_elements);
+
+/** Query whether the encoding of the elements of a scheme is always smaller than the elements.
+ * This is not the case for elements that are only a few bytes large, such as vertices.
+ * Such elements should be sent unencoded even if the forest uses compact transfer.
+ * \param [in] ts           The scheme of the elements.
+ * \return                  True if \ref t8_forest_element_encode_bound for one element is
+ *                          smaller than the size of an element.
+ */
+int
+t8_forest_element_codec_is_compact (const t8_eclass_scheme_c *ts);
+
+/** Encode a contiguous array of elements.
+ * \param [in]  ts           The scheme of the elements.
+ * \param [in]  elements     An array of \a num_elements elements of \a ts.
+ * \param [in]  num_elements The number of elements to encode.
+ * \param [out] buffer       A buffer of at least \ref t8_forest_element_encode_bound (\a num_elements) bytes.
+ * \return                   The number of bytes written to \a buffer.
+ */
+size_t
+t8_forest_element_encode (const t8_eclass_scheme_c *ts, const t8_element_t *elements, const size_t num_elements,
+                          char *buffer);
+
+/** Decode elements that were encoded with \ref t8_forest_element_encode.
+ * \param [in]  ts           The scheme of the elements.
+ * \param [in]  buffer       The encoded elements.
+ * \param [in]  num_elements The number of elements to decode.
+ * \param [out] elements     An array of \a num_elements initialized elements of \a ts.
+ * \return                   The number of bytes read from \a buffer.
+ */
+size_t
+t8_forest_element_decode (const t8_eclass_scheme_c *ts, const char *buffer, const size_t num_elements,
+                          t8_element_t *elements);
+
+#endif /* !T8_FOREST_ELEMENT_CODEC_HXX */
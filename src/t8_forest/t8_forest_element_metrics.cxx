@@ -0,0 +1,298 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest/t8_forest_element_metrics.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_geometrical.h>
+#include <t8_forest/t8_forest_ghost.h>
+#include <t8_forest/t8_forest_iterate.h>
+#include <t8_forest/t8_forest_private.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_element.hxx>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* Compute the metrics of one element with the geometry of the forest and
+ * store them at position index. */
+static void
+t8_forest_element_metrics_compute (t8_forest_t forest, const t8_locidx_t ltreeid, const t8_element_t *element,
+                                   const t8_locidx_t index)
+{
+  t8_forest_element_metrics_t *metrics = forest->element_metrics;
+  const t8_locidx_t num_elements = metrics->num_elements;
+  const t8_locidx_t num_faces = metrics->num_faces;
+  const t8_locidx_t first_face = metrics->face_offsets[index];
+  double centroid[3], normal[3];
+
+  metrics->volumes[index] = t8_forest_element_volume (forest, ltreeid, element);
+  t8_forest_element_centroid (forest, ltreeid, element, centroid);
+  for (int icomp = 0; icomp < 3; ++icomp) {
+    metrics->centroids[icomp * num_elements + index] = centroid[icomp];
+  }
+  for (int iface = 0; iface < metrics->face_offsets[index + 1] - first_face; ++iface) {
+    metrics->face_areas[first_face + iface] = t8_forest_element_face_area (forest, ltreeid, element, iface);
+    t8_forest_element_face_normal (forest, ltreeid, element, iface, normal);
+    for (int icomp = 0; icomp < 3; ++icomp) {
+      metrics->face_normals[icomp * num_faces + first_face + iface] = normal[icomp];
+    }
+  }
+}
+
+/* Copy the metrics of an element from the metrics of forest_from. */
+static void
+t8_forest_element_metrics_copy (t8_forest_t forest, const t8_forest_t forest_from, const t8_locidx_t index,
+                                const t8_locidx_t index_from)
+{
+  t8_forest_element_metrics_t *metrics = forest->element_metrics;
+  const t8_forest_element_metrics_t *metrics_from = forest_from->element_metrics;
+  const t8_locidx_t first_face = metrics->face_offsets[index];
+  const t8_locidx_t first_face_from = metrics_from->face_offsets[index_from];
+  const t8_locidx_t num_element_faces = metrics->face_offsets[index + 1] - first_face;
+
+  T8_ASSERT (num_element_faces == metrics_from->face_offsets[index_from + 1] - first_face_from);
+
+  metrics->volumes[index] = metrics_from->volumes[index_from];
+  for (int icomp = 0; icomp < 3; ++icomp) {
+    metrics->centroids[icomp * metrics->num_elements + index]
+      = metrics_from->centroids[icomp * metrics_from->num_elements + index_from];
+  }
+  memcpy (metrics->face_areas + first_face, metrics_from->face_areas + first_face_from,
+          num_element_faces * sizeof (double));
+  for (int icomp = 0; icomp < 3; ++icomp) {
+    memcpy (metrics->face_normals + icomp * metrics->num_faces + first_face,
+            metrics_from->face_normals + icomp * metrics_from->num_faces + first_face_from,
+            num_element_faces * sizeof (double));
+  }
+}
+
+/* The replace callback for t8_forest_iterate_replace. Unchanged elements are copied,
+ * the metrics of new elements are computed. */
+static void
+t8_forest_element_metrics_replace (t8_forest_t forest_old, t8_forest_t forest_new, t8_locidx_t which_tree,
+                                   t8_eclass_scheme_c *ts, const int refine, const int num_outgoing,
+                                   const t8_locidx_t first_outgoing, const int num_incoming,
+                                   const t8_locidx_t first_incoming)
+{
+  const t8_locidx_t offset_new = t8_forest_get_tree_element_offset (forest_new, which_tree);
+
+  if (refine == 0) {
+    T8_ASSERT (num_outgoing == 1 && num_incoming == 1);
+    const t8_locidx_t offset_old = t8_forest_get_tree_element_offset (forest_old, which_tree);
+    t8_forest_element_metrics_copy (forest_new, forest_old, offset_new + first_incoming, offset_old + first_outgoing);
+    return;
+  }
+  for (t8_locidx_t ielem = first_incoming; ielem < first_incoming + num_incoming; ++ielem) {
+    const t8_element_t *element = t8_forest_get_element_in_tree (forest_new, which_tree, ielem);
+    t8_forest_element_metrics_compute (forest_new, which_tree, element, offset_new + ielem);
+  }
+}
+
+void
+t8_forest_element_metrics_build (t8_forest_t forest, const t8_forest_t forest_from)
+{
+  t8_forest_element_metrics_t *metrics;
+  const t8_locidx_t num_local_elements = t8_forest_get_local_num_elements (forest);
+  const t8_locidx_t num_trees = t8_forest_get_num_local_trees (forest);
+  const t8_locidx_t num_ghost_trees = t8_forest_ghost_num_trees (forest);
+  t8_locidx_t lelement_id;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (forest->element_metrics == NULL);
+
+  t8_global_productionf ("Into t8_forest_element_metrics_build\n");
+
+  metrics = forest->element_metrics = T8_ALLOC_ZERO (t8_forest_element_metrics_t, 1);
+  metrics->num_local_elements = num_local_elements;
+  metrics->num_elements = num_local_elements + t8_forest_get_num_ghosts (forest);
+
+  /* Count the faces of all local leaves and ghosts */
+  metrics->face_offsets = T8_ALLOC (t8_locidx_t, metrics->num_elements + 1);
+  metrics->face_offsets[0] = 0;
+  lelement_id = 0;
+  for (t8_locidx_t itree = 0; itree < num_trees; ++itree) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    const t8_locidx_t num_tree_elements = t8_forest_get_tree_num_elements (forest, itree);
+    for (t8_locidx_t ielem = 0; ielem < num_tree_elements; ++ielem, ++lelement_id) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielem);
+      metrics->face_offsets[lelement_id + 1] = metrics->face_offsets[lelement_id] + ts->t8_element_num_faces (element);
+    }
+  }
+  T8_ASSERT (lelement_id == num_local_elements);
+  for (t8_locidx_t ighost_tree = 0; ighost_tree < num_ghost_trees; ++ighost_tree) {
+    t8_eclass_scheme_c *ts
+      = t8_forest_get_eclass_scheme (forest, t8_forest_ghost_get_tree_class (forest, ighost_tree));
+    const t8_element_array_t *ghosts = t8_forest_ghost_get_tree_elements (forest, ighost_tree);
+    const t8_locidx_t num_tree_ghosts = t8_forest_ghost_tree_num_elements (forest, ighost_tree);
+    for (t8_locidx_t ighost = 0; ighost < num_tree_ghosts; ++ighost, ++lelement_id) {
+      const t8_element_t *ghost = t8_element_array_index_locidx (ghosts, ighost);
+      metrics->face_offsets[lelement_id + 1] = metrics->face_offsets[lelement_id] + ts->t8_element_num_faces (ghost);
+    }
+  }
+  T8_ASSERT (lelement_id == metrics->num_elements);
+  metrics->num_faces = metrics->face_offsets[metrics->num_elements];
+
+  metrics->volumes = T8_ALLOC (double, metrics->num_elements);
+  metrics->centroids = T8_ALLOC (double, 3 * metrics->num_elements);
+  metrics->face_areas = T8_ALLOC (double, metrics->num_faces);
+  metrics->face_normals = T8_ALLOC (double, 3 * metrics->num_faces);
+
+  if (forest_from != NULL && forest_from->element_metrics != NULL) {
+    /* Copy the metrics of the unchanged leaves and compute the others */
+    T8_ASSERT (t8_forest_get_num_local_trees (forest_from) == num_trees);
+    t8_forest_iterate_replace (forest, forest_from, t8_forest_element_metrics_replace);
+  }
+  else {
+    /* Compute the metrics of all local leaves in one pass */
+    lelement_id = 0;
+    for (t8_locidx_t itree = 0; itree < num_trees; ++itree) {
+      const t8_locidx_t num_tree_elements = t8_forest_get_tree_num_elements (forest, itree);
+      for (t8_locidx_t ielem = 0; ielem < num_tree_elements; ++ielem, ++lelement_id) {
+        const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielem);
+        t8_forest_element_metrics_compute (forest, itree, element, lelement_id);
+      }
+    }
+  }
+
+  /* The ghost layer is rebuilt with each forest, thus we always compute the ghost metrics.
+   * The ghost trees are addressed with local tree ids following the local trees. */
+  lelement_id = num_local_elements;
+  for (t8_locidx_t ighost_tree = 0; ighost_tree < num_ghost_trees; ++ighost_tree) {
+    const t8_element_array_t *ghosts = t8_forest_ghost_get_tree_elements (forest, ighost_tree);
+    const t8_locidx_t num_tree_ghosts = t8_forest_ghost_tree_num_elements (forest, ighost_tree);
+    for (t8_locidx_t ighost = 0; ighost < num_tree_ghosts; ++ighost, ++lelement_id) {
+      const t8_element_t *ghost = t8_element_array_index_locidx (ghosts, ighost);
+      t8_forest_element_metrics_compute (forest, num_trees + ighost_tree, ghost, lelement_id);
+    }
+  }
+
+  t8_global_productionf ("Done t8_forest_element_metrics_build\n");
+}
+
+void
+t8_forest_element_metrics_destroy (t8_forest_t forest)
+{
+  t8_forest_element_metrics_t *metrics;
+
+  T8_ASSERT (forest != NULL);
+  metrics = forest->element_metrics;
+  T8_ASSERT (metrics != NULL);
+
+  T8_FREE (metrics->volumes);
+  T8_FREE (metrics->centroids);
+  T8_FREE (metrics->face_offsets);
+  T8_FREE (metrics->face_areas);
+  T8_FREE (metrics->face_normals);
+  T8_FREE (metrics);
+  forest->element_metrics = NULL;
+}
+
+int
+t8_forest_has_element_metrics (const t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  return forest->element_metrics != NULL;
+}
+
+const double *
+t8_forest_element_metrics_get_volumes (const t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_has_element_metrics (forest));
+  return forest->element_metrics->volumes;
+}
+
+const double *
+t8_forest_element_metrics_get_centroids (const t8_forest_t forest, const int component)
+{
+  T8_ASSERT (t8_forest_has_element_metrics (forest));
+  T8_ASSERT (0 <= component && component < 3);
+  return forest->element_metrics->centroids + component * forest->element_metrics->num_elements;
+}
+
+const t8_locidx_t *
+t8_forest_element_metrics_get_face_offsets (const t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_has_element_metrics (forest));
+  return forest->element_metrics->face_offsets;
+}
+
+const double *
+t8_forest_element_metrics_get_face_areas (const t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_has_element_metrics (forest));
+  return forest->element_metrics->face_areas;
+}
+
+const double *
+t8_forest_element_metrics_get_face_normals (const t8_forest_t forest, const int component)
+{
+  T8_ASSERT (t8_forest_has_element_metrics (forest));
+  T8_ASSERT (0 <= component && component < 3);
+  return forest->element_metrics->face_normals + component * forest->element_metrics->num_faces;
+}
+
+double
+t8_forest_element_metrics_volume (const t8_forest_t forest, const t8_locidx_t lelement_id)
+{
+  T8_ASSERT (t8_forest_has_element_metrics (forest));
+  T8_ASSERT (0 <= lelement_id && lelement_id < forest->element_metrics->num_elements);
+  return forest->element_metrics->volumes[lelement_id];
+}
+
+void
+t8_forest_element_metrics_centroid (const t8_forest_t forest, const t8_locidx_t lelement_id, double centroid[3])
+{
+  const t8_forest_element_metrics_t *metrics = forest->element_metrics;
+
+  T8_ASSERT (t8_forest_has_element_metrics (forest));
+  T8_ASSERT (0 <= lelement_id && lelement_id < metrics->num_elements);
+  for (int icomp = 0; icomp < 3; ++icomp) {
+    centroid[icomp] = metrics->centroids[icomp * metrics->num_elements + lelement_id];
+  }
+}
+
+double
+t8_forest_element_metrics_face_area (const t8_forest_t forest, const t8_locidx_t lelement_id, const int face)
+{
+  const t8_forest_element_metrics_t *metrics = forest->element_metrics;
+
+  T8_ASSERT (t8_forest_has_element_metrics (forest));
+  T8_ASSERT (0 <= lelement_id && lelement_id < metrics->num_elements);
+  T8_ASSERT (0 <= face && face < metrics->face_offsets[lelement_id + 1] - metrics->face_offsets[lelement_id]);
+  return metrics->face_areas[metrics->face_offsets[lelement_id] + face];
+}
+
+void
+t8_forest_element_metrics_face_normal (const t8_forest_t forest, const t8_locidx_t lelement_id, const int face,
+                                       double normal[3])
+{
+  const t8_forest_element_metrics_t *metrics = forest->element_metrics;
+
+  T8_ASSERT (t8_forest_has_element_metrics (forest));
+  T8_ASSERT (0 <= lelement_id && lelement_id < metrics->num_elements);
+  T8_ASSERT (0 <= face && face < metrics->face_offsets[lelement_id + 1] - metrics->face_offsets[lelement_id]);
+  for (int icomp = 0; icomp < 3; ++icomp) {
+    normal[icomp] = metrics->face_normals[icomp * metrics->num_faces + metrics->face_offsets[lelement_id] + face];
+  }
+}
+
+T8_EXTERN_C_END ();
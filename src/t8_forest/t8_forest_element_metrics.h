@@ -0,0 +1,132 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_forest_element_metrics.h
+ * A cache of the geometric metrics of all local leaves and ghosts of a forest.
+ * The volumes, centroids, face areas and face normals are computed once in
+ * \ref t8_forest_commit if \ref t8_forest_set_element_metrics was called and stored
+ * in contiguous arrays indexed by the local element index.
+ * Afterwards they can be looked up without evaluating the geometry, in contrast to
+ * \ref t8_forest_element_volume, \ref t8_forest_element_centroid,
+ * \ref t8_forest_element_face_area and \ref t8_forest_element_face_normal.
+ * The cache is filled in one pass that calls these functions for each element in turn,
+ * the geometry is not evaluated for batches of elements.
+ */
+
+#ifndef T8_FOREST_ELEMENT_METRICS_H
+#define T8_FOREST_ELEMENT_METRICS_H
+
+#include <t8.h>
+#include <t8_forest/t8_forest_general.h>
+
+T8_EXTERN_C_BEGIN ();
+
+/** Query whether a forest has element metrics.
+ * \param [in] forest   A committed forest.
+ * \return              True if \ref t8_forest_set_element_metrics was set before committing \a forest.
+ */
+int
+t8_forest_has_element_metrics (const t8_forest_t forest);
+
+/** Return the volumes of all local leaves and ghosts.
+ * \param [in] forest   A committed forest with element metrics.
+ * \return              An array of num_local_elements + num_ghosts volumes.
+ *                      Valid as long as \a forest is.
+ */
+const double *
+t8_forest_element_metrics_get_volumes (const t8_forest_t forest);
+
+/** Return one component of the centroids of all local leaves and ghosts.
+ * \param [in] forest     A committed forest with element metrics.
+ * \param [in] component  The component, 0 <= \a component < 3.
+ * \return                An array of num_local_elements + num_ghosts coordinates.
+ *                        Valid as long as \a forest is.
+ */
+const double *
+t8_forest_element_metrics_get_centroids (const t8_forest_t forest, const int component);
+
+/** Return the face offsets of all local leaves and ghosts.
+ * The faces of element e are numbered offsets[e], ..., offsets[e + 1] - 1 in the
+ * arrays returned by \ref t8_forest_element_metrics_get_face_areas and
+ * \ref t8_forest_element_metrics_get_face_normals.
+ * \param [in] forest   A committed forest with element metrics.
+ * \return              An array of num_local_elements + num_ghosts + 1 offsets.
+ *                      Valid as long as \a forest is.
+ */
+const t8_locidx_t *
+t8_forest_element_metrics_get_face_offsets (const t8_forest_t forest);
+
+/** Return the face areas of all local leaves and ghosts.
+ * \param [in] forest   A committed forest with element metrics.
+ * \return              An array with the area of each face.
+ *                      Valid as long as \a forest is.
+ */
+const double *
+t8_forest_element_metrics_get_face_areas (const t8_forest_t forest);
+
+/** Return one component of the outward unit face normals of all local leaves and ghosts.
+ * \param [in] forest     A committed forest with element metrics.
+ * \param [in] component  The component, 0 <= \a component < 3.
+ * \return                An array with the \a component of the normal of each face.
+ *                        Valid as long as \a forest is.
+ */
+const double *
+t8_forest_element_metrics_get_face_normals (const t8_forest_t forest, const int component);
+
+/** Look up the volume of a local leaf or ghost.
+ * \param [in] forest       A committed forest with element metrics.
+ * \param [in] lelement_id  The local index of a leaf, or num_local_elements + the index of a ghost.
+ * \return                  The volume of the element, see \ref t8_forest_element_volume.
+ */
+double
+t8_forest_element_metrics_volume (const t8_forest_t forest, const t8_locidx_t lelement_id);
+
+/** Look up the centroid of a local leaf or ghost.
+ * \param [in]  forest       A committed forest with element metrics.
+ * \param [in]  lelement_id  The local index of a leaf, or num_local_elements + the index of a ghost.
+ * \param [out] centroid     On output the centroid of the element, see \ref t8_forest_element_centroid.
+ */
+void
+t8_forest_element_metrics_centroid (const t8_forest_t forest, const t8_locidx_t lelement_id, double centroid[3]);
+
+/** Look up the area of a face of a local leaf or ghost.
+ * \param [in] forest       A committed forest with element metrics.
+ * \param [in] lelement_id  The local index of a leaf, or num_local_elements + the index of a ghost.
+ * \param [in] face         A face of the element.
+ * \return                  The area of the face, see \ref t8_forest_element_face_area.
+ */
+double
+t8_forest_element_metrics_face_area (const t8_forest_t forest, const t8_locidx_t lelement_id, const int face);
+
+/** Look up the outward unit normal of a face of a local leaf or ghost.
+ * \param [in]  forest       A committed forest with element metrics.
+ * \param [in]  lelement_id  The local index of a leaf, or num_local_elements + the index of a ghost.
+ * \param [in]  face         A face of the element.
+ * \param [out] normal       On output the normal of the face, see \ref t8_forest_element_face_normal.
+ */
+void
+t8_forest_element_metrics_face_normal (const t8_forest_t forest, const t8_locidx_t lelement_id, const int face,
+                                       double normal[3]);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_ELEMENT_METRICS_H */
@@ -0,0 +1,306 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+#include <t8_forest/t8_forest_face_connectivity.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_private.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_data/t8_containers.h>
+#include <t8_element.hxx>
+
+/* We want to export the whole implementation to be callable from "C" */
+T8_EXTERN_C_BEGIN ();
+
+/* Return true if a local tree has exactly the same leaves in forest and forest_from. */
+static int
+t8_forest_face_connectivity_tree_unchanged (const t8_forest_t forest, const t8_forest_t forest_from,
+                                            const t8_locidx_t ltreeid)
+{
+  const sc_array_t *elements = t8_element_array_get_array (t8_forest_get_tree_element_array (forest, ltreeid));
+  const sc_array_t *elements_from
+    = t8_element_array_get_array (t8_forest_get_tree_element_array (forest_from, ltreeid));
+
+  if (elements->elem_count != elements_from->elem_count || elements->elem_size != elements_from->elem_size) {
+    return 0;
+  }
+  /* A byte-wise comparison may report equal elements as different, which only
+   * means that we recompute more than necessary. */
+  return memcmp (elements->array, elements_from->array, elements->elem_count * elements->elem_size) == 0;
+}
+
+/* Try to copy the connectivity of a leaf from the table of forest_from.
+ * This succeeds if all neighbors of the leaf are local leaves in unchanged trees.
+ * Returns true on success. */
+static int
+t8_forest_face_connectivity_copy_leaf (const t8_forest_t forest, const t8_forest_t forest_from,
+                                       const int8_t *tree_unchanged, const t8_locidx_t lelement_id,
+                                       const t8_locidx_t lelement_id_from, sc_array_t *neighbor_ids,
+                                       sc_array_t *dual_faces)
+{
+  const t8_forest_face_connectivity_t *conn_from = forest_from->face_connectivity;
+  t8_forest_face_connectivity_t *conn = forest->face_connectivity;
+  const t8_locidx_t first_face_from = conn_from->face_offsets[lelement_id_from];
+  const t8_locidx_t end_face_from = conn_from->face_offsets[lelement_id_from + 1];
+  const t8_locidx_t first_face = conn->face_offsets[lelement_id];
+  const size_t old_count = neighbor_ids->elem_count;
+
+  T8_ASSERT (end_face_from - first_face_from == conn->face_offsets[lelement_id + 1] - first_face);
+
+  for (t8_locidx_t iface = 0; iface < end_face_from - first_face_from; ++iface) {
+    const t8_locidx_t face_from = first_face_from + iface;
+    conn->neighbor_offsets[first_face + iface] = (t8_locidx_t) neighbor_ids->elem_count;
+    for (t8_locidx_t ineigh = conn_from->neighbor_offsets[face_from];
+         ineigh < conn_from->neighbor_offsets[face_from + 1]; ++ineigh) {
+      const t8_locidx_t neigh_from = conn_from->neighbor_ids[ineigh];
+      t8_locidx_t neigh_tree;
+      if (neigh_from >= forest_from->local_num_elements) {
+        /* The neighbor is a ghost. Since the ghost layer is rebuilt, we cannot reuse its index. */
+        neighbor_ids->elem_count = old_count;
+        dual_faces->elem_count = old_count;
+        return 0;
+      }
+      (void) t8_forest_get_element (forest_from, neigh_from, &neigh_tree);
+      if (!tree_unchanged[neigh_tree]) {
+        neighbor_ids->elem_count = old_count;
+        dual_faces->elem_count = old_count;
+        return 0;
+      }
+      /* The neighbor has the same position within its tree in both forests. */
+      *(t8_locidx_t *) sc_array_push (neighbor_ids)
+        = neigh_from - t8_forest_get_tree_element_offset (forest_from, neigh_tree)
+          + t8_forest_get_tree_element_offset (forest, neigh_tree);
+      *(int8_t *) sc_array_push (dual_faces) = conn_from->dual_faces[ineigh];
+    }
+    conn->orientations[first_face + iface] = conn_from->orientations[face_from];
+    conn->flags[first_face + iface] = conn_from->flags[face_from];
+  }
+  return 1;
+}
+
+/* Compute the connectivity of a leaf with t8_forest_leaf_face_neighbors_ext. */
+static void
+t8_forest_face_connectivity_compute_leaf (t8_forest_t forest, const t8_locidx_t ltreeid, const t8_element_t *leaf,
+                                          t8_eclass_scheme_c *ts, const t8_locidx_t lelement_id,
+                                          sc_array_t *neighbor_ids, sc_array_t *dual_faces)
+{
+  t8_forest_face_connectivity_t *conn = forest->face_connectivity;
+  const t8_locidx_t first_face = conn->face_offsets[lelement_id];
+  const int num_faces = conn->face_offsets[lelement_id + 1] - first_face;
+  const int level = ts->t8_element_level (leaf);
+
+  for (int iface = 0; iface < num_faces; ++iface) {
+    t8_element_t **neighbor_leaves;
+    t8_locidx_t *element_indices;
+    t8_eclass_scheme_c *neigh_scheme;
+    int *neigh_dual_faces;
+    int num_neighbors;
+    int orientation = 0;
+    int flags = T8_FACE_CONNECTIVITY_CONFORMING;
+
+    t8_forest_leaf_face_neighbors_ext (forest, ltreeid, leaf, &neighbor_leaves, iface, &neigh_dual_faces,
+                                       &num_neighbors, &element_indices, &neigh_scheme, 1, NULL, &orientation);
+    conn->neighbor_offsets[first_face + iface] = (t8_locidx_t) neighbor_ids->elem_count;
+    if (num_neighbors == 0) {
+      flags = T8_FACE_CONNECTIVITY_BOUNDARY;
+    }
+    else {
+      /* All neighbors have the same level, since the forest is balanced.
+       * A finer neighbor of a line is a single element, so we compare the levels. */
+      const int neigh_level = neigh_scheme->t8_element_level (neighbor_leaves[0]);
+      if (neigh_level > level) {
+        flags |= T8_FACE_CONNECTIVITY_FINER;
+      }
+      else if (neigh_level < level) {
+        flags |= T8_FACE_CONNECTIVITY_COARSER;
+      }
+      for (int ineigh = 0; ineigh < num_neighbors; ++ineigh) {
+        if (element_indices[ineigh] >= forest->local_num_elements) {
+          flags |= T8_FACE_CONNECTIVITY_GHOST;
+        }
+        *(t8_locidx_t *) sc_array_push (neighbor_ids) = element_indices[ineigh];
+        *(int8_t *) sc_array_push (dual_faces) = (int8_t) neigh_dual_faces[ineigh];
+      }
+      neigh_scheme->t8_element_destroy (num_neighbors, neighbor_leaves);
+      T8_FREE (neighbor_leaves);
+      T8_FREE (element_indices);
+      T8_FREE (neigh_dual_faces);
+    }
+    conn->orientations[first_face + iface] = (int8_t) orientation;
+    conn->flags[first_face + iface] = (int8_t) flags;
+  }
+}
+
+void
+t8_forest_face_connectivity_build (t8_forest_t forest, const t8_forest_t forest_from)
+{
+  t8_forest_face_connectivity_t *conn;
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  const t8_locidx_t num_trees = t8_forest_get_num_local_trees (forest);
+  int8_t *tree_unchanged = NULL;
+  sc_array_t neighbor_ids;
+  sc_array_t dual_faces;
+  t8_locidx_t lelement_id;
+  t8_locidx_t num_copied = 0;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (forest->face_connectivity == NULL);
+  SC_CHECK_ABORT (forest->mpisize == 1 || forest->ghosts != NULL,
+                  "A ghost layer is needed to build the face connectivity of a forest.\n");
+
+  t8_global_productionf ("Into t8_forest_face_connectivity_build\n");
+
+  conn = forest->face_connectivity = T8_ALLOC_ZERO (t8_forest_face_connectivity_t, 1);
+  conn->num_elements = num_elements;
+
+  /* Count the faces of all leaves */
+  conn->face_offsets = T8_ALLOC (t8_locidx_t, num_elements + 1);
+  conn->face_offsets[0] = 0;
+  lelement_id = 0;
+  for (t8_locidx_t itree = 0; itree < num_trees; ++itree) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    const t8_locidx_t num_tree_elements = t8_forest_get_tree_num_elements (forest, itree);
+    for (t8_locidx_t ielem = 0; ielem < num_tree_elements; ++ielem, ++lelement_id) {
+      const t8_element_t *leaf = t8_forest_get_element_in_tree (forest, itree, ielem);
+      conn->face_offsets[lelement_id + 1] = conn->face_offsets[lelement_id] + ts->t8_element_num_faces (leaf);
+    }
+  }
+  T8_ASSERT (lelement_id == num_elements);
+  conn->num_faces = conn->face_offsets[num_elements];
+  conn->neighbor_offsets = T8_ALLOC (t8_locidx_t, conn->num_faces + 1);
+  conn->orientations = T8_ALLOC (int8_t, conn->num_faces);
+  conn->flags = T8_ALLOC (int8_t, conn->num_faces);
+
+  /* Find the trees that did not change since forest_from */
+  if (forest_from != NULL && forest_from->face_connectivity != NULL
+      && t8_forest_get_num_local_trees (forest_from) == num_trees
+      && t8_forest_get_first_local_tree_id (forest_from) == t8_forest_get_first_local_tree_id (forest)) {
+    tree_unchanged = T8_ALLOC (int8_t, num_trees);
+    for (t8_locidx_t itree = 0; itree < num_trees; ++itree) {
+      tree_unchanged[itree] = t8_forest_face_connectivity_tree_unchanged (forest, forest_from, itree);
+    }
+  }
+
+  /* Each face has about one neighbor */
+  sc_array_init_size (&neighbor_ids, sizeof (t8_locidx_t), conn->num_faces);
+  sc_array_init_size (&dual_faces, sizeof (int8_t), conn->num_faces);
+  sc_array_truncate (&neighbor_ids);
+  sc_array_truncate (&dual_faces);
+
+  lelement_id = 0;
+  for (t8_locidx_t itree = 0; itree < num_trees; ++itree) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    const t8_locidx_t num_tree_elements = t8_forest_get_tree_num_elements (forest, itree);
+    for (t8_locidx_t ielem = 0; ielem < num_tree_elements; ++ielem, ++lelement_id) {
+      if (tree_unchanged != NULL && tree_unchanged[itree]
+          && t8_forest_face_connectivity_copy_leaf (forest, forest_from, tree_unchanged, lelement_id,
+                                                    t8_forest_get_tree_element_offset (forest_from, itree) + ielem,
+                                                    &neighbor_ids, &dual_faces)) {
+        num_copied++;
+        continue;
+      }
+      const t8_element_t *leaf = t8_forest_get_element_in_tree (forest, itree, ielem);
+      t8_forest_face_connectivity_compute_leaf (forest, itree, leaf, ts, lelement_id, &neighbor_ids, &dual_faces);
+    }
+  }
+  conn->num_neighbors = (t8_locidx_t) neighbor_ids.elem_count;
+  conn->neighbor_offsets[conn->num_faces] = conn->num_neighbors;
+
+  /* Take over the memory of the arrays */
+  conn->neighbor_ids = T8_ALLOC (t8_locidx_t, conn->num_neighbors);
+  conn->dual_faces = T8_ALLOC (int8_t, conn->num_neighbors);
+  if (conn->num_neighbors > 0) {
+    memcpy (conn->neighbor_ids, neighbor_ids.array, conn->num_neighbors * sizeof (t8_locidx_t));
+    memcpy (conn->dual_faces, dual_faces.array, conn->num_neighbors * sizeof (int8_t));
+  }
+  sc_array_reset (&neighbor_ids);
+  sc_array_reset (&dual_faces);
+  T8_FREE (tree_unchanged);
+
+  t8_global_productionf ("Done t8_forest_face_connectivity_build. Reused %li of %li leaves.\n", (long) num_copied,
+                         (long) num_elements);
+}
+
+void
+t8_forest_face_connectivity_destroy (t8_forest_t forest)
+{
+  t8_forest_face_connectivity_t *conn;
+
+  T8_ASSERT (forest != NULL);
+  conn = forest->face_connectivity;
+  T8_ASSERT (conn != NULL);
+
+  T8_FREE (conn->face_offsets);
+  T8_FREE (conn->neighbor_offsets);
+  T8_FREE (conn->neighbor_ids);
+  T8_FREE (conn->dual_faces);
+  T8_FREE (conn->orientations);
+  T8_FREE (conn->flags);
+  T8_FREE (conn);
+  forest->face_connectivity = NULL;
+}
+
+int
+t8_forest_has_face_connectivity (const t8_forest_t forest)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  return forest->face_connectivity != NULL;
+}
+
+int
+t8_forest_face_connectivity_num_faces (const t8_forest_t forest, const t8_locidx_t lelement_id)
+{
+  const t8_forest_face_connectivity_t *conn = forest->face_connectivity;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (conn != NULL);
+  T8_ASSERT (0 <= lelement_id && lelement_id < conn->num_elements);
+
+  return conn->face_offsets[lelement_id + 1] - conn->face_offsets[lelement_id];
+}
+
+int
+t8_forest_face_connectivity_get_neighbors (const t8_forest_t forest, const t8_locidx_t lelement_id, const int face,
+                                           const t8_locidx_t **neighbor_ids, const int8_t **dual_faces,
+                                           int *orientation, int *flags)
+{
+  const t8_forest_face_connectivity_t *conn = forest->face_connectivity;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (conn != NULL);
+  T8_ASSERT (0 <= lelement_id && lelement_id < conn->num_elements);
+  T8_ASSERT (0 <= face && face < t8_forest_face_connectivity_num_faces (forest, lelement_id));
+
+  const t8_locidx_t iface = conn->face_offsets[lelement_id] + face;
+  const t8_locidx_t first_neighbor = conn->neighbor_offsets[iface];
+
+  *neighbor_ids = conn->neighbor_ids + first_neighbor;
+  *dual_faces = conn->dual_faces + first_neighbor;
+  if (orientation != NULL) {
+    *orientation = conn->orientations[iface];
+  }
+  if (flags != NULL) {
+    *flags = conn->flags[iface];
+  }
+  return conn->neighbor_offsets[iface + 1] - first_neighbor;
+}
+
+T8_EXTERN_C_END ();
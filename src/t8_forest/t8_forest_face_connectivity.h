@@ -0,0 +1,84 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_forest_face_connectivity.h
+ * A precomputed table of the face neighbors of all local leaves of a forest.
+ * The table is stored in compressed sparse row (CSR) format and is built in
+ * \ref t8_forest_commit if \ref t8_forest_set_face_connectivity was called.
+ * Afterwards the face neighbors of a leaf can be queried in constant time
+ * without allocating memory, in contrast to \ref t8_forest_leaf_face_neighbors.
+ */
+
+#ifndef T8_FOREST_FACE_CONNECTIVITY_H
+#define T8_FOREST_FACE_CONNECTIVITY_H
+
+#include <t8.h>
+#include <t8_forest/t8_forest_general.h>
+
+/** Flags that describe the type of a face of a leaf in the face connectivity table. */
+typedef enum t8_face_connectivity_flag {
+  T8_FACE_CONNECTIVITY_CONFORMING = 0, /**< The face has exactly one neighbor of the same level. */
+  T8_FACE_CONNECTIVITY_BOUNDARY = 1,   /**< The face lies on the domain boundary and has no neighbors. */
+  T8_FACE_CONNECTIVITY_FINER = 2,      /**< The face is hanging, the neighbors are finer than the leaf. */
+  T8_FACE_CONNECTIVITY_COARSER = 4,    /**< The face is hanging, the neighbor is coarser than the leaf. */
+  T8_FACE_CONNECTIVITY_GHOST = 8       /**< At least one neighbor is a ghost element. */
+} t8_face_connectivity_flag_t;
+
+T8_EXTERN_C_BEGIN ();
+
+/** Query whether a forest has a face connectivity table.
+ * \param [in] forest   A committed forest.
+ * \return              True if \ref t8_forest_set_face_connectivity was set before committing \a forest.
+ */
+int
+t8_forest_has_face_connectivity (const t8_forest_t forest);
+
+/** Return the number of faces of a local leaf as stored in the face connectivity table.
+ * \param [in] forest       A committed forest with face connectivity table.
+ * \param [in] lelement_id  The local index of a leaf, 0 <= \a lelement_id < num_local_elements.
+ * \return                  The number of faces of the leaf.
+ */
+int
+t8_forest_face_connectivity_num_faces (const t8_forest_t forest, const t8_locidx_t lelement_id);
+
+/** Look up the face neighbors of a local leaf in the face connectivity table.
+ * This function does not allocate memory. The returned arrays point into the table
+ * and are valid as long as \a forest is.
+ * \param [in]  forest        A committed forest with face connectivity table.
+ * \param [in]  lelement_id   The local index of a leaf, 0 <= \a lelement_id < num_local_elements.
+ * \param [in]  face          A face of the leaf.
+ * \param [out] neighbor_ids  On output the indices of the neighbor leaves.
+ *                            0, 1, ... num_local_el - 1 for local leaves and
+ *                            num_local_el, ..., num_local_el + num_ghosts - 1 for ghosts.
+ * \param [out] dual_faces    On output the face ids of the neighbor leaves' faces.
+ * \param [out] orientation   If not NULL, the face orientation is stored here.
+ * \param [out] flags         If not NULL, a combination of \ref t8_face_connectivity_flag_t is stored here.
+ * \return                    The number of face neighbors, 0 at the domain boundary.
+ */
+int
+t8_forest_face_connectivity_get_neighbors (const t8_forest_t forest, const t8_locidx_t lelement_id, const int face,
+                                           const t8_locidx_t **neighbor_ids, const int8_t **dual_faces,
+                                           int *orientation, int *flags);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_FACE_CONNECTIVITY_H */
@@ -37,6 +37,14 @@
 typedef struct t8_forest *t8_forest_t;
 typedef struct t8_tree *t8_tree_t;
 
+/** Opaque handle of a ghost data exchange that is in progress.
+ * \see t8_forest_ghost_exchange_begin */
+typedef struct t8_ghost_data_exchange t8_ghost_data_exchange_t;
+
+/** Opaque pointer to a persistent ghost data exchange plan.
+ * \see t8_forest_ghost_exchange_plan_new */
+typedef struct t8_forest_ghost_exchange_plan *t8_forest_ghost_exchange_plan_t;
+
 /** This type controls, which neighbors count as ghost elements.
  * Currently, we support face-neighbors. Vertex and edge neighbors will eventually be added. */
 typedef enum {
@@ -115,6 +123,20 @@ typedef int (*t8_forest_adapt_t) (t8_forest_t forest, t8_forest_t forest_from, t
                                   t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
                                   const int num_elements, t8_element_t *elements[]);
 
+/** Callback function prototype to compute the computational cost of an element
+ * when partitioning a forest. See \ref t8_forest_set_partition_weights.
+ * \param [in] forest       the forest that is partitioned
+ * \param [in] forest_from  the forest whose elements are distributed
+ * \param [in] which_tree   the local tree of \a forest_from containing \a element
+ * \param [in] lelement_id  the local element id of \a element in \a forest_from
+ * \param [in] ts           the eclass scheme of the tree
+ * \param [in] element      the element
+ * \return                  The non-negative weight of \a element.
+ */
+typedef double (*t8_forest_partition_weight_t) (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                                                t8_locidx_t lelement_id, t8_eclass_scheme_c *ts,
+                                                const t8_element_t *element);
+
 /** Create a new forest with reference count one.
  * This forest needs to be specialized with the t8_forest_set_* calls.
  * Currently it is manatory to either call the functions \ref
@@ -319,6 +341,34 @@ t8_forest_get_user_function (const t8_forest_t forest);
 void
 t8_forest_set_partition (t8_forest_t forest, const t8_forest_t set_from, int set_for_coarsening);
 
+/** Set a callback that assigns a weight to each element when the forest is partitioned.
+ * Instead of the same number of elements, each rank is assigned elements whose
+ * weights sum up to about the same value.
+ * \param [in, out] forest    The forest.
+ * \param [in]      weight_fn The weight function. If NULL, all elements have the same weight.
+ * \note The weights are evaluated for the elements of the forest that is partitioned,
+ *       thus after adaptation if \ref t8_forest_set_adapt is also set.
+ * \note The weights are only used by the partition step and not by the repartitioning
+ *       during \ref t8_forest_set_balance.
+ * \note Overwrites a previous call to \ref t8_forest_set_partition_weights_array.
+ */
+void
+t8_forest_set_partition_weights (t8_forest_t forest, t8_forest_partition_weight_t weight_fn);
+
+/** Set the weights of the elements when the forest is partitioned.
+ * Instead of the same number of elements, each rank is assigned elements whose
+ * weights sum up to about the same value.
+ * \param [in, out] forest    The forest.
+ * \param [in]      weights   One non-negative weight for each local element of the forest
+ *                            that is partitioned. Must stay valid until \a forest is committed.
+ *                            If NULL, all elements have the same weight.
+ * \note Since the weights refer to the elements of the source forest, this may not be
+ *       combined with \ref t8_forest_set_adapt. Use \ref t8_forest_set_partition_weights instead.
+ * \note Overwrites a previous call to \ref t8_forest_set_partition_weights.
+ */
+void
+t8_forest_set_partition_weights_array (t8_forest_t forest, const double *weights);
+
 /** Set a source forest to be balanced during commit.
  * A forest is said to be balanced if each element has face neighbors of level
  * at most +1 or -1 of the element's level.
@@ -367,10 +417,98 @@ t8_forest_set_ghost (t8_forest_t forest, int do_ghost, t8_ghost_type_t ghost_typ
 void
 t8_forest_set_ghost_ext (t8_forest_t forest, int do_ghost, t8_ghost_type_t ghost_type, int ghost_version);
 
-/* TODO: use assertions and document that the forest_set (..., from) and
- *       set_load are mutually exclusive. */
+/** Build a table of the face neighbors of all local leaves when the forest is committed.
+ * Afterwards the face neighbors can be queried in constant time with
+ * \ref t8_forest_face_connectivity_get_neighbors.
+ * If the forest is only adapted from a forest that also has a face connectivity table,
+ * the neighbors of leaves whose trees did not change are copied from that table.
+ * \param [in,out] forest      The forest.
+ * \param [in]     do_face_connectivity If true, the table is built. Default is false.
+ * \note This enables a face ghost layer if none was set. Do not disable ghosts afterwards.
+ * \note Currently the forest must be balanced.
+ * \see t8_forest_face_connectivity.h
+ */
+void
+t8_forest_set_face_connectivity (t8_forest_t forest, int do_face_connectivity);
+
+/** Compute and store the volumes, centroids, face areas and face normals of all local
+ * leaves and ghosts when the forest is committed.
+ * Afterwards they can be looked up without evaluating the geometry with the functions
+ * in \ref t8_forest_element_metrics.h.
+ * If the forest is only adapted non-recursively from a forest that also has element metrics,
+ * the metrics of unchanged leaves are copied and only those of new leaves are computed.
+ * \param [in,out] forest      The forest.
+ * \param [in]     do_element_metrics If true, the metrics are computed. Default is false.
+ * \note The metrics of ghosts are only available if a ghost layer is created.
+ * \see t8_forest_element_metrics.h
+ */
+void
+t8_forest_set_element_metrics (t8_forest_t forest, int do_element_metrics);
+
+/** Set the number of threads that the shared memory parallel algorithms of
+ * a forest may use. This is independent of the number of MPI processes.
+ * Currently, \ref t8_forest_commit adapts the local trees and finds the local elements
+ * that are ghosts of other processes in parallel if more than one thread is set
+ * and t8code was configured with OpenMP support.
+ * \param [in,out] forest      The forest.
+ * \param [in]     num_threads The number of threads, must be at least 1.
+ *                             Default is 1. Without OpenMP, the value has no effect.
+ *                             If libsc was built without pthread support, its memory
+ *                             allocation is not thread safe and only 1 thread is used.
+ * \note If more than one thread is used, the adapt callback and everything it calls, for example
+ *       user callbacks reached through the user data, must be thread safe, since it may be called
+ *       concurrently for elements of different trees.
+ * \note The geometry evaluation of a cmesh is not thread safe, since the geometry handler caches
+ *       the tree that was evaluated last. An adapt callback that evaluates the geometry, for example with
+ *       \ref t8_forest_element_centroid, must only be used with one thread, unless it serializes these calls.
+ * \note If adapt is combined with partition or balance, the setting is inherited by the
+ *       intermediate adapted forest that \ref t8_forest_commit creates. It is not inherited
+ *       by forests derived from \a forest.
+ */
+void
+t8_forest_set_num_threads (t8_forest_t forest, int num_threads);
+
+/** Return the number of threads that shared memory parallel algorithms of a forest may use.
+ * \param [in] forest      The forest.
+ * \return                 The number of threads. \see t8_forest_set_num_threads.
+ */
+int
+t8_forest_get_num_threads (const t8_forest_t forest);
+
+/** Set whether the elements of a forest are encoded compactly when they are sent
+ * to other processes during partition and ghost creation.
+ * In the compact encoding each element is sent as its level and its linear id,
+ * where the linear id is stored as a variable length difference to the previous element.
+ * This reduces the message sizes considerably, at the cost of computing the linear ids.
+ * \param [in,out] forest      The forest.
+ * \param [in]     compact_transfer If true, elements are encoded compactly. Default is false.
+ * \note The setting is inherited by the intermediate forests that \ref t8_forest_commit
+ *       creates, but not by forests derived from \a forest.
+ */
+void
+t8_forest_set_compact_transfer (t8_forest_t forest, int compact_transfer);
+
+/** Return whether the elements of a forest are encoded compactly when they are sent to other processes.
+ * \param [in] forest      The forest.
+ * \return                 True if compact encoding is used. \see t8_forest_set_compact_transfer.
+ */
+int
+t8_forest_get_compact_transfer (const t8_forest_t forest);
+
+/** Set a checkpoint from which a forest is loaded when it is committed.
+ * The checkpoint must have been written with \ref t8_forest_save.
+ * The coarse mesh is loaded from the checkpoint, so \ref t8_forest_set_cmesh
+ * must not be called. The scheme must be set with \ref t8_forest_set_scheme.
+ * This setting is mutually exclusive with \ref t8_forest_set_copy,
+ * \ref t8_forest_set_adapt, \ref t8_forest_set_partition and \ref t8_forest_set_balance.
+ * \param [in, out] forest     The forest.
+ * \param [in]      fileprefix The prefix that was passed to \ref t8_forest_save.
+ * \param [in]      comm       The MPI communicator of the forest. It may have a different
+ *                             size than the communicator of the saved forest.
+ * \see t8_forest_load
+ */
 void
-t8_forest_set_load (t8_forest_t forest, const char *filename);
+t8_forest_set_load (t8_forest_t forest, const char *fileprefix, sc_MPI_Comm comm);
 
 /** Compute the global number of elements in a forest as the sum
  *  of the local element counts.
@@ -548,11 +686,15 @@ t8_forest_leaf_face_orientation (t8_forest_t forest, const t8_locidx_t ltreeid,
  *                        num_local_el , ... , num_local_el + num_ghosts - 1 for ghosts.
  * \param [out]   pneigh_scheme On output the eclass scheme of the neighbor elements.
  * \param [in]    forest_is_balanced True if we know that \a forest is balanced, false
- *                        otherwise.
+ *                        otherwise. If false, the neighbor leaves may have any level
+ *                        difference to \a leaf and are found by searching the descendants
+ *                        of the same level neighbor. This is more expensive than the
+ *                        balanced version, but does not require to balance \a forest.
  * \param [out]   orientation If a pointer to an integer variable is given the face orientation is computed and stored there.
  * \note If there are no face neighbors, then *neighbor_leaves = NULL, num_neighbors = 0,
  * and *pelement_indices = NULL on output.
- * \note Currently \a forest must be balanced.
+ * \note For unbalanced forests the ghost layer must contain all face neighbors of the local
+ * leaves, which is the case for the default ghost algorithm, see \ref t8_forest_set_ghost.
  * \note \a forest must be committed before calling this function.
  *
  * \note Important! This routine allocates memory which must be freed. Do it like this:
@@ -587,12 +729,95 @@ t8_forest_leaf_face_neighbors_ext (t8_forest_t forest, t8_locidx_t ltreeid, cons
  * \note This function is collective and hence must be called by all processes in the forest's
  *       MPI Communicator.
  */
-/* TODO: In \ref t8_forest_ghost_cxx we already implemented a begin and end function
- *       that allow for overlapping communication and computation. We will make them
- *       available in this interface in the future. */
 void
 t8_forest_ghost_exchange_data (t8_forest_t forest, sc_array_t *element_data);
 
+/** Start a ghost data exchange of user defined element data.
+ * The data of the local elements is copied into send buffers and the messages
+ * are posted. The function returns immediately and the ghost entries of \a element_data
+ * are only valid after the matching call to \ref t8_forest_ghost_exchange_end.
+ * In between the user may work on the local entries of \a element_data, but must not
+ * modify the array itself or read its ghost entries.
+ * \param[in] forest       The forest. Must be committed.
+ * \param[in,out] element_data An array of length num_local_elements + num_ghosts
+ *                         storing one value for each local element and ghost in \a forest.
+ * \return                 A handle of the started exchange that has to be passed to
+ *                         \ref t8_forest_ghost_exchange_end. NULL if this process has no ghosts.
+ * \note This function is collective and hence must be called by all processes in the forest's
+ *       MPI Communicator.
+ */
+t8_ghost_data_exchange_t *
+t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t *element_data);
+
+/** Finish a ghost data exchange that was started with \ref t8_forest_ghost_exchange_begin.
+ * Waits for all messages to complete and frees the exchange handle.
+ * After this call the ghost entries of the exchanged array are valid.
+ * \param[in,out] data_exchange The handle returned by \ref t8_forest_ghost_exchange_begin.
+ *                             May be NULL, in which case nothing is done.
+ */
+void
+t8_forest_ghost_exchange_end (t8_ghost_data_exchange_t *data_exchange);
+
+/** Create a persistent plan for repeated ghost data exchanges on a forest.
+ * The plan precomputes for each remote process the flat list of local element
+ * indices that have to be sent, the receive offsets of the ghosts and allocates
+ * the send buffers once. Repeated exchanges with the plan do not perform any hash
+ * lookups, tree searches or allocations and (with MPI) reuse persistent requests.
+ * This is useful if data is exchanged several times on an unchanged forest, for example
+ * in each stage of a time stepping scheme.
+ * \param[in] forest       The forest. Must be committed and have a ghost layer.
+ * \param[in] data_size    The number of bytes per element of the data arrays that are
+ *                         exchanged with this plan.
+ * \return                 A new exchange plan. It holds a reference of \a forest and must be
+ *                         destroyed with \ref t8_forest_ghost_exchange_plan_destroy.
+ * \note This function is collective and hence must be called by all processes in the forest's
+ *       MPI Communicator.
+ */
+t8_forest_ghost_exchange_plan_t
+t8_forest_ghost_exchange_plan_new (t8_forest_t forest, size_t data_size);
+
+/** Create a persistent plan for repeated ghost data exchanges, optionally using shared memory.
+ * If \a use_shared_memory is true and MPI supports shared windows, the send buffers of all
+ * ranks on the same node are allocated in one shared window. The ghost data of remotes on the
+ * same node is then copied directly from their send buffers and only remotes on other nodes
+ * exchange MPI messages.
+ * \param[in] forest       The forest. Must be committed and have a ghost layer.
+ * \param[in] data_size    The number of bytes per element of the exchanged data arrays.
+ * \param[in] use_shared_memory If true, use shared memory for remotes on the same node.
+ *                         Must be the same on all processes.
+ * \return                 A new exchange plan, see \ref t8_forest_ghost_exchange_plan_new.
+ * \note This function is collective and hence must be called by all processes in the forest's
+ *       MPI Communicator. With shared memory, begin, end and destroy of the plan are collective
+ *       over all processes on the same node.
+ */
+t8_forest_ghost_exchange_plan_t
+t8_forest_ghost_exchange_plan_new_ext (t8_forest_t forest, size_t data_size, int use_shared_memory);
+
+/** Start a ghost data exchange with a persistent plan.
+ * \param[in] plan         An exchange plan without an active exchange.
+ * \param[in,out] element_data An array of length num_local_elements + num_ghosts of the
+ *                         plan's forest, whose element size is the plan's data size.
+ *                         If the same array is passed in subsequent exchanges, the receive
+ *                         requests are reused.
+ * \note The ghost entries of \a element_data are only valid after
+ *       \ref t8_forest_ghost_exchange_plan_end.
+ * \note This function is collective.
+ */
+void
+t8_forest_ghost_exchange_plan_begin (t8_forest_ghost_exchange_plan_t plan, sc_array_t *element_data);
+
+/** Finish a ghost data exchange that was started with \ref t8_forest_ghost_exchange_plan_begin.
+ * \param[in] plan         An exchange plan with an active exchange.
+ */
+void
+t8_forest_ghost_exchange_plan_end (t8_forest_ghost_exchange_plan_t plan);
+
+/** Destroy a persistent ghost exchange plan and release its reference of the forest.
+ * \param[in,out] pplan     Pointer to a plan without an active exchange. Set to NULL on output.
+ */
+void
+t8_forest_ghost_exchange_plan_destroy (t8_forest_ghost_exchange_plan_t *pplan);
+
 /** Print the ghost structure of a forest. Only used for debugging. */
 void
 t8_forest_ghost_print (t8_forest_t forest);
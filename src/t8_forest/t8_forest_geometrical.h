@@ -93,6 +93,47 @@ void
 t8_forest_element_from_ref_coords (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *element,
                                    const double *ref_coords, const size_t num_coords, double *coords_out);
 
+/** Compute the coordinates of points inside many elements of one tree at once.
+ *  The points are given in reference coordinates inside the elements. They are converted
+ *  to tree reference coordinates and the geometry of the tree is evaluated for all points
+ *  of all elements in a single call.
+ * \param [in]      forest            The forest.
+ * \param [in]      ltreeid           The forest local id of the tree in which the elements are.
+ * \param [in]      elements          The elements.
+ * \param [in]      num_elements      The number of elements.
+ * \param [in]      ref_coords        The reference coordinates of the points inside each element.
+ * \param [in]      num_coords        The number of coordinate sets in ref_coord (dimension x double).
+ * \param [out]     coords_out        On input an allocated array to store 3 x \a num_coords x \a num_elements doubles,
+ *                                    on output the coordinates of the points of element i at positions
+ *                                    3 * (i * \a num_coords + j).
+ */
+void
+t8_forest_element_batch_from_ref_coords (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t **elements,
+                                         const size_t num_elements, const double *ref_coords, const size_t num_coords,
+                                         double *coords_out);
+
+/** Compute the jacobian of the map from element reference coordinates to the domain
+ *  at points inside many elements of one tree at once.
+ *  The jacobian of the tree geometry is evaluated for all points of all elements in a single
+ *  call and multiplied with the jacobian of the affine map from element to tree reference coordinates.
+ * \param [in]      forest            The forest.
+ * \param [in]      ltreeid           The forest local id of the tree in which the elements are.
+ * \param [in]      elements          The elements.
+ * \param [in]      num_elements      The number of elements.
+ * \param [in]      ref_coords        The reference coordinates of the points inside each element.
+ * \param [in]      num_coords        The number of coordinate sets in ref_coord (dimension x double).
+ * \param [out]     jacobian_out      On input an allocated array to store
+ *                                    dimension x 3 x \a num_coords x \a num_elements doubles.
+ *                                    On output the jacobian of the j-th point of element i starts at position
+ *                                    3 * dimension * (i * \a num_coords + j). Its entry 3 * k + l is the derivative of
+ *                                    the l-th coordinate with respect to the k-th reference coordinate.
+ * \note The geometry of the tree must implement \ref t8_geometry::t8_geom_evaluate_jacobian.
+ */
+void
+t8_forest_element_batch_jacobian (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t **elements,
+                                  const size_t num_elements, const double *ref_coords, const size_t num_coords,
+                                  double *jacobian_out);
+
 /** Compute the coordinates of the centroid of an element if a geometry
  * for this tree is registered in the forest's cmesh.
  * The centroid can be seen as the midpoint of an element and thus can for example be used
@@ -26,10 +26,16 @@
 #include <t8_forest/t8_forest_private.h>
 #include <t8_forest/t8_forest_iterate.h>
 #include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_profiling.h>
+#include <t8_forest/t8_forest_element_codec.hxx>
 #include <t8_cmesh/t8_cmesh_trees.h>
 #include <t8_element.hxx>
 #include <t8_data/t8_containers.h>
+#include <t8_data/t8_shmem.h>
 #include <sc_statistics.h>
+#if T8_ENABLE_OPENMP
+#include <omp.h>
+#endif
 
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
@@ -155,8 +161,10 @@ t8_ghost_remote_equal_function (const void *remote_dataa, const void *remote_dat
  * Since we use asynchronuous communication, we store the
  * send buffers and mpi requests until we end the communication.
  */
-typedef struct
+struct t8_ghost_data_exchange
 {
+  t8_forest_t forest;
+  /** The forest whose ghost data is exchanged */
   int num_remotes;
   /** The number of processes, we send to */
   char **send_buffers;
@@ -165,7 +173,37 @@ typedef struct
   /** For each process we send to, the MPI request used */
   sc_MPI_Request *recv_requests;
   /** For each process we receive from, the MPI request used */
-} t8_ghost_data_exchange_t;
+};
+
+/** A persistent plan for repeated ghost data exchanges on the same forest.
+ * All offsets are computed once, such that an exchange only gathers the
+ * send data and starts the communication.
+ */
+struct t8_forest_ghost_exchange_plan
+{
+  t8_forest_t forest;          /**< The forest, we hold a reference of it. */
+  size_t data_size;            /**< The number of bytes per element. */
+  int num_remotes;             /**< The number of processes we send to and receive from. */
+  int *remote_ranks;           /**< The ranks of the remote processes. Points into the ghost structure. */
+  t8_locidx_t *send_offsets;   /**< For each remote the offset into \a send_indices, num_remotes + 1 entries. */
+  t8_locidx_t *send_indices;   /**< For all remotes the local indices of the elements to send. */
+  t8_locidx_t *recv_offsets;   /**< For each remote the offset of its ghosts, num_remotes + 1 entries. */
+  char *send_buffer;           /**< The send buffer for all remotes. */
+  sc_MPI_Request *requests;    /**< The receive requests followed by the send requests. */
+  void *recv_data;             /**< The array data that the receive requests are bound to. */
+  int requests_are_persistent; /**< True if \a requests were created as persistent requests. */
+  int active;                  /**< True between begin and end of an exchange. */
+  sc_array_t *element_data;    /**< The array of the active exchange. */
+  int use_shared;              /**< True if \a send_buffer is part of a shared window of the ranks on this node. */
+  const char **shared_data;    /**< For each remote on this node its send data for us in the window, else NULL. */
+  int num_message_remotes;     /**< The number of remotes that we exchange messages with. */
+  int *message_remotes;        /**< The indices of the remotes that we exchange messages with. */
+#if T8_ENABLE_MPI && defined(SC_ENABLE_MPIWINSHARED)
+  sc_MPI_Comm intranode;      /**< The communicator of the ranks on this node. */
+  MPI_Win window;             /**< The shared window holding the send buffers of all ranks on this node. */
+  sc_MPI_Request node_barrier; /**< The barrier of the ranks on this node that separates writing and reading. */
+#endif
+};
 
 void
 t8_forest_ghost_init (t8_forest_ghost_t *pghost, t8_ghost_type_t ghost_type)
@@ -484,6 +522,33 @@ t8_ghost_add_remote (t8_forest_t forest, t8_forest_ghost_t ghost, int remote_ran
   }
 }
 
+/* A local element that is a ghost of the process owner.
+ * These are collected during the detection of the remote elements
+ * and added to the remote ghosts afterwards. */
+typedef struct
+{
+  int owner;                 /* The remote process */
+  t8_locidx_t ltreeid;       /* The local tree of the element */
+  t8_locidx_t element_index; /* The index of the element in its tree */
+} t8_ghost_remote_candidate_t;
+
+/* Add the remote elements found by t8_forest_ghost_find_remotes_tree
+ * or t8_forest_ghost_search_boundary to the remote ghosts.
+ * The candidates must be in local tree and element order. */
+static void
+t8_forest_ghost_add_remote_candidates (t8_forest_t forest, t8_forest_ghost_t ghost, sc_array_t *candidates)
+{
+  size_t icandidate;
+
+  for (icandidate = 0; icandidate < candidates->elem_count; icandidate++) {
+    const t8_ghost_remote_candidate_t *candidate
+      = (const t8_ghost_remote_candidate_t *) sc_array_index (candidates, icandidate);
+    const t8_element_t *elem
+      = t8_forest_get_tree_element (t8_forest_get_tree (forest, candidate->ltreeid), candidate->element_index);
+    t8_ghost_add_remote (forest, ghost, candidate->owner, candidate->ltreeid, elem, candidate->element_index);
+  }
+}
+
 typedef struct
 {
   sc_array_t bounds_per_level; /* For each level from the nca to the parent of the current element
@@ -492,6 +557,7 @@ typedef struct
                                            Each entry is an array of 2 * (max_num_faces + 1) integers,
                                            | face_0 low | face_0 high | ... | face_n low | face_n high | owner low | owner high | */
   sc_array_t face_owners;      /* Temporary storage for all owners at a leaf's face */
+  sc_array_t candidates;       /* The remote elements found, as t8_ghost_remote_candidate_t */
   t8_eclass_scheme_c *ts;
   t8_gloidx_t gtreeid;
   int level_nca; /* The refinement level of the root element in the search.
@@ -504,11 +570,33 @@ typedef struct
 #endif
 } t8_forest_ghost_boundary_data_t;
 
+/* The user data of the top-down ghost search: one search data per thread. */
+typedef struct
+{
+  t8_forest_ghost_boundary_data_t *thread_data; /* The search data of each thread */
+  int num_threads;                              /* The number of threads that search */
+} t8_forest_ghost_boundary_search_t;
+
+/* Get the search data of the calling thread. */
+static t8_forest_ghost_boundary_data_t *
+t8_forest_ghost_get_boundary_data (t8_forest_t forest)
+{
+  t8_forest_ghost_boundary_search_t *search = (t8_forest_ghost_boundary_search_t *) t8_forest_get_user_data (forest);
+#if T8_ENABLE_OPENMP
+  if (search->num_threads > 1) {
+    T8_ASSERT (omp_get_thread_num () < search->num_threads);
+    return &search->thread_data[omp_get_thread_num ()];
+  }
+#endif
+  T8_ASSERT (search->num_threads == 1);
+  return search->thread_data;
+}
+
 static int
 t8_forest_ghost_search_boundary (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *element,
                                  const int is_leaf, const t8_element_array_t *leaves, const t8_locidx_t tree_leaf_index)
 {
-  t8_forest_ghost_boundary_data_t *data = (t8_forest_ghost_boundary_data_t *) t8_forest_get_user_data (forest);
+  t8_forest_ghost_boundary_data_t *data = t8_forest_ghost_get_boundary_data (forest);
   int num_faces, iface, faces_totally_owned, level;
   int parent_face;
   int lower, upper, *bounds, *new_bounds, parent_lower, parent_upper;
@@ -605,11 +693,15 @@ t8_forest_ghost_search_boundary (t8_forest_t forest, t8_locidx_t ltreeid, const
       *(int *) sc_array_index (&data->face_owners, 0) = lower;
       *(int *) sc_array_index (&data->face_owners, 1) = upper;
       t8_forest_element_owners_at_neigh_face (forest, ltreeid, element, iface, &data->face_owners);
-      /*TODO: add as remotes */
+      /* Remember the element as a remote element of all of them. They are added to the
+       * ghost structure after the search, since threads may search concurrently. */
       for (iproc = 0; iproc < (int) data->face_owners.elem_count; iproc++) {
         remote_rank = *(int *) sc_array_index (&data->face_owners, iproc);
         if (remote_rank != forest->mpirank) {
-          t8_ghost_add_remote (forest, forest->ghosts, remote_rank, ltreeid, element, tree_leaf_index);
+          t8_ghost_remote_candidate_t *candidate = (t8_ghost_remote_candidate_t *) sc_array_push (&data->candidates);
+          candidate->owner = remote_rank;
+          candidate->ltreeid = ltreeid;
+          candidate->element_index = tree_leaf_index;
         }
       }
     }
@@ -628,180 +720,232 @@ t8_forest_ghost_search_boundary (t8_forest_t forest, t8_locidx_t ltreeid, const
   return 1;
 }
 
+/* Initialize the search data of one thread.
+ * The entries are set in t8_forest_ghost_search_boundary each time a new tree is entered. */
+static void
+t8_forest_ghost_boundary_data_init (t8_forest_ghost_boundary_data_t *data)
+{
+  /* Start with invalid entries */
+  data->eclass = T8_ECLASS_COUNT;
+  data->gtreeid = -1;
+  data->ts = NULL;
+#ifdef T8_ENABLE_DEBUG
+  data->left_out = 0;
+#endif
+  sc_array_init (&data->face_owners, sizeof (int));
+  sc_array_init (&data->candidates, sizeof (t8_ghost_remote_candidate_t));
+  /* This is a dummy init, since we call sc_array_reset in ghost_search_boundary
+   * and we should not call sc_array_reset on a non-initialized array */
+  sc_array_init (&data->bounds_per_level, 1);
+}
+
+/* Reset the search data of one thread. */
+static void
+t8_forest_ghost_boundary_data_reset (t8_forest_ghost_boundary_data_t *data)
+{
+  sc_array_reset (&data->face_owners);
+  sc_array_reset (&data->candidates);
+  sc_array_reset (&data->bounds_per_level);
+}
+
 /* Fill the remote ghosts of a ghost structure.
- * We iterate through all elements and check if their neighbors
- * lie on remote processes. If so, we add the element to the
+ * We search top-down through all trees and check if the neighbors
+ * of the leaves lie on remote processes. If so, we add the element to the
  * remote_ghosts array of ghost.
  * We also fill the remote_processes here.
+ * If the forest uses multiple threads, each thread searches a contiguous range of
+ * trees and collects its remote elements in its own list. The lists are added
+ * to the remote ghosts in tree order afterwards, so the result does not depend
+ * on the number of threads.
  */
 static void
 t8_forest_ghost_fill_remote_v3 (t8_forest_t forest)
 {
-  t8_forest_ghost_boundary_data_t data;
+  t8_forest_ghost_boundary_search_t search;
   void *store_user_data = NULL;
+  int max_threads = 1, ithread;
 
-  /* Start with invalid entries in the user data.
-   * These are set in t8_forest_ghost_search_boundary each time a new tree is entered */
-  data.eclass = T8_ECLASS_COUNT;
-  data.gtreeid = -1;
-  data.ts = NULL;
-#ifdef T8_ENABLE_DEBUG
-  data.left_out = 0;
+#if T8_ENABLE_OPENMP
+  max_threads = SC_MAX (SC_MIN (forest->num_threads, t8_forest_get_num_local_trees (forest)), 1);
 #endif
-  sc_array_init (&data.face_owners, sizeof (int));
-  /* This is a dummy init, since we call sc_array_reset in ghost_search_boundary
-   * and we should not call sc_array_reset on a non-initialized array */
-  sc_array_init (&data.bounds_per_level, 1);
+  search.thread_data = T8_ALLOC (t8_forest_ghost_boundary_data_t, max_threads);
+  search.num_threads = 1;
+  for (ithread = 0; ithread < max_threads; ithread++) {
+    t8_forest_ghost_boundary_data_init (&search.thread_data[ithread]);
+  }
   /* Store any user data that may reside on the forest */
   store_user_data = t8_forest_get_user_data (forest);
   /* Set the user data for the search routine */
-  t8_forest_set_user_data (forest, &data);
-  /* Loop over the trees of the forest */
-  t8_forest_search (forest, t8_forest_ghost_search_boundary, NULL, NULL);
+  t8_forest_set_user_data (forest, &search);
+
+#if T8_ENABLE_OPENMP
+  if (max_threads > 1) {
+    t8_locidx_t *first_tree = NULL;
+
+#pragma omp parallel num_threads (max_threads)
+    {
+      /* The runtime may give us fewer threads than requested. */
+      const int thread_id = omp_get_thread_num ();
+
+#pragma omp single
+      {
+        search.num_threads = omp_get_num_threads ();
+        first_tree = T8_ALLOC (t8_locidx_t, search.num_threads + 1);
+        t8_forest_split_local_trees (forest, search.num_threads, first_tree);
+      } /* Implicit barrier */
+
+      t8_forest_search_trees (forest, first_tree[thread_id], first_tree[thread_id + 1],
+                              t8_forest_ghost_search_boundary, NULL, NULL);
+    }
+    T8_FREE (first_tree);
+  }
+  else
+#endif
+  {
+    /* Loop over the trees of the forest */
+    t8_forest_search (forest, t8_forest_ghost_search_boundary, NULL, NULL);
+  }
 
   /* Reset the user data from before search */
   t8_forest_set_user_data (forest, store_user_data);
 
-  /* Reset the data arrays */
-  sc_array_reset (&data.face_owners);
-  sc_array_reset (&data.bounds_per_level);
-#ifdef T8_ENABLE_DEBUG
-#endif
+  /* Add the remote elements in thread order, which is the order of the trees, and reset the data */
+  for (ithread = 0; ithread < max_threads; ithread++) {
+    t8_forest_ghost_add_remote_candidates (forest, forest->ghosts, &search.thread_data[ithread].candidates);
+    t8_forest_ghost_boundary_data_reset (&search.thread_data[ithread]);
+  }
+  T8_FREE (search.thread_data);
 }
 
-/* Fill the remote ghosts of a ghost structure.
- * We iterate through all elements and check if their neighbors
- * lie on remote processes. If so, we add the element to the
- * remote_ghosts array of ghost.
- * We also fill the remote_processes here.
+/* Find the remote processes of all elements of one local tree.
+ * We iterate through the elements and check if their neighbors
+ * lie on remote processes. If so, we append the element and the process to
+ * candidates, in the order of the elements.
  * If ghost_method is 0, then we assume a balanced forest and
  * construct the remote processes by looking at the half neighbors of an element.
  * Otherwise, we use the owners_at_face method.
+ * This function does not modify the forest and can be called concurrently for different trees.
  */
 static void
-t8_forest_ghost_fill_remote (t8_forest_t forest, t8_forest_ghost_t ghost, int ghost_method)
+t8_forest_ghost_find_remotes_tree (t8_forest_t forest, t8_locidx_t itree, int ghost_method, sc_array_t *candidates)
 {
   t8_element_t **half_neighbors = NULL;
-  t8_locidx_t num_local_trees, num_tree_elems;
-  t8_locidx_t itree, ielem;
+  t8_locidx_t num_tree_elems, ielem;
   t8_tree_t tree;
   t8_eclass_t tree_class, neigh_class, last_class;
   t8_gloidx_t neighbor_tree;
   t8_eclass_scheme_c *ts, *neigh_scheme = NULL, *prev_neigh_scheme = NULL;
+  t8_ghost_remote_candidate_t *candidate;
 
   int iface, num_faces;
   int num_face_children, max_num_face_children = 0;
   int ichild, owner;
-  sc_array_t owners, tree_owners;
+  sc_array_t owners;
   int is_atom;
 
   last_class = T8_ECLASS_COUNT;
-  num_local_trees = t8_forest_get_num_local_trees (forest);
   if (ghost_method != 0) {
     sc_array_init (&owners, sizeof (int));
-    sc_array_init (&tree_owners, sizeof (int));
-  }
-
-  /* Loop over the trees of the forest */
-  for (itree = 0; itree < num_local_trees; itree++) {
-    /* Get a pointer to the tree, the class of the tree, the
-     * scheme associated to the class and the number of elements in this tree. */
-    tree = t8_forest_get_tree (forest, itree);
-    tree_class = t8_forest_get_tree_class (forest, itree);
-    ts = t8_forest_get_eclass_scheme (forest, tree_class);
-
-    /* Loop over the elements of this tree */
-    num_tree_elems = t8_forest_get_tree_element_count (tree);
-    for (ielem = 0; ielem < num_tree_elems; ielem++) {
-      /* Get the element of the tree */
-      const t8_element_t *elem = t8_forest_get_tree_element (tree, ielem);
-      num_faces = ts->t8_element_num_faces (elem);
-      if (ts->t8_element_level (elem) == ts->t8_element_maxlevel ()) {
-        /* flag to decide whether this element is at the maximum level */
-        is_atom = 1;
-      }
-      else {
-        is_atom = 0;
-      }
-      for (iface = 0; iface < num_faces; iface++) {
-        /* TODO: Check whether the neighbor element is inside the forest,
-         *       if not then do not compute the half_neighbors.
-         *       This will save computing time. Needs an "element is in forest" function
-         *       Currently we perform this check in the half_neighbors function. */
-
-        /* Get the element class of the neighbor tree */
-        neigh_class = t8_forest_element_neighbor_eclass (forest, itree, elem, iface);
-        neigh_scheme = t8_forest_get_eclass_scheme (forest, neigh_class);
-        if (ghost_method == 0) {
-          /* Use half neighbors */
-          /* Get the number of face children of the element at this face */
-          num_face_children = ts->t8_element_num_face_children (elem, iface);
-          /* regrow the half_neighbors array if necessary.
-           * We also need to reallocate it, if the element class of the neighbor
-           * changes */
-          if (max_num_face_children < num_face_children || last_class != neigh_class) {
-            if (max_num_face_children > 0) {
-              /* Clean-up memory */
-              prev_neigh_scheme->t8_element_destroy (max_num_face_children, half_neighbors);
-              T8_FREE (half_neighbors);
-            }
-            half_neighbors = T8_ALLOC (t8_element_t *, num_face_children);
-            /* Allocate memory for the half size face neighbors */
-            neigh_scheme->t8_element_new (num_face_children, half_neighbors);
-            max_num_face_children = num_face_children;
-            last_class = neigh_class;
-            prev_neigh_scheme = neigh_scheme;
-          }
-          if (!is_atom) {
-            /* Construct each half size neighbor */
-            neighbor_tree = t8_forest_element_half_face_neighbors (forest, itree, elem, half_neighbors, neigh_scheme,
-                                                                   iface, num_face_children, NULL);
-          }
-          else {
-            int dummy_neigh_face;
-            /* This element has maximum level, we only construct its neighbor */
-            neighbor_tree = t8_forest_element_face_neighbor (forest, itree, elem, half_neighbors[0], neigh_scheme,
-                                                             iface, &dummy_neigh_face);
-          }
-          if (neighbor_tree >= 0) {
-            /* If there exist face neighbor elements (we are not at a domain boundary */
-            /* Find the owner process of each face_child */
-            for (ichild = 0; ichild < num_face_children; ichild++) {
-              /* find the owner */
-              owner = t8_forest_element_find_owner (forest, neighbor_tree, half_neighbors[ichild], neigh_class);
-              T8_ASSERT (0 <= owner && owner < forest->mpisize);
-              if (owner != forest->mpirank) {
-                /* Add the element as a remote element */
-                t8_ghost_add_remote (forest, ghost, owner, itree, elem, ielem);
-              }
-            }
+  }
+
+  /* Get a pointer to the tree, the class of the tree, the
+   * scheme associated to the class and the number of elements in this tree. */
+  tree = t8_forest_get_tree (forest, itree);
+  tree_class = t8_forest_get_tree_class (forest, itree);
+  ts = t8_forest_get_eclass_scheme (forest, tree_class);
+
+  /* Loop over the elements of this tree */
+  num_tree_elems = t8_forest_get_tree_element_count (tree);
+  for (ielem = 0; ielem < num_tree_elems; ielem++) {
+    /* Get the element of the tree */
+    const t8_element_t *elem = t8_forest_get_tree_element (tree, ielem);
+    num_faces = ts->t8_element_num_faces (elem);
+    if (ts->t8_element_level (elem) == ts->t8_element_maxlevel ()) {
+      /* flag to decide whether this element is at the maximum level */
+      is_atom = 1;
+    }
+    else {
+      is_atom = 0;
+    }
+    for (iface = 0; iface < num_faces; iface++) {
+      /* TODO: Check whether the neighbor element is inside the forest,
+       *       if not then do not compute the half_neighbors.
+       *       This will save computing time. Needs an "element is in forest" function
+       *       Currently we perform this check in the half_neighbors function. */
+
+      /* Get the element class of the neighbor tree */
+      neigh_class = t8_forest_element_neighbor_eclass (forest, itree, elem, iface);
+      neigh_scheme = t8_forest_get_eclass_scheme (forest, neigh_class);
+      if (ghost_method == 0) {
+        /* Use half neighbors */
+        /* Get the number of face children of the element at this face */
+        num_face_children = ts->t8_element_num_face_children (elem, iface);
+        /* regrow the half_neighbors array if necessary.
+         * We also need to reallocate it, if the element class of the neighbor
+         * changes */
+        if (max_num_face_children < num_face_children || last_class != neigh_class) {
+          if (max_num_face_children > 0) {
+            /* Clean-up memory */
+            prev_neigh_scheme->t8_element_destroy (max_num_face_children, half_neighbors);
+            T8_FREE (half_neighbors);
           }
-        } /* end ghost_method 0 */
+          half_neighbors = T8_ALLOC (t8_element_t *, num_face_children);
+          /* Allocate memory for the half size face neighbors */
+          neigh_scheme->t8_element_new (num_face_children, half_neighbors);
+          max_num_face_children = num_face_children;
+          last_class = neigh_class;
+          prev_neigh_scheme = neigh_scheme;
+        }
+        if (!is_atom) {
+          /* Construct each half size neighbor */
+          neighbor_tree = t8_forest_element_half_face_neighbors (forest, itree, elem, half_neighbors, neigh_scheme,
+                                                                 iface, num_face_children, NULL);
+        }
         else {
-          size_t iowner;
-          /* Construct the owners at the face of the neighbor element */
-          t8_forest_element_owners_at_neigh_face (forest, itree, elem, iface, &owners);
-          T8_ASSERT (owners.elem_count >= 0);
-          /* Iterate over all owners and if any is not the current process,
-           * add this element as remote */
-          for (iowner = 0; iowner < owners.elem_count; iowner++) {
-            owner = *(int *) sc_array_index (&owners, iowner);
+          int dummy_neigh_face;
+          /* This element has maximum level, we only construct its neighbor */
+          neighbor_tree = t8_forest_element_face_neighbor (forest, itree, elem, half_neighbors[0], neigh_scheme, iface,
+                                                           &dummy_neigh_face);
+        }
+        if (neighbor_tree >= 0) {
+          /* If there exist face neighbor elements (we are not at a domain boundary */
+          /* Find the owner process of each face_child */
+          for (ichild = 0; ichild < num_face_children; ichild++) {
+            /* find the owner */
+            owner = t8_forest_element_find_owner (forest, neighbor_tree, half_neighbors[ichild], neigh_class);
             T8_ASSERT (0 <= owner && owner < forest->mpisize);
             if (owner != forest->mpirank) {
-              /* Add the element as a remote element */
-              t8_ghost_add_remote (forest, ghost, owner, itree, elem, ielem);
+              /* Remember the element as a remote element */
+              candidate = (t8_ghost_remote_candidate_t *) sc_array_push (candidates);
+              candidate->owner = owner;
+              candidate->ltreeid = itree;
+              candidate->element_index = ielem;
             }
           }
-          sc_array_truncate (&owners);
         }
-      } /* end face loop */
-    }   /* end element loop */
-  }     /* end tree loop */
+      } /* end ghost_method 0 */
+      else {
+        size_t iowner;
+        /* Construct the owners at the face of the neighbor element */
+        t8_forest_element_owners_at_neigh_face (forest, itree, elem, iface, &owners);
+        T8_ASSERT (owners.elem_count >= 0);
+        /* Iterate over all owners and if any is not the current process,
+         * remember this element as remote */
+        for (iowner = 0; iowner < owners.elem_count; iowner++) {
+          owner = *(int *) sc_array_index (&owners, iowner);
+          T8_ASSERT (0 <= owner && owner < forest->mpisize);
+          if (owner != forest->mpirank) {
+            candidate = (t8_ghost_remote_candidate_t *) sc_array_push (candidates);
+            candidate->owner = owner;
+            candidate->ltreeid = itree;
+            candidate->element_index = ielem;
+          }
+        }
+        sc_array_truncate (&owners);
+      }
+    } /* end face loop */
+  }   /* end element loop */
 
-  if (forest->profile != NULL) {
-    /* If profiling is enabled, we count the number of remote processes. */
-    forest->profile->ghosts_remotes = ghost->remote_processes->elem_count;
-  }
   /* Clean-up memory */
   if (ghost_method == 0) {
     if (half_neighbors != NULL) {
@@ -811,7 +955,78 @@ t8_forest_ghost_fill_remote (t8_forest_t forest, t8_forest_ghost_t ghost, int gh
   }
   else {
     sc_array_reset (&owners);
-    sc_array_reset (&tree_owners);
+  }
+}
+
+/* Fill the remote ghosts of a ghost structure.
+ * We iterate through all elements and check if their neighbors
+ * lie on remote processes. If so, we add the element to the
+ * remote_ghosts array of ghost.
+ * We also fill the remote_processes here.
+ * If ghost_method is 0, then we assume a balanced forest and
+ * construct the remote processes by looking at the half neighbors of an element.
+ * Otherwise, we use the owners_at_face method.
+ * If the forest uses multiple threads, each thread searches a contiguous range of
+ * trees and collects its remote elements in its own list. The lists are added
+ * to the remote ghosts in tree order afterwards, so the result does not depend
+ * on the number of threads.
+ */
+static void
+t8_forest_ghost_fill_remote (t8_forest_t forest, t8_forest_ghost_t ghost, int ghost_method)
+{
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+  t8_locidx_t itree;
+  sc_array_t candidates;
+
+#if T8_ENABLE_OPENMP
+  if (forest->num_threads > 1) {
+    const int max_threads = SC_MIN (forest->num_threads, SC_MAX (num_local_trees, 1));
+    sc_array_t *thread_candidates = T8_ALLOC (sc_array_t, max_threads);
+    t8_locidx_t *first_tree = NULL;
+    int num_threads = 0, ithread;
+
+#pragma omp parallel num_threads (max_threads)
+    {
+      /* The runtime may give us fewer threads than requested. */
+      const int thread_id = omp_get_thread_num ();
+
+#pragma omp single
+      {
+        num_threads = omp_get_num_threads ();
+        first_tree = T8_ALLOC (t8_locidx_t, num_threads + 1);
+        t8_forest_split_local_trees (forest, num_threads, first_tree);
+      } /* Implicit barrier */
+
+      sc_array_init (&thread_candidates[thread_id], sizeof (t8_ghost_remote_candidate_t));
+      for (t8_locidx_t ithread_tree = first_tree[thread_id]; ithread_tree < first_tree[thread_id + 1];
+           ithread_tree++) {
+        t8_forest_ghost_find_remotes_tree (forest, ithread_tree, ghost_method, &thread_candidates[thread_id]);
+      }
+    }
+    /* Merge the lists in thread order, which is the order of the trees */
+    for (ithread = 0; ithread < num_threads; ithread++) {
+      t8_forest_ghost_add_remote_candidates (forest, ghost, &thread_candidates[ithread]);
+      sc_array_reset (&thread_candidates[ithread]);
+    }
+    T8_FREE (first_tree);
+    T8_FREE (thread_candidates);
+  }
+  else
+#endif
+  {
+    sc_array_init (&candidates, sizeof (t8_ghost_remote_candidate_t));
+    /* Loop over the trees of the forest */
+    for (itree = 0; itree < num_local_trees; itree++) {
+      t8_forest_ghost_find_remotes_tree (forest, itree, ghost_method, &candidates);
+      t8_forest_ghost_add_remote_candidates (forest, ghost, &candidates);
+      sc_array_truncate (&candidates);
+    }
+    sc_array_reset (&candidates);
+  }
+
+  if (forest->profile != NULL) {
+    /* If profiling is enabled, we count the number of remote processes. */
+    forest->profile->ghosts_remotes = ghost->remote_processes->elem_count;
   }
 }
 
@@ -880,7 +1095,13 @@ t8_forest_ghost_send_start (t8_forest_t forest, t8_forest_ghost_t ghost, sc_MPI_
       /* The byte count of the elements */
       element_size = t8_element_array_get_size (&remote_tree->elements);
       element_count = t8_element_array_get_count (&remote_tree->elements);
-      element_bytes = element_size * element_count;
+      /* In compact mode we only know an upper bound for the bytes of the elements */
+      if (forest->compact_transfer && t8_forest_element_codec_is_compact (remote_tree->elements.scheme)) {
+        element_bytes = t8_forest_element_encode_bound (remote_tree->elements.scheme, element_count);
+      }
+      else {
+        element_bytes = element_size * element_count;
+      }
       /* We will store the number of elements */
       current_send_info->num_bytes += sizeof (size_t);
       /* add padding before the elements */
@@ -921,12 +1142,20 @@ t8_forest_ghost_send_start (t8_forest_t forest, t8_forest_ghost_t ghost, sc_MPI_
       memcpy (current_buffer + bytes_written, &element_count, sizeof (size_t));
       bytes_written += sizeof (size_t);
       bytes_written += T8_ADD_PADDING (bytes_written);
-      /* The byte count of the elements */
-      element_size = t8_element_array_get_size (&remote_tree->elements);
-      element_bytes = element_size * element_count;
-      /* Copy the elements into the send buffer */
-      memcpy (current_buffer + bytes_written, t8_element_array_get_data (&remote_tree->elements), element_bytes);
-      bytes_written += element_bytes;
+      if (forest->compact_transfer && t8_forest_element_codec_is_compact (remote_tree->elements.scheme)) {
+        /* Encode the elements into the send buffer */
+        bytes_written
+          += t8_forest_element_encode (remote_tree->elements.scheme, t8_element_array_get_data (&remote_tree->elements),
+                                       element_count, current_buffer + bytes_written);
+      }
+      else {
+        /* The byte count of the elements */
+        element_size = t8_element_array_get_size (&remote_tree->elements);
+        element_bytes = element_size * element_count;
+        /* Copy the elements into the send buffer */
+        memcpy (current_buffer + bytes_written, t8_element_array_get_data (&remote_tree->elements), element_bytes);
+        bytes_written += element_bytes;
+      }
       /* add padding after the elements */
       bytes_written += T8_ADD_PADDING (bytes_written);
 
@@ -937,7 +1166,10 @@ t8_forest_ghost_send_start (t8_forest_t forest, t8_forest_ghost_t ghost, sc_MPI_
 #endif
     } /* End tree loop */
 
-    T8_ASSERT (bytes_written == current_send_info->num_bytes);
+    T8_ASSERT (bytes_written == current_send_info->num_bytes
+               || (forest->compact_transfer && bytes_written <= current_send_info->num_bytes));
+    /* Only the used part of the buffer is sent */
+    current_send_info->num_bytes = bytes_written;
     /* We can now post the MPI_Isend for the remote process */
     mpiret = sc_MPI_Isend (current_buffer, bytes_written, sc_MPI_BYTE, remote_rank, T8_MPI_GHOST_FOREST,
                            forest->mpicomm, *requests + proc_index);
@@ -1002,6 +1234,9 @@ t8_forest_ghost_receive_message (int recv_rank, sc_MPI_Comm comm, sc_MPI_Status
  *  size_t   |     |t8_gloidx |     |t8_eclass |     | size_t      |     | t8_element_t |
  *
  * pad is paddind, see T8_ADD_PADDING
+ * If the forest uses compact transfer and the encoding is smaller than the elements,
+ * the elements are encoded with t8_forest_element_encode and their byte count is
+ * only known after decoding.
  *
  * current_element_offset is updated in each step to store the element offset
  * of the next ghost tree to be inserted.
@@ -1111,9 +1346,13 @@ t8_forest_ghost_parse_received_message (t8_forest_t forest, t8_forest_ghost_t gh
       first_element_index = old_elem_count;
     }
     /* Insert the new elements */
-    memcpy (element_insert, recv_buffer + bytes_read, num_elements * ts->t8_element_size ());
-
-    bytes_read += num_elements * ts->t8_element_size ();
+    if (forest->compact_transfer && t8_forest_element_codec_is_compact (ts)) {
+      bytes_read += t8_forest_element_decode (ts, recv_buffer + bytes_read, num_elements, element_insert);
+    }
+    else {
+      memcpy (element_insert, recv_buffer + bytes_read, num_elements * ts->t8_element_size ());
+      bytes_read += num_elements * ts->t8_element_size ();
+    }
     bytes_read += T8_ADD_PADDING (bytes_read);
     *current_element_offset += num_elements;
   }
@@ -1411,6 +1650,7 @@ t8_forest_ghost_create_ext (t8_forest_t forest, int unbalanced_version)
      * Only delete the line, if you know what you are doing. */
     t8_global_productionf ("Start ghost at %f  %f\n", sc_MPI_Wtime (), forest->profile->ghost_runtime);
   }
+  t8_forest_profile_timer_start (forest, "ghost");
 
   if (forest->element_offsets == NULL) {
     /* create element offset array if not done already */
@@ -1432,6 +1672,7 @@ t8_forest_ghost_create_ext (t8_forest_t forest, int unbalanced_version)
     if (forest->ghost_type == T8_GHOST_NONE) {
       t8_debugf ("WARNING: Trying to construct ghosts with ghost_type NONE. "
                  "Ghost layer is not constructed.\n");
+      t8_forest_profile_timer_stop (forest, "ghost");
       return;
     }
     /* Currently we only support face ghosts */
@@ -1441,6 +1682,11 @@ t8_forest_ghost_create_ext (t8_forest_t forest, int unbalanced_version)
     t8_forest_ghost_init (&forest->ghosts, forest->ghost_type);
     ghost = forest->ghosts;
 
+    if (forest->profile != NULL) {
+      /* Measure the time to find the remote elements */
+      forest->profile->ghost_remote_runtime = -sc_MPI_Wtime ();
+    }
+    t8_forest_profile_timer_start (forest, "remote");
     if (unbalanced_version == -1) {
       t8_forest_ghost_fill_remote_v3 (forest);
     }
@@ -1448,15 +1694,34 @@ t8_forest_ghost_create_ext (t8_forest_t forest, int unbalanced_version)
       /* Construct the remote elements and processes. */
       t8_forest_ghost_fill_remote (forest, ghost, unbalanced_version != 0);
     }
+    t8_forest_profile_timer_stop (forest, "remote");
+    if (forest->profile != NULL) {
+      forest->profile->ghost_remote_runtime += sc_MPI_Wtime ();
+      /* Measure the time to exchange the ghost elements */
+      forest->profile->ghost_comm_runtime = -sc_MPI_Wtime ();
+    }
 
     /* Start sending the remote elements */
+    t8_forest_profile_timer_start (forest, "send");
     send_info = t8_forest_ghost_send_start (forest, ghost, &requests);
+    t8_forest_profile_timer_stop (forest, "send");
 
     /* Receive the ghost elements from the remote processes */
+    t8_forest_profile_timer_start (forest, "receive");
     t8_forest_ghost_receive (forest, ghost);
+    t8_forest_profile_timer_stop (forest, "receive");
 
     /* End sending the remote elements */
+    t8_forest_profile_timer_start (forest, "wait");
     t8_forest_ghost_send_end (forest, ghost, send_info, requests);
+    t8_forest_profile_timer_stop (forest, "wait");
+    if (forest->profile != NULL) {
+      forest->profile->ghost_comm_runtime += sc_MPI_Wtime ();
+      /* Count the elements and messages */
+      t8_forest_profile_count (forest, "elements_sent", ghost->num_remote_elements);
+      t8_forest_profile_count (forest, "elements_received", ghost->num_ghosts_elements);
+      t8_forest_profile_count (forest, "messages_sent", ghost->remote_processes->elem_count);
+    }
   }
 
   if (create_element_array) {
@@ -1471,6 +1736,7 @@ t8_forest_ghost_create_ext (t8_forest_t forest, int unbalanced_version)
     /* Free the offset memory, if created */
     t8_shmem_array_destroy (&forest->global_first_desc);
   }
+  t8_forest_profile_timer_stop (forest, "ghost");
 
   if (forest->profile != NULL) {
     /* If profiling is enabled, we measure the runtime of ghost_create */
@@ -1647,7 +1913,7 @@ t8_forest_ghost_exchange_fill_send_buffer (t8_forest_t forest, int remote, char
   return byte_count;
 }
 
-static t8_ghost_data_exchange_t *
+t8_ghost_data_exchange_t *
 t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t *element_data)
 {
   t8_ghost_data_exchange_t *data_exchange;
@@ -1664,12 +1930,19 @@ t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t *element_data)
 
   T8_ASSERT (t8_forest_is_committed (forest));
   T8_ASSERT (element_data != NULL);
-  T8_ASSERT (forest->ghosts != NULL);
+
+  if (forest->ghosts == NULL) {
+    /* This process has no ghosts */
+    return NULL;
+  }
+  T8_ASSERT ((t8_locidx_t) element_data->elem_count
+             == t8_forest_get_local_num_elements (forest) + t8_forest_get_num_ghosts (forest));
 
   ghost = forest->ghosts;
 
   /* Allocate the new exchange context */
   data_exchange = T8_ALLOC (t8_ghost_data_exchange_t, 1);
+  data_exchange->forest = forest;
   /* The number of processes we need to send to */
   data_exchange->num_remotes = ghost->remote_processes->elem_count;
   /* Allocate MPI requests */
@@ -1739,15 +2012,27 @@ t8_forest_ghost_exchange_begin (t8_forest_t forest, sc_array_t *element_data)
   return data_exchange;
 }
 
-static void
+void
 t8_forest_ghost_exchange_end (t8_ghost_data_exchange_t *data_exchange)
 {
   int iproc;
+  t8_forest_t forest;
 
-  T8_ASSERT (data_exchange != NULL);
+  if (data_exchange == NULL) {
+    /* There was nothing to exchange */
+    return;
+  }
+  forest = data_exchange->forest;
+  if (forest->profile != NULL) {
+    /* Measure the time for ghost_exchange_end */
+    forest->profile->ghost_waittime = -sc_MPI_Wtime ();
+  }
   /* Wait for all communications to end */
   sc_MPI_Waitall (data_exchange->num_remotes, data_exchange->recv_requests, sc_MPI_STATUSES_IGNORE);
   sc_MPI_Waitall (data_exchange->num_remotes, data_exchange->send_requests, sc_MPI_STATUSES_IGNORE);
+  if (forest->profile != NULL) {
+    forest->profile->ghost_waittime += sc_MPI_Wtime ();
+  }
 
   /* Free the send buffers */
   for (iproc = 0; iproc < data_exchange->num_remotes; iproc++) {
@@ -1779,16 +2064,389 @@ t8_forest_ghost_exchange_data (t8_forest_t forest, sc_array_t *element_data)
              == t8_forest_get_local_num_elements (forest) + t8_forest_get_num_ghosts (forest));
 
   data_exchange = t8_forest_ghost_exchange_begin (forest, element_data);
+  t8_forest_ghost_exchange_end (data_exchange);
+  t8_debugf ("Finished ghost_exchange_data\n");
+}
+
+#if T8_ENABLE_MPI && defined(SC_ENABLE_MPIWINSHARED)
+/* Allocate the send buffer of a plan in a shared memory window of the ranks on this node
+ * and look up for each remote on the same node where the data that it sends to us starts
+ * in its part of the window. Returns true if the window was created. */
+static int
+t8_forest_ghost_exchange_plan_setup_shared (t8_forest_ghost_exchange_plan_t plan, const t8_locidx_t num_send)
+{
+  const sc_MPI_Comm comm = plan->forest->mpicomm;
+  sc_MPI_Comm internode;
+  MPI_Group group, node_group;
+  MPI_Aint window_size;
+  int *node_ranks, disp_unit, iremote, num_requests, mpiret;
+  t8_locidx_t *remote_send_offsets;
+  sc_MPI_Request *requests;
+  void *remote_base;
+
+  /* Get the communicator of the ranks on this node */
+  t8_shmem_init (comm);
+  sc_mpi_comm_get_node_comms (comm, &plan->intranode, &internode);
+  if (plan->intranode == sc_MPI_COMM_NULL) {
+    /* libsc could not split the communicator, we use messages for all remotes */
+    return 0;
+  }
+
+  /* Translate the ranks of the remotes to ranks on this node.
+   * Remotes on other nodes get MPI_UNDEFINED. */
+  node_ranks = T8_ALLOC (int, plan->num_remotes);
+  mpiret = MPI_Comm_group (comm, &group);
+  SC_CHECK_MPI (mpiret);
+  mpiret = MPI_Comm_group (plan->intranode, &node_group);
+  SC_CHECK_MPI (mpiret);
+  mpiret = MPI_Group_translate_ranks (group, plan->num_remotes, plan->remote_ranks, node_group, node_ranks);
+  SC_CHECK_MPI (mpiret);
+  mpiret = MPI_Group_free (&group);
+  SC_CHECK_MPI (mpiret);
+  mpiret = MPI_Group_free (&node_group);
+  SC_CHECK_MPI (mpiret);
+
+  /* Allocate the send buffer as this rank's part of the shared window */
+  mpiret = MPI_Win_allocate_shared ((MPI_Aint) num_send * plan->data_size, 1, MPI_INFO_NULL, plan->intranode,
+                                    (void *) &plan->send_buffer, &plan->window);
+  SC_CHECK_MPI (mpiret);
+  mpiret = MPI_Win_lock_all (MPI_MODE_NOCHECK, plan->window);
+  SC_CHECK_MPI (mpiret);
+  plan->node_barrier = sc_MPI_REQUEST_NULL;
+
+  /* Each remote on this node tells us the offset of our data in its send buffer */
+  remote_send_offsets = T8_ALLOC (t8_locidx_t, plan->num_remotes);
+  requests = T8_ALLOC (sc_MPI_Request, 2 * plan->num_remotes);
+  num_requests = 0;
+  for (iremote = 0; iremote < plan->num_remotes; iremote++) {
+    if (node_ranks[iremote] == MPI_UNDEFINED) {
+      continue;
+    }
+    mpiret = sc_MPI_Irecv (remote_send_offsets + iremote, 1, T8_MPI_LOCIDX, plan->remote_ranks[iremote],
+                           T8_MPI_GHOST_EXC_SHMEM, comm, requests + num_requests++);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Isend (plan->send_offsets + iremote, 1, T8_MPI_LOCIDX, plan->remote_ranks[iremote],
+                           T8_MPI_GHOST_EXC_SHMEM, comm, requests + num_requests++);
+    SC_CHECK_MPI (mpiret);
+  }
+  mpiret = sc_MPI_Waitall (num_requests, requests, sc_MPI_STATUSES_IGNORE);
+  SC_CHECK_MPI (mpiret);
+
+  /* Compute the addresses of the data that the remotes on this node send to us */
+  for (iremote = 0; iremote < plan->num_remotes; iremote++) {
+    if (node_ranks[iremote] == MPI_UNDEFINED) {
+      continue;
+    }
+    mpiret = MPI_Win_shared_query (plan->window, node_ranks[iremote], &window_size, &disp_unit, &remote_base);
+    SC_CHECK_MPI (mpiret);
+    T8_ASSERT (disp_unit == 1);
+    plan->shared_data[iremote] = (const char *) remote_base + remote_send_offsets[iremote] * plan->data_size;
+  }
+  t8_debugf ("Ghost exchange plan reads from %i of %i remotes through shared memory\n", num_requests / 2,
+             plan->num_remotes);
+
+  T8_FREE (node_ranks);
+  T8_FREE (remote_send_offsets);
+  T8_FREE (requests);
+  return 1;
+}
+#endif
+
+t8_forest_ghost_exchange_plan_t
+t8_forest_ghost_exchange_plan_new_ext (t8_forest_t forest, size_t data_size, int use_shared_memory)
+{
+  t8_forest_ghost_exchange_plan_t plan;
+  t8_forest_ghost_t ghost;
+  t8_ghost_remote_t *remote_entry;
+  t8_ghost_remote_tree_t *remote_tree;
+  t8_ghost_process_hash_t *proc_entry;
+  t8_locidx_t num_send, isend, itree, ielement, ltreeid, tree_offset;
+  int iremote;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (data_size > 0);
+
+  plan = T8_ALLOC_ZERO (struct t8_forest_ghost_exchange_plan, 1);
+  t8_forest_ref (forest);
+  plan->forest = forest;
+  plan->data_size = data_size;
+
+  ghost = forest->ghosts;
+  if (ghost == NULL) {
+    /* This process has no ghosts, the plan has no remotes. If shared memory is used,
+     * we still take part in the window creation and the node barriers with an empty
+     * send buffer, since these are collective over all ranks on this node. */
+    plan->send_offsets = T8_ALLOC_ZERO (t8_locidx_t, 1);
+    plan->recv_offsets = T8_ALLOC_ZERO (t8_locidx_t, 1);
+    num_send = 0;
+  }
+  else {
+    plan->num_remotes = ghost->remote_processes->elem_count;
+    plan->remote_ranks = (int *) ghost->remote_processes->array;
+    plan->send_offsets = T8_ALLOC (t8_locidx_t, plan->num_remotes + 1);
+    plan->recv_offsets = T8_ALLOC (t8_locidx_t, plan->num_remotes + 1);
+    plan->shared_data = T8_ALLOC_ZERO (const char *, plan->num_remotes);
+
+    /* Count the elements to send to each remote and look up the
+     * offsets of the received ghosts. */
+    plan->send_offsets[0] = 0;
+    for (iremote = 0; iremote < plan->num_remotes; iremote++) {
+      remote_entry = t8_forest_ghost_get_remote (forest, plan->remote_ranks[iremote]);
+      plan->send_offsets[iremote + 1] = plan->send_offsets[iremote] + remote_entry->num_elements;
+      proc_entry = t8_forest_ghost_get_proc_info (forest, plan->remote_ranks[iremote]);
+      plan->recv_offsets[iremote] = proc_entry->ghost_offset;
+    }
+    plan->recv_offsets[plan->num_remotes] = ghost->num_ghosts_elements;
+    num_send = plan->send_offsets[plan->num_remotes];
+
+    /* Compute the flat list of local element indices that we send */
+    plan->send_indices = T8_ALLOC (t8_locidx_t, num_send);
+    isend = 0;
+    for (iremote = 0; iremote < plan->num_remotes; iremote++) {
+      remote_entry = t8_forest_ghost_get_remote (forest, plan->remote_ranks[iremote]);
+      for (itree = 0; itree < (t8_locidx_t) remote_entry->remote_trees.elem_count; itree++) {
+        remote_tree = (t8_ghost_remote_tree_t *) t8_sc_array_index_locidx (&remote_entry->remote_trees, itree);
+        ltreeid = t8_forest_get_local_id (forest, remote_tree->global_id);
+        tree_offset = t8_forest_get_tree_element_offset (forest, ltreeid);
+        for (ielement = 0; ielement < (t8_locidx_t) remote_tree->element_indices.elem_count; ielement++) {
+          plan->send_indices[isend++]
+            = tree_offset + *(t8_locidx_t *) t8_sc_array_index_locidx (&remote_tree->element_indices, ielement);
+        }
+      }
+      T8_ASSERT (isend == plan->send_offsets[iremote + 1]);
+    }
+  }
+
+  /* Allocate the send buffer once, if possible in shared memory */
+#if T8_ENABLE_MPI && defined(SC_ENABLE_MPIWINSHARED)
+  if (use_shared_memory) {
+    plan->use_shared = t8_forest_ghost_exchange_plan_setup_shared (plan, num_send);
+  }
+#endif
+  if (!plan->use_shared) {
+    plan->send_buffer = T8_ALLOC (char, num_send * data_size);
+  }
+
+  /* All remotes whose data we cannot read from shared memory exchange messages */
+  plan->message_remotes = T8_ALLOC (int, plan->num_remotes);
+  plan->num_message_remotes = 0;
+  for (iremote = 0; iremote < plan->num_remotes; iremote++) {
+    if (plan->shared_data[iremote] == NULL) {
+      plan->message_remotes[plan->num_message_remotes++] = iremote;
+    }
+  }
+  plan->requests = T8_ALLOC (sc_MPI_Request, 2 * plan->num_message_remotes);
+  return plan;
+}
+
+t8_forest_ghost_exchange_plan_t
+t8_forest_ghost_exchange_plan_new (t8_forest_t forest, size_t data_size)
+{
+  return t8_forest_ghost_exchange_plan_new_ext (forest, data_size, 0);
+}
+
+/* Free the persistent requests of a plan, if created. */
+static void
+t8_forest_ghost_exchange_plan_free_requests (t8_forest_ghost_exchange_plan_t plan)
+{
+#if T8_ENABLE_MPI
+  int ireq, mpiret;
+
+  if (plan->requests_are_persistent) {
+    for (ireq = 0; ireq < 2 * plan->num_message_remotes; ireq++) {
+      mpiret = MPI_Request_free (plan->requests + ireq);
+      SC_CHECK_MPI (mpiret);
+    }
+  }
+#endif
+  plan->requests_are_persistent = 0;
+  plan->recv_data = NULL;
+}
+
+#if T8_ENABLE_MPI && defined(SC_ENABLE_MPIWINSHARED)
+/* Wait until all ranks on this node passed the last barrier of a plan
+ * and synchronize the shared window. */
+static void
+t8_forest_ghost_exchange_plan_wait_node (t8_forest_ghost_exchange_plan_t plan)
+{
+  int mpiret;
+
+  mpiret = sc_MPI_Wait (&plan->node_barrier, sc_MPI_STATUS_IGNORE);
+  SC_CHECK_MPI (mpiret);
+  mpiret = MPI_Win_sync (plan->window);
+  SC_CHECK_MPI (mpiret);
+}
+
+/* Synchronize the shared window and start a barrier of all ranks on this node. */
+static void
+t8_forest_ghost_exchange_plan_start_node_barrier (t8_forest_ghost_exchange_plan_t plan)
+{
+  int mpiret;
+
+  mpiret = MPI_Win_sync (plan->window);
+  SC_CHECK_MPI (mpiret);
+  mpiret = MPI_Ibarrier (plan->intranode, &plan->node_barrier);
+  SC_CHECK_MPI (mpiret);
+}
+#endif
+
+void
+t8_forest_ghost_exchange_plan_begin (t8_forest_ghost_exchange_plan_t plan, sc_array_t *element_data)
+{
+  t8_forest_t forest;
+  t8_locidx_t isend;
+  size_t data_size;
+
+  T8_ASSERT (plan != NULL);
+  T8_ASSERT (!plan->active);
+  T8_ASSERT (element_data != NULL);
+  T8_ASSERT (element_data->elem_size == plan->data_size);
+
+  forest = plan->forest;
+  T8_ASSERT ((t8_locidx_t) element_data->elem_count
+             == t8_forest_get_local_num_elements (forest) + t8_forest_get_num_ghosts (forest));
+  plan->active = 1;
+  plan->element_data = element_data;
+  if (plan->num_remotes == 0 && !plan->use_shared) {
+    return;
+  }
+  data_size = plan->data_size;
+
+#if T8_ENABLE_MPI && defined(SC_ENABLE_MPIWINSHARED)
+  if (plan->use_shared) {
+    /* The ranks on this node may still read the send buffer of the previous exchange */
+    t8_forest_ghost_exchange_plan_wait_node (plan);
+  }
+#endif
+
+  /* Gather the data of all elements that we send */
+  for (isend = 0; isend < plan->send_offsets[plan->num_remotes]; isend++) {
+    memcpy (plan->send_buffer + isend * data_size, sc_array_index (element_data, plan->send_indices[isend]),
+            data_size);
+  }
+
+#if T8_ENABLE_MPI
+  const t8_locidx_t num_local = t8_forest_get_local_num_elements (forest);
+  sc_MPI_Request *recv_requests = plan->requests;
+  sc_MPI_Request *send_requests = plan->requests + plan->num_message_remotes;
+  int imessage, iremote, mpiret;
+
+#if defined(SC_ENABLE_MPIWINSHARED)
+  if (plan->use_shared) {
+    /* Signal the ranks on this node that the send buffer is filled */
+    t8_forest_ghost_exchange_plan_start_node_barrier (plan);
+  }
+#endif
+  if (plan->requests_are_persistent && plan->recv_data != element_data->array) {
+    /* The receive requests are bound to another array, we rebuild them */
+    t8_forest_ghost_exchange_plan_free_requests (plan);
+  }
+  if (!plan->requests_are_persistent) {
+    for (imessage = 0; imessage < plan->num_message_remotes; imessage++) {
+      iremote = plan->message_remotes[imessage];
+      mpiret = MPI_Recv_init (sc_array_index (element_data, num_local + plan->recv_offsets[iremote]),
+                              (plan->recv_offsets[iremote + 1] - plan->recv_offsets[iremote]) * data_size, MPI_BYTE,
+                              plan->remote_ranks[iremote], T8_MPI_GHOST_EXC_FOREST, forest->mpicomm,
+                              recv_requests + imessage);
+      SC_CHECK_MPI (mpiret);
+      mpiret = MPI_Send_init (plan->send_buffer + plan->send_offsets[iremote] * data_size,
+                              (plan->send_offsets[iremote + 1] - plan->send_offsets[iremote]) * data_size, MPI_BYTE,
+                              plan->remote_ranks[iremote], T8_MPI_GHOST_EXC_FOREST, forest->mpicomm,
+                              send_requests + imessage);
+      SC_CHECK_MPI (mpiret);
+    }
+    plan->requests_are_persistent = 1;
+    plan->recv_data = element_data->array;
+  }
+  if (plan->num_message_remotes > 0) {
+    mpiret = MPI_Startall (2 * plan->num_message_remotes, plan->requests);
+    SC_CHECK_MPI (mpiret);
+  }
+#else
+  /* Without MPI there are no remote processes */
+  SC_ABORT_NOT_REACHED ();
+#endif
+}
+
+void
+t8_forest_ghost_exchange_plan_end (t8_forest_ghost_exchange_plan_t plan)
+{
+  t8_forest_t forest;
+  int mpiret;
+
+  T8_ASSERT (plan != NULL);
+  T8_ASSERT (plan->active);
+
+  forest = plan->forest;
+  plan->active = 0;
+  if (plan->num_remotes == 0 && !plan->use_shared) {
+    return;
+  }
   if (forest->profile != NULL) {
-    /* Measure the time for ghost_exchange_end */
     forest->profile->ghost_waittime = -sc_MPI_Wtime ();
   }
-  t8_forest_ghost_exchange_end (data_exchange);
+  /* Wait for all receives and sends to complete. Persistent requests stay allocated. */
+  mpiret = sc_MPI_Waitall (2 * plan->num_message_remotes, plan->requests, sc_MPI_STATUSES_IGNORE);
+  SC_CHECK_MPI (mpiret);
+#if T8_ENABLE_MPI && defined(SC_ENABLE_MPIWINSHARED)
+  if (plan->use_shared) {
+    const t8_locidx_t num_local = t8_forest_get_local_num_elements (forest);
+    int iremote;
+
+    /* Wait until the ranks on this node filled their send buffers */
+    t8_forest_ghost_exchange_plan_wait_node (plan);
+    /* Copy the ghost data of the remotes on this node directly from their send buffers */
+    for (iremote = 0; iremote < plan->num_remotes; iremote++) {
+      if (plan->shared_data[iremote] != NULL) {
+        memcpy (sc_array_index (plan->element_data, num_local + plan->recv_offsets[iremote]),
+                plan->shared_data[iremote],
+                (plan->recv_offsets[iremote + 1] - plan->recv_offsets[iremote]) * plan->data_size);
+      }
+    }
+    /* Signal the ranks on this node that we are done reading their send buffers */
+    t8_forest_ghost_exchange_plan_start_node_barrier (plan);
+  }
+#endif
+  plan->element_data = NULL;
   if (forest->profile != NULL) {
-    /* Measure the time for ghost_exchange_end */
     forest->profile->ghost_waittime += sc_MPI_Wtime ();
   }
-  t8_debugf ("Finished ghost_exchange_data\n");
+}
+
+void
+t8_forest_ghost_exchange_plan_destroy (t8_forest_ghost_exchange_plan_t *pplan)
+{
+  t8_forest_ghost_exchange_plan_t plan;
+
+  T8_ASSERT (pplan != NULL);
+  plan = *pplan;
+  T8_ASSERT (plan != NULL);
+  T8_ASSERT (!plan->active);
+
+  t8_forest_ghost_exchange_plan_free_requests (plan);
+#if T8_ENABLE_MPI && defined(SC_ENABLE_MPIWINSHARED)
+  if (plan->use_shared) {
+    int mpiret;
+
+    /* The send buffer is freed together with the window */
+    t8_forest_ghost_exchange_plan_wait_node (plan);
+    mpiret = MPI_Win_unlock_all (plan->window);
+    SC_CHECK_MPI (mpiret);
+    mpiret = MPI_Win_free (&plan->window);
+    SC_CHECK_MPI (mpiret);
+    plan->send_buffer = NULL;
+  }
+#endif
+  T8_FREE (plan->send_offsets);
+  T8_FREE (plan->recv_offsets);
+  T8_FREE (plan->send_indices);
+  T8_FREE (plan->send_buffer);
+  T8_FREE (plan->shared_data);
+  T8_FREE (plan->message_remotes);
+  T8_FREE (plan->requests);
+  t8_forest_unref (&plan->forest);
+  T8_FREE (plan);
+  *pplan = NULL;
 }
 
 /* Print a forest ghost structure */
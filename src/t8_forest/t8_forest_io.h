@@ -30,11 +30,60 @@
 #define T8_FOREST_IO_H
 
 #include <t8_vtk.h>
+#include <t8_forest/t8_forest_general.h>
 T8_EXTERN_C_BEGIN ();
 
-/* TODO: implement */
-void
-t8_forest_save (t8_forest_t forest);
+/** Increment this constant each time the forest file format changes.
+ *  We can only read files that were written in the same format. */
+#define T8_FOREST_FORMAT 0x0001
+
+/** Save a forest to a binary checkpoint.
+ * The coarse mesh is written with \ref t8_cmesh_save to the files fileprefix_RANK.cmesh.
+ * The partition, the elements and optionally user data for each element are written
+ * with MPI-IO into the single shared file fileprefix.t8f.
+ * The file is written in the native byte order.
+ * This function is collective and must be called on each process.
+ * \param [in]      forest        A committed forest. Its coarse mesh must use the linear geometry.
+ * \param [in]      fileprefix    The prefix of the files.
+ * \param [in]      data_size     The number of bytes of user data per element, or 0.
+ * \param [in]      element_data  If \a data_size > 0, an array of \a data_size bytes per local element.
+ * \return  True if successful, false if not (same value on all processes).
+ * \see t8_forest_load
+ */
+int
+t8_forest_save (t8_forest_t forest, const char *fileprefix, const size_t data_size, const void *element_data);
+
+/** Load a forest from a checkpoint written with \ref t8_forest_save.
+ * The forest may be loaded on a different number of processes than it was saved.
+ * If the number of processes is the same, the saved partition is restored.
+ * Otherwise, the elements are partitioned evenly among the processes.
+ * A forest with a partitioned coarse mesh can only be loaded on at least as many processes
+ * as it was saved.
+ * This function is collective and must be called on each process.
+ * \param [in]      fileprefix    The prefix that was passed to \ref t8_forest_save.
+ * \param [in]      scheme        The scheme of the elements. We take ownership.
+ * \param [in]      comm          The MPI communicator of the new forest.
+ * \param [in, out] element_data  If not NULL, an initialized array with element size equal to
+ *                                the data size of the checkpoint. On output it holds the
+ *                                user data of the local elements.
+ * \return  The committed forest.
+ * \see t8_forest_set_load
+ */
+t8_forest_t
+t8_forest_load (const char *fileprefix, t8_scheme_cxx_t *scheme, sc_MPI_Comm comm, sc_array_t *element_data);
+
+/** Read the user data of the elements of a forest from a checkpoint.
+ * \a forest must contain the same elements as the checkpoint, in any partition,
+ * for example after loading it with \ref t8_forest_set_load and repartitioning it.
+ * This function is collective and must be called on each process.
+ * \param [in]      forest        A committed forest.
+ * \param [in]      fileprefix    The prefix that was passed to \ref t8_forest_save.
+ * \param [in, out] element_data  An initialized array with element size equal to the data size
+ *                                of the checkpoint. On output it holds the data of the local elements.
+ * \return  True if successful, false if not (same value on all processes).
+ */
+int
+t8_forest_load_element_data (t8_forest_t forest, const char *fileprefix, sc_array_t *element_data);
 
 /** Write the forest in a parallel vtu format. Extended version.
  * See \ref t8_forest_write_vtk for the standard version of this function.
@@ -75,6 +124,41 @@ t8_forest_write_vtk_ext (t8_forest_t forest, const char *fileprefix, const int w
                          const int write_level, const int write_element_id, const int write_ghosts,
                          const int write_curved, int do_not_use_API, const int num_data, t8_vtk_data_field_t *data);
 
+/** Write the forest in a parallel vtu format with the inbuilt writer and
+ * a given data format. The VTK library is not used.
+ * Writes one master .pvtu file and each process writes in its own .vtu file.
+ * Forest must be committed when calling this function.
+ * This function is collective and must be called on each process.
+ * \param [in]      forest              The forest to write.
+ * \param [in]      fileprefix          The prefix of the files where the vtk will
+ *                                      be stored. The master file is then fileprefix.pvtu
+ *                                      and the process with rank r writes in the file
+ *                                      fileprefix_r.vtu.
+ * \param [in]      format              The format of the data arrays. Binary and appended
+ *                                      output is considerably faster and smaller than ASCII.
+ * \param [in]      write_treeid        If true, the global tree id is written for each element.
+ * \param [in]      write_mpirank       If true, the mpirank is written for each element.
+ * \param [in]      write_level         If true, the refinement level is written for each element.
+ * \param [in]      write_element_id    If true, the global element id is written for each element.
+ * \param [in]      write_ghosts        If true, each process additionally writes its ghost elements.
+ *                                      For ghost element the treeid is -1.
+ * \param [in]      write_shared_points If true, each point that is shared by several elements
+ *                                      is written only once and the cells refer to common points.
+ *                                      This reduces the file size considerably and allows point based
+ *                                      post-processing. Point data is averaged over the local elements.
+ * \param [in]      num_data            Number of user defined double valued data fields to write.
+ * \param [in]      data                Array of t8_vtk_data_field_t of length \a num_data
+ *                                      providing the user defined per element data.
+ *                                      If scalar and vector fields are used, all scalar fields
+ *                                      must come first in the array.
+ * \return  True if successful, false if not (process local).
+ */
+int
+t8_forest_write_vtk_format (t8_forest_t forest, const char *fileprefix, const t8_vtk_format_t format,
+                            const int write_treeid, const int write_mpirank, const int write_level,
+                            const int write_element_id, const int write_ghosts, const int write_shared_points,
+                            const int num_data, t8_vtk_data_field_t *data);
+
 /** Write the forest in a parallel vtu format. Writes one master
  * .pvtu file and each process writes in its own .vtu file.
  * If linked, the VTK API is used.
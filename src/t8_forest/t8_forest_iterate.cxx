@@ -23,7 +23,9 @@
 #include <t8_forest/t8_forest_iterate.h>
 #include <t8_forest/t8_forest_types.h>
 #include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_private.h>
 #include <t8_element.hxx>
+#include <t8_element_buffer.hxx>
 
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
@@ -156,24 +158,120 @@ t8_forest_iterate_faces (t8_forest_t forest, t8_locidx_t ltreeid, const t8_eleme
   }
 }
 
-/* The recursion that is called from t8_forest_search_tree
+/* Preallocated memory of the non-recursive search.
+ * The search keeps an explicit stack with one frame per refinement level below
+ * the nearest common ancestor of a tree's leaves. The memory is allocated once
+ * per call of t8_forest_search and reused for all trees and elements. */
+typedef struct
+{
+  int max_depth;                              /* The number of frames of the stack. */
+  int max_children[T8_ECLASS_COUNT];          /* For each eclass the maximum number of children of an element. */
+  t8_element_t **children[T8_ECLASS_COUNT];   /* For each eclass max_depth * max_children elements or NULL. */
+  size_t *split_offsets;                      /* For each frame max_children + 1 offsets of the children's leaves. */
+  int *num_children;                          /* For each frame the number of children of its element. */
+  int *next_child;                            /* For each frame the next child to visit. */
+  size_t *leaf_offsets;                       /* For each frame the index of the element's first leaf in the tree. */
+  size_t *leaf_counts;                        /* For each frame the number of leaves of the element. */
+  size_t *query_offsets;                      /* For each frame the start of its active queries in active_queries. */
+  sc_array_t active_queries;                  /* The active queries of all frames, stored contiguously. */
+  int *query_matches;                         /* One entry for each query. */
+} t8_forest_search_scratch_t;
+
+/* Allocate the memory of the search. */
+static void
+t8_forest_search_scratch_init (t8_forest_t forest, t8_forest_search_scratch_t *scratch, const sc_array_t *queries)
+{
+  const int max_children = 10; /* Pyramids have the most children */
+
+  /* The depth below the nearest common ancestor of a tree is at most maxlevel. */
+  scratch->max_depth = t8_forest_get_maxlevel (forest) + 1;
+  for (int eclass = T8_ECLASS_ZERO; eclass < T8_ECLASS_COUNT; eclass++) {
+    scratch->max_children[eclass] = 0;
+    scratch->children[eclass] = NULL;
+  }
+  scratch->split_offsets = T8_ALLOC (size_t, scratch->max_depth * (max_children + 1));
+  scratch->num_children = T8_ALLOC (int, scratch->max_depth);
+  scratch->next_child = T8_ALLOC (int, scratch->max_depth);
+  scratch->leaf_offsets = T8_ALLOC (size_t, scratch->max_depth);
+  scratch->leaf_counts = T8_ALLOC (size_t, scratch->max_depth);
+  scratch->query_offsets = T8_ALLOC (size_t, scratch->max_depth);
+  sc_array_init (&scratch->active_queries, sizeof (size_t));
+  scratch->query_matches = NULL;
+  if (queries != NULL) {
+    const size_t num_queries = queries->elem_count;
+    /* Initially all queries are active, we write 0, 1, 2, 3,... into the buffer */
+    sc_array_resize (&scratch->active_queries, num_queries);
+    for (size_t iquery = 0; iquery < num_queries; ++iquery) {
+      *(size_t *) sc_array_index (&scratch->active_queries, iquery) = iquery;
+    }
+    scratch->query_matches = T8_ALLOC (int, SC_MAX (num_queries, 1));
+  }
+}
+
+/* Return the children buffer of a frame for a given scheme, allocating the elements
+ * of the scheme on first use. */
+static t8_element_t **
+t8_forest_search_scratch_children (t8_forest_search_scratch_t *scratch, const t8_eclass_t eclass,
+                                   const t8_eclass_scheme_c *ts, const int depth)
+{
+  if (scratch->children[eclass] == NULL) {
+    t8_element_t *root;
+    /* The root element has the maximum number of children of all elements of its class. */
+    ts->t8_element_new (1, &root);
+    ts->t8_element_root (root);
+    scratch->max_children[eclass] = ts->t8_element_num_children (root);
+    ts->t8_element_destroy (1, &root);
+    const int num_elements = scratch->max_depth * scratch->max_children[eclass];
+    scratch->children[eclass] = T8_ALLOC (t8_element_t *, num_elements);
+    ts->t8_element_new (num_elements, scratch->children[eclass]);
+  }
+  T8_ASSERT (0 <= depth && depth < scratch->max_depth);
+  return scratch->children[eclass] + depth * scratch->max_children[eclass];
+}
+
+/* Free the memory of the search. */
+static void
+t8_forest_search_scratch_reset (t8_forest_t forest, t8_forest_search_scratch_t *scratch)
+{
+  for (int eclass = T8_ECLASS_ZERO; eclass < T8_ECLASS_COUNT; eclass++) {
+    if (scratch->children[eclass] != NULL) {
+      const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, (t8_eclass_t) eclass);
+      ts->t8_element_destroy (scratch->max_depth * scratch->max_children[eclass], scratch->children[eclass]);
+      T8_FREE (scratch->children[eclass]);
+    }
+  }
+  T8_FREE (scratch->split_offsets);
+  T8_FREE (scratch->num_children);
+  T8_FREE (scratch->next_child);
+  T8_FREE (scratch->leaf_offsets);
+  T8_FREE (scratch->leaf_counts);
+  T8_FREE (scratch->query_offsets);
+  sc_array_reset (&scratch->active_queries);
+  T8_FREE (scratch->query_matches);
+}
+
+/* Call the callbacks of the search for one element.
  * Input is an element and an array of all leaf elements of this element.
  * The callback function is called on element and if it returns true,
  * the search continues with the children of the element.
  * Additionally a query function and a set of queries can be given.
- * In this case the recursion stops when either the search_fn function
+ * In this case the search stops when either the search_fn function
  * returns false or the query_fn function returns false for all active queries.
- * (Thus, if there are no active queries left, the recursion also stops.)
+ * (Thus, if there are no active queries left, the search also stops.)
  * A query is active for an element if the query_fn callback returned true
- * for the parent element.
+ * for the parent element. The active queries of the element are the entries
+ * query_offset, ..., query_offset + num_active - 1 of scratch->active_queries.
  * If the callback function (search_fn) returns false for an element,
  * the query function is not called for this element.
+ * Returns true if the search continues with the children. In this case the queries
+ * that are active for the children are appended to scratch->active_queries.
  */
-static void
-t8_forest_search_recursion (t8_forest_t forest, const t8_locidx_t ltreeid, t8_element_t *element,
-                            const t8_eclass_scheme_c *ts, t8_element_array_t *leaf_elements,
-                            const t8_locidx_t tree_lindex_of_first_leaf, t8_forest_search_fn search_fn,
-                            t8_forest_query_fn query_fn, sc_array_t *queries, sc_array_t *active_queries)
+static int
+t8_forest_search_element (t8_forest_t forest, const t8_locidx_t ltreeid, const t8_element_t *element,
+                          const t8_eclass_scheme_c *ts, t8_element_array_t *leaf_elements,
+                          const t8_locidx_t tree_lindex_of_first_leaf, t8_forest_search_fn search_fn,
+                          t8_forest_query_fn query_fn, sc_array_t *queries, t8_forest_search_scratch_t *scratch,
+                          const size_t query_offset, const size_t num_active)
 {
   /* Assertions to check for necessary requirements */
   /* The forest must be committed */
@@ -186,12 +284,11 @@ t8_forest_search_recursion (t8_forest_t forest, const t8_locidx_t ltreeid, t8_el
   const size_t elem_count = t8_element_array_get_count (leaf_elements);
   if (elem_count == 0) {
     /* There are no leaves left, so we have nothing to do */
-    return;
+    return 0;
   }
-  const size_t num_active = queries == NULL ? 0 : active_queries->elem_count;
   if (queries != NULL && num_active == 0) {
-    /* There are no queries left. We stop the recursion */
-    return;
+    /* There are no queries left. We stop the search */
+    return 0;
   }
 
   int is_leaf = 0;
@@ -212,89 +309,65 @@ t8_forest_search_recursion (t8_forest_t forest, const t8_locidx_t ltreeid, t8_el
   const int ret = search_fn (forest, ltreeid, element, is_leaf, leaf_elements, tree_lindex_of_first_leaf);
 
   if (!ret) {
-    /* The function returned false. We abort the recursion */
-    return;
+    /* The function returned false. We abort the search of this element */
+    return 0;
   }
 
   /* Check the queries.
-   * If the current element is not a leaf, we store the queries that
+   * If the current element is not a leaf, we append the queries that
    * return true in order to pass them on to the children of the element. */
-  sc_array_t *new_active_queries = NULL;
   if (num_active > 0) {
+    sc_array_t *active_queries = &scratch->active_queries;
+    const size_t new_offset = active_queries->elem_count;
+    sc_array_t query_indices;
+
+    /* Reserve the space for the new active queries, such that the view below stays valid */
     if (!is_leaf) {
-      /* Initialize the new active query array */
-      new_active_queries = sc_array_new (sizeof (size_t));
+      sc_array_resize (active_queries, new_offset + num_active);
     }
-    int *active_queries_matches = T8_ALLOC (int, num_active);
+    /* The queries of this element as one contiguous batch */
+    sc_array_init_view (&query_indices, active_queries, query_offset, num_active);
     T8_ASSERT (query_fn != NULL);
-    query_fn (forest, ltreeid, element, is_leaf, leaf_elements, tree_lindex_of_first_leaf, queries, active_queries,
-              active_queries_matches, num_active);
+    query_fn (forest, ltreeid, element, is_leaf, leaf_elements, tree_lindex_of_first_leaf, queries, &query_indices,
+              scratch->query_matches, num_active);
 
-    for (size_t iactive = 0; iactive < num_active; iactive++) {
-      if (!is_leaf && active_queries_matches[iactive]) {
-        size_t query_index = *(size_t *) sc_array_index (active_queries, iactive);
-        *(size_t *) sc_array_push (new_active_queries) = query_index;
+    if (!is_leaf) {
+      const size_t *indices = (const size_t *) sc_array_index (active_queries, query_offset);
+      size_t *new_indices = (size_t *) sc_array_index (active_queries, new_offset);
+      size_t num_new_active = 0;
+      for (size_t iactive = 0; iactive < num_active; iactive++) {
+        if (scratch->query_matches[iactive]) {
+          new_indices[num_new_active++] = indices[iactive];
+        }
+      }
+      sc_array_resize (active_queries, new_offset + num_new_active);
+      if (num_new_active == 0) {
+        /* No queries returned true for this element. We abort the search of this element */
+        return 0;
       }
     }
-    T8_FREE (active_queries_matches);
   }
 
-  if (is_leaf) {
-    /* The element was a leaf. We abort the recursion. */
-    return;
-  }
-
-  if (num_active > 0 && new_active_queries->elem_count == 0) {
-    /* No queries returned true for this element. We abort the recursion */
-    sc_array_destroy (new_active_queries);
-    return;
-  }
-
-  /* Enter the recursion (the element is definitely not a leaf at this point) */
-  /* We compute all children of E, compute their leaf arrays and call search_recursion */
-  /* allocate the memory to store the children */
-  const int num_children = ts->t8_element_num_children (element);
-  t8_element_t **children = T8_ALLOC (t8_element_t *, num_children);
-  ts->t8_element_new (num_children, children);
-  /* Memory for the indices that split the leaf_elements array */
-  size_t *split_offsets = T8_ALLOC (size_t, num_children + 1);
-  /* Compute the children */
-  ts->t8_element_children (element, num_children, children);
-  /* Split the leaves array in portions belonging to the children of element */
-  t8_forest_split_array (element, leaf_elements, split_offsets);
-  for (int ichild = 0; ichild < num_children; ichild++) {
-    /* Check if there are any leaf elements for this child */
-    const size_t indexa = split_offsets[ichild];     /* first leaf of this child */
-    const size_t indexb = split_offsets[ichild + 1]; /* first leaf of next child */
-    if (indexa < indexb) {
-      t8_element_array_t child_leaves;
-      /* There exist leaves of this child in leaf_elements,
-       * we construct an array of these leaves */
-      t8_element_array_init_view (&child_leaves, leaf_elements, indexa, indexb - indexa);
-      /* Enter the recursion */
-      t8_forest_search_recursion (forest, ltreeid, children[ichild], ts, &child_leaves,
-                                  indexa + tree_lindex_of_first_leaf, search_fn, query_fn, queries, new_active_queries);
-    }
-  }
-  /* clean-up */
-  ts->t8_element_destroy (num_children, children);
-  T8_FREE (children);
-  T8_FREE (split_offsets);
-  if (num_active > 0) {
-    sc_array_destroy (new_active_queries);
-  }
+  /* The element was a leaf. We abort the search of this element. */
+  return !is_leaf;
 }
 
-/* Perform a top-down search in one tree of the forest */
+/* Perform a top-down search in one tree of the forest.
+ * We traverse the elements in the same depth-first order as a recursive
+ * search would, but store the state of each level on an explicit stack
+ * in the preallocated scratch memory. */
 static void
 t8_forest_search_tree (t8_forest_t forest, t8_locidx_t ltreeid, t8_forest_search_fn search_fn,
-                       t8_forest_query_fn query_fn, sc_array_t *queries, sc_array_t *active_queries)
+                       t8_forest_query_fn query_fn, sc_array_t *queries, t8_forest_search_scratch_t *scratch)
 {
 
   /* Get the element class, scheme and leaf elements of this tree */
   const t8_eclass_t eclass = t8_forest_get_eclass (forest, ltreeid);
   const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, eclass);
   t8_element_array_t *leaf_elements = t8_forest_tree_get_leaves (forest, ltreeid);
+  t8_element_array_t element_leaves;
+  sc_array_t *active_queries = &scratch->active_queries;
+  const size_t num_queries = queries == NULL ? 0 : queries->elem_count;
 
   /* assert for empty tree */
   T8_ASSERT (t8_element_array_get_count (leaf_elements) >= 0);
@@ -303,39 +376,102 @@ t8_forest_search_tree (t8_forest_t forest, t8_locidx_t ltreeid, t8_forest_search
   const t8_element_t *last_el
     = t8_element_array_index_locidx (leaf_elements, t8_element_array_get_count (leaf_elements) - 1);
   /* Compute their nearest common ancestor */
-  t8_element_t *nca;
-  ts->t8_element_new (1, &nca);
+  t8_element_buffer<1> buffer (ts);
+  t8_element_t *nca = buffer[0];
   ts->t8_element_nca (first_el, last_el, nca);
 
-  /* Start the top-down search */
-  t8_forest_search_recursion (forest, ltreeid, nca, ts, leaf_elements, 0, search_fn, query_fn, queries, active_queries);
+  /* Search the nearest common ancestor. Initially all queries are active. */
+  T8_ASSERT (active_queries->elem_count == num_queries);
+  if (!t8_forest_search_element (forest, ltreeid, nca, ts, leaf_elements, 0, search_fn, query_fn, queries, scratch, 0,
+                                 num_queries)) {
+    sc_array_resize (active_queries, num_queries);
+    return;
+  }
 
-  ts->t8_element_destroy (1, &nca);
+  /* Push the nearest common ancestor on the stack */
+  int depth = 0;
+  const t8_element_t *element = nca;
+  scratch->leaf_offsets[0] = 0;
+  scratch->leaf_counts[0] = t8_element_array_get_count (leaf_elements);
+  scratch->query_offsets[0] = num_queries;
+  for (;;) {
+    /* The element of the current frame continues the search.
+     * We compute its children and split its leaves among them. */
+    SC_CHECK_ABORT (depth < scratch->max_depth, "Search: exceeded the maximum refinement level\n");
+    t8_element_t **children = t8_forest_search_scratch_children (scratch, eclass, ts, depth);
+    size_t *split_offsets = scratch->split_offsets + depth * (scratch->max_children[eclass] + 1);
+    const int num_children = ts->t8_element_num_children (element);
+    T8_ASSERT (num_children <= scratch->max_children[eclass]);
+    ts->t8_element_children (element, num_children, children);
+    t8_element_array_init_view (&element_leaves, leaf_elements, scratch->leaf_offsets[depth],
+                                scratch->leaf_counts[depth]);
+    t8_forest_split_array (element, &element_leaves, split_offsets);
+    scratch->num_children[depth] = num_children;
+    scratch->next_child[depth] = 0;
+
+    /* Find the next child that continues the search, popping finished frames */
+    for (;;) {
+      if (scratch->next_child[depth] == scratch->num_children[depth]) {
+        /* All children of this frame are done, we remove the queries that were active for them and pop it */
+        sc_array_resize (active_queries, scratch->query_offsets[depth]);
+        if (depth == 0) {
+          /* The search of this tree is finished */
+          T8_ASSERT (active_queries->elem_count == num_queries);
+          return;
+        }
+        depth--;
+        continue;
+      }
+      const int ichild = scratch->next_child[depth]++;
+      const size_t *offsets = scratch->split_offsets + depth * (scratch->max_children[eclass] + 1);
+      /* Check if there are any leaf elements for this child */
+      const size_t indexa = offsets[ichild];     /* first leaf of this child */
+      const size_t indexb = offsets[ichild + 1]; /* first leaf of next child */
+      if (indexa == indexb) {
+        continue;
+      }
+      /* There exist leaves of this child, we construct an array of these leaves */
+      const size_t first_leaf = scratch->leaf_offsets[depth] + indexa;
+      t8_element_array_init_view (&element_leaves, leaf_elements, first_leaf, indexb - indexa);
+      const size_t query_offset = scratch->query_offsets[depth];
+      const size_t num_active = num_queries == 0 ? 0 : active_queries->elem_count - query_offset;
+      const t8_element_t *child = t8_forest_search_scratch_children (scratch, eclass, ts, depth)[ichild];
+      if (t8_forest_search_element (forest, ltreeid, child, ts, &element_leaves, first_leaf, search_fn, query_fn,
+                                    queries, scratch, query_offset, num_active)) {
+        /* Push the child on the stack */
+        depth++;
+        element = child;
+        scratch->leaf_offsets[depth] = first_leaf;
+        scratch->leaf_counts[depth] = indexb - indexa;
+        scratch->query_offsets[depth] = query_offset + num_active;
+        break;
+      }
+    }
+  }
 }
 
 void
-t8_forest_search (t8_forest_t forest, t8_forest_search_fn search_fn, t8_forest_query_fn query_fn, sc_array_t *queries)
+t8_forest_search_trees (t8_forest_t forest, t8_locidx_t first_tree, t8_locidx_t end_tree,
+                        t8_forest_search_fn search_fn, t8_forest_query_fn query_fn, sc_array_t *queries)
 {
-  /* If we have queries build a list of all active queries,
-   * thus all queries in the array */
-  sc_array_t *active_queries = NULL;
-  if (queries != NULL) {
-    const size_t num_queries = queries->elem_count;
-    /* build an array and write 0, 1, 2, 3,... into it */
-    active_queries = sc_array_new_count (sizeof (size_t), num_queries);
-    for (size_t iquery = 0; iquery < num_queries; ++iquery) {
-      *(size_t *) sc_array_index (active_queries, iquery) = iquery;
-    }
-  }
+  t8_forest_search_scratch_t scratch;
 
-  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
-  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
-    t8_forest_search_tree (forest, itree, search_fn, query_fn, queries, active_queries);
-  }
+  T8_ASSERT (0 <= first_tree && first_tree <= end_tree && end_tree <= t8_forest_get_num_local_trees (forest));
+  /* Allocate the memory of the search once for all trees.
+   * If we have queries all of them are initially active. */
+  t8_forest_search_scratch_init (forest, &scratch, queries);
 
-  if (active_queries != NULL) {
-    sc_array_destroy (active_queries);
+  for (t8_locidx_t itree = first_tree; itree < end_tree; itree++) {
+    t8_forest_search_tree (forest, itree, search_fn, query_fn, queries, &scratch);
   }
+
+  t8_forest_search_scratch_reset (forest, &scratch);
+}
+
+void
+t8_forest_search (t8_forest_t forest, t8_forest_search_fn search_fn, t8_forest_query_fn query_fn, sc_array_t *queries)
+{
+  t8_forest_search_trees (forest, 0, t8_forest_get_num_local_trees (forest), search_fn, query_fn, queries);
 }
 
 void
@@ -68,6 +68,9 @@ typedef int (*t8_forest_search_fn) (t8_forest_t forest, const t8_locidx_t ltreei
  * \param[in] tree_leaf_index     the local index of the first leaf in \a leaf_elements
  * \param[in] queries             An array of queries that are checked by the function
  * \param[in] query_indices       An array of size_t entries, where each entry is an index of a query in \q queries.
+ *                                The entries are stored contiguously, such that the callback can process all
+ *                                active queries of \a element as one batch. The array is a view into memory
+ *                                of the search and must not be resized.
  * \param[in, out] query_matches  An array of length \a num_active_queries. 
  *                                If the element is not a leave must be set to true or false at the i-th index for 
  *                                each query, specifying whether the element 'matches' the query of the i-th query 
@@ -104,6 +107,8 @@ t8_forest_iterate_faces (t8_forest_t forest, t8_locidx_t ltreeid, const t8_eleme
  * If the callback returns false for an element, its descendants
  * are not further searched.
  * To pass user data to the search_fn function use \ref t8_forest_set_user_data
+ * The search is not recursive. All memory it needs is allocated once per call,
+ * independently of the number of elements and queries that are visited.
  */
 void
 t8_forest_search (t8_forest_t forest, t8_forest_search_fn search_fn, t8_forest_query_fn query_fn, sc_array_t *queries);
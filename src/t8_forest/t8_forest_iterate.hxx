@@ -0,0 +1,215 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_forest_iterate.hxx
+ * Iterate over the leaf elements of a forest with a kernel that is compiled
+ * for the concrete scheme of each tree.
+ * The scheme of a tree is determined once per tree. If it is one of the default
+ * schemes, the kernel is called with a pointer to the concrete scheme class,
+ * such as \ref t8_default_scheme_quad_c. Since these classes are final, calls
+ * to the element functions of the scheme bind statically instead of through the vtable.
+ * They remain calls into the scheme's translation unit, as the functions are not defined inline.
+ * This only applies to calls made through the concrete pointer; a kernel that passes the scheme
+ * on as a \ref t8_eclass_scheme_c pointer calls through the vtable again.
+ * For all other schemes the kernel is called with a \ref t8_eclass_scheme_c pointer.
+ *
+ * Example:
+ *   int max_level = 0;
+ *   t8_forest_for_each_element (forest, [&] (const auto *scheme, t8_locidx_t ltreeid, t8_locidx_t ielement,
+ *                                            t8_locidx_t element_index, const t8_element_t *element) {
+ *     max_level = SC_MAX (max_level, scheme->t8_element_level (element));
+ *   });
+ */
+
+#pragma once
+
+#include <t8.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_schemes/t8_default/t8_default_vertex/t8_default_vertex.hxx>
+#include <t8_schemes/t8_default/t8_default_line/t8_default_line.hxx>
+#include <t8_schemes/t8_default/t8_default_quad/t8_default_quad.hxx>
+#include <t8_schemes/t8_default/t8_default_tri/t8_default_tri.hxx>
+#include <t8_schemes/t8_default/t8_default_hex/t8_default_hex.hxx>
+#include <t8_schemes/t8_default/t8_default_tet/t8_default_tet.hxx>
+#include <t8_schemes/t8_default/t8_default_prism/t8_default_prism.hxx>
+#include <t8_schemes/t8_default/t8_default_pyramid/t8_default_pyramid.hxx>
+
+/** The default scheme class and its element type for an element class.
+ * \tparam eclass   The element class.
+ * The member \a scheme_type is the scheme class and \a element_type the type
+ * that the elements of this scheme can be cast to. */
+template <t8_eclass_t eclass>
+struct t8_default_scheme_traits;
+
+template <>
+struct t8_default_scheme_traits<T8_ECLASS_VERTEX>
+{
+  using scheme_type = t8_default_scheme_vertex_c;
+  using element_type = t8_dvertex_t;
+};
+
+template <>
+struct t8_default_scheme_traits<T8_ECLASS_LINE>
+{
+  using scheme_type = t8_default_scheme_line_c;
+  using element_type = t8_dline_t;
+};
+
+template <>
+struct t8_default_scheme_traits<T8_ECLASS_QUAD>
+{
+  using scheme_type = t8_default_scheme_quad_c;
+  using element_type = t8_dquad_t;
+};
+
+template <>
+struct t8_default_scheme_traits<T8_ECLASS_TRIANGLE>
+{
+  using scheme_type = t8_default_scheme_tri_c;
+  using element_type = t8_dtri_t;
+};
+
+template <>
+struct t8_default_scheme_traits<T8_ECLASS_HEX>
+{
+  using scheme_type = t8_default_scheme_hex_c;
+  using element_type = t8_dhex_t;
+};
+
+template <>
+struct t8_default_scheme_traits<T8_ECLASS_TET>
+{
+  using scheme_type = t8_default_scheme_tet_c;
+  using element_type = t8_dtet_t;
+};
+
+template <>
+struct t8_default_scheme_traits<T8_ECLASS_PRISM>
+{
+  using scheme_type = t8_default_scheme_prism_c;
+  using element_type = t8_dprism_t;
+};
+
+template <>
+struct t8_default_scheme_traits<T8_ECLASS_PYRAMID>
+{
+  using scheme_type = t8_default_scheme_pyramid_c;
+  using element_type = t8_dpyramid_t;
+};
+
+/** Call a kernel for all leaf elements of one local tree.
+ * \param [in] forest         The committed forest.
+ * \param [in] ltreeid        A local tree id of \a forest.
+ * \param [in] scheme         The scheme of the tree, either a concrete default scheme or the base class.
+ * \param [in] first_index    The local index of the first element of the tree in the forest.
+ * \param [in] kernel         The kernel, see \ref t8_forest_for_each_element.
+ */
+template <typename scheme_type, typename kernel_type>
+inline void
+t8_forest_for_each_element_in_tree (t8_forest_t forest, const t8_locidx_t ltreeid, const scheme_type *scheme,
+                                    const t8_locidx_t first_index, kernel_type &kernel)
+{
+  const t8_element_array_t *leaves = t8_forest_tree_get_leaves (forest, ltreeid);
+  const t8_locidx_t num_elements = t8_element_array_get_count (leaves);
+  if (num_elements == 0) {
+    return;
+  }
+  /* Step through the array directly instead of calling the scheme for the element size each time */
+  const char *elements = (const char *) t8_element_array_get_data (leaves);
+  const size_t element_size = scheme->t8_element_size ();
+  for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+    kernel (scheme, ltreeid, ielement, first_index + ielement,
+            (const t8_element_t *) (elements + ielement * element_size));
+  }
+}
+
+/** Call a kernel for all leaf elements of one local tree of class \a eclass.
+ * The kernel is called with the concrete scheme if \a scheme is the default scheme of \a eclass.
+ */
+template <t8_eclass_t eclass, typename kernel_type>
+inline void
+t8_forest_for_each_element_dispatch (t8_forest_t forest, const t8_locidx_t ltreeid, const t8_eclass_scheme_c *scheme,
+                                     const t8_locidx_t first_index, kernel_type &kernel)
+{
+  using default_scheme = typename t8_default_scheme_traits<eclass>::scheme_type;
+  const default_scheme *concrete_scheme = dynamic_cast<const default_scheme *> (scheme);
+  if (concrete_scheme != NULL) {
+    t8_forest_for_each_element_in_tree (forest, ltreeid, concrete_scheme, first_index, kernel);
+  }
+  else {
+    t8_forest_for_each_element_in_tree (forest, ltreeid, scheme, first_index, kernel);
+  }
+}
+
+/** Call a kernel for each local leaf element of a forest.
+ * The trees are traversed in order and the elements of each tree in their linear order.
+ * The kernel must be callable for each concrete default scheme and for \ref t8_eclass_scheme_c,
+ * for example a generic lambda with the signature
+ *   (const auto *scheme, t8_locidx_t ltreeid, t8_locidx_t ielement, t8_locidx_t element_index,
+ *    const t8_element_t *element)
+ * where \a ielement is the index of the element in its tree and \a element_index its local index in the forest.
+ * Use \ref t8_default_scheme_traits to cast \a element to the element type of a default scheme.
+ * \param [in] forest       A committed forest.
+ * \param [in] kernel       The kernel that is called for each element.
+ */
+template <typename kernel_type>
+void
+t8_forest_for_each_element (t8_forest_t forest, kernel_type &&kernel)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+
+  const t8_locidx_t num_trees = t8_forest_get_num_local_trees (forest);
+  t8_locidx_t first_index = 0;
+  for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+    const t8_eclass_t eclass = t8_forest_get_tree_class (forest, itree);
+    const t8_eclass_scheme_c *scheme = t8_forest_get_eclass_scheme (forest, eclass);
+    switch (eclass) {
+    case T8_ECLASS_VERTEX:
+      t8_forest_for_each_element_dispatch<T8_ECLASS_VERTEX> (forest, itree, scheme, first_index, kernel);
+      break;
+    case T8_ECLASS_LINE:
+      t8_forest_for_each_element_dispatch<T8_ECLASS_LINE> (forest, itree, scheme, first_index, kernel);
+      break;
+    case T8_ECLASS_QUAD:
+      t8_forest_for_each_element_dispatch<T8_ECLASS_QUAD> (forest, itree, scheme, first_index, kernel);
+      break;
+    case T8_ECLASS_TRIANGLE:
+      t8_forest_for_each_element_dispatch<T8_ECLASS_TRIANGLE> (forest, itree, scheme, first_index, kernel);
+      break;
+    case T8_ECLASS_HEX:
+      t8_forest_for_each_element_dispatch<T8_ECLASS_HEX> (forest, itree, scheme, first_index, kernel);
+      break;
+    case T8_ECLASS_TET:
+      t8_forest_for_each_element_dispatch<T8_ECLASS_TET> (forest, itree, scheme, first_index, kernel);
+      break;
+    case T8_ECLASS_PRISM:
+      t8_forest_for_each_element_dispatch<T8_ECLASS_PRISM> (forest, itree, scheme, first_index, kernel);
+      break;
+    case T8_ECLASS_PYRAMID:
+      t8_forest_for_each_element_dispatch<T8_ECLASS_PYRAMID> (forest, itree, scheme, first_index, kernel);
+      break;
+    default:
+      SC_ABORT_NOT_REACHED ();
+    }
+    first_index += t8_forest_get_tree_num_elements (forest, itree);
+  }
+}
@@ -24,6 +24,8 @@
 #include <t8_forest/t8_forest_types.h>
 #include <t8_forest/t8_forest_private.h>
 #include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_profiling.h>
+#include <t8_forest/t8_forest_element_codec.hxx>
 #include <t8_cmesh/t8_cmesh_offset.h>
 #include <t8_element.hxx>
 
@@ -400,8 +402,112 @@ t8_forest_partition_create_tree_offsets (t8_forest_t forest)
   }
 }
 
+/* Return the weight of a local element of forest->set_from for partitioning. */
+static double
+t8_forest_partition_element_weight (t8_forest_t forest, const t8_locidx_t ltreeid, t8_eclass_scheme_c *ts,
+                                    const t8_element_t *element, const t8_locidx_t lelement_id)
+{
+  double weight;
+
+  if (forest->set_partition_weight_fn != NULL) {
+    weight = forest->set_partition_weight_fn (forest, forest->set_from, ltreeid, lelement_id, ts, element);
+  }
+  else {
+    weight = forest->set_partition_weights[lelement_id];
+  }
+  T8_ASSERT (weight >= 0);
+  return weight;
+}
+
+/* Calculate the new element_offset for forest from
+ * the element in forest->set_from with the weights given by
+ * forest->set_partition_weight_fn or forest->set_partition_weights.
+ * Each element is assigned to the rank floor (mpisize * W_i / W), where
+ * W_i is the sum of the weights of all previous elements and W the total weight.
+ * Since this is monotonous in i, the first element of rank p is the minimum over
+ * all processes of the first local element that is assigned to p or a later rank. */
+static void
+t8_forest_partition_compute_new_offset_weighted (t8_forest_t forest)
+{
+  t8_forest_t forest_from = forest->set_from;
+  sc_MPI_Comm comm = forest->mpicomm;
+  const int mpisize = forest->mpisize;
+  const t8_locidx_t num_trees = t8_forest_get_num_local_trees (forest_from);
+  double *weights;
+  double local_weight = 0;
+  double prefix_weight;
+  double total_weight;
+  t8_gloidx_t *local_offsets;
+  t8_gloidx_t *new_offsets;
+  t8_locidx_t lelement_id;
+  int mpiret;
+
+  T8_ASSERT (t8_forest_is_committed (forest_from));
+  T8_ASSERT (forest->set_partition_weight_fn != NULL || forest->set_partition_weights != NULL);
+
+  /* Evaluate the weights of all local elements */
+  weights = T8_ALLOC (double, SC_MAX (forest_from->local_num_elements, 1));
+  lelement_id = 0;
+  for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest_from, t8_forest_get_tree_class (forest_from, itree));
+    const t8_locidx_t num_elements = t8_forest_get_tree_num_elements (forest_from, itree);
+    for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++, lelement_id++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest_from, itree, ielement);
+      weights[lelement_id] = t8_forest_partition_element_weight (forest, itree, ts, element, lelement_id);
+      local_weight += weights[lelement_id];
+    }
+  }
+  T8_ASSERT (lelement_id == forest_from->local_num_elements);
+
+  /* Compute the weight of all elements on previous processes and the total weight */
+  mpiret = sc_MPI_Scan (&local_weight, &prefix_weight, 1, sc_MPI_DOUBLE, sc_MPI_SUM, comm);
+  SC_CHECK_MPI (mpiret);
+  prefix_weight -= local_weight;
+  mpiret = sc_MPI_Allreduce (&local_weight, &total_weight, 1, sc_MPI_DOUBLE, sc_MPI_SUM, comm);
+  SC_CHECK_MPI (mpiret);
+
+  /* For each rank compute the first local element that is assigned to it or a later rank */
+  local_offsets = T8_ALLOC (t8_gloidx_t, mpisize + 1);
+  new_offsets = T8_ALLOC (t8_gloidx_t, mpisize + 1);
+  for (int irank = 0; irank <= mpisize; irank++) {
+    local_offsets[irank] = forest_from->global_num_elements;
+  }
+  if (total_weight > 0) {
+    const t8_gloidx_t first_element = t8_shmem_array_get_gloidx (forest_from->element_offsets, forest_from->mpirank);
+    int next_rank = 0;
+    for (lelement_id = 0; lelement_id < forest_from->local_num_elements && next_rank < mpisize; lelement_id++) {
+      const int rank = SC_MIN ((int) (mpisize * (prefix_weight / total_weight)), mpisize - 1);
+      while (next_rank <= rank) {
+        local_offsets[next_rank++] = first_element + lelement_id;
+      }
+      prefix_weight += weights[lelement_id];
+    }
+  }
+  else {
+    /* All weights are zero, we use the unweighted partition */
+    for (int irank = 0; irank < mpisize; irank++) {
+      local_offsets[irank] = (t8_gloidx_t) (((long double) irank * forest_from->global_num_elements) / mpisize);
+    }
+  }
+  mpiret = sc_MPI_Allreduce (local_offsets, new_offsets, mpisize + 1, T8_MPI_GLOIDX, sc_MPI_MIN, comm);
+  SC_CHECK_MPI (mpiret);
+
+  if (t8_shmem_array_start_writing (forest->element_offsets)) {
+    t8_gloidx_t *element_offsets = t8_shmem_array_get_gloidx_array_for_writing (forest->element_offsets);
+    for (int irank = 0; irank <= mpisize; irank++) {
+      element_offsets[irank] = new_offsets[irank];
+    }
+  }
+  t8_shmem_array_end_writing (forest->element_offsets);
+
+  T8_FREE (weights);
+  T8_FREE (local_offsets);
+  T8_FREE (new_offsets);
+}
+
 /* Calculate the new element_offset for forest from
- * the element in forest->set_from assuming a partition without element weights */
+ * the element in forest->set_from assuming a partition without element weights,
+ * unless weights were set */
 static void
 t8_forest_partition_compute_new_offset (t8_forest_t forest)
 {
@@ -425,6 +531,12 @@ t8_forest_partition_compute_new_offset (t8_forest_t forest)
   mpiret = sc_MPI_Comm_size (comm, &mpisize);
   SC_CHECK_MPI (mpiret);
 
+  if (forest->set_partition_weight_fn != NULL || forest->set_partition_weights != NULL) {
+    /* The elements have different weights */
+    t8_forest_partition_compute_new_offset_weighted (forest);
+    return;
+  }
+
   if (t8_shmem_array_start_writing (forest->element_offsets)) {
     if (forest_from->global_num_elements > 0) {
       t8_gloidx_t *element_offsets = t8_shmem_array_get_gloidx_array_for_writing (forest->element_offsets);
@@ -558,17 +670,22 @@ t8_forest_partition_tree_first_last_el (t8_tree_t tree, t8_locidx_t tree_id, t8_
  *                              we would send elements from to the next process.
  * \param [in]  first_element_send The local id of the first element that we need to send.
  * \param [in]  last_element_send The local id of the last element that we need to send.
+ * \param [in]  compact         If true, the elements are encoded compactly.
  */
 /* The send buffer will look like this:
  *
  * | number of trees | padding | tree_1 info | ... | tree_n info | tree_1 elements | ... | tree_n elements |
+ *
+ * If compact is true and the encoding of the tree's elements is smaller than the elements,
+ * the elements of each tree are encoded with t8_forest_element_encode instead of being copied.
+ * The receiver knows the number of elements of each tree from the tree info and decodes them in order.
  */
 /* If send_data is true, data must be an array of length forest_from->num_local elements
  * and instead of shipping the elements of forest_from, we ship the data entries. */
 static void
 t8_forest_partition_fill_buffer (t8_forest_t forest_from, char **send_buffer, int *buffer_alloc,
                                  t8_locidx_t *current_tree, t8_locidx_t first_element_send,
-                                 t8_locidx_t last_element_send)
+                                 t8_locidx_t last_element_send, const int compact)
 {
   t8_locidx_t num_elements_send;
   t8_tree_t tree;
@@ -598,7 +715,13 @@ t8_forest_partition_fill_buffer (t8_forest_t forest_from, char **send_buffer, in
     num_elements_send = last_tree_element - first_tree_element + 1;
     T8_ASSERT (num_elements_send >= 0);
     elem_size = t8_element_array_get_size (&tree->elements);
-    element_alloc += num_elements_send * elem_size;
+    /* In compact mode we only know an upper bound for the bytes of the elements */
+    if (compact && t8_forest_element_codec_is_compact (tree->elements.scheme)) {
+      element_alloc += t8_forest_element_encode_bound (tree->elements.scheme, num_elements_send);
+    }
+    else {
+      element_alloc += num_elements_send * elem_size;
+    }
     current_element += num_elements_send;
     num_trees_send++;
     tree_id++;
@@ -643,13 +766,22 @@ t8_forest_partition_fill_buffer (t8_forest_t forest_from, char **send_buffer, in
     /* We can now fill the send buffer with all elements of that tree */
     if (num_elements_send > 0) {
       const t8_element_t *pfirst_element = t8_element_array_index_locidx (&tree->elements, first_tree_element);
-      elem_size = t8_element_array_get_size (&tree->elements);
-      memcpy (*send_buffer + element_pos, (const void *) pfirst_element, num_elements_send * elem_size);
-      element_pos += num_elements_send * elem_size;
+      const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest_from, tree->eclass);
+      if (compact && t8_forest_element_codec_is_compact (ts)) {
+        element_pos += t8_forest_element_encode (ts, pfirst_element, num_elements_send, *send_buffer + element_pos);
+      }
+      else {
+        elem_size = t8_element_array_get_size (&tree->elements);
+        memcpy (*send_buffer + element_pos, (const void *) pfirst_element, num_elements_send * elem_size);
+        element_pos += num_elements_send * elem_size;
+      }
     }
   }
   *current_tree += num_trees_send - 1 + last_element_is_last_tree_element;
-  *buffer_alloc = byte_alloc;
+  /* Only the used part of the buffer is sent. Without compact encoding, this is the whole buffer. */
+  T8_ASSERT (element_pos <= byte_alloc);
+  T8_ASSERT (compact || element_pos == byte_alloc);
+  *buffer_alloc = element_pos;
   t8_debugf ("Post send of %i trees\n", num_trees_send);
 }
 
@@ -783,7 +915,7 @@ t8_forest_partition_sendloop (t8_forest_t forest, const int send_first, const in
       if (!send_data) {
         /* Fill the buffer with the elements and calculate the next tree from which to send elements */
         t8_forest_partition_fill_buffer (forest_from, buffer, &buffer_alloc, &current_tree, first_element_send,
-                                         last_element_send);
+                                         last_element_send, forest->compact_transfer);
       }
       else {
         T8_ASSERT (send_data);
@@ -985,10 +1117,22 @@ t8_forest_partition_recv_message (t8_forest_t forest, sc_MPI_Comm comm, int proc
       /* Get the size of an element of the tree */
       eclass_scheme = t8_forest_get_eclass_scheme (forest->set_from, tree->eclass);
       element_size = eclass_scheme->t8_element_size ();
-      /* initialize the elements array and copy the elements from the receive buffer */
-      T8_ASSERT (element_cursor + tree_info->num_elements * element_size <= (size_t) recv_bytes);
-      t8_element_array_init_copy (&tree->elements, eclass_scheme, (t8_element_t *) (recv_buffer + element_cursor),
-                                  tree_info->num_elements);
+      if (forest->compact_transfer && t8_forest_element_codec_is_compact (eclass_scheme)) {
+        /* initialize the elements array and decode the elements from the receive buffer */
+        t8_element_array_init_size (&tree->elements, eclass_scheme, tree_info->num_elements);
+        if (tree_info->num_elements > 0) {
+          element_cursor += t8_forest_element_decode (
+            eclass_scheme, recv_buffer + element_cursor, tree_info->num_elements,
+            t8_element_array_index_locidx_mutable (&tree->elements, 0));
+        }
+      }
+      else {
+        /* initialize the elements array and copy the elements from the receive buffer */
+        T8_ASSERT (element_cursor + tree_info->num_elements * element_size <= (size_t) recv_bytes);
+        t8_element_array_init_copy (&tree->elements, eclass_scheme, (t8_element_t *) (recv_buffer + element_cursor),
+                                    tree_info->num_elements);
+        element_cursor += element_size * tree_info->num_elements;
+      }
     }
     else {
       T8_ASSERT (itree == 0); /* This situation only happens for the first tree */
@@ -1009,8 +1153,16 @@ t8_forest_partition_recv_message (t8_forest_t forest, sc_MPI_Comm comm, int proc
         eclass_scheme = t8_forest_get_eclass_scheme (forest->set_from, tree->eclass);
         element_size = eclass_scheme->t8_element_size ();
         T8_ASSERT (element_size == t8_element_array_get_size (&tree->elements));
-        /* Copy the elements from the receive buffer to the elements array */
-        memcpy ((void *) first_new_element, recv_buffer + element_cursor, tree_info->num_elements * element_size);
+        if (forest->compact_transfer && t8_forest_element_codec_is_compact (eclass_scheme)) {
+          /* Decode the elements from the receive buffer into the elements array */
+          element_cursor += t8_forest_element_decode (eclass_scheme, recv_buffer + element_cursor,
+                                                      tree_info->num_elements, first_new_element);
+        }
+        else {
+          /* Copy the elements from the receive buffer to the elements array */
+          memcpy ((void *) first_new_element, recv_buffer + element_cursor, tree_info->num_elements * element_size);
+          element_cursor += element_size * tree_info->num_elements;
+        }
       }
     }
 
@@ -1018,8 +1170,7 @@ t8_forest_partition_recv_message (t8_forest_t forest, sc_MPI_Comm comm, int proc
     forest->local_num_elements += tree_info->num_elements;
     /* Set the new last local tree */
     forest->last_local_tree = tree_info->gtree_id;
-    /* advance the element cursor */
-    element_cursor += element_size * tree_info->num_elements;
+    T8_ASSERT (element_cursor <= (size_t) recv_bytes);
     /* Advance to the next tree_info entry in the recv buffer */
     tree_cursor += sizeof (t8_forest_partition_tree_info_t);
     tree_info += 1;
@@ -1118,8 +1269,10 @@ t8_forest_partition_given (t8_forest_t forest, const int send_data, const sc_arr
   t8_debugf ("send_last = %i\n", send_last);
 
   /* Send all elements to other ranks */
+  t8_forest_profile_timer_start (forest, "sendloop");
   to_self = t8_forest_partition_sendloop (forest, send_first, send_last, &requests, &num_request_alloc, &send_buffer,
                                           send_data, data_in, &byte_to_self);
+  t8_forest_profile_timer_stop (forest, "sendloop");
   if (to_self) {
     /* We have sent data to ourselves. */
     sent_to_self = *(send_buffer + forest->mpirank - send_first);
@@ -1140,7 +1293,9 @@ t8_forest_partition_given (t8_forest_t forest, const int send_data, const sc_arr
   if (num_new_elements > 0) {
     /* Receive all element from other ranks */
     t8_forest_partition_recvrange (forest, &recv_first, &recv_last);
+    t8_forest_profile_timer_start (forest, "recvloop");
     t8_forest_partition_recvloop (forest, recv_first, recv_last, send_data, data_out, sent_to_self, byte_to_self);
+    t8_forest_profile_timer_stop (forest, "recvloop");
   }
   else if (!send_data) {
     /* This forest is empty, set first and last local tree such
@@ -1151,8 +1306,10 @@ t8_forest_partition_given (t8_forest_t forest, const int send_data, const sc_arr
   }
   /* Wait for all sends to complete */
   if (num_request_alloc > 0) {
+    t8_forest_profile_timer_start (forest, "wait");
     mpiret = sc_MPI_Waitall (num_request_alloc, requests, sc_MPI_STATUSES_IGNORE);
     SC_CHECK_MPI (mpiret);
+    t8_forest_profile_timer_stop (forest, "wait");
   }
   T8_FREE (requests);
   for (i = 0; i < num_request_alloc; i++) {
@@ -1164,7 +1321,7 @@ t8_forest_partition_given (t8_forest_t forest, const int send_data, const sc_arr
 }
 
 /* Populate a forest with the partitioned elements of forest->set_from.
- * Currently the elements are distributed evenly (each element has the same weight).
+ * The elements are distributed evenly, unless element weights were set.
  */
 void
 t8_forest_partition (t8_forest_t forest)
@@ -1188,6 +1345,7 @@ t8_forest_partition (t8_forest_t forest)
      * Only delete the line, if you know what you are doing. */
     t8_global_productionf ("Start partition %f %f\n", sc_MPI_Wtime (), forest->profile->partition_runtime);
   }
+  t8_forest_profile_timer_start (forest, "partition");
 
   if (forest_from->element_offsets == NULL) {
     /* We create the partition table of forest_from */
@@ -1208,6 +1366,14 @@ t8_forest_partition (t8_forest_t forest)
     t8_shmem_array_destroy (&forest_from->element_offsets);
   }
 
+  if (forest->profile != NULL) {
+    /* Count the elements, bytes and messages that were sent */
+    t8_forest_profile_count (forest, "elements_sent", forest->profile->partition_elements_shipped);
+    t8_forest_profile_count (forest, "elements_received", forest->profile->partition_elements_recv);
+    t8_forest_profile_count (forest, "bytes_sent", forest->profile->partition_bytes_sent);
+    t8_forest_profile_count (forest, "messages_sent", forest->profile->partition_procs_sent);
+  }
+  t8_forest_profile_timer_stop (forest, "partition");
   if (forest->profile != NULL) {
     /* If profiling is enabled, we measure the runtime of partition */
     forest->profile->partition_runtime = sc_MPI_Wtime () - forest->profile->partition_runtime;
@@ -1264,4 +1430,248 @@ t8_forest_partition_data (t8_forest_t forest_from, t8_forest_t forest_to, const
   t8_global_productionf ("Done forest partition data.\n");
 }
 
+/* One array that is transferred with a partition data transfer */
+typedef struct
+{
+  const sc_array_t *data_in; /* The data on forest_from */
+  sc_array_t *data_out;      /* The data on forest_to */
+  size_t byte_offset;        /* The sum of the element sizes of all previously added arrays */
+} t8_forest_partition_data_field_t;
+
+/* One message of a partition data transfer */
+typedef struct
+{
+  int rank;             /* The rank we send to or receive from */
+  t8_locidx_t first;    /* The local index of the first element in the message */
+  t8_locidx_t count;    /* The number of elements in the message */
+  size_t buffer_offset; /* The position of the message in the send or receive buffer */
+} t8_forest_partition_data_message_t;
+
+struct t8_forest_partition_data_transfer
+{
+  t8_forest_t forest_from;   /**< The forest before partitioning, we hold a reference of it. */
+  t8_forest_t forest_to;     /**< The partitioned forest, we hold a reference of it. */
+  sc_array_t fields;         /**< The transferred arrays, of type t8_forest_partition_data_field_t. */
+  size_t bytes_per_element;  /**< The sum of the element sizes of all arrays. */
+  sc_array_t sends;          /**< The messages we send, of type t8_forest_partition_data_message_t. */
+  sc_array_t recvs;          /**< The messages we receive, of type t8_forest_partition_data_message_t. */
+  char *send_buffer;         /**< The packed data of all messages that we send. */
+  char *recv_buffer;         /**< The packed data of all messages that we receive. */
+  sc_MPI_Request *requests;  /**< The receive requests followed by the send requests. */
+  int active;                /**< True between begin and end of the transfer. */
+};
+
+/* Compute the messages between the elements of this rank in the partition \a offset_mine
+ * and all ranks in the partition \a offset_other. Each message stores the other rank,
+ * the local index of its first element with respect to \a offset_mine and its number of elements.
+ * The messages are sorted by rank and also contain the elements that stay on this rank.
+ * Returns the number of elements in all messages. */
+static t8_locidx_t
+t8_forest_partition_data_messages (const int mpisize, const int mpirank, const t8_gloidx_t *offset_mine,
+                                   const t8_gloidx_t *offset_other, sc_array_t *messages)
+{
+  const t8_gloidx_t first_element = t8_forest_partition_first_element (offset_mine, mpirank);
+  const t8_gloidx_t last_element = t8_forest_partition_last_element (offset_mine, mpirank);
+  t8_locidx_t num_elements = 0;
+
+  if (last_element < first_element) {
+    /* This rank has no elements */
+    return 0;
+  }
+  const int first_rank = t8_forest_partition_owner_of_element (mpisize, mpirank, first_element, offset_other);
+  const int last_rank = t8_forest_partition_owner_of_element (mpisize, mpirank, last_element, offset_other);
+  for (int iproc = first_rank; iproc <= last_rank; iproc++) {
+    /* Intersect the element range of iproc with ours */
+    const t8_gloidx_t first = SC_MAX (first_element, t8_forest_partition_first_element (offset_other, iproc));
+    const t8_gloidx_t last = SC_MIN (last_element, t8_forest_partition_last_element (offset_other, iproc));
+    if (last < first) {
+      /* iproc is empty in the other partition */
+      continue;
+    }
+    t8_forest_partition_data_message_t *message = (t8_forest_partition_data_message_t *) sc_array_push (messages);
+    message->rank = iproc;
+    message->first = first - first_element;
+    message->count = last - first + 1;
+    message->buffer_offset = 0;
+    num_elements += message->count;
+  }
+  return num_elements;
+}
+
+/* Copy the data of \a count elements starting at \a first of all arrays of a transfer into a
+ * message buffer (pack is true) or from a message buffer (pack is false).
+ * In the buffer the data of each array is stored contiguously, one array after another. */
+static void
+t8_forest_partition_data_copy_message (t8_forest_partition_data_transfer_t transfer, char *buffer,
+                                       const t8_locidx_t first, const t8_locidx_t count, const int pack)
+{
+  for (size_t ifield = 0; ifield < transfer->fields.elem_count; ifield++) {
+    const t8_forest_partition_data_field_t *field
+      = (const t8_forest_partition_data_field_t *) sc_array_index (&transfer->fields, ifield);
+    char *field_buffer = buffer + count * field->byte_offset;
+    if (pack) {
+      memcpy (field_buffer, t8_sc_array_index_locidx ((sc_array_t *) field->data_in, first),
+              count * field->data_in->elem_size);
+    }
+    else {
+      memcpy (t8_sc_array_index_locidx (field->data_out, first), field_buffer, count * field->data_out->elem_size);
+    }
+  }
+}
+
+t8_forest_partition_data_transfer_t
+t8_forest_partition_data_transfer_new (t8_forest_t forest_from, t8_forest_t forest_to)
+{
+  t8_forest_partition_data_transfer_t transfer;
+
+  T8_ASSERT (t8_forest_is_committed (forest_from));
+  T8_ASSERT (t8_forest_is_committed (forest_to));
+
+  transfer = T8_ALLOC_ZERO (struct t8_forest_partition_data_transfer, 1);
+  t8_forest_ref (forest_from);
+  t8_forest_ref (forest_to);
+  transfer->forest_from = forest_from;
+  transfer->forest_to = forest_to;
+  sc_array_init (&transfer->fields, sizeof (t8_forest_partition_data_field_t));
+  sc_array_init (&transfer->sends, sizeof (t8_forest_partition_data_message_t));
+  sc_array_init (&transfer->recvs, sizeof (t8_forest_partition_data_message_t));
+  return transfer;
+}
+
+void
+t8_forest_partition_data_transfer_add (t8_forest_partition_data_transfer_t transfer, const sc_array_t *data_in,
+                                       sc_array_t *data_out)
+{
+  T8_ASSERT (transfer != NULL);
+  T8_ASSERT (!transfer->active);
+  T8_ASSERT (data_in != NULL && data_out != NULL);
+  T8_ASSERT (data_in->elem_size == data_out->elem_size);
+  T8_ASSERT (data_in->elem_count == (size_t) transfer->forest_from->local_num_elements);
+  T8_ASSERT (data_out->elem_count == (size_t) transfer->forest_to->local_num_elements);
+
+  t8_forest_partition_data_field_t *field = (t8_forest_partition_data_field_t *) sc_array_push (&transfer->fields);
+  field->data_in = data_in;
+  field->data_out = data_out;
+  field->byte_offset = transfer->bytes_per_element;
+  transfer->bytes_per_element += data_in->elem_size;
+}
+
+void
+t8_forest_partition_data_transfer_begin (t8_forest_partition_data_transfer_t transfer)
+{
+  t8_forest_t forest_from, forest_to;
+  size_t imessage, buffer_offset;
+  int mpiret;
+
+  T8_ASSERT (transfer != NULL);
+  T8_ASSERT (!transfer->active);
+  forest_from = transfer->forest_from;
+  forest_to = transfer->forest_to;
+  transfer->active = 1;
+
+  t8_forest_profile_timer_start (forest_to, "partition_data");
+  /* Create partition tables if not existent yet */
+  if (forest_from->element_offsets == NULL) {
+    t8_forest_partition_create_offsets (forest_from);
+  }
+  if (forest_to->element_offsets == NULL) {
+    t8_forest_partition_create_offsets (forest_to);
+  }
+  const t8_gloidx_t *offset_from = t8_shmem_array_get_gloidx_array (forest_from->element_offsets);
+  const t8_gloidx_t *offset_to = t8_shmem_array_get_gloidx_array (forest_to->element_offsets);
+  const int mpirank = forest_to->mpirank;
+  const int mpisize = forest_to->mpisize;
+
+  /* The ranks that our old elements move to and the ranks that our new elements come from */
+  const t8_locidx_t num_send_elements
+    = t8_forest_partition_data_messages (mpisize, mpirank, offset_from, offset_to, &transfer->sends);
+  const t8_locidx_t num_recv_elements
+    = t8_forest_partition_data_messages (mpisize, mpirank, offset_to, offset_from, &transfer->recvs);
+  transfer->send_buffer = T8_ALLOC (char, num_send_elements * transfer->bytes_per_element);
+  transfer->recv_buffer = T8_ALLOC (char, num_recv_elements * transfer->bytes_per_element);
+  transfer->requests = T8_ALLOC (sc_MPI_Request, transfer->recvs.elem_count + transfer->sends.elem_count);
+
+  /* Post all receives, the message sizes are known from the offsets */
+  buffer_offset = 0;
+  for (imessage = 0; imessage < transfer->recvs.elem_count; imessage++) {
+    t8_forest_partition_data_message_t *message
+      = (t8_forest_partition_data_message_t *) sc_array_index (&transfer->recvs, imessage);
+    message->buffer_offset = buffer_offset;
+    buffer_offset += message->count * transfer->bytes_per_element;
+    if (message->rank == mpirank) {
+      transfer->requests[imessage] = sc_MPI_REQUEST_NULL;
+      continue;
+    }
+    mpiret = sc_MPI_Irecv (transfer->recv_buffer + message->buffer_offset, message->count * transfer->bytes_per_element,
+                           sc_MPI_BYTE, message->rank, T8_MPI_PARTITION_DATA, forest_to->mpicomm,
+                           transfer->requests + imessage);
+    SC_CHECK_MPI (mpiret);
+  }
+
+  /* Pack one message with all arrays per rank and post the sends */
+  sc_MPI_Request *send_requests = transfer->requests + transfer->recvs.elem_count;
+  buffer_offset = 0;
+  for (imessage = 0; imessage < transfer->sends.elem_count; imessage++) {
+    t8_forest_partition_data_message_t *message
+      = (t8_forest_partition_data_message_t *) sc_array_index (&transfer->sends, imessage);
+    message->buffer_offset = buffer_offset;
+    buffer_offset += message->count * transfer->bytes_per_element;
+    char *buffer = transfer->send_buffer + message->buffer_offset;
+    t8_forest_partition_data_copy_message (transfer, buffer, message->first, message->count, 1);
+    if (message->rank == mpirank) {
+      /* The elements stay on this rank, we copy them to the receive buffer */
+      send_requests[imessage] = sc_MPI_REQUEST_NULL;
+      for (size_t irecv = 0; irecv < transfer->recvs.elem_count; irecv++) {
+        const t8_forest_partition_data_message_t *recv
+          = (const t8_forest_partition_data_message_t *) sc_array_index (&transfer->recvs, irecv);
+        if (recv->rank == mpirank) {
+          T8_ASSERT (recv->count == message->count);
+          memcpy (transfer->recv_buffer + recv->buffer_offset, buffer, message->count * transfer->bytes_per_element);
+        }
+      }
+      continue;
+    }
+    mpiret = sc_MPI_Isend (buffer, message->count * transfer->bytes_per_element, sc_MPI_BYTE, message->rank,
+                           T8_MPI_PARTITION_DATA, forest_to->mpicomm, send_requests + imessage);
+    SC_CHECK_MPI (mpiret);
+  }
+  t8_forest_profile_timer_stop (forest_to, "partition_data");
+}
+
+void
+t8_forest_partition_data_transfer_end (t8_forest_partition_data_transfer_t *ptransfer)
+{
+  t8_forest_partition_data_transfer_t transfer;
+  int mpiret;
+
+  T8_ASSERT (ptransfer != NULL);
+  transfer = *ptransfer;
+  T8_ASSERT (transfer != NULL);
+
+  if (transfer->active) {
+    t8_forest_profile_timer_start (transfer->forest_to, "partition_data_wait");
+    /* Wait for all messages to arrive and unpack them */
+    mpiret = sc_MPI_Waitall (transfer->recvs.elem_count + transfer->sends.elem_count, transfer->requests,
+                             sc_MPI_STATUSES_IGNORE);
+    SC_CHECK_MPI (mpiret);
+    t8_forest_profile_timer_stop (transfer->forest_to, "partition_data_wait");
+    for (size_t imessage = 0; imessage < transfer->recvs.elem_count; imessage++) {
+      const t8_forest_partition_data_message_t *message
+        = (const t8_forest_partition_data_message_t *) sc_array_index (&transfer->recvs, imessage);
+      t8_forest_partition_data_copy_message (transfer, transfer->recv_buffer + message->buffer_offset, message->first,
+                                             message->count, 0);
+    }
+    T8_FREE (transfer->requests);
+    T8_FREE (transfer->send_buffer);
+    T8_FREE (transfer->recv_buffer);
+  }
+  sc_array_reset (&transfer->fields);
+  sc_array_reset (&transfer->sends);
+  sc_array_reset (&transfer->recvs);
+  t8_forest_unref (&transfer->forest_from);
+  t8_forest_unref (&transfer->forest_to);
+  T8_FREE (transfer);
+  *ptransfer = NULL;
+}
+
 T8_EXTERN_C_END ();
@@ -32,6 +32,10 @@
 #include <t8.h>
 #include <t8_forest/t8_forest_general.h>
 
+/** Opaque handle of a transfer of several element data arrays to a new partition.
+ * \see t8_forest_partition_data_transfer_new */
+typedef struct t8_forest_partition_data_transfer *t8_forest_partition_data_transfer_t;
+
 T8_EXTERN_C_BEGIN ();
 /* TODO: document */
 void
@@ -85,6 +89,56 @@ void
 t8_forest_partition_data (t8_forest_t forest_from, t8_forest_t forest_to, const sc_array_t *data_in,
                           sc_array_t *data_out);
 
+/** Create a transfer of several element data arrays from a forest to its repartitioned forest.
+ * Arrays are registered with \ref t8_forest_partition_data_transfer_add. All arrays are
+ * packed into one message per process, such that the communication and the computation of
+ * the send and receive ranges are done only once.
+ * The transfer is started with \ref t8_forest_partition_data_transfer_begin and completed with
+ * \ref t8_forest_partition_data_transfer_end. In between the user may do other work, for example
+ * create the ghost layer of \a forest_to.
+ * \param[in] forest_from The forest before the partitioning step.
+ * \param[in] forest_to   The partitioned forest of \a forest_from.
+ * \return                A new transfer. It holds a reference of both forests.
+ *
+ * Example:
+ *   t8_forest_partition_data_transfer_t transfer = t8_forest_partition_data_transfer_new (forest, forest_partition);
+ *   t8_forest_partition_data_transfer_add (transfer, &density, &density_new);
+ *   t8_forest_partition_data_transfer_add (transfer, &velocity, &velocity_new);
+ *   t8_forest_partition_data_transfer_begin (transfer);
+ *   ... do other work ...
+ *   t8_forest_partition_data_transfer_end (&transfer);
+ */
+t8_forest_partition_data_transfer_t
+t8_forest_partition_data_transfer_new (t8_forest_t forest_from, t8_forest_t forest_to);
+
+/** Register an array with a partition data transfer.
+ * \param[in,out] transfer A transfer that was not started yet.
+ * \param[in] data_in      An array with one value per local element of the transfer's \a forest_from.
+ * \param[in,out] data_out An allocated array with one value per local element of the transfer's \a forest_to
+ *                         and the same element size as \a data_in. Different arrays may have different element sizes.
+ * \note Both arrays must not be modified or reallocated until the transfer has ended.
+ */
+void
+t8_forest_partition_data_transfer_add (t8_forest_partition_data_transfer_t transfer, const sc_array_t *data_in,
+                                       sc_array_t *data_out);
+
+/** Start a partition data transfer. The data of all registered arrays is packed and
+ * the messages are posted. The function returns immediately.
+ * \param[in,out] transfer A transfer that was not started yet.
+ * \note This function is collective and hence must be called by all processes in the forests'
+ *       MPI Communicator.
+ */
+void
+t8_forest_partition_data_transfer_begin (t8_forest_partition_data_transfer_t transfer);
+
+/** Finish a partition data transfer that was started with \ref t8_forest_partition_data_transfer_begin
+ * and destroy it. After this call the \a data_out arrays of the transfer are filled.
+ * A transfer that was never started is only destroyed.
+ * \param[in,out] ptransfer Pointer to a transfer. Set to NULL on output.
+ */
+void
+t8_forest_partition_data_transfer_end (t8_forest_partition_data_transfer_t *ptransfer);
+
 /** Test if the last descendant of the last element of current rank has
  * a smaller linear id than the stored first descendant of rank+1.
  * If this is not the case, elements overlap.
@@ -52,3 +52,25 @@ t8_forest_get_tree_element_array_mutable (const t8_forest_t forest, t8_locidx_t
 {
   return (t8_element_array_t*) t8_forest_get_tree_element_array (forest, ltreeid);
 }
+
+void
+t8_forest_split_local_trees (t8_forest_t forest, int num_ranges, t8_locidx_t *first_tree)
+{
+  const t8_locidx_t num_trees = t8_forest_get_num_local_trees (forest);
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  t8_locidx_t ltree_id, el_count = 0;
+  int irange = 1;
+
+  T8_ASSERT (num_ranges >= 1);
+  first_tree[0] = 0;
+  for (ltree_id = 0; ltree_id < num_trees && irange < num_ranges; ltree_id++) {
+    el_count += t8_forest_get_tree_num_elements (forest, ltree_id);
+    /* Start the next range after this tree, if the ranges so far hold enough elements */
+    while (irange < num_ranges && el_count >= (t8_locidx_t) (((int64_t) num_elements * irange) / num_ranges)) {
+      first_tree[irange++] = ltree_id + 1;
+    }
+  }
+  while (irange <= num_ranges) {
+    first_tree[irange++] = num_trees;
+  }
+}
@@ -32,6 +32,7 @@
 
 #include <t8.h>
 #include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_iterate.h>
 
 T8_EXTERN_C_BEGIN ();
 
@@ -68,6 +69,20 @@ t8_forest_compute_desc (t8_forest_t forest);
 void
 t8_forest_populate (t8_forest_t forest);
 
+/** Load the coarse mesh and the elements of this process from a checkpoint
+ * written by \ref t8_forest_save.
+ * If the forest is loaded on as many processes as it was saved, the saved partition
+ * is restored. Otherwise, the elements are partitioned evenly.
+ * \param [in,out] forest     A forest in \ref t8_forest_commit with mpicomm, mpisize,
+ *                            mpirank and scheme set.
+ * \param [in]     fileprefix The prefix of the checkpoint.
+ * \return                    True if the loaded cmesh is partitioned and its partition
+ *                            does not match the elements. In this case it must be repartitioned
+ *                            with \ref t8_forest_partition_cmesh once the forest is committed.
+ */
+int
+t8_forest_load_trees (t8_forest_t forest, const char *fileprefix);
+
 /** Return the eclass scheme of a given element class associated to a forest.
  * This function does not check whether the given forest is committed, use with
  * caution and only if you are sure that the eclass_scheme was set.
@@ -424,6 +439,68 @@ int
 t8_forest_element_has_leaf_desc (t8_forest_t forest, t8_gloidx_t gtreeid, const t8_element_t *element,
                                  t8_eclass_scheme_c *ts);
 
+/** Split the local trees of a forest into contiguous ranges, such that each range
+ * holds roughly the same number of elements. This is used to distribute the trees over threads.
+ * \param [in]  forest      A committed forest.
+ * \param [in]  num_ranges  The number of ranges, at least 1.
+ * \param [out] first_tree  An array of \a num_ranges + 1 entries. On output range i consists
+ *                          of the local trees first_tree[i], ..., first_tree[i + 1] - 1.
+ * \note Ranges may be empty.
+ */
+void
+t8_forest_split_local_trees (t8_forest_t forest, int num_ranges, t8_locidx_t *first_tree);
+
+/** Build the face connectivity table of a committed forest, see \ref t8_forest_face_connectivity.h.
+ * This function is called by \ref t8_forest_commit and should not be called directly.
+ * If \a forest_from is given, it must be the forest that \a forest was adapted from
+ * and have a face connectivity table. Then the rows of all leaves whose tree and whose
+ * neighbor trees did not change during adaptation are copied from the old table and
+ * only the remaining rows are recomputed.
+ * \param [in,out] forest      A committed and balanced forest with ghost layer.
+ * \param [in]     forest_from The forest that \a forest was adapted from or NULL.
+ */
+void
+t8_forest_face_connectivity_build (t8_forest_t forest, const t8_forest_t forest_from);
+
+/** Free the memory of the face connectivity table of a forest.
+ * \param [in,out] forest A forest with face connectivity table. It has no table on output.
+ */
+void
+t8_forest_face_connectivity_destroy (t8_forest_t forest);
+
+/** Compute the element metrics of a committed forest, see \ref t8_forest_element_metrics.h.
+ * This function is called by \ref t8_forest_commit and should not be called directly.
+ * If \a forest_from is given, \a forest must have been adapted non-recursively from it
+ * and \a forest_from must have element metrics. Then the metrics of all local leaves
+ * that did not change during adaptation are copied and only the metrics of the
+ * refined and coarsened leaves are recomputed.
+ * The metrics of the ghosts are always recomputed.
+ * \param [in,out] forest      A committed forest.
+ * \param [in]     forest_from The forest that \a forest was adapted from or NULL.
+ */
+void
+t8_forest_element_metrics_build (t8_forest_t forest, const t8_forest_t forest_from);
+
+/** Free the memory of the element metrics of a forest.
+ * \param [in,out] forest A forest with element metrics. It has no element metrics on output.
+ */
+void
+t8_forest_element_metrics_destroy (t8_forest_t forest);
+
+/** Perform a top-down search, as \ref t8_forest_search does, but only in a range of local trees.
+ * The scratch memory of the search is owned by the call, hence different threads may search
+ * disjoint ranges of trees concurrently, as long as \a search_fn and \a query_fn are thread-safe.
+ * \param [in] forest      A committed forest.
+ * \param [in] first_tree  The first local tree to search.
+ * \param [in] end_tree    One past the last local tree to search.
+ * \param [in] search_fn   The search callback, see \ref t8_forest_search.
+ * \param [in] query_fn    The query callback or NULL, see \ref t8_forest_search.
+ * \param [in] queries     The queries or NULL, see \ref t8_forest_search.
+ */
+void
+t8_forest_search_trees (t8_forest_t forest, t8_locidx_t first_tree, t8_locidx_t end_tree,
+                        t8_forest_search_fn search_fn, t8_forest_query_fn query_fn, sc_array_t *queries);
+
 T8_EXTERN_C_END ();
 
 #endif /* !T8_FOREST_PRIVATE_H */
@@ -121,6 +121,20 @@ t8_forest_profile_get_balance_time (t8_forest_t forest, int *balance_rounds);
 double
 t8_forest_profile_get_ghost_time (t8_forest_t forest, t8_locidx_t *ghosts_sent);
 
+/** Get the split of the runtime of the last call to \ref t8_forest_create_ghosts
+ * into finding the remote elements and communicating the ghost elements.
+ * \param [in]   forest         The forest.
+ * \param [out]  comm_time      On output the time spent on sending and receiving the ghost elements
+ *                              if profiling was activated.
+ * \return                      The time spent on finding the local elements that are ghosts
+ *                              of other processes if profiling was activated. 0 otherwise.
+ * \a forest must be committed before calling this function.
+ * \see t8_forest_set_profiling
+ * \see t8_forest_set_num_threads
+ */
+double
+t8_forest_profile_get_ghost_remote_time (t8_forest_t forest, double *comm_time);
+
 /** Get the waittime of the last call to \ref t8_forest_ghost_exchange_data.
  * \param [in]   forest         The forest.
  * \return                      The time of ghost_exchange_data that was spent waiting
@@ -132,6 +146,104 @@ t8_forest_profile_get_ghost_time (t8_forest_t forest, t8_locidx_t *ghosts_sent);
  */
 double
 t8_forest_profile_get_ghostexchange_waittime (t8_forest_t forest);
+
+/** The file formats of \ref t8_forest_profile_write. */
+typedef enum t8_profile_format
+{
+  T8_PROFILE_FORMAT_CSV = 0, /**< One line per timer or counter. */
+  T8_PROFILE_FORMAT_JSON     /**< One JSON object per record and line. */
+} t8_profile_format_t;
+
+/** Start a named timer of a forest with profiling enabled.
+ * Timers can be nested. The path of a timer consists of the names of all running
+ * timers, separated by '/', for example "commit/ghost/remote".
+ * The runtimes of timers with the same path are accumulated.
+ * t8code itself times the phases of \ref t8_forest_commit below the path "commit".
+ * If profiling is not enabled, nothing happens.
+ * \param [in,out] forest       The forest.
+ * \param [in]     name         The name of the timer. Must not contain '/', ',' or '"'.
+ * \see t8_forest_set_profiling
+ */
+void
+t8_forest_profile_timer_start (t8_forest_t forest, const char *name);
+
+/** Stop the innermost running timer of a forest.
+ * \param [in,out] forest       The forest.
+ * \param [in]     name         The name of the timer, must match the name given to
+ *                              \ref t8_forest_profile_timer_start.
+ */
+void
+t8_forest_profile_timer_stop (t8_forest_t forest, const char *name);
+
+/** Add a value to a named counter of a forest, e.g. a number of elements, bytes or messages.
+ * The counter is placed below the running timers like a timer.
+ * If profiling is not enabled, nothing happens.
+ * \param [in,out] forest       The forest.
+ * \param [in]     name         The name of the counter. Must not contain '/', ',' or '"'.
+ * \param [in]     value        The value that is added to the counter.
+ */
+void
+t8_forest_profile_count (t8_forest_t forest, const char *name, double value);
+
+/** Return the accumulated runtime of a timer of a forest.
+ * \param [in]   forest         The forest.
+ * \param [in]   path           The full path of the timer, e.g. "commit/partition".
+ * \param [out]  calls          If not NULL, the number of times the timer was stopped.
+ * \return                      The runtime in seconds, 0 if the timer does not exist.
+ */
+double
+t8_forest_profile_get_timer (t8_forest_t forest, const char *path, long *calls);
+
+/** Return the value of a counter of a forest.
+ * \param [in]   forest         The forest.
+ * \param [in]   path           The full path of the counter, e.g. "commit/ghost/elements_sent".
+ * \return                      The value of the counter, 0 if the counter does not exist.
+ */
+double
+t8_forest_profile_get_counter (t8_forest_t forest, const char *path);
+
+/** Enable or disable hardware counters for the timers of a forest.
+ * If enabled, the number of cpu cycles and instructions of the calling thread are
+ * recorded for each timer as the counters "<path>/cycles" and "<path>/instructions".
+ * This uses perf_event on Linux and is not available on other systems.
+ * Profiling must be enabled and no timer may be running.
+ * \param [in,out] forest       The forest.
+ * \param [in]     enable       If true, hardware counters are read.
+ */
+void
+t8_forest_profile_set_hardware_counters (t8_forest_t forest, int enable);
+
+/** Append the timers and counters of a forest to a file.
+ * For each entry the minimum, mean and maximum over all processes are written.
+ * The file is written by rank 0. This function is collective.
+ * \param [in]   forest         A committed forest.
+ * \param [in]   filename       The file to append to.
+ * \param [in]   format         The format of the record.
+ */
+void
+t8_forest_profile_write (t8_forest_t forest, const char *filename, t8_profile_format_t format);
+
+/** Set a file to which a record is appended at the end of each \ref t8_forest_commit
+ * of a forest with profiling enabled. The records are numbered in the order of the commits.
+ * \param [in]   filename       The file, or NULL to stop writing records.
+ * \param [in]   format         The format of the records.
+ */
+void
+t8_forest_profile_set_output (const char *filename, t8_profile_format_t format);
+
+/** Append the accumulated timers and counters of all forests that were committed with
+ * profiling enabled so far to a file. This function is collective.
+ * \param [in]   filename       The file to append to.
+ * \param [in]   format         The format of the record.
+ * \param [in]   comm           The communicator of the profiled forests.
+ */
+void
+t8_forest_profile_write_summary (const char *filename, t8_profile_format_t format, sc_MPI_Comm comm);
+
+/** Reset the accumulated timers and counters of \ref t8_forest_profile_write_summary. */
+void
+t8_forest_profile_reset_summary (void);
+
 T8_EXTERN_C_END ();
 
 #endif /* !T8_FOREST_PROFILING_H */
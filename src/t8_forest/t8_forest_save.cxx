@@ -0,0 +1,541 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this file we save a committed forest to a binary checkpoint file
+ * and load it again, possibly on a different number of processes.
+ *
+ * A checkpoint with prefix P consists of the coarse mesh files written by
+ * t8_cmesh_save (P_RANK.cmesh) and one shared forest file P.t8f with the layout
+ *
+ *   header                  t8_forest_save_header_t
+ *   element offsets         (mpisize + 1) int64, the partition of the saved forest
+ *   element records         global_num_elements records of T8_FOREST_SAVE_RECORD_SIZE bytes
+ *   element data            global_num_elements * data_size bytes (optional)
+ *
+ * Each element record stores the global tree id, the linear id of the element
+ * at its level, the level and the eclass of the tree, such that the records do
+ * not depend on the memory layout of the elements of a scheme.
+ * All numbers are stored in the native byte order.
+ */
+
+#include <t8_forest/t8_forest_io.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_types.h>
+#include <t8_forest/t8_forest_private.h>
+#include <t8_cmesh/t8_cmesh_save.h>
+#include <t8_data/t8_shmem.h>
+#include <t8_element.hxx>
+
+T8_EXTERN_C_BEGIN ();
+
+/** The number of bytes of one element record in a forest file. */
+#define T8_FOREST_SAVE_RECORD_SIZE 18
+
+/** The header of a forest file. All entries are 64 bit wide, such that the
+ * struct does not contain padding. */
+typedef struct
+{
+  char magic[8];               /**< Always "t8forest". */
+  int64_t format;              /**< The file format version, \ref T8_FOREST_FORMAT. */
+  int64_t mpisize;             /**< The number of processes that saved the forest. */
+  int64_t cmesh_partitioned;   /**< True if the coarse mesh is partitioned. */
+  int64_t incomplete_trees;    /**< The incomplete_trees flag of the forest. */
+  int64_t data_size;           /**< The number of bytes of user data per element, or 0. */
+  int64_t global_num_elements; /**< The global number of elements. */
+  int64_t global_num_trees;    /**< The global number of trees. */
+} t8_forest_save_header_t;
+
+/** A shared file that all processes of a communicator read from or write to. */
+typedef struct
+{
+#if T8_ENABLE_MPIIO
+  MPI_File fh; /**< The MPI-IO file handle. */
+#else
+  FILE *fp; /**< Without MPI-IO, each process opens the file on its own. */
+#endif
+} t8_forest_save_file_t;
+
+/* Open a shared file. If write is true, the file is created or truncated.
+ * This function is collective and returns true on all processes if the
+ * file could be opened on all processes. */
+static int
+t8_forest_save_file_open (t8_forest_save_file_t *file, const char *filename, const int write, sc_MPI_Comm comm)
+{
+  int success, global_success;
+  int mpiret;
+
+#if T8_ENABLE_MPIIO
+  mpiret = MPI_File_open (comm, (char *) filename, write ? MPI_MODE_WRONLY | MPI_MODE_CREATE : MPI_MODE_RDONLY,
+                          sc_MPI_INFO_NULL, &file->fh);
+  success = mpiret == sc_MPI_SUCCESS;
+  if (success && write) {
+    /* Truncate the file, in case it already existed */
+    success = MPI_File_set_size (file->fh, 0) == sc_MPI_SUCCESS;
+  }
+#else
+  int mpirank;
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  success = 1;
+  if (write) {
+    /* Rank 0 creates the file, such that the other processes can open it for writing. */
+    if (mpirank == 0) {
+      file->fp = fopen (filename, "wb");
+      success = file->fp != NULL;
+      if (success) {
+        fclose (file->fp);
+      }
+    }
+    mpiret = sc_MPI_Barrier (comm);
+    SC_CHECK_MPI (mpiret);
+  }
+  if (success) {
+    file->fp = fopen (filename, write ? "r+b" : "rb");
+    success = file->fp != NULL;
+  }
+#endif
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_LAND, comm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    if (success) {
+#if T8_ENABLE_MPIIO
+      MPI_File_close (&file->fh);
+#else
+      fclose (file->fp);
+#endif
+    }
+    t8_errorf ("Error when opening file %s.\n", filename);
+  }
+  return global_success;
+}
+
+#if !T8_ENABLE_MPIIO
+/* Set the position of the file of a process to a byte offset from its beginning.
+ * Forest files may exceed 2 GiB, which fseek cannot address if long has 32 bits.
+ * Returns true if successful. */
+static int
+t8_forest_save_file_seek (t8_forest_save_file_t *file, const t8_gloidx_t offset)
+{
+#ifndef _WIN32
+  if ((t8_gloidx_t) (off_t) offset != offset) {
+    /* off_t is too small for this offset */
+    return 0;
+  }
+  return fseeko (file->fp, (off_t) offset, SEEK_SET) == 0;
+#else
+  return _fseeki64 (file->fp, offset, SEEK_SET) == 0;
+#endif
+}
+#endif
+
+/* Write bytes at a given offset of a shared file.
+ * This function is collective, processes that do not write pass 0 as bytes.
+ * Returns true if successful (process local). */
+static int
+t8_forest_save_file_write_at (t8_forest_save_file_t *file, const t8_gloidx_t offset, const void *data,
+                              const size_t bytes)
+{
+#if T8_ENABLE_MPIIO
+  SC_CHECK_ABORT (bytes <= INT_MAX, "Forest file section too large for one process.\n");
+  return MPI_File_write_at_all (file->fh, (MPI_Offset) offset, (void *) data, (int) bytes, sc_MPI_BYTE,
+                                MPI_STATUS_IGNORE)
+         == sc_MPI_SUCCESS;
+#else
+  if (bytes == 0) {
+    return 1;
+  }
+  return t8_forest_save_file_seek (file, offset) && fwrite (data, 1, bytes, file->fp) == bytes;
+#endif
+}
+
+/* Read bytes at a given offset of a shared file.
+ * This function is collective, processes that do not read pass 0 as bytes.
+ * Returns true if successful (process local). */
+static int
+t8_forest_save_file_read_at (t8_forest_save_file_t *file, const t8_gloidx_t offset, void *data, const size_t bytes)
+{
+#if T8_ENABLE_MPIIO
+  SC_CHECK_ABORT (bytes <= INT_MAX, "Forest file section too large for one process.\n");
+  return MPI_File_read_at_all (file->fh, (MPI_Offset) offset, data, (int) bytes, sc_MPI_BYTE, MPI_STATUS_IGNORE)
+         == sc_MPI_SUCCESS;
+#else
+  if (bytes == 0) {
+    return 1;
+  }
+  return t8_forest_save_file_seek (file, offset) && fread (data, 1, bytes, file->fp) == bytes;
+#endif
+}
+
+/* Close a shared file. This function is collective. */
+static void
+t8_forest_save_file_close (t8_forest_save_file_t *file)
+{
+#if T8_ENABLE_MPIIO
+  MPI_File_close (&file->fh);
+#else
+  fclose (file->fp);
+#endif
+}
+
+/* Build the name of the forest file from a prefix. */
+static void
+t8_forest_save_filename (const char *fileprefix, char *filename)
+{
+  snprintf (filename, BUFSIZ, "%s.t8f", fileprefix);
+}
+
+/* Return the position in the file of the first element record. */
+static t8_gloidx_t
+t8_forest_save_records_start (const t8_forest_save_header_t *header)
+{
+  return sizeof (t8_forest_save_header_t) + (header->mpisize + 1) * sizeof (int64_t);
+}
+
+/* Return the position in the file of the user data of the first element. */
+static t8_gloidx_t
+t8_forest_save_data_start (const t8_forest_save_header_t *header)
+{
+  return t8_forest_save_records_start (header) + header->global_num_elements * T8_FOREST_SAVE_RECORD_SIZE;
+}
+
+/* Read the header of a forest file and check that it can be loaded.
+ * This function is collective. Aborts if the file is not a valid forest file. */
+static void
+t8_forest_save_read_header (t8_forest_save_file_t *file, t8_forest_save_header_t *header, const char *filename)
+{
+  int success;
+
+  success = t8_forest_save_file_read_at (file, 0, header, sizeof (t8_forest_save_header_t));
+  SC_CHECK_ABORTF (success, "Error when reading the header of %s.\n", filename);
+  SC_CHECK_ABORTF (memcmp (header->magic, "t8forest", 8) == 0, "%s is not a t8code forest file.\n", filename);
+  SC_CHECK_ABORTF (header->format == T8_FOREST_FORMAT,
+                   "File %s has format version %lli, but only version %i is supported.\n", filename,
+                   (long long) header->format, T8_FOREST_FORMAT);
+}
+
+/* Store an element in a record. */
+static void
+t8_forest_save_pack_record (char *record, const int64_t gtreeid, const t8_eclass_t eclass,
+                            const t8_eclass_scheme_c *ts, const t8_element_t *element)
+{
+  const int level = ts->t8_element_level (element);
+  const uint64_t linear_id = ts->t8_element_get_linear_id (element, level);
+
+  memcpy (record, &gtreeid, sizeof (int64_t));
+  memcpy (record + 8, &linear_id, sizeof (uint64_t));
+  record[16] = (int8_t) level;
+  record[17] = (int8_t) eclass;
+}
+
+/* Read the tree, eclass, level and linear id from a record. */
+static void
+t8_forest_save_unpack_record (const char *record, int64_t *gtreeid, t8_eclass_t *eclass, int *level,
+                              t8_linearidx_t *linear_id)
+{
+  uint64_t id;
+
+  memcpy (gtreeid, record, sizeof (int64_t));
+  memcpy (&id, record + 8, sizeof (uint64_t));
+  *linear_id = id;
+  *level = (int8_t) record[16];
+  *eclass = (t8_eclass_t) record[17];
+}
+
+int
+t8_forest_save (t8_forest_t forest, const char *fileprefix, const size_t data_size, const void *element_data)
+{
+  t8_forest_save_file_t file;
+  t8_forest_save_header_t header;
+  char filename[BUFSIZ];
+  int success, global_success;
+  int mpiret;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (fileprefix != NULL);
+  T8_ASSERT (data_size == 0 || element_data != NULL || forest->local_num_elements == 0);
+
+  /* Save the coarse mesh, a replicated cmesh is only written by rank 0. */
+  success = t8_cmesh_save (forest->cmesh, fileprefix);
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_LAND, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_global_errorf ("Could not save the coarse mesh of the forest to %s.\n", fileprefix);
+    return 0;
+  }
+
+  t8_forest_save_filename (fileprefix, filename);
+  if (!t8_forest_save_file_open (&file, filename, 1, forest->mpicomm)) {
+    return 0;
+  }
+
+  /* Fill the header */
+  memcpy (header.magic, "t8forest", 8);
+  header.format = T8_FOREST_FORMAT;
+  header.mpisize = forest->mpisize;
+  header.cmesh_partitioned = t8_cmesh_is_partitioned (forest->cmesh);
+  header.incomplete_trees = forest->incomplete_trees;
+  header.data_size = data_size;
+  header.global_num_elements = forest->global_num_elements;
+  header.global_num_trees = forest->global_num_trees;
+
+  /* The element offsets are computed in t8_forest_commit */
+  T8_ASSERT (forest->element_offsets != NULL);
+  const t8_gloidx_t *offsets = t8_shmem_array_get_gloidx_array (forest->element_offsets);
+  const t8_gloidx_t first_element = offsets[forest->mpirank];
+  const size_t is_root = forest->mpirank == 0;
+
+  /* Rank 0 writes the header and the partition */
+  success = t8_forest_save_file_write_at (&file, 0, &header, is_root * sizeof (t8_forest_save_header_t));
+  success = success
+            && t8_forest_save_file_write_at (&file, sizeof (t8_forest_save_header_t), offsets,
+                                             is_root * (forest->mpisize + 1) * sizeof (int64_t));
+
+  /* Pack and write the local elements */
+  char *records = T8_ALLOC (char, SC_MAX (forest->local_num_elements, 1) * T8_FOREST_SAVE_RECORD_SIZE);
+  char *record = records;
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_eclass_t eclass = t8_forest_get_tree_class (forest, itree);
+    const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, eclass);
+    const t8_gloidx_t gtreeid = t8_forest_global_tree_id (forest, itree);
+    const t8_locidx_t num_elements = t8_forest_get_tree_num_elements (forest, itree);
+    for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+      t8_forest_save_pack_record (record, gtreeid, eclass, ts, t8_forest_get_element_in_tree (forest, itree, ielement));
+      record += T8_FOREST_SAVE_RECORD_SIZE;
+    }
+  }
+  const t8_gloidx_t records_start = t8_forest_save_records_start (&header);
+  success = success
+            && t8_forest_save_file_write_at (&file, records_start + first_element * T8_FOREST_SAVE_RECORD_SIZE,
+                                             records, forest->local_num_elements * T8_FOREST_SAVE_RECORD_SIZE);
+  T8_FREE (records);
+
+  /* Write the user data */
+  if (data_size > 0) {
+    success = success
+              && t8_forest_save_file_write_at (&file, t8_forest_save_data_start (&header) + first_element * data_size,
+                                               element_data, forest->local_num_elements * data_size);
+  }
+  t8_forest_save_file_close (&file);
+
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_LAND, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_global_errorf ("Error when writing forest file %s.\n", filename);
+  }
+  return global_success;
+}
+
+int
+t8_forest_load_trees (t8_forest_t forest, const char *fileprefix)
+{
+  t8_forest_save_file_t file;
+  t8_forest_save_header_t header;
+  char filename[BUFSIZ];
+  int success;
+  int repartition_cmesh = 0;
+
+  T8_ASSERT (forest->mpicomm != sc_MPI_COMM_NULL);
+  T8_ASSERT (forest->mpisize > 0);
+  T8_ASSERT (forest->cmesh == NULL);
+  T8_ASSERT (forest->scheme_cxx != NULL);
+
+  t8_forest_save_filename (fileprefix, filename);
+  SC_CHECK_ABORTF (t8_forest_save_file_open (&file, filename, 0, forest->mpicomm), "Could not open forest file %s.\n",
+                   filename);
+  t8_forest_save_read_header (&file, &header, filename);
+
+  /* Load the coarse mesh */
+  if (header.cmesh_partitioned) {
+    /* Each process of the saving run has written one cmesh file */
+    SC_CHECK_ABORTF (forest->mpisize >= header.mpisize,
+                     "A forest with partitioned coarse mesh that was saved on %lli processes "
+                     "cannot be loaded on %i processes.\n",
+                     (long long) header.mpisize, forest->mpisize);
+    forest->cmesh
+      = t8_cmesh_load_and_distribute (fileprefix, header.mpisize, forest->mpicomm, T8_LOAD_SIMPLE, 0);
+    /* The trees of the cmesh match the elements only if we restore the saved partition */
+    repartition_cmesh = forest->mpisize != header.mpisize;
+  }
+  else {
+    forest->cmesh = t8_cmesh_load_and_distribute (fileprefix, 1, forest->mpicomm, T8_LOAD_SIMPLE, 0);
+  }
+  SC_CHECK_ABORTF (forest->cmesh != NULL, "Could not load the coarse mesh from %s.\n", fileprefix);
+  SC_CHECK_ABORT (t8_cmesh_get_num_trees (forest->cmesh) == header.global_num_trees,
+                  "Number of trees of the coarse mesh does not match the forest file.\n");
+
+  /* Determine the range of elements of this process */
+  t8_gloidx_t first_element, end_element;
+  if (forest->mpisize == header.mpisize) {
+    /* Restore the partition of the saved forest */
+    int64_t offsets[2];
+    success = t8_forest_save_file_read_at (&file, sizeof (t8_forest_save_header_t) + forest->mpirank * sizeof (int64_t),
+                                           offsets, 2 * sizeof (int64_t));
+    SC_CHECK_ABORTF (success, "Error when reading the partition of %s.\n", filename);
+    first_element = offsets[0];
+    end_element = offsets[1];
+  }
+  else {
+    /* Partition the elements evenly among the processes */
+    first_element = (t8_gloidx_t) (((long double) forest->mpirank * header.global_num_elements) / forest->mpisize);
+    end_element = (t8_gloidx_t) (((long double) (forest->mpirank + 1) * header.global_num_elements) / forest->mpisize);
+  }
+  T8_ASSERT (0 <= first_element && first_element <= end_element && end_element <= header.global_num_elements);
+  const t8_locidx_t num_elements = end_element - first_element;
+
+  /* Read the element records of this process */
+  char *records = T8_ALLOC (char, SC_MAX (num_elements, 1) * T8_FOREST_SAVE_RECORD_SIZE);
+  success = t8_forest_save_file_read_at (
+    &file, t8_forest_save_records_start (&header) + first_element * T8_FOREST_SAVE_RECORD_SIZE, records,
+    num_elements * T8_FOREST_SAVE_RECORD_SIZE);
+  SC_CHECK_ABORTF (success, "Error when reading the elements of %s.\n", filename);
+  t8_forest_save_file_close (&file);
+
+  /* Count the local trees. Since the records are sorted, the elements of a tree are contiguous. */
+  int64_t gtreeid, last_gtreeid = -1;
+  t8_eclass_t eclass;
+  int level;
+  t8_linearidx_t linear_id;
+  t8_locidx_t num_local_trees = 0;
+  for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+    t8_forest_save_unpack_record (records + ielement * T8_FOREST_SAVE_RECORD_SIZE, &gtreeid, &eclass, &level,
+                                  &linear_id);
+    if (gtreeid != last_gtreeid) {
+      T8_ASSERT (gtreeid > last_gtreeid);
+      num_local_trees++;
+      last_gtreeid = gtreeid;
+    }
+  }
+
+  /* Build the trees and elements */
+  forest->trees = sc_array_new_count (sizeof (t8_tree_struct_t), num_local_trees);
+  if (num_elements == 0) {
+    /* This process is empty, set first and last local tree such
+     * that t8_forest_get_num_local_trees return 0 */
+    forest->first_local_tree = 0;
+    forest->last_local_tree = -1;
+  }
+  t8_tree_t tree = NULL;
+  t8_locidx_t itree = -1;
+  t8_locidx_t tree_start = 0;
+  for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+    t8_forest_save_unpack_record (records + ielement * T8_FOREST_SAVE_RECORD_SIZE, &gtreeid, &eclass, &level,
+                                  &linear_id);
+    if (tree == NULL || gtreeid != forest->first_local_tree + itree) {
+      /* This element starts a new tree */
+      T8_ASSERT (0 <= eclass && eclass < T8_ECLASS_COUNT);
+      if (tree == NULL) {
+        forest->first_local_tree = gtreeid;
+      }
+      forest->last_local_tree = gtreeid;
+      itree++;
+      /* The local trees are consecutive in the global tree order */
+      SC_CHECK_ABORT (gtreeid == forest->first_local_tree + itree, "Forest file has non-contiguous trees.\n");
+      tree = (t8_tree_t) t8_sc_array_index_locidx (forest->trees, itree);
+      tree->eclass = eclass;
+      tree->elements_offset = ielement;
+      tree_start = ielement;
+      /* Count the elements of this tree */
+      t8_locidx_t tree_end = ielement + 1;
+      int64_t next_gtreeid = gtreeid;
+      while (tree_end < num_elements) {
+        memcpy (&next_gtreeid, records + tree_end * T8_FOREST_SAVE_RECORD_SIZE, sizeof (int64_t));
+        if (next_gtreeid != gtreeid) {
+          break;
+        }
+        tree_end++;
+      }
+      t8_eclass_scheme_c *ts = forest->scheme_cxx->eclass_schemes[eclass];
+      SC_CHECK_ABORT (ts != NULL, "The scheme of the forest does not support the element class of a tree.\n");
+      t8_element_array_init_size (&tree->elements, ts, tree_end - ielement);
+    }
+    const t8_eclass_scheme_c *ts = forest->scheme_cxx->eclass_schemes[eclass];
+    t8_element_t *element = t8_element_array_index_locidx_mutable (&tree->elements, ielement - tree_start);
+    ts->t8_element_set_linear_id (element, level, linear_id);
+  }
+  T8_FREE (records);
+
+  forest->local_num_elements = num_elements;
+  forest->global_num_elements = header.global_num_elements;
+  forest->incomplete_trees = header.incomplete_trees;
+  return repartition_cmesh;
+}
+
+int
+t8_forest_load_element_data (t8_forest_t forest, const char *fileprefix, sc_array_t *element_data)
+{
+  t8_forest_save_file_t file;
+  t8_forest_save_header_t header;
+  char filename[BUFSIZ];
+  int success, global_success;
+  int mpiret;
+
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (element_data != NULL);
+
+  t8_forest_save_filename (fileprefix, filename);
+  if (!t8_forest_save_file_open (&file, filename, 0, forest->mpicomm)) {
+    return 0;
+  }
+  t8_forest_save_read_header (&file, &header, filename);
+  if (header.data_size != (int64_t) element_data->elem_size
+      || header.global_num_elements != forest->global_num_elements) {
+    /* All processes read the same header, so they all return here */
+    t8_global_errorf ("Forest file %s does not contain element data of size %zd for this forest.\n", filename,
+                      element_data->elem_size);
+    t8_forest_save_file_close (&file);
+    return 0;
+  }
+
+  /* Read the data of the local elements */
+  const t8_gloidx_t first_element = t8_forest_get_first_local_element_id (forest);
+  sc_array_resize (element_data, forest->local_num_elements);
+  success = t8_forest_save_file_read_at (&file, t8_forest_save_data_start (&header) + first_element * header.data_size,
+                                         element_data->array, forest->local_num_elements * header.data_size);
+  t8_forest_save_file_close (&file);
+
+  mpiret = sc_MPI_Allreduce (&success, &global_success, 1, sc_MPI_INT, sc_MPI_LAND, forest->mpicomm);
+  SC_CHECK_MPI (mpiret);
+  if (!global_success) {
+    t8_global_errorf ("Error when reading the element data of %s.\n", filename);
+  }
+  return global_success;
+}
+
+t8_forest_t
+t8_forest_load (const char *fileprefix, t8_scheme_cxx_t *scheme, sc_MPI_Comm comm, sc_array_t *element_data)
+{
+  t8_forest_t forest;
+
+  t8_forest_init (&forest);
+  t8_forest_set_load (forest, fileprefix, comm);
+  t8_forest_set_scheme (forest, scheme);
+  t8_forest_commit (forest);
+
+  if (element_data != NULL) {
+    SC_CHECK_ABORTF (t8_forest_load_element_data (forest, fileprefix, element_data),
+                     "Could not load the element data from %s.\n", fileprefix);
+  }
+  return forest;
+}
+
+T8_EXTERN_C_END ();
@@ -0,0 +1,486 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_forest_timers.cxx
+ * Nested named timers and counters of a forest profile, optional hardware
+ * counters via perf_event on Linux, and their output as CSV or JSON.
+ */
+
+#include <t8_forest/t8_forest_timers.h>
+#include <t8_forest/t8_forest_profiling.h>
+#include <t8_forest/t8_forest_types.h>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+#include <cfloat>
+#include <cstring>
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/perf_event.h>)
+#define T8_FOREST_TIMERS_PERF_EVENT 1
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+/* The number of hardware counters that are read for each timer */
+#define T8_FOREST_TIMERS_NUM_HARDWARE 2
+
+/* The name suffixes of the hardware counters */
+static const char *t8_forest_timers_hardware_names[T8_FOREST_TIMERS_NUM_HARDWARE] = { "cycles", "instructions" };
+
+/* A timer or a counter */
+typedef struct
+{
+  int is_timer; /* True for a timer, false for a counter */
+  long calls;   /* The number of times the timer was stopped or the counter was incremented */
+  double value; /* The accumulated runtime in seconds or the sum of the counter */
+} t8_forest_timer_entry_t;
+
+/* The entries of a forest or of a whole run, sorted by their path */
+typedef std::map<std::string, t8_forest_timer_entry_t> t8_forest_timer_entries_t;
+
+/* A timer that was started and not yet stopped */
+typedef struct
+{
+  std::string path;                                   /* The path of the timer, i.e. "commit/ghost/remote" */
+  double start;                                       /* The time at which the timer was started */
+  long long hardware_start[T8_FOREST_TIMERS_NUM_HARDWARE]; /* The hardware counters at start */
+} t8_forest_running_timer_t;
+
+struct t8_forest_timers
+{
+  t8_forest_timer_entries_t entries;              /* All timers and counters */
+  std::vector<t8_forest_running_timer_t> running; /* The running timers, the innermost last */
+  int hardware_fds[T8_FOREST_TIMERS_NUM_HARDWARE]; /* The perf_event file descriptors, -1 if not open */
+};
+
+/* The accumulated entries of all profiled forests of this run */
+static t8_forest_timer_entries_t t8_forest_timers_run_totals;
+/* The file that a record is appended to after each profiled commit, empty if none */
+static std::string t8_forest_timers_output;
+static t8_profile_format_t t8_forest_timers_output_format = T8_PROFILE_FORMAT_CSV;
+/* The number of records written to t8_forest_timers_output */
+static long t8_forest_timers_num_commits = 0;
+/* The number of profiled commits that are currently running. Intermediate forests
+ * are committed inside the commit of another forest and merged into its entries,
+ * so only the outermost commit is recorded. */
+static int t8_forest_timers_commit_depth = 0;
+
+/* Return the timers of a forest, or NULL if profiling is disabled */
+static t8_forest_timers_t
+t8_forest_timers_get (const t8_forest_t forest)
+{
+  T8_ASSERT (forest != NULL);
+  if (forest->profile == NULL) {
+    return NULL;
+  }
+  T8_ASSERT (forest->profile->timers != NULL);
+  return forest->profile->timers;
+}
+
+/* Return the path of a new entry \a name below the running timers */
+static std::string
+t8_forest_timers_path (const t8_forest_timers_t timers, const char *name)
+{
+  T8_ASSERT (name != NULL && strchr (name, '/') == NULL);
+  if (timers->running.empty ()) {
+    return std::string (name);
+  }
+  return timers->running.back ().path + "/" + name;
+}
+
+/* Read the current value of the hardware counters, 0 if a counter is not available */
+static void
+t8_forest_timers_read_hardware (const t8_forest_timers_t timers, long long values[T8_FOREST_TIMERS_NUM_HARDWARE])
+{
+  for (int icounter = 0; icounter < T8_FOREST_TIMERS_NUM_HARDWARE; icounter++) {
+    values[icounter] = 0;
+#if T8_FOREST_TIMERS_PERF_EVENT
+    if (timers->hardware_fds[icounter] >= 0) {
+      if (read (timers->hardware_fds[icounter], &values[icounter], sizeof (long long)) != sizeof (long long)) {
+        values[icounter] = 0;
+      }
+    }
+#endif
+  }
+}
+
+/* Add a value to an entry */
+static void
+t8_forest_timers_add (t8_forest_timer_entries_t &entries, const std::string &path, const int is_timer,
+                      const long calls, const double value)
+{
+  t8_forest_timer_entry_t &entry = entries[path];
+  entry.is_timer = is_timer;
+  entry.calls += calls;
+  entry.value += value;
+}
+
+t8_forest_timers_t
+t8_forest_timers_new (void)
+{
+  t8_forest_timers_t timers = new t8_forest_timers;
+  for (int icounter = 0; icounter < T8_FOREST_TIMERS_NUM_HARDWARE; icounter++) {
+    timers->hardware_fds[icounter] = -1;
+  }
+  return timers;
+}
+
+void
+t8_forest_timers_destroy (t8_forest_timers_t *ptimers)
+{
+  T8_ASSERT (ptimers != NULL && *ptimers != NULL);
+#if T8_FOREST_TIMERS_PERF_EVENT
+  for (int icounter = 0; icounter < T8_FOREST_TIMERS_NUM_HARDWARE; icounter++) {
+    if ((*ptimers)->hardware_fds[icounter] >= 0) {
+      close ((*ptimers)->hardware_fds[icounter]);
+    }
+  }
+#endif
+  delete *ptimers;
+  *ptimers = NULL;
+}
+
+void
+t8_forest_profile_set_hardware_counters (t8_forest_t forest, int enable)
+{
+  t8_forest_timers_t timers = t8_forest_timers_get (forest);
+  SC_CHECK_ABORT (timers != NULL, "Hardware counters require profiling. See t8_forest_set_profiling.\n");
+  T8_ASSERT (timers->running.empty ());
+
+  for (int icounter = 0; icounter < T8_FOREST_TIMERS_NUM_HARDWARE; icounter++) {
+#if T8_FOREST_TIMERS_PERF_EVENT
+    if (enable && timers->hardware_fds[icounter] < 0) {
+      struct perf_event_attr attr;
+      memset (&attr, 0, sizeof (attr));
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.size = sizeof (attr);
+      attr.config = icounter == 0 ? PERF_COUNT_HW_CPU_CYCLES : PERF_COUNT_HW_INSTRUCTIONS;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      /* Count for the calling thread on any cpu */
+      timers->hardware_fds[icounter] = syscall (__NR_perf_event_open, &attr, 0, -1, -1, 0);
+      if (timers->hardware_fds[icounter] < 0) {
+        t8_errorf ("Could not open the hardware counter %s. Check /proc/sys/kernel/perf_event_paranoid.\n",
+                   t8_forest_timers_hardware_names[icounter]);
+      }
+    }
+    else if (!enable && timers->hardware_fds[icounter] >= 0) {
+      close (timers->hardware_fds[icounter]);
+      timers->hardware_fds[icounter] = -1;
+    }
+#else
+    if (enable && icounter == 0) {
+      t8_errorf ("Hardware counters are only supported on Linux with perf_event.\n");
+    }
+#endif
+  }
+}
+
+void
+t8_forest_profile_timer_start (t8_forest_t forest, const char *name)
+{
+  t8_forest_timers_t timers = t8_forest_timers_get (forest);
+  if (timers == NULL) {
+    return;
+  }
+  t8_forest_running_timer_t timer;
+  timer.path = t8_forest_timers_path (timers, name);
+  t8_forest_timers_read_hardware (timers, timer.hardware_start);
+  timer.start = sc_MPI_Wtime ();
+  timers->running.push_back (timer);
+}
+
+void
+t8_forest_profile_timer_stop (t8_forest_t forest, const char *name)
+{
+  t8_forest_timers_t timers = t8_forest_timers_get (forest);
+  if (timers == NULL) {
+    return;
+  }
+  const double stop = sc_MPI_Wtime ();
+  long long hardware_stop[T8_FOREST_TIMERS_NUM_HARDWARE];
+  t8_forest_timers_read_hardware (timers, hardware_stop);
+
+  SC_CHECK_ABORTF (!timers->running.empty (), "Stopping timer %s that is not running.\n", name);
+  const t8_forest_running_timer_t &timer = timers->running.back ();
+  T8_ASSERT (timer.path.size () >= strlen (name)
+             && timer.path.compare (timer.path.size () - strlen (name), std::string::npos, name) == 0);
+  t8_forest_timers_add (timers->entries, timer.path, 1, 1, stop - timer.start);
+  for (int icounter = 0; icounter < T8_FOREST_TIMERS_NUM_HARDWARE; icounter++) {
+    if (timers->hardware_fds[icounter] >= 0) {
+      t8_forest_timers_add (timers->entries, timer.path + "/" + t8_forest_timers_hardware_names[icounter], 0, 1,
+                            (double) (hardware_stop[icounter] - timer.hardware_start[icounter]));
+    }
+  }
+  timers->running.pop_back ();
+}
+
+void
+t8_forest_profile_count (t8_forest_t forest, const char *name, double value)
+{
+  t8_forest_timers_t timers = t8_forest_timers_get (forest);
+  if (timers == NULL) {
+    return;
+  }
+  t8_forest_timers_add (timers->entries, t8_forest_timers_path (timers, name), 0, 1, value);
+}
+
+/* Look up an entry of a forest by its path */
+static const t8_forest_timer_entry_t *
+t8_forest_timers_find (const t8_forest_t forest, const char *path)
+{
+  const t8_forest_timers_t timers = t8_forest_timers_get (forest);
+  if (timers == NULL) {
+    return NULL;
+  }
+  auto entry = timers->entries.find (path);
+  return entry == timers->entries.end () ? NULL : &entry->second;
+}
+
+double
+t8_forest_profile_get_timer (t8_forest_t forest, const char *path, long *calls)
+{
+  const t8_forest_timer_entry_t *entry = t8_forest_timers_find (forest, path);
+  if (calls != NULL) {
+    *calls = entry != NULL && entry->is_timer ? entry->calls : 0;
+  }
+  return entry != NULL && entry->is_timer ? entry->value : 0;
+}
+
+double
+t8_forest_profile_get_counter (t8_forest_t forest, const char *path)
+{
+  const t8_forest_timer_entry_t *entry = t8_forest_timers_find (forest, path);
+  return entry != NULL && !entry->is_timer ? entry->value : 0;
+}
+
+void
+t8_forest_timers_merge (t8_forest_t forest, const t8_forest_t forest_from)
+{
+  t8_forest_timers_t timers = t8_forest_timers_get (forest);
+  const t8_forest_timers_t timers_from = t8_forest_timers_get (forest_from);
+  if (timers == NULL || timers_from == NULL) {
+    return;
+  }
+  const std::string prefix = timers->running.empty () ? std::string () : timers->running.back ().path + "/";
+  for (const auto &entry : timers_from->entries) {
+    /* The commit of forest_from is part of the running timer of forest */
+    std::string path = entry.first;
+    if (path == "commit") {
+      continue;
+    }
+    if (path.compare (0, 7, "commit/") == 0) {
+      path = path.substr (7);
+    }
+    t8_forest_timers_add (timers->entries, prefix + path, entry.second.is_timer, entry.second.calls,
+                          entry.second.value);
+  }
+}
+
+/* Aggregate entries over all processes and write them on rank 0 of \a comm.
+ * For each path that exists on any process we write the minimum, mean and
+ * maximum over the processes on which it exists. */
+static void
+t8_forest_timers_write_entries (const t8_forest_timer_entries_t &entries, const char *filename,
+                                const t8_profile_format_t format, const char *label, sc_MPI_Comm comm)
+{
+  int mpirank, mpisize, mpiret;
+
+  mpiret = sc_MPI_Comm_rank (comm, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (comm, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  /* Gather the paths of all processes on rank 0 and broadcast their union */
+  std::string local_paths;
+  for (const auto &entry : entries) {
+    local_paths += entry.first;
+    local_paths.push_back ('\0');
+  }
+  int local_length = local_paths.size ();
+  std::vector<int> lengths (mpisize), offsets (mpisize + 1, 0);
+  mpiret = sc_MPI_Gather (&local_length, 1, sc_MPI_INT, lengths.data (), 1, sc_MPI_INT, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  for (int iproc = 0; iproc < mpisize; iproc++) {
+    offsets[iproc + 1] = offsets[iproc] + lengths[iproc];
+  }
+  std::vector<char> all_paths (mpirank == 0 ? SC_MAX (offsets[mpisize], 1) : 1);
+  mpiret = sc_MPI_Gatherv (local_paths.data (), local_length, sc_MPI_CHAR, all_paths.data (), lengths.data (),
+                           offsets.data (), sc_MPI_CHAR, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  std::string union_paths;
+  if (mpirank == 0) {
+    std::set<std::string> path_set;
+    for (int ichar = 0; ichar < offsets[mpisize]; ichar += strlen (&all_paths[ichar]) + 1) {
+      path_set.insert (std::string (&all_paths[ichar]));
+    }
+    for (const std::string &path : path_set) {
+      union_paths += path;
+      union_paths.push_back ('\0');
+    }
+  }
+  int union_length = union_paths.size ();
+  mpiret = sc_MPI_Bcast (&union_length, 1, sc_MPI_INT, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  union_paths.resize (union_length);
+  mpiret = sc_MPI_Bcast (&union_paths[0], union_length, sc_MPI_CHAR, 0, comm);
+  SC_CHECK_MPI (mpiret);
+  std::vector<std::string> paths;
+  for (int ichar = 0; ichar < union_length; ichar += strlen (&union_paths[ichar]) + 1) {
+    paths.push_back (std::string (&union_paths[ichar]));
+  }
+
+  /* Reduce the values of each path */
+  const int num_paths = paths.size ();
+  std::vector<double> values_min (num_paths), values_max (num_paths), values_sum (num_paths);
+  std::vector<double> global_min (num_paths), global_max (num_paths), global_sum (num_paths);
+  std::vector<long> calls (num_paths), global_calls (num_paths);
+  std::vector<int> is_timer (num_paths), global_is_timer (num_paths), present (num_paths), num_present (num_paths);
+  for (int ipath = 0; ipath < num_paths; ipath++) {
+    auto entry = entries.find (paths[ipath]);
+    present[ipath] = entry != entries.end ();
+    values_min[ipath] = present[ipath] ? entry->second.value : DBL_MAX;
+    values_max[ipath] = present[ipath] ? entry->second.value : -DBL_MAX;
+    values_sum[ipath] = present[ipath] ? entry->second.value : 0;
+    calls[ipath] = present[ipath] ? entry->second.calls : 0;
+    is_timer[ipath] = present[ipath] ? entry->second.is_timer : 0;
+  }
+  if (num_paths > 0) {
+    mpiret = sc_MPI_Reduce (values_min.data (), global_min.data (), num_paths, sc_MPI_DOUBLE, sc_MPI_MIN, 0, comm);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Reduce (values_max.data (), global_max.data (), num_paths, sc_MPI_DOUBLE, sc_MPI_MAX, 0, comm);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Reduce (values_sum.data (), global_sum.data (), num_paths, sc_MPI_DOUBLE, sc_MPI_SUM, 0, comm);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Reduce (calls.data (), global_calls.data (), num_paths, sc_MPI_LONG, sc_MPI_MAX, 0, comm);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Reduce (is_timer.data (), global_is_timer.data (), num_paths, sc_MPI_INT, sc_MPI_MAX, 0, comm);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Reduce (present.data (), num_present.data (), num_paths, sc_MPI_INT, sc_MPI_SUM, 0, comm);
+    SC_CHECK_MPI (mpiret);
+  }
+  if (mpirank != 0) {
+    return;
+  }
+
+  /* Append the record to the file */
+  FILE *file = fopen (filename, "a");
+  if (file == NULL) {
+    t8_global_errorf ("Could not open file %s for writing the profile.\n", filename);
+    return;
+  }
+  fseek (file, 0, SEEK_END);
+  if (format == T8_PROFILE_FORMAT_CSV) {
+    if (ftell (file) == 0) {
+      fprintf (file, "commit,name,kind,calls,min,mean,max,processes\n");
+    }
+    for (int ipath = 0; ipath < num_paths; ipath++) {
+      fprintf (file, "%s,%s,%s,%ld,%.9g,%.9g,%.9g,%i\n", label, paths[ipath].c_str (),
+               global_is_timer[ipath] ? "timer" : "counter", global_calls[ipath], global_min[ipath],
+               global_sum[ipath] / num_present[ipath], global_max[ipath], num_present[ipath]);
+    }
+  }
+  else {
+    /* One JSON object per line, such that records of several commits can be appended */
+    fprintf (file, "{\"commit\": \"%s\", \"processes\": %i, \"entries\": [", label, mpisize);
+    for (int ipath = 0; ipath < num_paths; ipath++) {
+      fprintf (file,
+               "%s{\"name\": \"%s\", \"kind\": \"%s\", \"calls\": %ld, \"min\": %.9g, \"mean\": %.9g, \"max\": %.9g, "
+               "\"processes\": %i}",
+               ipath > 0 ? ", " : "", paths[ipath].c_str (), global_is_timer[ipath] ? "timer" : "counter",
+               global_calls[ipath], global_min[ipath], global_sum[ipath] / num_present[ipath], global_max[ipath],
+               num_present[ipath]);
+    }
+    fprintf (file, "]}\n");
+  }
+  fclose (file);
+}
+
+void
+t8_forest_profile_write (t8_forest_t forest, const char *filename, t8_profile_format_t format)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  const t8_forest_timers_t timers = t8_forest_timers_get (forest);
+  const t8_forest_timer_entries_t empty;
+  t8_forest_timers_write_entries (timers != NULL ? timers->entries : empty, filename, format, "forest",
+                                  forest->mpicomm);
+}
+
+void
+t8_forest_profile_set_output (const char *filename, t8_profile_format_t format)
+{
+  t8_forest_timers_output = filename != NULL ? filename : "";
+  t8_forest_timers_output_format = format;
+  t8_forest_timers_num_commits = 0;
+}
+
+void
+t8_forest_timers_begin_commit (t8_forest_t forest)
+{
+  if (t8_forest_timers_get (forest) == NULL) {
+    return;
+  }
+  t8_forest_timers_commit_depth++;
+  t8_forest_profile_timer_start (forest, "commit");
+}
+
+void
+t8_forest_timers_commit (t8_forest_t forest)
+{
+  const t8_forest_timers_t timers = t8_forest_timers_get (forest);
+  if (timers == NULL) {
+    return;
+  }
+  t8_forest_profile_timer_stop (forest, "commit");
+  T8_ASSERT (timers->running.empty ());
+  T8_ASSERT (t8_forest_timers_commit_depth > 0);
+  if (--t8_forest_timers_commit_depth > 0) {
+    /* This is an intermediate forest, its entries are merged into the outer one */
+    return;
+  }
+
+  for (const auto &entry : timers->entries) {
+    t8_forest_timers_add (t8_forest_timers_run_totals, entry.first, entry.second.is_timer, entry.second.calls,
+                          entry.second.value);
+  }
+  if (!t8_forest_timers_output.empty ()) {
+    const std::string label = std::to_string (t8_forest_timers_num_commits++);
+    t8_forest_timers_write_entries (timers->entries, t8_forest_timers_output.c_str (), t8_forest_timers_output_format,
+                                    label.c_str (), forest->mpicomm);
+  }
+}
+
+void
+t8_forest_profile_write_summary (const char *filename, t8_profile_format_t format, sc_MPI_Comm comm)
+{
+  t8_forest_timers_write_entries (t8_forest_timers_run_totals, filename, format, "total", comm);
+}
+
+void
+t8_forest_profile_reset_summary (void)
+{
+  t8_forest_timers_run_totals.clear ();
+}
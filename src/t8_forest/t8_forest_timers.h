@@ -0,0 +1,80 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_forest_timers.h
+ * Internal functions of the structured forest profiling.
+ * The public interface is declared in \ref t8_forest_profiling.h.
+ */
+
+#ifndef T8_FOREST_TIMERS_H
+#define T8_FOREST_TIMERS_H
+
+#include <t8.h>
+#include <t8_forest/t8_forest_general.h>
+
+T8_EXTERN_C_BEGIN ();
+
+/** The named timers and counters of one forest. */
+typedef struct t8_forest_timers *t8_forest_timers_t;
+
+/** Allocate an empty set of timers and counters.
+ * \return                  A new timer set without any entries.
+ */
+t8_forest_timers_t
+t8_forest_timers_new (void);
+
+/** Free a set of timers and counters and close its hardware counters.
+ * \param [in,out] ptimers  The timer set. Set to NULL on output.
+ */
+void
+t8_forest_timers_destroy (t8_forest_timers_t *ptimers);
+
+/** Add all timers and counters of \a forest_from to \a forest.
+ * The names of the entries are prefixed with the path of the timers that are
+ * currently running on \a forest. This is used to collect the timers of the
+ * intermediate forests that are created during commit or balance.
+ * \param [in,out] forest       A forest with profiling enabled.
+ * \param [in]     forest_from  A forest. If it has no profile nothing happens.
+ */
+void
+t8_forest_timers_merge (t8_forest_t forest, const t8_forest_t forest_from);
+
+/** Called at the beginning of \ref t8_forest_commit.
+ * Starts the timer "commit". If profiling is disabled nothing happens.
+ * \param [in,out] forest   A forest that is being committed.
+ */
+void
+t8_forest_timers_begin_commit (t8_forest_t forest);
+
+/** Called at the end of \ref t8_forest_commit.
+ * Stops the timer "commit". If this is not the commit of an intermediate forest,
+ * adds the entries of the forest to the run totals and, if an output file was
+ * set with \ref t8_forest_profile_set_output, appends a record of the commit to it.
+ * This function is collective. If profiling is disabled nothing happens.
+ * \param [in] forest       A committed forest.
+ */
+void
+t8_forest_timers_commit (t8_forest_t forest);
+
+T8_EXTERN_C_END ();
+
+#endif /* !T8_FOREST_TIMERS_H */
@@ -38,6 +38,8 @@
 
 typedef struct t8_profile t8_profile_t;            /* Defined below */
 typedef struct t8_forest_ghost *t8_forest_ghost_t; /* Defined below */
+typedef struct t8_forest_face_connectivity t8_forest_face_connectivity_t; /* Defined below */
+typedef struct t8_forest_element_metrics t8_forest_element_metrics_t;     /* Defined below */
 
 /** If a forest is to be derived from another forest, there are different
  * possibilities how the original forest is modified.
@@ -62,7 +64,7 @@ typedef int8_t t8_forest_from_t;
 #define T8_FOREST_BALANCE_NO_REPART 2 /**< Value of forest->set_balance if balancing without repartitioning */
 
 /** The number of statistics collected by a profile struct. */
-#define T8_PROFILE_NUM_STATS 14
+#define T8_PROFILE_NUM_STATS 16
 
 /** This structure is private to the implementation. */
 typedef struct t8_forest
@@ -88,11 +90,17 @@ typedef struct t8_forest
                                              false on all ranks. */
 
   t8_forest_t set_from;           /**< Temporarily store source forest. */
+  char *set_load;                 /**< If not NULL, the file prefix of a checkpoint to load the forest from.
+                                             \see t8_forest_set_load. */
   t8_forest_from_t from_method;   /**< Method to derive from \b set_from. */
   t8_forest_adapt_t set_adapt_fn; /**< refinement and coarsen function. Called when \b from_method
                                              is set to T8_FOREST_FROM_ADAPT. */
   int set_adapt_recursive;        /**< Flag to decide whether coarsen and refine
                                                 are carried out recursive */
+  t8_forest_partition_weight_t set_partition_weight_fn; /**< If not NULL, the weight of each element when
+                                                         partitioning. \see t8_forest_set_partition_weights. */
+  const double *set_partition_weights; /**< If not NULL, the weight of each element of \b set_from when
+                                                partitioning. \see t8_forest_set_partition_weights_array. */
   int set_balance;                /**< Flag to decide whether to forest will be balance in \ref t8_forest_commit.
                                              See \ref t8_forest_set_balance.
                                              If 0, no balance. If 1 balance with repartitioning, if 2 balance without
@@ -101,6 +109,12 @@ typedef struct t8_forest
   t8_ghost_type_t ghost_type;     /**< If a ghost layer will be created, the type of neighbors that count as ghost. */
   int ghost_algorithm;            /**< Controls the algorithm used for ghost. 1 = balanced only. 2 = also unbalanced
                                              3 = top-down search and unbalanced. */
+  int do_face_connectivity;       /**< If True, a face connectivity table will be built when the forest is committed. */
+  int do_element_metrics;         /**< If True, the element metrics will be computed when the forest is committed. */
+  int num_threads;                /**< The number of threads that shared memory parallel algorithms may use.
+                                             \see t8_forest_set_num_threads. */
+  int compact_transfer;           /**< If True, elements are encoded compactly when they are sent to other processes.
+                                             \see t8_forest_set_compact_transfer. */
   void *user_data;                /**< Pointer for arbitrary user data. \see t8_forest_set_user_data. */
   void (*user_function) ();       /**< Pointer for arbitrary user function. \see t8_forest_set_user_function. */
   void *t8code_data;              /**< Pointer for arbitrary data that is used internally. */
@@ -117,6 +131,10 @@ typedef struct t8_forest
   t8_gloidx_t global_num_trees; /**< The total number of global trees */
   sc_array_t *trees;
   t8_forest_ghost_t ghosts;           /**< If not NULL, the ghost elements. \see t8_forest_ghost.h */
+  t8_forest_face_connectivity_t *face_connectivity; /**< If not NULL, the face neighbors of all local leaves.
+                                                         \see t8_forest_face_connectivity.h */
+  t8_forest_element_metrics_t *element_metrics;     /**< If not NULL, the cached geometric metrics of all local leaves
+                                                         and ghosts. \see t8_forest_element_metrics.h */
   t8_shmem_array_t element_offsets;   /**< If partitioned, for each process the global index
                                             of its first element. Since it is memory consuming,
                                             it is usually only constructed when needed and otherwise unallocated. */
@@ -156,9 +174,6 @@ typedef struct t8_tree
  * it is nonzero, various runtimes and data measurements are stored here.
  * \see t8_cmesh_set_profiling and \see t8_cmesh_print_profile
  */
-
-/** The number of statistics collected by a profile struct. */
-#define T8_PROFILE_NUM_STATS 14
 typedef struct t8_profile
 {
   t8_locidx_t partition_elements_shipped; /**< The number of elements this process has
@@ -181,8 +196,12 @@ typedef struct t8_profile
                                                   partition in t8_forest_balance). */
   double ghost_runtime;     /**< The runtime of the last call to \a t8_forest_ghost_create. */
   double ghost_waittime;    /**< Amount of synchronisation time in ghost. */
+  double ghost_remote_runtime; /**< The part of \a ghost_runtime spent on finding the local elements
+                                                  that are ghosts of other processes. */
+  double ghost_comm_runtime;   /**< The part of \a ghost_runtime spent on exchanging the ghost elements. */
   double balance_runtime;   /**< The runtime of the last call to \a t8_forest_balance. */
   double commit_runtime;    /**< The runtime of the last call to \a t8_cmesh_commit. */
+  struct t8_forest_timers *timers; /**< Named timers and counters. See \ref t8_forest_profile_timer_start. */
 
 } t8_profile_struct_t;
 
@@ -216,4 +235,39 @@ typedef struct t8_forest_ghost
   sc_mempool_t *proc_offset_mempool;
 } t8_forest_ghost_struct_t;
 
+/** The face neighbors of all local leaves of a forest in compressed sparse row format.
+ * The faces of leaf i are numbered face_offsets[i], ..., face_offsets[i + 1] - 1 and
+ * the neighbors of face f are stored at positions neighbor_offsets[f], ..., neighbor_offsets[f + 1] - 1
+ * of \a neighbor_ids and \a dual_faces. \see t8_forest_face_connectivity.h */
+typedef struct t8_forest_face_connectivity
+{
+  t8_locidx_t num_elements;      /**< The number of local leaves. */
+  t8_locidx_t num_faces;         /**< The sum of the number of faces of all local leaves. */
+  t8_locidx_t num_neighbors;     /**< The total number of stored face neighbors. */
+  t8_locidx_t *face_offsets;     /**< For each leaf the index of its first face, num_elements + 1 entries. */
+  t8_locidx_t *neighbor_offsets; /**< For each face the index of its first neighbor, num_faces + 1 entries. */
+  t8_locidx_t *neighbor_ids;     /**< The local or ghost indices of the neighbors. */
+  int8_t *dual_faces;            /**< For each neighbor the face across which it touches the leaf. */
+  int8_t *orientations;          /**< For each face the face orientation. */
+  int8_t *flags;                 /**< For each face a combination of t8_face_connectivity_flag_t. */
+} t8_forest_face_connectivity_struct_t;
+
+/** The geometric metrics of all local leaves and ghosts of a forest as structure of arrays.
+ * The elements are indexed by their local index, the ghosts follow the local leaves.
+ * Vector quantities are stored component-wise, the i-th component of element e is found at
+ * position i * num_elements + e (i * num_faces + f for the faces).
+ * The faces of element e are numbered face_offsets[e], ..., face_offsets[e + 1] - 1.
+ * \see t8_forest_element_metrics.h */
+typedef struct t8_forest_element_metrics
+{
+  t8_locidx_t num_local_elements; /**< The number of local leaves. */
+  t8_locidx_t num_elements;       /**< The number of local leaves plus the number of ghosts. */
+  t8_locidx_t num_faces;          /**< The sum of the number of faces of all elements. */
+  double *volumes;                /**< For each element its volume. */
+  double *centroids;              /**< For each element the 3 components of its centroid. */
+  t8_locidx_t *face_offsets;      /**< For each element the index of its first face, num_elements + 1 entries. */
+  double *face_areas;             /**< For each face its area. */
+  double *face_normals;           /**< For each face the 3 components of its outward unit normal. */
+} t8_forest_element_metrics_struct_t;
+
 #endif /* ! T8_FOREST_TYPES_H */
@@ -91,98 +91,303 @@ t8_geom_triangular_interpolation (const double *coefficients, const double *corn
   }
 }
 
+/* The batched kernels below evaluate the linear geometry of one tree for many points.
+ * The switch on the tree class is outside of the loops over the points. The loops of
+ * lines, quads, hexes, triangles and tets still branch on the dimension; the branch
+ * does not change within a batch, but it is not hoisted out of the loops by hand.
+ * The arithmetic is the same as in t8_geom_linear_interpolation and
+ * t8_geom_triangular_interpolation, thus the results coincide bitwise. */
+
+/* Evaluate a multilinear map on [0,1]^dim for lines, quads and hexes. */
+static void
+t8_geom_compute_multilinear_batch (const double *tree_vertices, const int dimension, const double *ref_coords,
+                                   const size_t num_coords, double *out_coords)
+{
+  const double *v = tree_vertices;
+  for (size_t i_coord = 0; i_coord < num_coords; i_coord++) {
+    const double *xi = ref_coords + i_coord * dimension;
+    double *out = out_coords + i_coord * T8_ECLASS_MAX_DIM;
+    const double x = xi[0];
+    for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
+      double temp = v[0 * 3 + i_dim] * (1 - x) + v[1 * 3 + i_dim] * x;
+      if (dimension > 1) {
+        const double y = xi[1];
+        temp *= (1 - y);
+        temp += (v[2 * 3 + i_dim] * (1 - x) + v[3 * 3 + i_dim] * x) * y;
+        if (dimension == 3) {
+          const double z = xi[2];
+          temp *= (1 - z);
+          temp += (v[4 * 3 + i_dim] * (1 - x) * (1 - y) + v[5 * 3 + i_dim] * x * (1 - y)
+                   + v[6 * 3 + i_dim] * (1 - x) * y + v[7 * 3 + i_dim] * x * y)
+                  * z;
+        }
+      }
+      out[i_dim] = temp;
+    }
+  }
+}
+
+/* Compute the jacobian of a multilinear map on [0,1]^dim for lines, quads and hexes. */
+static void
+t8_geom_compute_multilinear_jacobian_batch (const double *tree_vertices, const int dimension, const double *ref_coords,
+                                            const size_t num_coords, double *jacobian)
+{
+  const double *v = tree_vertices;
+  for (size_t i_coord = 0; i_coord < num_coords; i_coord++) {
+    const double *xi = ref_coords + i_coord * dimension;
+    double *jac = jacobian + i_coord * dimension * T8_ECLASS_MAX_DIM;
+    for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
+      if (dimension == 1) {
+        jac[i_dim] = v[3 + i_dim] - v[i_dim];
+      }
+      else if (dimension == 2) {
+        const double x = xi[0], y = xi[1];
+        /* d/dx */
+        jac[i_dim] = (1 - y) * (v[1 * 3 + i_dim] - v[0 * 3 + i_dim]) + y * (v[3 * 3 + i_dim] - v[2 * 3 + i_dim]);
+        /* d/dy */
+        jac[3 + i_dim] = (1 - x) * (v[2 * 3 + i_dim] - v[0 * 3 + i_dim]) + x * (v[3 * 3 + i_dim] - v[1 * 3 + i_dim]);
+      }
+      else {
+        const double x = xi[0], y = xi[1], z = xi[2];
+        /* d/dx */
+        jac[i_dim] = (1 - y) * (1 - z) * (v[1 * 3 + i_dim] - v[0 * 3 + i_dim])
+                     + y * (1 - z) * (v[3 * 3 + i_dim] - v[2 * 3 + i_dim])
+                     + (1 - y) * z * (v[5 * 3 + i_dim] - v[4 * 3 + i_dim])
+                     + y * z * (v[7 * 3 + i_dim] - v[6 * 3 + i_dim]);
+        /* d/dy */
+        jac[3 + i_dim] = (1 - x) * (1 - z) * (v[2 * 3 + i_dim] - v[0 * 3 + i_dim])
+                         + x * (1 - z) * (v[3 * 3 + i_dim] - v[1 * 3 + i_dim])
+                         + (1 - x) * z * (v[6 * 3 + i_dim] - v[4 * 3 + i_dim])
+                         + x * z * (v[7 * 3 + i_dim] - v[5 * 3 + i_dim]);
+        /* d/dz */
+        jac[6 + i_dim] = (1 - x) * (1 - y) * (v[4 * 3 + i_dim] - v[0 * 3 + i_dim])
+                         + x * (1 - y) * (v[5 * 3 + i_dim] - v[1 * 3 + i_dim])
+                         + (1 - x) * y * (v[6 * 3 + i_dim] - v[2 * 3 + i_dim])
+                         + x * y * (v[7 * 3 + i_dim] - v[3 * 3 + i_dim]);
+      }
+    }
+  }
+}
+
+/* Compute the spanning vectors of a triangle or tet, such that
+ * x = v_0 + sum_j span[j] * ref_coords[j]. */
+static void
+t8_geom_simplex_spanning_vectors (const double *tree_vertices, const int dimension, double span[3][3])
+{
+  const double *v = tree_vertices;
+  for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
+    span[0][i_dim] = v[1 * 3 + i_dim] - v[0 * 3 + i_dim];
+    if (dimension == 2) {
+      span[1][i_dim] = v[2 * 3 + i_dim] - v[1 * 3 + i_dim];
+    }
+    else {
+      span[1][i_dim] = v[3 * 3 + i_dim] - v[2 * 3 + i_dim];
+      span[2][i_dim] = v[2 * 3 + i_dim] - v[1 * 3 + i_dim];
+    }
+  }
+}
+
+/* Evaluate the affine map of a triangle or tet. */
+static void
+t8_geom_compute_simplex_batch (const double *tree_vertices, const int dimension, const double *ref_coords,
+                               const size_t num_coords, double *out_coords)
+{
+  double span[3][3];
+  t8_geom_simplex_spanning_vectors (tree_vertices, dimension, span);
+  for (size_t i_coord = 0; i_coord < num_coords; i_coord++) {
+    const double *xi = ref_coords + i_coord * dimension;
+    double *out = out_coords + i_coord * T8_ECLASS_MAX_DIM;
+    for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
+      if (dimension == 2) {
+        out[i_dim] = span[0][i_dim] * xi[0] + span[1][i_dim] * xi[1] + tree_vertices[i_dim];
+      }
+      else {
+        out[i_dim] = span[0][i_dim] * xi[0] + span[1][i_dim] * xi[1] + span[2][i_dim] * xi[2] + tree_vertices[i_dim];
+      }
+    }
+  }
+}
+
+/* Evaluate a prism as the triangle spanned by the interpolation of its three vertical edges. */
+static void
+t8_geom_compute_prism_batch (const double *tree_vertices, const double *ref_coords, const size_t num_coords,
+                             double *out_coords)
+{
+  const double *v = tree_vertices;
+  for (size_t i_coord = 0; i_coord < num_coords; i_coord++) {
+    const double *xi = ref_coords + i_coord * 3;
+    double *out = out_coords + i_coord * T8_ECLASS_MAX_DIM;
+    const double z = xi[2];
+    for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
+      const double e_0 = v[0 * 3 + i_dim] * (1 - z) + v[3 * 3 + i_dim] * z;
+      const double e_1 = v[1 * 3 + i_dim] * (1 - z) + v[4 * 3 + i_dim] * z;
+      const double e_2 = v[2 * 3 + i_dim] * (1 - z) + v[5 * 3 + i_dim] * z;
+      out[i_dim] = (e_1 - e_0) * xi[0] + (e_2 - e_1) * xi[1] + e_0;
+    }
+  }
+}
+
+/* Compute the jacobian of a prism. With the bottom triangle B and the top triangle T
+ * the prism is x = (1 - z) * B (x, y) + z * T (x, y). */
+static void
+t8_geom_compute_prism_jacobian_batch (const double *tree_vertices, const double *ref_coords, const size_t num_coords,
+                                      double *jacobian)
+{
+  const double *v = tree_vertices;
+  for (size_t i_coord = 0; i_coord < num_coords; i_coord++) {
+    const double *xi = ref_coords + i_coord * 3;
+    double *jac = jacobian + i_coord * 3 * T8_ECLASS_MAX_DIM;
+    const double z = xi[2];
+    for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
+      const double bottom = (v[1 * 3 + i_dim] - v[0 * 3 + i_dim]) * xi[0]
+                            + (v[2 * 3 + i_dim] - v[1 * 3 + i_dim]) * xi[1] + v[0 * 3 + i_dim];
+      const double top = (v[4 * 3 + i_dim] - v[3 * 3 + i_dim]) * xi[0] + (v[5 * 3 + i_dim] - v[4 * 3 + i_dim]) * xi[1]
+                         + v[3 * 3 + i_dim];
+      jac[i_dim] = (1 - z) * (v[1 * 3 + i_dim] - v[0 * 3 + i_dim]) + z * (v[4 * 3 + i_dim] - v[3 * 3 + i_dim]);
+      jac[3 + i_dim] = (1 - z) * (v[2 * 3 + i_dim] - v[1 * 3 + i_dim]) + z * (v[5 * 3 + i_dim] - v[4 * 3 + i_dim]);
+      jac[6 + i_dim] = top - bottom;
+    }
+  }
+}
+
+/* Evaluate a pyramid. After projecting the point onto the base,
+ * we use a bilinear interpolation to do a quad interpolation on the base
+ * and then we interpolate via the height to the top vertex. */
+static void
+t8_geom_compute_pyramid_batch (const double *tree_vertices, const double *ref_coords, const size_t num_coords,
+                               double *out_coords)
+{
+  double base_coords[2];
+  double vec[3];
+
+  for (size_t i_coord = 0; i_coord < num_coords; i_coord++) {
+    const double *xi = ref_coords + i_coord * 3;
+    double *out = out_coords + i_coord * T8_ECLASS_MAX_DIM;
+    if (xi[2] == 1.) {
+      /* The point is the tip of the pyramid */
+      for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
+        out[i_dim] = tree_vertices[4 * T8_ECLASS_MAX_DIM + i_dim];
+      }
+      continue;
+    }
+    /* Project point on base */
+    for (int i_dim = 0; i_dim < 2; i_dim++) {
+      base_coords[i_dim] = 1 - (1 - xi[i_dim]) / (1 - xi[2]);
+    }
+    /* Get a quad interpolation of the base */
+    t8_geom_linear_interpolation (base_coords, tree_vertices, T8_ECLASS_MAX_DIM, 2, out);
+    /* Get vector from base to pyramid tip */
+    t8_vec_diff (tree_vertices + 4 * T8_ECLASS_MAX_DIM, out, vec);
+    /* Add vector to base */
+    for (int i_dim = 0; i_dim < 3; i_dim++) {
+      out[i_dim] += vec[i_dim] * xi[2];
+    }
+  }
+}
+
+/* Compute the jacobian of a pyramid. With s = 1 - z and the projected base coordinates
+ * u = 1 - (1 - x) / s, w = 1 - (1 - y) / s the pyramid is x = s * Q (u, w) + z * v_4
+ * for the bilinear base quad Q. At the tip the jacobian is not unique, there we
+ * use the limit along the edge from vertex 3 to the tip. */
+static void
+t8_geom_compute_pyramid_jacobian_batch (const double *tree_vertices, const double *ref_coords, const size_t num_coords,
+                                        double *jacobian)
+{
+  const double *v = tree_vertices;
+  for (size_t i_coord = 0; i_coord < num_coords; i_coord++) {
+    const double *xi = ref_coords + i_coord * 3;
+    double *jac = jacobian + i_coord * 3 * T8_ECLASS_MAX_DIM;
+    const double s = 1 - xi[2];
+    const int is_tip = s == 0.;
+    const double u = is_tip ? 1 : 1 - (1 - xi[0]) / s;
+    const double w = is_tip ? 1 : 1 - (1 - xi[1]) / s;
+    const double ratio_u = is_tip ? 0 : (1 - xi[0]) / s;
+    const double ratio_w = is_tip ? 0 : (1 - xi[1]) / s;
+    for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
+      const double quad = ((v[0 * 3 + i_dim] * (1 - u) + v[1 * 3 + i_dim] * u) * (1 - w)
+                           + (v[2 * 3 + i_dim] * (1 - u) + v[3 * 3 + i_dim] * u) * w);
+      const double quad_u = (1 - w) * (v[1 * 3 + i_dim] - v[0 * 3 + i_dim]) + w * (v[3 * 3 + i_dim] - v[2 * 3 + i_dim]);
+      const double quad_w = (1 - u) * (v[2 * 3 + i_dim] - v[0 * 3 + i_dim]) + u * (v[3 * 3 + i_dim] - v[1 * 3 + i_dim]);
+      jac[i_dim] = quad_u;
+      jac[3 + i_dim] = quad_w;
+      jac[6 + i_dim] = v[4 * 3 + i_dim] - quad - ratio_u * quad_u - ratio_w * quad_w;
+    }
+  }
+}
+
 void
 t8_geom_compute_linear_geometry (t8_eclass_t tree_class, const double *tree_vertices, const double *ref_coords,
                                  const size_t num_coords, double *out_coords)
 {
-  double tri_vertices[9];
-  double line_vertices[6];
-  double base_coords[2];
-  double vec[3];
-  int i_dim;
-  size_t i_coord;
   const int dimension = t8_eclass_to_dimension[tree_class];
   /* Compute the coordinates, depending on the shape of the element */
   switch (tree_class) {
   case T8_ECLASS_VERTEX:
     /* A vertex has exactly one corner, and we already know its coordinates, since they are
      * the same as the trees coordinates. */
-    for (i_coord = 0; i_coord < num_coords; i_coord++) {
-      const size_t offset_domain_dim = i_coord * T8_ECLASS_MAX_DIM;
-      for (i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
-        out_coords[offset_domain_dim + i_dim] = tree_vertices[offset_domain_dim + i_dim];
+    for (size_t i_coord = 0; i_coord < num_coords; i_coord++) {
+      for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
+        out_coords[i_coord * T8_ECLASS_MAX_DIM + i_dim] = tree_vertices[i_dim];
       }
     }
     break;
   case T8_ECLASS_TRIANGLE:
   case T8_ECLASS_TET:
-    for (i_coord = 0; i_coord < num_coords; i_coord++) {
-      const size_t offset_tree_dim = i_coord * dimension;
-      const size_t offset_domain_dim = i_coord * T8_ECLASS_MAX_DIM;
-      t8_geom_triangular_interpolation (ref_coords + offset_tree_dim, tree_vertices, T8_ECLASS_MAX_DIM, dimension,
-                                        out_coords + offset_domain_dim);
-    }
+    t8_geom_compute_simplex_batch (tree_vertices, dimension, ref_coords, num_coords, out_coords);
     break;
   case T8_ECLASS_PRISM:
-    for (i_coord = 0; i_coord < num_coords; i_coord++) {
-      const size_t offset_tree_dim = i_coord * dimension;
-      const size_t offset_domain_dim = i_coord * T8_ECLASS_MAX_DIM;
-      /* Prisminterpolation, via height and triangle */
-      /* Get a triangle at the specific height */
-      for (int i_tri_vertex = 0; i_tri_vertex < 3; i_tri_vertex++) {
-        /* Vertices of each edge have to be linear in memory */
-        memcpy (line_vertices, tree_vertices + i_tri_vertex * T8_ECLASS_MAX_DIM, T8_ECLASS_MAX_DIM * sizeof (double));
-        memcpy (line_vertices + 3, tree_vertices + (i_tri_vertex + 3) * T8_ECLASS_MAX_DIM,
-                T8_ECLASS_MAX_DIM * sizeof (double));
-        t8_geom_linear_interpolation (ref_coords + offset_tree_dim + 2, line_vertices, T8_ECLASS_MAX_DIM, 1,
-                                      tri_vertices + i_tri_vertex * T8_ECLASS_MAX_DIM);
-      }
-      t8_geom_triangular_interpolation (ref_coords + offset_tree_dim, tri_vertices, T8_ECLASS_MAX_DIM, 2,
-                                        out_coords + offset_domain_dim);
-    }
+    t8_geom_compute_prism_batch (tree_vertices, ref_coords, num_coords, out_coords);
     break;
   case T8_ECLASS_LINE:
   case T8_ECLASS_QUAD:
   case T8_ECLASS_HEX:
-    for (i_coord = 0; i_coord < num_coords; i_coord++) {
-      const size_t offset_tree_dim = i_coord * dimension;
-      const size_t offset_domain_dim = i_coord * T8_ECLASS_MAX_DIM;
-      t8_geom_linear_interpolation (ref_coords + offset_tree_dim, tree_vertices, T8_ECLASS_MAX_DIM, dimension,
-                                    out_coords + offset_domain_dim);
-    }
+    t8_geom_compute_multilinear_batch (tree_vertices, dimension, ref_coords, num_coords, out_coords);
     break;
   case T8_ECLASS_PYRAMID:
-    for (i_coord = 0; i_coord < num_coords; i_coord++) {
-      const size_t offset_tree_dim = i_coord * dimension;
-      const size_t offset_domain_dim = i_coord * T8_ECLASS_MAX_DIM;
-      /* Pyramid interpolation. After projecting the point onto the base,
-      * we use a bilinear interpolation to do a quad interpolation on the base
-      * and then we interpolate via the height to the top vertex */
-
-      /* Project point on base */
-      if (ref_coords[offset_tree_dim + 2] != 1.) {
-        for (i_dim = 0; i_dim < 2; i_dim++) {
-          base_coords[i_dim] = 1 - (1 - ref_coords[offset_tree_dim + i_dim]) / (1 - ref_coords[offset_tree_dim + 2]);
-        }
-      }
-      else {
-        for (i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
-          out_coords[offset_domain_dim + i_dim] = tree_vertices[4 * T8_ECLASS_MAX_DIM + i_dim];
+    t8_geom_compute_pyramid_batch (tree_vertices, ref_coords, num_coords, out_coords);
+    break;
+  default:
+    SC_ABORT ("Linear geometry coordinate computation is only supported for "
+              "vertices/lines/triangles/tets/quads/prisms/hexes/pyramids.");
+    break;
+  }
+}
+
+void
+t8_geom_compute_linear_geometry_jacobian (t8_eclass_t tree_class, const double *tree_vertices,
+                                          const double *ref_coords, const size_t num_coords, double *jacobian)
+{
+  const int dimension = t8_eclass_to_dimension[tree_class];
+  switch (tree_class) {
+  case T8_ECLASS_VERTEX:
+    /* A vertex has no reference coordinates, the jacobian is empty. */
+    break;
+  case T8_ECLASS_TRIANGLE:
+  case T8_ECLASS_TET: {
+    /* The map is affine, the jacobian is the same at all points. */
+    double span[3][3];
+    t8_geom_simplex_spanning_vectors (tree_vertices, dimension, span);
+    for (size_t i_coord = 0; i_coord < num_coords; i_coord++) {
+      for (int i_col = 0; i_col < dimension; i_col++) {
+        for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; i_dim++) {
+          jacobian[(i_coord * dimension + i_col) * T8_ECLASS_MAX_DIM + i_dim] = span[i_col][i_dim];
         }
-        continue;
-      }
-      /* Get a quad interpolation of the base */
-      t8_geom_linear_interpolation (base_coords, tree_vertices, T8_ECLASS_MAX_DIM, 2, out_coords + offset_domain_dim);
-      /* Get vector from base to pyramid tip */
-      t8_vec_diff (tree_vertices + 4 * T8_ECLASS_MAX_DIM, out_coords + offset_domain_dim, vec);
-      /* Add vector to base */
-      for (i_dim = 0; i_dim < 3; i_dim++) {
-        out_coords[offset_domain_dim + i_dim] += vec[i_dim] * ref_coords[offset_tree_dim + 2];
       }
     }
+  } break;
+  case T8_ECLASS_PRISM:
+    t8_geom_compute_prism_jacobian_batch (tree_vertices, ref_coords, num_coords, jacobian);
+    break;
+  case T8_ECLASS_LINE:
+  case T8_ECLASS_QUAD:
+  case T8_ECLASS_HEX:
+    t8_geom_compute_multilinear_jacobian_batch (tree_vertices, dimension, ref_coords, num_coords, jacobian);
+    break;
+  case T8_ECLASS_PYRAMID:
+    t8_geom_compute_pyramid_jacobian_batch (tree_vertices, ref_coords, num_coords, jacobian);
     break;
   default:
-    SC_ABORT ("Linear geometry coordinate computation is only supported for "
+    SC_ABORT ("Linear geometry jacobian computation is only supported for "
               "vertices/lines/triangles/tets/quads/prisms/hexes/pyramids.");
     break;
   }
@@ -225,7 +430,34 @@ t8_geom_compute_linear_axis_aligned_geometry (const t8_eclass_t tree_class, cons
     const size_t offset_domain_dim = i_coord * T8_ECLASS_MAX_DIM;
     for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; ++i_dim) {
       out_coords[offset_domain_dim + i_dim] = tree_vertices[i_dim];
-      out_coords[offset_domain_dim + i_dim] += ref_coords[offset_tree_dim + i_dim] * vector[i_dim];
+      /* The reference coordinates beyond the tree dimension do not exist,
+       * the vertices coincide in these coordinates. */
+      if (i_dim < dimension) {
+        out_coords[offset_domain_dim + i_dim] += ref_coords[offset_tree_dim + i_dim] * vector[i_dim];
+      }
+    }
+  }
+}
+
+void
+t8_geom_compute_linear_axis_aligned_geometry_jacobian (const t8_eclass_t tree_class, const double *tree_vertices,
+                                                       const double *ref_coords, const size_t num_coords,
+                                                       double *jacobian)
+{
+  if (tree_class != T8_ECLASS_LINE && tree_class != T8_ECLASS_QUAD && tree_class != T8_ECLASS_HEX) {
+    SC_ABORT ("Linear geometry jacobian computation is only supported for lines/quads/hexes.");
+  }
+  const int dimension = t8_eclass_to_dimension[tree_class];
+  /* Compute vector between both points */
+  double vector[3];
+  t8_vec_diff (tree_vertices + T8_ECLASS_MAX_DIM, tree_vertices, vector);
+
+  /* The jacobian is diagonal and the same at all points. */
+  for (size_t i_coord = 0; i_coord < num_coords; ++i_coord) {
+    for (int i_col = 0; i_col < dimension; ++i_col) {
+      for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; ++i_dim) {
+        jacobian[(i_coord * dimension + i_col) * T8_ECLASS_MAX_DIM + i_dim] = i_col == i_dim ? vector[i_dim] : 0;
+      }
     }
   }
 }
@@ -43,6 +43,21 @@ void
 t8_geom_compute_linear_geometry (t8_eclass_t tree_class, const double *tree_vertices, const double *ref_coords,
                                  const size_t num_coords, double *out_coords);
 
+/** Compute the jacobian of the linear geometry of a tree at given reference coordinates.
+ * \param [in]    tree_class     The eclass of the tree.
+ * \param [in]    tree_vertices  Array with the tree vertex coordinates.
+ * \param [in]    ref_coords     The reference coordinates of the points.
+ * \param [in]    num_coords     Number of points to evaluate.
+ * \param [out]   jacobian       The jacobian at each point. Array of size \a num_coords x dimension x 3.
+ *                               Entry 3 * (i * dimension + j) + k of the i-th point is the derivative
+ *                               of the k-th coordinate with respect to the j-th reference coordinate.
+ * \note At the tip of a pyramid the jacobian is not unique. There we use the limit along the
+ *       edge from vertex 3 to the tip.
+ */
+void
+t8_geom_compute_linear_geometry_jacobian (t8_eclass_t tree_class, const double *tree_vertices,
+                                          const double *ref_coords, const size_t num_coords, double *jacobian);
+
 /** Compute the linear, axis-aligned geometry of a tree at a given reference coordinate.
  *  This function is faster than \ref t8_geom_compute_linear_geometry, but only works
  *  for axis-aligned trees of \ref T8_ECLASS_LINE, \ref T8_ECLASS_QUAD and \ref T8_ECLASS_HEX.
@@ -56,6 +71,18 @@ void
 t8_geom_compute_linear_axis_aligned_geometry (t8_eclass_t tree_class, const double *tree_vertices,
                                               const double *ref_coords, const size_t num_coords, double *out_coords);
 
+/** Compute the jacobian of the linear, axis-aligned geometry of a tree at given reference coordinates.
+ * \param [in]    tree_class     The eclass of the tree.
+ * \param [in]    tree_vertices  Array with the tree vertex coordinates.
+ * \param [in]    ref_coords     The reference coordinates of the points.
+ * \param [in]    num_coords     Number of points to evaluate.
+ * \param [out]   jacobian       The jacobian at each point, see \ref t8_geom_compute_linear_geometry_jacobian.
+ */
+void
+t8_geom_compute_linear_axis_aligned_geometry_jacobian (t8_eclass_t tree_class, const double *tree_vertices,
+                                                       const double *ref_coords, const size_t num_coords,
+                                                       double *jacobian);
+
 /** Interpolates linearly between 2, bilinearly between 4 or trilineraly between 8 points.
  * \param [in]    coefficients        An array of size at least dim giving the coefficients used for the interpolation
  * \param [in]    corner_values       An array of size 2^dim * 3, giving for each corner (in zorder) of
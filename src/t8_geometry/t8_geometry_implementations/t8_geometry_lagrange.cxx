@@ -19,7 +19,9 @@
   along with t8code; if not, write to the Free Software Foundation, Inc.,
   51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
 */
+#include <algorithm>
 #include <array>
+#include <cstring>
 #include <sstream>
 
 #include <t8_geometry/t8_geometry_base.hxx>
@@ -41,23 +43,98 @@ t8_geometry_lagrange::~t8_geometry_lagrange ()
 {
 }
 
+/* Node tables of the tensor product elements (lines, quadrilaterals and hexahedra).
+ * Entry i of a table holds for basis function i the indices of the 1D basis functions
+ * in x, y and z direction whose product it is, see t8_geom_lagrange_basis_1d. */
+/* clang-format off */
+static const int t8_geom_lagrange_s2_nodes[2][T8_ECLASS_MAX_DIM] = { { 0 }, { 1 } };
+static const int t8_geom_lagrange_s3_nodes[3][T8_ECLASS_MAX_DIM] = { { 0 }, { 1 }, { 2 } };
+static const int t8_geom_lagrange_q4_nodes[4][T8_ECLASS_MAX_DIM] = { { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 } };
+static const int t8_geom_lagrange_q9_nodes[9][T8_ECLASS_MAX_DIM] = {
+  { 0, 0 }, { 1, 0 }, { 0, 1 }, { 1, 1 }, { 0, 2 }, { 1, 2 }, { 2, 0 }, { 2, 1 }, { 2, 2 } };
+static const int t8_geom_lagrange_h8_nodes[8][T8_ECLASS_MAX_DIM] = {
+  { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 1, 1, 0 }, { 0, 0, 1 }, { 1, 0, 1 }, { 0, 1, 1 }, { 1, 1, 1 } };
+static const int t8_geom_lagrange_h27_nodes[27][T8_ECLASS_MAX_DIM] = {
+  { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 1, 1, 0 }, { 0, 0, 1 }, { 1, 0, 1 }, { 0, 1, 1 }, { 1, 1, 1 },
+  { 0, 1, 2 }, { 0, 0, 2 }, { 0, 2, 0 }, { 0, 2, 1 }, { 0, 2, 2 }, { 1, 0, 2 }, { 1, 1, 2 }, { 1, 2, 0 },
+  { 1, 2, 1 }, { 1, 2, 2 }, { 2, 0, 0 }, { 2, 0, 1 }, { 2, 0, 2 }, { 2, 1, 0 }, { 2, 1, 1 }, { 2, 1, 2 },
+  { 2, 2, 0 }, { 2, 2, 1 }, { 2, 2, 2 } };
+/* clang-format on */
+
+/* Evaluate the 1D Lagrange basis functions of degree 1 or 2 and their derivatives at t.
+ * The nodes are numbered 0 (t = 0), 1 (t = 1) and, for degree 2, 2 (t = 0.5). */
+static inline void
+t8_geom_lagrange_basis_1d (const int degree, const double t, double *values, double *slopes)
+{
+  if (degree == 1) {
+    values[0] = 1 - t;
+    values[1] = t;
+    slopes[0] = -1;
+    slopes[1] = 1;
+  }
+  else {
+    T8_ASSERT (degree == 2);
+    values[0] = (1 - t) * (1 - 2 * t);
+    values[1] = t * (2 * t - 1);
+    values[2] = 4 * t * (1 - t);
+    slopes[0] = 4 * t - 3;
+    slopes[1] = 4 * t - 1;
+    slopes[2] = 4 - 8 * t;
+  }
+}
+
+/* Evaluate the basis functions of a tensor product element and optionally their derivatives.
+ * Each basis function is the product of 1D basis functions, given by the node table. */
+static inline void
+t8_geom_lagrange_tensor_basis (const int dim, const int degree, const int num_basis,
+                               const int nodes[][T8_ECLASS_MAX_DIM], const double *ref_point, double *basis,
+                               double *derivatives)
+{
+  double values[T8_ECLASS_MAX_DIM][T8_GEOMETRY_MAX_POLYNOMIAL_DEGREE + 1];
+  double slopes[T8_ECLASS_MAX_DIM][T8_GEOMETRY_MAX_POLYNOMIAL_DEGREE + 1];
+  for (int i_dim = 0; i_dim < dim; i_dim++) {
+    t8_geom_lagrange_basis_1d (degree, ref_point[i_dim], values[i_dim], slopes[i_dim]);
+  }
+  for (int i_basis = 0; i_basis < num_basis; i_basis++) {
+    const int *node = nodes[i_basis];
+    double value = 1;
+    for (int i_dim = 0; i_dim < dim; i_dim++) {
+      value *= values[i_dim][node[i_dim]];
+    }
+    basis[i_basis] = value;
+  }
+  if (derivatives != NULL) {
+    for (int i_dir = 0; i_dir < dim; i_dir++) {
+      for (int i_basis = 0; i_basis < num_basis; i_basis++) {
+        const int *node = nodes[i_basis];
+        double slope = 1;
+        for (int i_dim = 0; i_dim < dim; i_dim++) {
+          slope *= i_dim == i_dir ? slopes[i_dim][node[i_dim]] : values[i_dim][node[i_dim]];
+        }
+        derivatives[i_dir * num_basis + i_basis] = slope;
+      }
+    }
+  }
+}
+
 void
 t8_geometry_lagrange::t8_geom_evaluate (t8_cmesh_t cmesh, t8_gloidx_t gtreeid, const double *ref_coords,
                                         const size_t num_points, double *out_coords) const
 {
-  if (num_points != 1)
-    SC_ABORT ("Error: Batch computation of geometry not yet supported.");
   T8_ASSERT (t8_geom_check_tree_compatibility ());
-  const auto basis_functions = t8_geometry_lagrange::t8_geom_compute_basis (ref_coords);
-  const size_t n_vertex = basis_functions.size ();
-  for (size_t i_component = 0; i_component < T8_ECLASS_MAX_DIM; i_component++) {
-    double inner_product = 0;
-    for (size_t j_vertex = 0; j_vertex < n_vertex; j_vertex++) {
-      const double coordinate = active_tree_vertices[j_vertex * T8_ECLASS_MAX_DIM + i_component];
+  const int dim = t8_eclass_to_dimension[active_tree_class];
+  double basis_functions[T8_GEOMETRY_LAGRANGE_MAX_NUM_BASIS];
+  for (size_t i_point = 0; i_point < num_points; i_point++) {
+    const int n_vertex = t8_geom_compute_basis (ref_coords + i_point * dim, basis_functions, NULL);
+    double *mapped = out_coords + i_point * T8_ECLASS_MAX_DIM;
+    mapped[0] = mapped[1] = mapped[2] = 0;
+    for (int j_vertex = 0; j_vertex < n_vertex; j_vertex++) {
+      const double *vertex = active_tree_vertices + j_vertex * T8_ECLASS_MAX_DIM;
       const double basis_function = basis_functions[j_vertex];
-      inner_product += basis_function * coordinate;
+      for (int i_component = 0; i_component < T8_ECLASS_MAX_DIM; i_component++) {
+        mapped[i_component] += basis_function * vertex[i_component];
+      }
     }
-    out_coords[i_component] = inner_product;
   }
 }
 
@@ -65,7 +142,24 @@ void
 t8_geometry_lagrange::t8_geom_evaluate_jacobian (t8_cmesh_t cmesh, t8_gloidx_t gtreeid, const double *ref_coords,
                                                  const size_t num_points, double *jacobian) const
 {
-  SC_ABORT_NOT_REACHED ();
+  T8_ASSERT (t8_geom_check_tree_compatibility ());
+  const int dim = t8_eclass_to_dimension[active_tree_class];
+  double basis_functions[T8_GEOMETRY_LAGRANGE_MAX_NUM_BASIS];
+  double derivatives[T8_ECLASS_MAX_DIM * T8_GEOMETRY_LAGRANGE_MAX_NUM_BASIS];
+  for (size_t i_point = 0; i_point < num_points; i_point++) {
+    const int n_vertex = t8_geom_compute_basis (ref_coords + i_point * dim, basis_functions, derivatives);
+    for (int i_dir = 0; i_dir < dim; i_dir++) {
+      double *column = jacobian + (i_point * dim + i_dir) * T8_ECLASS_MAX_DIM;
+      const double *slopes = derivatives + i_dir * n_vertex;
+      column[0] = column[1] = column[2] = 0;
+      for (int j_vertex = 0; j_vertex < n_vertex; j_vertex++) {
+        const double *vertex = active_tree_vertices + j_vertex * T8_ECLASS_MAX_DIM;
+        for (int i_component = 0; i_component < T8_ECLASS_MAX_DIM; i_component++) {
+          column[i_component] += slopes[j_vertex] * vertex[i_component];
+        }
+      }
+    }
+  }
 }
 
 inline void
@@ -78,42 +172,55 @@ t8_geometry_lagrange::t8_geom_load_tree_data (t8_cmesh_t cmesh, t8_gloidx_t gtre
   T8_ASSERT (degree != NULL);
 }
 
-inline std::vector<double>
-t8_geometry_lagrange::t8_geom_compute_basis (const double *ref_coords) const
+inline int
+t8_geometry_lagrange::t8_geom_compute_basis (const double *ref_point, double *basis, double *derivatives) const
 {
   switch (active_tree_class) {
   case T8_ECLASS_LINE:
     switch (*degree) {
     case 1:
-      return t8_geometry_lagrange::t8_geom_s2_basis (ref_coords);
+      t8_geometry_lagrange::t8_geom_s2_basis (ref_point, basis, derivatives);
+      return 2;
     case 2:
-      return t8_geometry_lagrange::t8_geom_s3_basis (ref_coords);
+      t8_geometry_lagrange::t8_geom_s3_basis (ref_point, basis, derivatives);
+      return 3;
     }
+    break;
   case T8_ECLASS_TRIANGLE:
     switch (*degree) {
     case 1:
-      return t8_geometry_lagrange::t8_geom_t3_basis (ref_coords);
+      t8_geometry_lagrange::t8_geom_t3_basis (ref_point, basis, derivatives);
+      return 3;
     case 2:
-      return t8_geometry_lagrange::t8_geom_t6_basis (ref_coords);
+      t8_geometry_lagrange::t8_geom_t6_basis (ref_point, basis, derivatives);
+      return 6;
     }
+    break;
   case T8_ECLASS_QUAD:
     switch (*degree) {
     case 1:
-      return t8_geometry_lagrange::t8_geom_q4_basis (ref_coords);
+      t8_geometry_lagrange::t8_geom_q4_basis (ref_point, basis, derivatives);
+      return 4;
     case 2:
-      return t8_geometry_lagrange::t8_geom_q9_basis (ref_coords);
+      t8_geometry_lagrange::t8_geom_q9_basis (ref_point, basis, derivatives);
+      return 9;
     }
+    break;
   case T8_ECLASS_HEX:
     switch (*degree) {
     case 1:
-      return t8_geometry_lagrange::t8_geom_h8_basis (ref_coords);
+      t8_geometry_lagrange::t8_geom_h8_basis (ref_point, basis, derivatives);
+      return 8;
     case 2:
-      return t8_geometry_lagrange::t8_geom_h27_basis (ref_coords);
+      t8_geometry_lagrange::t8_geom_h27_basis (ref_point, basis, derivatives);
+      return 27;
     }
+    break;
   default:
-    SC_ABORTF ("Error: Lagrange geometry for degree %i %s not yet implemented. \n", *degree,
-               t8_eclass_to_string[active_tree_class]);
+    break;
   }
+  SC_ABORTF ("Error: Lagrange geometry for degree %i %s not yet implemented. \n", *degree,
+             t8_eclass_to_string[active_tree_class]);
 }
 
 bool
@@ -135,145 +242,87 @@ t8_geometry_lagrange::t8_geom_check_tree_compatibility () const
   return true;
 }
 
-inline std::vector<double>
-t8_geometry_lagrange::t8_geom_s2_basis (const double *ref_point) const
+inline void
+t8_geometry_lagrange::t8_geom_s2_basis (const double *ref_point, double *basis, double *derivatives) const
 {
-  const double xi = ref_point[0];
-  const std::vector<double> basis_functions = { 1 - xi, xi };
-  return basis_functions;
+  t8_geom_lagrange_tensor_basis (1, 1, 2, t8_geom_lagrange_s2_nodes, ref_point, basis, derivatives);
 }
 
-inline std::vector<double>
-t8_geometry_lagrange::t8_geom_s3_basis (const double *ref_point) const
+inline void
+t8_geometry_lagrange::t8_geom_s3_basis (const double *ref_point, double *basis, double *derivatives) const
 {
-  const double xi = ref_point[0];
-  /* clang-format off */
-  const std::vector<double> basis_functions = {
-    (1 - xi) * (1 - 2 * xi),
-    xi * (2 * xi - 1),
-    4 * xi * (1 - xi) };
-  /* clang-format on */
-  return basis_functions;
+  t8_geom_lagrange_tensor_basis (1, 2, 3, t8_geom_lagrange_s3_nodes, ref_point, basis, derivatives);
 }
 
-inline std::vector<double>
-t8_geometry_lagrange::t8_geom_t3_basis (const double *ref_point) const
+inline void
+t8_geometry_lagrange::t8_geom_t3_basis (const double *ref_point, double *basis, double *derivatives) const
 {
   const double xi = ref_point[0];
   const double eta = ref_point[1];
-  const std::vector<double> basis_functions = { 1 - xi, xi - eta, eta };
-  return basis_functions;
+  basis[0] = 1 - xi;
+  basis[1] = xi - eta;
+  basis[2] = eta;
+  if (derivatives != NULL) {
+    /* clang-format off */
+    const double slopes[2][3] = {
+      { -1, 1, 0 },
+      { 0, -1, 1 } };
+    /* clang-format on */
+    memcpy (derivatives, slopes, sizeof (slopes));
+  }
 }
 
-inline std::vector<double>
-t8_geometry_lagrange::t8_geom_t6_basis (const double *ref_point) const
+inline void
+t8_geometry_lagrange::t8_geom_t6_basis (const double *ref_point, double *basis, double *derivatives) const
 {
   const double xi = ref_point[0];
   const double eta = ref_point[1];
-  /* clang-format off */
-  const std::vector<double> basis_functions = {
-    1 - 3 * xi + 2 * xi * xi,
-    -xi + eta + 2 * xi * xi + 2 * eta * eta - 4 * xi * eta,
-    -eta + 2 * eta * eta,
-    -4 * eta * eta + 4 * xi * eta,
-    4 * eta - 4 * xi * eta,
-    4 * xi - 4 * eta - 4 * xi * xi + 4 * xi * eta };
-  /* clang-format on */
-  return basis_functions;
+  basis[0] = 1 - 3 * xi + 2 * xi * xi;
+  basis[1] = -xi + eta + 2 * xi * xi + 2 * eta * eta - 4 * xi * eta;
+  basis[2] = -eta + 2 * eta * eta;
+  basis[3] = -4 * eta * eta + 4 * xi * eta;
+  basis[4] = 4 * eta - 4 * xi * eta;
+  basis[5] = 4 * xi - 4 * eta - 4 * xi * xi + 4 * xi * eta;
+  if (derivatives != NULL) {
+    /* Derivatives in xi direction */
+    derivatives[0] = -3 + 4 * xi;
+    derivatives[1] = -1 + 4 * xi - 4 * eta;
+    derivatives[2] = 0;
+    derivatives[3] = 4 * eta;
+    derivatives[4] = -4 * eta;
+    derivatives[5] = 4 - 8 * xi + 4 * eta;
+    /* Derivatives in eta direction */
+    derivatives[6] = 0;
+    derivatives[7] = 1 - 4 * xi + 4 * eta;
+    derivatives[8] = -1 + 4 * eta;
+    derivatives[9] = 4 * xi - 8 * eta;
+    derivatives[10] = 4 - 4 * xi;
+    derivatives[11] = -4 + 4 * xi;
+  }
 }
 
-inline std::vector<double>
-t8_geometry_lagrange::t8_geom_q4_basis (const double *ref_point) const
+inline void
+t8_geometry_lagrange::t8_geom_q4_basis (const double *ref_point, double *basis, double *derivatives) const
 {
-  const double xi = ref_point[0];
-  const double eta = ref_point[1];
-  /* clang-format off */
-  const std::vector<double> basis_functions = {
-    (1 - xi) * (1 - eta),
-    xi * (1 - eta),
-    eta * (1 - xi),
-    xi * eta };
-  /* clang-format on */
-  return basis_functions;
+  t8_geom_lagrange_tensor_basis (2, 1, 4, t8_geom_lagrange_q4_nodes, ref_point, basis, derivatives);
 }
 
-inline std::vector<double>
-t8_geometry_lagrange::t8_geom_q9_basis (const double *ref_point) const
+inline void
+t8_geometry_lagrange::t8_geom_q9_basis (const double *ref_point, double *basis, double *derivatives) const
 {
-  const double xi = ref_point[0];
-  const double eta = ref_point[1];
-  /* clang-format off */
-  const std::vector<double> basis_functions = {
-    4 * (eta - 1) * (eta - 0.5) * (xi - 1) * (xi - 0.5),
-    4 * xi * (eta - 1) * (eta - 0.5) * (xi - 0.5),
-    4 * eta * (eta - 0.5) * (xi - 1) * (xi - 0.5),
-    4 * eta * xi * (eta - 0.5) * (xi - 0.5),
-    -8 * eta * (eta - 1) * (xi - 1) * (xi - 0.5),
-    -8 * eta * xi * (eta - 1) * (xi - 0.5),
-    -8 * xi * (eta - 1) * (eta - 0.5) * (xi - 1),
-    -8 * eta * xi * (eta - 0.5) * (xi - 1),
-    16 * eta * xi * (eta - 1) * (xi - 1) };
-  /* clang-format on */
-  return basis_functions;
-}
-
-inline std::vector<double>
-t8_geometry_lagrange::t8_geom_h8_basis (const double *ref_point) const
+  t8_geom_lagrange_tensor_basis (2, 2, 9, t8_geom_lagrange_q9_nodes, ref_point, basis, derivatives);
+}
+
+inline void
+t8_geometry_lagrange::t8_geom_h8_basis (const double *ref_point, double *basis, double *derivatives) const
 {
-  const double xi = ref_point[0];
-  const double eta = ref_point[1];
-  const double zeta = ref_point[2];
-  /* clang-format off */
-  const std::vector<double> basis_functions = {
-    (1 - xi) * (1 - eta) * (1 - zeta),
-    xi * (1 - eta) * (1 - zeta),
-    (1 - xi) * eta * (1 - zeta),
-    xi * eta * (1 - zeta),
-    (1 - xi) * (1 - eta) * zeta,
-    xi * (1 - eta) * zeta,
-    (1 - xi) * eta * zeta,
-    xi * eta * zeta };
-  /* clang-format on */
-  return basis_functions;
-}
-
-inline std::vector<double>
-t8_geometry_lagrange::t8_geom_h27_basis (const double *ref_point) const
+  t8_geom_lagrange_tensor_basis (3, 1, 8, t8_geom_lagrange_h8_nodes, ref_point, basis, derivatives);
+}
+
+inline void
+t8_geometry_lagrange::t8_geom_h27_basis (const double *ref_point, double *basis, double *derivatives) const
 {
-  const double xi = ref_point[0];
-  const double eta = ref_point[1];
-  const double zeta = ref_point[2];
-  /* clang-format off */
-  const std::vector<double> basis_functions = {
-    8 * (eta - 1) * (eta - 0.5) * (xi - 1) * (xi - 0.5) * (zeta - 1) * (zeta - 0.5),
-    8 * xi * (eta - 1) * (eta - 0.5) * (xi - 0.5) * (zeta - 1) * (zeta - 0.5),
-    8 * eta * (eta - 0.5) * (xi - 1) * (xi - 0.5) * (zeta - 1) * (zeta - 0.5),
-    8 * eta * xi * (eta - 0.5) * (xi - 0.5) * (zeta - 1) * (zeta - 0.5),
-    8 * zeta * (eta - 1) * (eta - 0.5) * (xi - 1) * (xi - 0.5) * (zeta - 0.5),
-    8 * xi * zeta * (eta - 1) * (eta - 0.5) * (xi - 0.5) * (zeta - 0.5),
-    8 * eta * zeta * (eta - 0.5) * (xi - 1) * (xi - 0.5) * (zeta - 0.5),
-    8 * eta * xi * zeta * (eta - 0.5) * (xi - 0.5) * (zeta - 0.5),
-    -16 * eta * zeta * (eta - 0.5) * (xi - 1) * (xi - 0.5) * (zeta - 1),
-    -16 * zeta * (eta - 1) * (eta - 0.5) * (xi - 1) * (xi - 0.5) * (zeta - 1),
-    -16 * eta * (eta - 1) * (xi - 1) * (xi - 0.5) * (zeta - 1) * (zeta - 0.5),
-    -16 * eta * zeta * (eta - 1) * (xi - 1) * (xi - 0.5) * (zeta - 0.5),
-    32 * eta * zeta * (eta - 1) * (xi - 1) * (xi - 0.5) * (zeta - 1),
-    -16 * xi * zeta * (eta - 1) * (eta - 0.5) * (xi - 0.5) * (zeta - 1),
-    -16 * eta * xi * zeta * (eta - 0.5) * (xi - 0.5) * (zeta - 1),
-    -16 * eta * xi * (eta - 1) * (xi - 0.5) * (zeta - 1) * (zeta - 0.5),
-    -16 * eta * xi * zeta * (eta - 1) * (xi - 0.5) * (zeta - 0.5),
-    32 * eta * xi * zeta * (eta - 1) * (xi - 0.5) * (zeta - 1),
-    -16 * xi * (eta - 1) * (eta - 0.5) * (xi - 1) * (zeta - 1) * (zeta - 0.5),
-    -16 * xi * zeta * (eta - 1) * (eta - 0.5) * (xi - 1) * (zeta - 0.5),
-    32 * xi * zeta * (eta - 1) * (eta - 0.5) * (xi - 1) * (zeta - 1),
-    -16 * eta * xi * (eta - 0.5) * (xi - 1) * (zeta - 1) * (zeta - 0.5),
-    -16 * eta * xi * zeta * (eta - 0.5) * (xi - 1) * (zeta - 0.5),
-    32 * eta * xi * zeta * (eta - 0.5) * (xi - 1) * (zeta - 1),
-    32 * eta * xi * (eta - 1) * (xi - 1) * (zeta - 1) * (zeta - 0.5),
-    32 * eta * xi * zeta * (eta - 1) * (xi - 1) * (zeta - 0.5),
-    -64 * eta * xi * zeta * (eta - 1) * (xi - 1) * (zeta - 1) };
-  /* clang-format on */
-  return basis_functions;
+  t8_geom_lagrange_tensor_basis (3, 2, 27, t8_geom_lagrange_h27_nodes, ref_point, basis, derivatives);
 }
 
 t8_forest_t
@@ -435,6 +484,29 @@ t8_lagrange_element::evaluate (const std::array<double, T8_ECLASS_MAX_DIM> &ref_
   return mapped;
 }
 
+std::vector<std::array<double, T8_ECLASS_MAX_DIM>>
+t8_lagrange_element::evaluate (const std::vector<std::array<double, T8_ECLASS_MAX_DIM>> &ref_points) const
+{
+  const int dim = t8_eclass_to_dimension[eclass];
+  const size_t n_point = ref_points.size ();
+  /* Pack the reference coordinates with the stride of the element dimension */
+  std::vector<double> ref_coords (n_point * dim);
+  for (size_t i_point = 0; i_point < n_point; ++i_point) {
+    std::copy_n (ref_points[i_point].begin (), dim, ref_coords.begin () + i_point * dim);
+  }
+  std::vector<std::array<double, T8_ECLASS_MAX_DIM>> mapped (n_point);
+  t8_geometry_evaluate (cmesh, 0, ref_coords.data (), n_point, mapped.data ()->data ());
+  return mapped;
+}
+
+std::array<double, T8_ECLASS_MAX_DIM * T8_ECLASS_MAX_DIM>
+t8_lagrange_element::jacobian (const std::array<double, T8_ECLASS_MAX_DIM> &ref_point) const
+{
+  std::array<double, T8_ECLASS_MAX_DIM * T8_ECLASS_MAX_DIM> jacobian = {};
+  t8_geometry_jacobian (cmesh, 0, ref_point.data (), 1, jacobian.data ());
+  return jacobian;
+}
+
 std::array<double, T8_ECLASS_MAX_DIM>
 t8_lagrange_element::map_on_face (t8_eclass map_onto, const int face_id,
                                   const std::array<double, T8_ECLASS_MAX_DIM> &coord) const
@@ -41,6 +41,9 @@
 
 #define T8_GEOMETRY_MAX_POLYNOMIAL_DEGREE 2
 
+/** The maximum number of basis functions of a Lagrange tree. */
+#define T8_GEOMETRY_LAGRANGE_MAX_NUM_BASIS 27
+
 /**
  * Mapping with Lagrange basis functions
  * 
@@ -123,7 +126,7 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
    * \param [in]  cmesh       The cmesh in which the point lies.
    * \param [in]  gtreeid     The global tree (of the cmesh) in which the reference point is.
    * \param [in]  ref_coords  Array of \a dimension x \a num_points entries, specifying points in the reference space.
-   * \param [in]  num_points  Number of points to map. Currently, only one point is supported.
+   * \param [in]  num_points  Number of points to map.
    * \param [out] out_coords  Coordinates of the mapped points in physical space of \a ref_coords. The length is \a num_points * 3.
    */
   void
@@ -131,7 +134,12 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
                     double *out_coords) const;
 
   /**
-   * Compute the Jacobian of the \a t8_geom_evaluate map at a point in the reference space.
+   * Compute the Jacobian of the \a t8_geom_evaluate map at points in the reference space.
+   * The Jacobian is computed analytically from the derivatives of the basis functions
+   *
+   * \f[ \frac{\partial \mathbf{x}}{\partial \xi_k}(\vec{\xi})
+   *     = \sum\limits_{i=1}^{N_{\mathrm{vertex}}} \frac{\partial \psi_i}{\partial \xi_k}(\vec{\xi}) \mathbf{x}_i. \f]
+   *
    * \param [in]  cmesh      The cmesh in which the point lies.
    * \param [in]  gtreeid    The global tree (of the cmesh) in which the reference point is.
    * \param [in]  ref_coords  Array of \a dimension x \a num_points entries, specifying points in the reference space.
@@ -163,11 +171,18 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
 
  private:
   /**
-   * Evaluates the basis functions of the current tree type at a point.
-   * \param [in]  ref_point  Array of \a dimension entries, specifying the point in the reference space.
+   * Evaluates the basis functions of the current tree type and degree at a point.
+   * \param [in]  ref_point    Array of \a dimension entries, specifying the point in the reference space.
+   * \param [out] basis        The values of the basis functions at \a ref_point.
+   *                           Must have room for \ref T8_GEOMETRY_LAGRANGE_MAX_NUM_BASIS entries.
+   * \param [out] derivatives  If not NULL, the derivatives of the basis functions at \a ref_point.
+   *                           Entry \a k * num_basis + \a i is the derivative of basis function \a i
+   *                           in reference direction \a k. Must have room for
+   *                           \a dimension * \ref T8_GEOMETRY_LAGRANGE_MAX_NUM_BASIS entries.
+   * \return                   The number of basis functions.
    */
-  inline std::vector<double>
-  t8_geom_compute_basis (const double *ref_point) const;
+  inline int
+  t8_geom_compute_basis (const double *ref_point, double *basis, double *derivatives) const;
 
   /**
    * Basis functions of a 2-node segment.
@@ -175,11 +190,13 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
       x --------- x
      0             1
      \endverbatim
-   * \param ref_point  Point in the reference space.
-   * \return  Basis functions evaluated at the reference point.
+   * \param [in]  ref_point    Point in the reference space.
+   * \param [out] basis        Basis functions evaluated at the reference point.
+   * \param [out] derivatives  If not NULL, the derivatives of the basis functions at the
+   *                           reference point, see \ref t8_geom_compute_basis.
    */
-  inline std::vector<double>
-  t8_geom_s2_basis (const double *ref_point) const;
+  inline void
+  t8_geom_s2_basis (const double *ref_point, double *basis, double *derivatives) const;
 
   /**
    * Basis functions of a 3-node segment.
@@ -187,11 +204,13 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
       x ----x---- x
      0      2      1
      \endverbatim
-   * \param ref_point  Point in the reference space.
-   * \return  Basis functions evaluated at the reference point.
+   * \param [in]  ref_point    Point in the reference space.
+   * \param [out] basis        Basis functions evaluated at the reference point.
+   * \param [out] derivatives  If not NULL, the derivatives of the basis functions at the
+   *                           reference point, see \ref t8_geom_compute_basis.
    */
-  inline std::vector<double>
-  t8_geom_s3_basis (const double *ref_point) const;
+  inline void
+  t8_geom_s3_basis (const double *ref_point, double *basis, double *derivatives) const;
 
   /**
    * Basis functions of a 3-node triangle element.
@@ -206,11 +225,13 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
       x --------- x
      0             1
      \endverbatim
-   * \param ref_point  Point in the reference space.
-   * \return  Basis functions evaluated at the reference point.
+   * \param [in]  ref_point    Point in the reference space.
+   * \param [out] basis        Basis functions evaluated at the reference point.
+   * \param [out] derivatives  If not NULL, the derivatives of the basis functions at the
+   *                           reference point, see \ref t8_geom_compute_basis.
    */
-  inline std::vector<double>
-  t8_geom_t3_basis (const double *ref_point) const;
+  inline void
+  t8_geom_t3_basis (const double *ref_point, double *basis, double *derivatives) const;
 
   /**
    * Basis functions of a 6-node triangle element.
@@ -225,11 +246,13 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
       x --- x --- x
      0      5      1
      \endverbatim
-   * \param ref_point  Point in the reference space.
-   * \return  Basis functions evaluated at the reference point.
+   * \param [in]  ref_point    Point in the reference space.
+   * \param [out] basis        Basis functions evaluated at the reference point.
+   * \param [out] derivatives  If not NULL, the derivatives of the basis functions at the
+   *                           reference point, see \ref t8_geom_compute_basis.
    */
-  inline std::vector<double>
-  t8_geom_t6_basis (const double *ref_point) const;
+  inline void
+  t8_geom_t6_basis (const double *ref_point, double *basis, double *derivatives) const;
 
   /**
    * Basis functions of a 4-node quadrilateral element.
@@ -244,11 +267,13 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
       x --------- x
      0             1
      \endverbatim
-   * \param ref_point  Point in the reference space.
-   * \return  Basis functions evaluated at the reference point.
+   * \param [in]  ref_point    Point in the reference space.
+   * \param [out] basis        Basis functions evaluated at the reference point.
+   * \param [out] derivatives  If not NULL, the derivatives of the basis functions at the
+   *                           reference point, see \ref t8_geom_compute_basis.
    */
-  inline std::vector<double>
-  t8_geom_q4_basis (const double *ref_point) const;
+  inline void
+  t8_geom_q4_basis (const double *ref_point, double *basis, double *derivatives) const;
 
   /**
    * Basis functions of a 9-node quadrilateral element.
@@ -263,11 +288,13 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
       x ----x---- x
      0      6      1
      \endverbatim
-   * \param ref_point  Point in the reference space.
-   * \return  Basis functions evaluated at the reference point.
+   * \param [in]  ref_point    Point in the reference space.
+   * \param [out] basis        Basis functions evaluated at the reference point.
+   * \param [out] derivatives  If not NULL, the derivatives of the basis functions at the
+   *                           reference point, see \ref t8_geom_compute_basis.
    */
-  inline std::vector<double>
-  t8_geom_q9_basis (const double *ref_point) const;
+  inline void
+  t8_geom_q9_basis (const double *ref_point, double *basis, double *derivatives) const;
 
   /**
    * Basis functions of an 8-node hexahedron element.
@@ -286,11 +313,13 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
       x --------- x    -->
      0             1
      \endverbatim
-   * \param ref_point  Point in the reference space.
-   * \return  Basis functions evaluated at the reference point.
+   * \param [in]  ref_point    Point in the reference space.
+   * \param [out] basis        Basis functions evaluated at the reference point.
+   * \param [out] derivatives  If not NULL, the derivatives of the basis functions at the
+   *                           reference point, see \ref t8_geom_compute_basis.
    */
-  inline std::vector<double>
-  t8_geom_h8_basis (const double *ref_point) const;
+  inline void
+  t8_geom_h8_basis (const double *ref_point, double *basis, double *derivatives) const;
 
   /**
    * Basis functions of a 27-node hexahedron element.
@@ -309,11 +338,13 @@ struct t8_geometry_lagrange: public t8_geometry_with_vertices
       x ----x---- x  -->        x ----x---- x  -->        x ----x---- x  -->
      0     18     1            9     20      13          4     19      5
      \endverbatim
-   * \param ref_point  Point in the reference space.
-   * \return  Basis functions evaluated at the reference point.
+   * \param [in]  ref_point    Point in the reference space.
+   * \param [out] basis        Basis functions evaluated at the reference point.
+   * \param [out] derivatives  If not NULL, the derivatives of the basis functions at the
+   *                           reference point, see \ref t8_geom_compute_basis.
    */
-  inline std::vector<double>
-  t8_geom_h27_basis (const double *ref_point) const;
+  inline void
+  t8_geom_h27_basis (const double *ref_point, double *basis, double *derivatives) const;
 
   /** Polynomial degree of the interpolation. */
   const int *degree;
@@ -435,6 +466,27 @@ class t8_lagrange_element {
   std::array<double, T8_ECLASS_MAX_DIM>
   evaluate (const std::array<double, T8_ECLASS_MAX_DIM> &ref_point) const;
 
+  /**
+   * Physical coordinates of several points given in the reference domain.
+   * All points are mapped with a single batched evaluation of the geometry.
+   * \param points  Parametric coordinates of the points to be mapped,
+   *                see \ref evaluate.
+   * \return        Coordinates of the points in the physical space.
+   */
+  std::vector<std::array<double, T8_ECLASS_MAX_DIM>>
+  evaluate (const std::vector<std::array<double, T8_ECLASS_MAX_DIM>> &ref_points) const;
+
+  /**
+   * Jacobian of the geometrical mapping at a point given in the reference domain.
+   * \param point  Parametric coordinates of the point, see \ref evaluate.
+   * \return       The Jacobian. Entry 3 * \a i + \a j is the derivative of the
+   *               \a j-th physical coordinate in the \a i-th reference direction.
+   *               Only the first \a dim * 3 entries are set, where \a dim is the
+   *               dimension of the element.
+   */
+  std::array<double, T8_ECLASS_MAX_DIM * T8_ECLASS_MAX_DIM>
+  jacobian (const std::array<double, T8_ECLASS_MAX_DIM> &ref_point) const;
+
   /**
    * Sample random points in the reference domain.
    * 
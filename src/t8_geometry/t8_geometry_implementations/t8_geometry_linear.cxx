@@ -46,7 +46,7 @@ void
 t8_geometry_linear::t8_geom_evaluate_jacobian (t8_cmesh_t cmesh, t8_gloidx_t gtreeid, const double *ref_coords,
                                                const size_t num_coords, double *jacobian) const
 {
-  SC_ABORT ("Not implemented.");
+  t8_geom_compute_linear_geometry_jacobian (active_tree_class, active_tree_vertices, ref_coords, num_coords, jacobian);
 }
 
 #if T8_ENABLE_DEBUG
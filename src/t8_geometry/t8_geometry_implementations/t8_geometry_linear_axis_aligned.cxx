@@ -65,7 +65,9 @@ t8_geometry_linear_axis_aligned::t8_geom_evaluate_jacobian (t8_cmesh_t cmesh, t8
                                                             const double *ref_coords, const size_t num_coords,
                                                             double *jacobian) const
 {
-  SC_ABORT ("Not implemented.");
+  T8_ASSERT (correct_point_order (active_tree_vertices));
+  t8_geom_compute_linear_axis_aligned_geometry_jacobian (active_tree_class, active_tree_vertices, ref_coords,
+                                                         num_coords, jacobian);
 }
 
 void
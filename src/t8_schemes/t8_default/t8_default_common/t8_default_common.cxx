@@ -22,6 +22,9 @@
 
 #include <sc_functions.h>
 #include <t8_schemes/t8_default/t8_default_common/t8_default_common.hxx>
+#if T8_ENABLE_OPENMP
+#include <omp.h>
+#endif
 
 /* We want to export the whole implementation to be callable from "C" */
 T8_EXTERN_C_BEGIN ();
@@ -46,13 +49,100 @@ t8_default_mempool_alloc (sc_mempool_t *ts_context, int length, t8_element_t **e
 static void
 t8_default_mempool_free (sc_mempool_t *ts_context, int length, t8_element_t **elem);
 
+/* Constructor */
+t8_default_scheme_common_c::t8_default_scheme_common_c ()
+{
+#if T8_ENABLE_OPENMP
+  /* We reserve one pool per thread that a parallel region may have by default.
+   * The pools themselves are created on first use by their thread. */
+  num_thread_pools = SC_MAX (omp_get_max_threads (), omp_get_num_procs ());
+  /* The additional last entry is a pool shared by all threads with a larger id. */
+  thread_pools = T8_ALLOC_ZERO (sc_mempool_t *, num_thread_pools + 1);
+#else
+  num_thread_pools = 0;
+  thread_pools = NULL;
+#endif
+#if T8_ENABLE_DEBUG
+  debug_pool_elements = new std::unordered_set<const t8_element_t *>[num_thread_pools + 1];
+#endif
+}
+
 /* Destructor */
 t8_default_scheme_common_c::~t8_default_scheme_common_c ()
 {
   T8_ASSERT (ts_context != NULL);
   SC_ASSERT (((sc_mempool_t *) ts_context)->elem_count == 0);
   sc_mempool_destroy ((sc_mempool_t *) ts_context);
+  for (int ithread = 0; thread_pools != NULL && ithread <= num_thread_pools; ++ithread) {
+    if (thread_pools[ithread] != NULL) {
+      SC_ASSERT (thread_pools[ithread]->elem_count == 0);
+      sc_mempool_destroy (thread_pools[ithread]);
+    }
+  }
+  T8_FREE (thread_pools);
+#if T8_ENABLE_DEBUG
+  delete[] debug_pool_elements;
+#endif
+}
+
+sc_mempool_t *
+t8_default_scheme_common_c::t8_element_get_mempool () const
+{
+#if T8_ENABLE_OPENMP
+  if (omp_in_parallel ()) {
+    const int thread_id = omp_get_thread_num ();
+    if (thread_id > 0) {
+      SC_CHECK_ABORT (omp_get_active_level () <= 1, "Allocating elements in nested parallel regions is not supported.");
+      if (thread_id >= num_thread_pools) {
+        /* This thread has no own pool, it has to use the shared pool in a critical section */
+        return NULL;
+      }
+      /* Only this thread accesses this entry, so we do not need to synchronize. */
+      if (thread_pools[thread_id] == NULL) {
+        thread_pools[thread_id] = sc_mempool_new (element_size);
+      }
+      return thread_pools[thread_id];
+    }
+  }
+#endif
+  return (sc_mempool_t *) ts_context;
+}
+
+#if T8_ENABLE_DEBUG
+int
+t8_default_scheme_common_c::t8_element_get_pool_index (const sc_mempool_t *pool) const
+{
+  if (pool == (const sc_mempool_t *) ts_context) {
+    return 0;
+  }
+#if T8_ENABLE_OPENMP
+  /* A thread's own pool is stored at the index of the thread */
+  T8_ASSERT (pool == thread_pools[omp_get_thread_num ()]);
+  return omp_get_thread_num ();
+#else
+  SC_ABORT_NOT_REACHED ();
+  return -1;
+#endif
+}
+
+void
+t8_default_scheme_common_c::t8_element_debug_track (int pool_index, int length, t8_element_t *const *elem,
+                                                    bool allocate) const
+{
+  T8_ASSERT (0 <= pool_index && pool_index <= num_thread_pools);
+  std::unordered_set<const t8_element_t *> &pool_elements = debug_pool_elements[pool_index];
+  for (int ielem = 0; ielem < length; ++ielem) {
+    if (allocate) {
+      pool_elements.insert (elem[ielem]);
+    }
+    else {
+      /* If this fails, the element was allocated by a different thread */
+      SC_CHECK_ABORT (pool_elements.erase (elem[ielem]) == 1,
+                      "Element destroyed by a thread that did not allocate it or destroyed twice.");
+    }
+  }
 }
+#endif
 
 /** Compute the number of corners of a given element. */
 int
@@ -66,13 +156,48 @@ t8_default_scheme_common_c::t8_element_num_corners (const t8_element_t *elem) co
 void
 t8_default_scheme_common_c::t8_element_new (int length, t8_element_t **elem) const
 {
-  t8_default_mempool_alloc ((sc_mempool_t *) this->ts_context, length, elem);
+  sc_mempool_t *pool = t8_element_get_mempool ();
+#if T8_ENABLE_OPENMP
+  if (pool == NULL) {
+#pragma omp critical(t8_default_scheme_shared_pool)
+    {
+      if (thread_pools[num_thread_pools] == NULL) {
+        thread_pools[num_thread_pools] = sc_mempool_new (element_size);
+      }
+      t8_default_mempool_alloc (thread_pools[num_thread_pools], length, elem);
+#if T8_ENABLE_DEBUG
+      t8_element_debug_track (num_thread_pools, length, elem, true);
+#endif
+    }
+    return;
+  }
+#endif
+  t8_default_mempool_alloc (pool, length, elem);
+#if T8_ENABLE_DEBUG
+  t8_element_debug_track (t8_element_get_pool_index (pool), length, elem, true);
+#endif
 }
 
 void
 t8_default_scheme_common_c::t8_element_destroy (int length, t8_element_t **elem) const
 {
-  t8_default_mempool_free ((sc_mempool_t *) this->ts_context, length, elem);
+  sc_mempool_t *pool = t8_element_get_mempool ();
+#if T8_ENABLE_OPENMP
+  if (pool == NULL) {
+#pragma omp critical(t8_default_scheme_shared_pool)
+    {
+#if T8_ENABLE_DEBUG
+      t8_element_debug_track (num_thread_pools, length, elem, false);
+#endif
+      t8_default_mempool_free (thread_pools[num_thread_pools], length, elem);
+    }
+    return;
+  }
+#endif
+#if T8_ENABLE_DEBUG
+  t8_element_debug_track (t8_element_get_pool_index (pool), length, elem, false);
+#endif
+  t8_default_mempool_free (pool, length, elem);
 }
 
 static void
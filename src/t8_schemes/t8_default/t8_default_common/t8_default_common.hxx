@@ -26,7 +26,11 @@
 
 #pragma once
 
+#include <sc_containers.h>
 #include <t8_element.hxx>
+#if T8_ENABLE_DEBUG
+#include <unordered_set>
+#endif
 
 /* Macro to check whether a pointer (VAR) to a base class, comes from an
  * implementation of a child class (TYPE). */
@@ -34,6 +38,9 @@
 
 class t8_default_scheme_common_c: public t8_eclass_scheme_c {
  public:
+  /** Constructor for all default schemes */
+  t8_default_scheme_common_c ();
+
   /** Destructor for all default schemes */
   virtual ~t8_default_scheme_common_c ();
 
@@ -44,11 +51,15 @@ class t8_default_scheme_common_c: public t8_eclass_scheme_c {
   int
   t8_element_num_corners (const t8_element_t *elem) const override;
 
-  /** Allocate space for a bunch of elements. */
+  /** Allocate space for a bunch of elements.
+   * Inside of an OpenMP parallel region each thread allocates from its own
+   * memory pool, thus this function is thread safe. */
   void
   t8_element_new (int length, t8_element_t **elem) const override;
 
-  /** Deallocate space for a bunch of elements. */
+  /** Deallocate space for a bunch of elements.
+   * \note An element must be destroyed by the same thread that allocated it.
+   *       In debugging mode this is checked. */
   void
   t8_element_destroy (int length, t8_element_t **elem) const override;
 
@@ -130,4 +141,33 @@ class t8_default_scheme_common_c: public t8_eclass_scheme_c {
   virtual void
   t8_element_debug_print (const t8_element_t *elem) const;
 #endif
+
+ private:
+  /** Return the memory pool that the calling thread allocates elements from.
+   * Outside of parallel regions and on the master thread this is \a ts_context.
+   * Returns NULL on threads without an own pool. These share the last entry of
+   * \a thread_pools and may only access it in a critical section. */
+  sc_mempool_t *
+  t8_element_get_mempool () const;
+
+#if T8_ENABLE_DEBUG
+  /** Return the index of a pool returned by \ref t8_element_get_mempool in \a debug_pool_elements. */
+  int
+  t8_element_get_pool_index (const sc_mempool_t *pool) const;
+
+  /** Record the allocation or deallocation of elements from one memory pool.
+   * Aborts if an element is deallocated that was not allocated from this pool.
+   * \param [in] pool_index  The index of the pool, 0 for \a ts_context, \a num_thread_pools for the shared pool.
+   * \param [in] length      The number of elements.
+   * \param [in] elem        The elements.
+   * \param [in] allocate    True if the elements were allocated, false if they are about to be deallocated. */
+  void
+  t8_element_debug_track (int pool_index, int length, t8_element_t *const *elem, bool allocate) const;
+
+  std::unordered_set<const t8_element_t *> *debug_pool_elements; /**< The allocated elements of each pool. */
+#endif
+
+  sc_mempool_t **thread_pools; /**< One lazily created memory pool per OpenMP thread, entry 0 is unused.
+                                    The last entry is shared by all threads with id >= \a num_thread_pools. */
+  int num_thread_pools;        /**< The number of threads with an own entry in \a thread_pools. */
 };
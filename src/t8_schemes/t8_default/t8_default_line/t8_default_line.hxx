@@ -36,7 +36,7 @@
  * It is written as a self-contained library in the t8_dline_* files.
  */
 
-struct t8_default_scheme_line_c: public t8_default_scheme_common_c
+struct t8_default_scheme_line_c final: public t8_default_scheme_common_c
 {
  public:
   /** The virtual table for a particular implementation of an element class. */
@@ -35,7 +35,7 @@
  * t8_dpyramid_* files.
  */
 
-struct t8_default_scheme_pyramid_c: public t8_default_scheme_common_c
+struct t8_default_scheme_pyramid_c final: public t8_default_scheme_common_c
 {
  public:
   /** The virtual table for a particular implementation of an element class. */
@@ -76,7 +76,7 @@ typedef p4est_quadrant_t t8_pquad_t;
     (quad)->p.user_long = (long) (coord); \
   } while (0)
 
-struct t8_default_scheme_quad_c: public t8_default_scheme_common_c
+struct t8_default_scheme_quad_c final: public t8_default_scheme_common_c
 {
  public:
   /** The virtual table for a particular implementation of an element class. */
@@ -32,7 +32,7 @@
 #include <t8_schemes/t8_default/t8_default_line/t8_default_line.hxx>
 #include <t8_schemes/t8_default/t8_default_common/t8_default_common.hxx>
 
-struct t8_default_scheme_tri_c: public t8_default_scheme_common_c
+struct t8_default_scheme_tri_c final: public t8_default_scheme_common_c
 {
  public:
   /** The virtual table for a particular implementation of an element class. */
@@ -118,21 +118,59 @@ t8_dtri_equal (const t8_dtri_t *elem1, const t8_dtri_t *elem2)
 int
 t8_dtri_compare (const t8_dtri_t *t1, const t8_dtri_t *t2)
 {
-  int maxlvl;
-  t8_linearidx_t id1, id2;
-
-  /* Compute the bigger level of the two */
-  maxlvl = SC_MAX (t1->level, t2->level);
-  /* Compute the linear ids of the elements */
-  id1 = t8_dtri_linear_id (t1, maxlvl);
-  id2 = t8_dtri_linear_id (t2, maxlvl);
-  if (id1 == id2) {
-    /* The linear ids are the same, the triangle with the smaller level is considered smaller */
-    T8_ASSERT (t1->level != t2->level || t8_dtri_is_equal (t1, t2));
-    return t1->level - t2->level;
-  }
-  /* return negative if id1 < id2, zero if id1 = id2, positive if id1 > id2 */
-  return id1 < id2 ? -1 : id1 != id2;
+  uint32_t exclor;
+  int level, min_level, common_level;
+  t8_dtri_type_t t1_type_at_l, t2_type_at_l;
+  t8_dtri_type_t t1_parent_type, t2_parent_type;
+
+  /* Instead of computing both linear ids, we search for the level at which
+   * the ancestors of t1 and t2 diverge and compare the local ids of these ancestors.
+   * This only walks through the levels below the divergence level, which is
+   * usually close to the levels of t1 and t2 when sorting or searching. */
+
+  /* The anchor coordinates of t1 and t2 agree up to the highest differing bit.
+   * Thus, the ancestors up to this level lie in the same cube. */
+  exclor = (t1->x ^ t2->x) | (t1->y ^ t2->y);
+#ifdef T8_DTRI_TO_DTET
+  exclor |= t1->z ^ t2->z;
+#endif
+  min_level = SC_MIN (t1->level, t2->level);
+  common_level = T8_DTRI_MAXLEVEL - (SC_LOG2_32 (exclor) + 1);
+  if (common_level >= min_level) {
+    /* The ancestors at min_level lie in the same cube */
+    level = min_level;
+    t1_type_at_l = compute_type (t1, level);
+    t2_type_at_l = compute_type (t2, level);
+    if (t1_type_at_l == t2_type_at_l) {
+      /* The ancestors at min_level are equal, hence one triangle is an ancestor of the other
+       * or they are equal. The triangle with the smaller level is considered smaller. */
+      return t1->level - t2->level;
+    }
+  }
+  else {
+    /* The ancestors at common_level + 1 lie in different cubes */
+    level = common_level + 1;
+    t1_type_at_l = compute_type (t1, level);
+    t2_type_at_l = compute_type (t2, level);
+  }
+  /* Go up until the ancestors coincide. Then the ancestors on the level below differ. */
+  for (; level > 0; level--) {
+    t1_parent_type = compute_type_ext (t1, level - 1, t1_type_at_l, level);
+    t2_parent_type = compute_type_ext (t2, level - 1, t2_type_at_l, level);
+    if (t1_parent_type == t2_parent_type) {
+      break;
+    }
+    t1_type_at_l = t1_parent_type;
+    t2_type_at_l = t2_parent_type;
+  }
+  T8_ASSERT (level > 0);
+  {
+    /* The ancestors at level have the same parent, we compare their local ids */
+    const int t1_local_id = t8_dtri_type_cid_to_Iloc[t1_type_at_l][compute_cubeid (t1, level)];
+    const int t2_local_id = t8_dtri_type_cid_to_Iloc[t2_type_at_l][compute_cubeid (t2, level)];
+    T8_ASSERT (t1_local_id != t2_local_id);
+    return t1_local_id < t2_local_id ? -1 : 1;
+  }
 }
 
 void
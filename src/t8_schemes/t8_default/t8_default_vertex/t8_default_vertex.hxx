@@ -33,7 +33,7 @@
 #include <t8_schemes/t8_default/t8_default_tri/t8_default_tri.hxx>
 #include <t8_schemes/t8_default/t8_default_common/t8_default_common.hxx>
 
-struct t8_default_scheme_vertex_c: public t8_default_scheme_common_c
+struct t8_default_scheme_vertex_c final: public t8_default_scheme_common_c
 {
  public:
   /** Constructor. */
@@ -54,6 +54,16 @@
 #define t8_vtk_gloidx_array_type_t vtkTypeInt64Array
 #endif
 
+/** The format in which the data arrays of the native vtk writer are stored. */
+typedef enum {
+  T8_VTK_ASCII = 0,          /**< Human readable ASCII values. */
+  T8_VTK_BINARY,             /**< Base64 encoded binary values inside each data array. */
+  T8_VTK_BINARY_COMPRESSED,  /**< Base64 encoded zlib compressed values. Requires libsc to be built with zlib,
+                                  otherwise \ref T8_VTK_BINARY is used. */
+  T8_VTK_APPENDED            /**< Raw binary values of all data arrays in a single appended block
+                                  at the end of the file. */
+} t8_vtk_format_t;
+
 /* TODO: Add support for integer data type. */
 typedef enum {
   T8_VTK_SCALAR, /* One double value per element */
@@ -23,16 +23,15 @@
 #include "t8_vtk/t8_vtk_write_ASCII.hxx"
 #include "t8_vtk/t8_vtk_writer_helper.hxx"
 #include <t8_vtk.h>
+#include <sc_vtk.h>
 #include <t8_element.hxx>
 #include <t8_forest/t8_forest_ghost.h>
+#include <t8_forest/t8_forest_iterate.hxx>
 #include <t8_vec.h>
 #include "t8_forest/t8_forest_types.h"
 #include "t8_cmesh/t8_cmesh_trees.h"
 #include "t8_cmesh/t8_cmesh_types.h"
 
-/* TODO: Currently we only use ASCII mode and no data compression.
- *       We also do not use sc_io to buffer our output stream. */
-
 /* There are different cell data to write, e.g. connectivity, type, vertices, ...
  * The structure is always the same:
  * Iterate over the trees,
@@ -43,11 +42,30 @@
  *  t8_forest_vtk_write_cell_data.
  * This function accepts a callback function, which is then executed for
  * each element. The callback function is defined below.
+ *
+ * The kernels do not write to the file directly, but pass their values to
+ * t8_forest_vtk_write_int and t8_forest_vtk_write_float. In ASCII format these
+ * print the values. In the binary formats the values of one data array are
+ * collected in a contiguous buffer, which is written with a single call once
+ * all elements are processed.
  */
-/* TODO: As soon as we have element iterators we should restructure this concept
- * appropriately. */
+/* The local elements are traversed with t8_forest_for_each_element.
+ * The kernels get the scheme as t8_eclass_scheme_c, so their scheme calls remain virtual. */
 typedef enum { T8_VTK_KERNEL_INIT, T8_VTK_KERNEL_EXECUTE, T8_VTK_KERNEL_CLEANUP } T8_VTK_KERNEL_MODUS;
 
+/** The destination of the data arrays of a .vtu file. */
+typedef struct
+{
+  FILE *vtufile;          /**< The open .vtu file. */
+  t8_vtk_format_t format; /**< The format in which the data arrays are written. */
+  sc_array_t buffer;      /**< In binary formats, the bytes of the current data array. */
+  sc_array_t appended;    /**< In appended format, the size and bytes of all data arrays written so far. */
+  const t8_forest_vtk_shared_points_t *shared_points; /**< If not NULL, the points shared between elements. */
+} t8_forest_vtk_output_t;
+
+/* The type of the size header of each data array in appended format. */
+typedef uint64_t t8_vtk_appended_header_t;
+
 /** Callback function prototype for writing cell data.
  * The function is executed for each element.
  * The callback can run in three different modi:
@@ -64,7 +82,7 @@ typedef enum { T8_VTK_KERNEL_INIT, T8_VTK_KERNEL_EXECUTE, T8_VTK_KERNEL_CLEANUP
  * \param [in] is_ghost Non-zero if the current element is a ghost element.
  *                      In this cas \a tree is NULL.
  *                      All ghost element will be traversed after all elements are
- * \param [in,out] vtufile The open file stream to which we write the forest.
+ * \param [in,out] output  The output to which we write the forest.
  * \param [in,out] columns An integer counting the number of written columns.
  *                         The callback should increase this value by the number
  *                         of values written to the file.
@@ -76,8 +94,37 @@ typedef enum { T8_VTK_KERNEL_INIT, T8_VTK_KERNEL_EXECUTE, T8_VTK_KERNEL_CLEANUP
  */
 typedef int (*t8_forest_vtk_cell_data_kernel) (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                                const t8_locidx_t element_index, const t8_element_t *element,
-                                               t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                               void **data, T8_VTK_KERNEL_MODUS modus);
+                                               const t8_eclass_scheme_c *ts, const int is_ghost,
+                                               t8_forest_vtk_output_t *output, int *columns, void **data,
+                                               T8_VTK_KERNEL_MODUS modus);
+
+/* Write an integer value of a data array.
+ * All integer data arrays are of type Int32, see T8_VTK_LOCIDX and T8_VTK_GLOIDX.
+ * Returns true on success. */
+static int
+t8_forest_vtk_write_int (t8_forest_vtk_output_t *output, const long long value)
+{
+  if (output->format == T8_VTK_ASCII) {
+    return fprintf (output->vtufile, " %lld", value) > 0;
+  }
+  const int32_t value32 = (int32_t) value;
+  memcpy (sc_array_push_count (&output->buffer, sizeof (int32_t)), &value32, sizeof (int32_t));
+  return 1;
+}
+
+/* Write a floating point value of a data array of type T8_VTK_FLOAT_NAME.
+ * Returns true on success. */
+static int
+t8_forest_vtk_write_float (t8_forest_vtk_output_t *output, const double value)
+{
+  if (output->format == T8_VTK_ASCII) {
+    return fprintf (output->vtufile, " %g", value) > 0;
+  }
+  const T8_VTK_FLOAT_TYPE value_float = (T8_VTK_FLOAT_TYPE) value;
+  memcpy (sc_array_push_count (&output->buffer, sizeof (T8_VTK_FLOAT_TYPE)), &value_float,
+          sizeof (T8_VTK_FLOAT_TYPE));
+  return 1;
+}
 
 static t8_locidx_t
 t8_forest_num_points (t8_forest_t forest, const int count_ghosts)
@@ -117,8 +164,8 @@ t8_forest_num_points (t8_forest_t forest, const int count_ghosts)
 static int
 t8_forest_vtk_cells_vertices_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                      const t8_locidx_t element_index, const t8_element_t *element,
-                                     t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                     void **data, T8_VTK_KERNEL_MODUS modus)
+                                     const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                     int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   double element_coordinates[3];
   int num_el_vertices, ivertex;
@@ -139,15 +186,21 @@ t8_forest_vtk_cells_vertices_kernel (t8_forest_t forest, const t8_locidx_t ltree
   for (ivertex = 0; ivertex < num_el_vertices; ivertex++) {
     const double *ref_coords = t8_forest_vtk_point_to_element_ref_coords[element_shape][ivertex];
     t8_forest_element_from_ref_coords (forest, ltree_id, element, ref_coords, 1, element_coordinates);
-    freturn = fprintf (vtufile, "         ");
+    if (output->format != T8_VTK_ASCII) {
+      for (int idim = 0; idim < 3; idim++) {
+        t8_forest_vtk_write_float (output, element_coordinates[idim]);
+      }
+      continue;
+    }
+    freturn = fprintf (output->vtufile, "         ");
     if (freturn <= 0) {
       return 0;
     }
 #ifdef T8_VTK_DOUBLES
-    freturn = fprintf (vtufile, " %24.16e %24.16e %24.16e\n", element_coordinates[0], element_coordinates[1],
+    freturn = fprintf (output->vtufile, " %24.16e %24.16e %24.16e\n", element_coordinates[0], element_coordinates[1],
                        element_coordinates[2]);
 #else
-    freturn = fprintf (vtufile, " %16.8e %16.8e %16.8e\n", element_coordinates[0], element_coordinates[1],
+    freturn = fprintf (output->vtufile, " %16.8e %16.8e %16.8e\n", element_coordinates[0], element_coordinates[1],
                        element_coordinates[2]);
 #endif
     if (freturn <= 0) {
@@ -163,11 +216,11 @@ t8_forest_vtk_cells_vertices_kernel (t8_forest_t forest, const t8_locidx_t ltree
 static int
 t8_forest_vtk_cells_connectivity_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                          const t8_locidx_t element_index, const t8_element_t *element,
-                                         t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                         void **data, T8_VTK_KERNEL_MODUS modus)
+                                         const t8_eclass_scheme_c *ts, const int is_ghost,
+                                         t8_forest_vtk_output_t *output, int *columns, void **data,
+                                         T8_VTK_KERNEL_MODUS modus)
 {
   int ivertex, num_vertices;
-  int freturn;
   t8_locidx_t *count_vertices;
   t8_element_shape_t element_shape;
 
@@ -186,8 +239,10 @@ t8_forest_vtk_cells_connectivity_kernel (t8_forest_t forest, const t8_locidx_t l
   element_shape = ts->t8_element_shape (element);
   num_vertices = t8_eclass_num_vertices[element_shape];
   for (ivertex = 0; ivertex < num_vertices; ++ivertex, (*count_vertices)++) {
-    freturn = fprintf (vtufile, " %ld", (long) *count_vertices);
-    if (freturn <= 0) {
+    /* If points are shared, we write the point of the current corner. Otherwise each corner is its own point. */
+    const t8_locidx_t point = output->shared_points != NULL ? output->shared_points->corner_to_point[*count_vertices]
+                                                            : *count_vertices;
+    if (!t8_forest_vtk_write_int (output, point)) {
       return 0;
     }
   }
@@ -197,12 +252,11 @@ t8_forest_vtk_cells_connectivity_kernel (t8_forest_t forest, const t8_locidx_t l
 
 static int
 t8_forest_vtk_cells_offset_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                   const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                   const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                   T8_VTK_KERNEL_MODUS modus)
+                                   const t8_locidx_t element_index, const t8_element_t *element,
+                                   const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                   int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   long long *offset;
-  int freturn;
   int num_vertices;
 
   if (modus == T8_VTK_KERNEL_INIT) {
@@ -219,8 +273,7 @@ t8_forest_vtk_cells_offset_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
 
   num_vertices = t8_eclass_num_vertices[ts->t8_element_shape (element)];
   *offset += num_vertices;
-  freturn = fprintf (vtufile, " %lld", *offset);
-  if (freturn <= 0) {
+  if (!t8_forest_vtk_write_int (output, *offset)) {
     return false;
   }
   *columns += 1;
@@ -230,15 +283,13 @@ t8_forest_vtk_cells_offset_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
 
 static int
 t8_forest_vtk_cells_type_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                 const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                 const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                 T8_VTK_KERNEL_MODUS modus)
+                                 const t8_locidx_t element_index, const t8_element_t *element,
+                                 const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                 int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
-  int freturn;
   if (modus == T8_VTK_KERNEL_EXECUTE) {
     /* print the vtk type of the element */
-    freturn = fprintf (vtufile, " %d", t8_eclass_vtk_type[ts->t8_element_shape (element)]);
-    if (freturn <= 0) {
+    if (!t8_forest_vtk_write_int (output, t8_eclass_vtk_type[ts->t8_element_shape (element)])) {
       return 0;
     }
     *columns += 1;
@@ -248,12 +299,12 @@ t8_forest_vtk_cells_type_kernel (t8_forest_t forest, const t8_locidx_t ltree_id,
 
 static int
 t8_forest_vtk_cells_level_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                  const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                  const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                  T8_VTK_KERNEL_MODUS modus)
+                                  const t8_locidx_t element_index, const t8_element_t *element,
+                                  const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                  int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   if (modus == T8_VTK_KERNEL_EXECUTE) {
-    fprintf (vtufile, "%i ", ts->t8_element_level (element));
+    t8_forest_vtk_write_int (output, ts->t8_element_level (element));
     *columns += 1;
   }
   return 1;
@@ -261,12 +312,12 @@ t8_forest_vtk_cells_level_kernel (t8_forest_t forest, const t8_locidx_t ltree_id
 
 static int
 t8_forest_vtk_cells_rank_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                 const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                 const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                 T8_VTK_KERNEL_MODUS modus)
+                                 const t8_locidx_t element_index, const t8_element_t *element,
+                                 const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                 int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   if (modus == T8_VTK_KERNEL_EXECUTE) {
-    fprintf (vtufile, "%i ", forest->mpirank);
+    t8_forest_vtk_write_int (output, forest->mpirank);
     *columns += 1;
   }
   return 1;
@@ -274,9 +325,9 @@ t8_forest_vtk_cells_rank_kernel (t8_forest_t forest, const t8_locidx_t ltree_id,
 
 static int
 t8_forest_vtk_cells_treeid_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                   const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                   const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                   T8_VTK_KERNEL_MODUS modus)
+                                   const t8_locidx_t element_index, const t8_element_t *element,
+                                   const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                   int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   if (modus == T8_VTK_KERNEL_EXECUTE) {
     long long tree_id;
@@ -288,7 +339,7 @@ t8_forest_vtk_cells_treeid_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
       /* Otherwise the global tree id */
       tree_id = (long long) ltree_id + forest->first_local_tree;
     }
-    fprintf (vtufile, "%lli ", tree_id);
+    t8_forest_vtk_write_int (output, tree_id);
     *columns += 1;
   }
   return 1;
@@ -297,16 +348,16 @@ t8_forest_vtk_cells_treeid_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
 static int
 t8_forest_vtk_cells_elementid_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                       const t8_locidx_t element_index, const t8_element_t *element,
-                                      t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                      void **data, T8_VTK_KERNEL_MODUS modus)
+                                      const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                      int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   if (modus == T8_VTK_KERNEL_EXECUTE) {
     if (!is_ghost) {
-      fprintf (vtufile, "%lli ",
-               element_index + tree->elements_offset + (long long) t8_forest_get_first_local_element_id (forest));
+      t8_forest_vtk_write_int (output, element_index + tree->elements_offset
+                                         + (long long) t8_forest_get_first_local_element_id (forest));
     }
     else {
-      fprintf (vtufile, "%lli ", (long long) -1);
+      t8_forest_vtk_write_int (output, -1);
     }
     *columns += 1;
   }
@@ -315,9 +366,9 @@ t8_forest_vtk_cells_elementid_kernel (t8_forest_t forest, const t8_locidx_t ltre
 
 static int
 t8_forest_vtk_cells_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                   const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                   const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                   T8_VTK_KERNEL_MODUS modus)
+                                   const t8_locidx_t element_index, const t8_element_t *element,
+                                   const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                   int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   double element_value = 0;
   t8_locidx_t scalar_index;
@@ -331,7 +382,7 @@ t8_forest_vtk_cells_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
     else {
       element_value = 0;
     }
-    fprintf (vtufile, "%g ", element_value);
+    t8_forest_vtk_write_float (output, element_value);
     *columns += 1;
   }
   return 1;
@@ -339,9 +390,9 @@ t8_forest_vtk_cells_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
 
 static int
 t8_forest_vtk_cells_vector_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
-                                   const t8_locidx_t element_index, const t8_element_t *element, t8_eclass_scheme_c *ts,
-                                   const int is_ghost, FILE *vtufile, int *columns, void **data,
-                                   T8_VTK_KERNEL_MODUS modus)
+                                   const t8_locidx_t element_index, const t8_element_t *element,
+                                   const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                   int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   double *element_values, null_vec[3] = { 0, 0, 0 };
   int dim, idim;
@@ -360,7 +411,7 @@ t8_forest_vtk_cells_vector_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
       element_values = null_vec;
     }
     for (idim = 0; idim < dim; idim++) {
-      fprintf (vtufile, "%g ", element_values[idim]);
+      t8_forest_vtk_write_float (output, element_values[idim]);
     }
     *columns += dim;
   }
@@ -371,8 +422,8 @@ t8_forest_vtk_cells_vector_kernel (t8_forest_t forest, const t8_locidx_t ltree_i
 static int
 t8_forest_vtk_vertices_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                       const t8_locidx_t element_index, const t8_element_t *element,
-                                      t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                      void **data, T8_VTK_KERNEL_MODUS modus)
+                                      const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                      int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   double element_value = 0;
   int num_vertex, ivertex;
@@ -390,7 +441,7 @@ t8_forest_vtk_vertices_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltre
       else {
         element_value = 0;
       }
-      fprintf (vtufile, "%g ", element_value);
+      t8_forest_vtk_write_float (output, element_value);
       *columns += 1;
     }
   }
@@ -401,8 +452,8 @@ t8_forest_vtk_vertices_scalar_kernel (t8_forest_t forest, const t8_locidx_t ltre
 static int
 t8_forest_vtk_vertices_vector_kernel (t8_forest_t forest, const t8_locidx_t ltree_id, const t8_tree_t tree,
                                       const t8_locidx_t element_index, const t8_element_t *element,
-                                      t8_eclass_scheme_c *ts, const int is_ghost, FILE *vtufile, int *columns,
-                                      void **data, T8_VTK_KERNEL_MODUS modus)
+                                      const t8_eclass_scheme_c *ts, const int is_ghost, t8_forest_vtk_output_t *output,
+                                      int *columns, void **data, T8_VTK_KERNEL_MODUS modus)
 {
   double *element_values, null_vec[3] = { 0, 0, 0 };
   int dim, idim;
@@ -424,7 +475,7 @@ t8_forest_vtk_vertices_vector_kernel (t8_forest_t forest, const t8_locidx_t ltre
         element_values = null_vec;
       }
       for (idim = 0; idim < dim; idim++) {
-        fprintf (vtufile, "%g ", element_values[idim]);
+        t8_forest_vtk_write_float (output, element_values[idim]);
       }
       *columns += dim;
     }
@@ -432,30 +483,94 @@ t8_forest_vtk_vertices_vector_kernel (t8_forest_t forest, const t8_locidx_t ltre
   return 1;
 }
 
+/* Write the opening tag of a data array.
+ * In appended format, the tag is closed immediately and references the
+ * position of the array in the appended data section. */
+static int
+t8_forest_vtk_write_data_array_begin (t8_forest_vtk_output_t *output, const char *dataname, const char *datatype,
+                                      const char *component_string)
+{
+  int freturn;
+
+  switch (output->format) {
+  case T8_VTK_ASCII:
+    freturn = fprintf (output->vtufile,
+                       "        <DataArray type=\"%s\" "
+                       "Name=\"%s\" %s format=\"ascii\">\n         ",
+                       datatype, dataname, component_string);
+    break;
+  case T8_VTK_APPENDED:
+    freturn = fprintf (output->vtufile,
+                       "        <DataArray type=\"%s\" "
+                       "Name=\"%s\" %s format=\"appended\" offset=\"%zu\"/>\n",
+                       datatype, dataname, component_string, output->appended.elem_count);
+    break;
+  default:
+    freturn = fprintf (output->vtufile,
+                       "        <DataArray type=\"%s\" "
+                       "Name=\"%s\" %s format=\"binary\">\n          ",
+                       datatype, dataname, component_string);
+  }
+  return freturn > 0;
+}
+
+/* Write the values collected in a binary format and close the data array. */
+static int
+t8_forest_vtk_write_data_array_end (t8_forest_vtk_output_t *output)
+{
+  int freturn = 0;
+
+  switch (output->format) {
+  case T8_VTK_ASCII:
+    freturn = fprintf (output->vtufile, "\n        </DataArray>\n") > 0;
+    break;
+  case T8_VTK_APPENDED: {
+    /* Append the size of the array followed by its bytes to the appended data */
+    const t8_vtk_appended_header_t num_bytes = output->buffer.elem_count;
+    memcpy (sc_array_push_count (&output->appended, sizeof (t8_vtk_appended_header_t)), &num_bytes,
+            sizeof (t8_vtk_appended_header_t));
+    if (num_bytes > 0) {
+      memcpy (sc_array_push_count (&output->appended, num_bytes), output->buffer.array, num_bytes);
+    }
+    freturn = 1;
+    break;
+  }
+  case T8_VTK_BINARY_COMPRESSED:
+#ifdef SC_HAVE_ZLIB
+    freturn = !sc_vtk_write_compressed (output->vtufile, output->buffer.array, output->buffer.elem_count);
+    freturn = freturn && fprintf (output->vtufile, "\n        </DataArray>\n") > 0;
+    break;
+#endif
+    /* Without zlib, we fall back to uncompressed binary data */
+  case T8_VTK_BINARY:
+    freturn = !sc_vtk_write_binary (output->vtufile, output->buffer.array, output->buffer.elem_count);
+    freturn = freturn && fprintf (output->vtufile, "\n        </DataArray>\n") > 0;
+    break;
+  default:
+    SC_ABORT_NOT_REACHED ();
+  }
+  sc_array_truncate (&output->buffer);
+  return freturn;
+}
+
 /* Iterate over all cells and write cell data to the file using
  * the cell_data_kernel as callback */
 static int
-t8_forest_vtk_write_cell_data (t8_forest_t forest, FILE *vtufile, const char *dataname, const char *datatype,
-                               const char *component_string, const int max_columns,
+t8_forest_vtk_write_cell_data (t8_forest_t forest, t8_forest_vtk_output_t *output, const char *dataname,
+                               const char *datatype, const char *component_string, const int max_columns,
                                t8_forest_vtk_cell_data_kernel kernel, const int write_ghosts, void *udata)
 {
-  int freturn;
+  int freturn = 1;
   int countcols;
-  t8_tree_t tree;
-  t8_locidx_t itree, ighost;
-  t8_locidx_t element_index, elems_in_tree;
+  t8_locidx_t ighost;
   t8_locidx_t num_local_trees, num_ghost_trees;
-  t8_element_t *element;
   t8_eclass_scheme_c *ts;
   void *data = NULL;
+  /* Line breaks are only written in ASCII format */
+  const int break_lines = output->format == T8_VTK_ASCII;
 
-  /* Write the connectivity information.
-   * Thus for each tree we write the indices of its corner vertices. */
-  freturn = fprintf (vtufile,
-                     "        <DataArray type=\"%s\" "
-                     "Name=\"%s\" %s format=\"ascii\">\n         ",
-                     datatype, dataname, component_string);
-  if (freturn <= 0) {
+  /* Write the opening tag of the data array. */
+  if (!t8_forest_vtk_write_data_array_begin (output, dataname, datatype, component_string)) {
     return 0;
   }
 
@@ -468,43 +583,30 @@ t8_forest_vtk_write_cell_data (t8_forest_t forest, FILE *vtufile, const char *da
   /* Call the kernel in initialization modus to possibly initialize the
    * data pointer */
   kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_INIT);
-  /* We iterate over the trees and count each trees vertices,
-   * we add this to the already counted vertices and write it to the file */
-  /* TODO: replace with an element iterator */
+  /* We iterate over the local elements tree by tree and write their values to the file.
+   * The iterator steps through the element arrays, so we do not search the tree of each element. */
+  int success = 1;
+  countcols = 0;
   num_local_trees = t8_forest_get_num_local_trees (forest);
-  for (itree = 0, countcols = 0; itree < num_local_trees; itree++) {
-    /* Get the tree that stores the elements */
-    tree = t8_forest_get_tree (forest, itree);
-    /* Get the eclass scheme of the tree */
-    ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
-    elems_in_tree = (t8_locidx_t) t8_element_array_get_count (&tree->elements);
-    for (element_index = 0; element_index < elems_in_tree; element_index++) {
-      /* Get a pointer to the element */
-      element = t8_forest_get_element (forest, tree->elements_offset + element_index, NULL);
-      T8_ASSERT (element != NULL);
-      /* Execute the given callback on each element */
-      if (!kernel (forest, itree, tree, element_index, element, ts, 0, vtufile, &countcols, &data,
-                   T8_VTK_KERNEL_EXECUTE)) {
-        /* call the kernel in clean-up modus */
-        kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
-        return 0;
-      }
-      /* After max_columns we break the line */
-      if (!(countcols % max_columns)) {
-        freturn = fprintf (vtufile, "\n         ");
-        if (freturn <= 0) {
-          /* call the kernel in clean-up modus */
-          kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
-          return 0;
-        }
-      }
-    } /* element loop ends here */
-    if (freturn <= 0) {
-      /* call the kernel in clean-up modus */
-      kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
-      return 0;
+  t8_forest_for_each_element (forest, [&] (const auto *scheme, t8_locidx_t itree, t8_locidx_t ielement,
+                                           t8_locidx_t element_index, const t8_element_t *element) {
+    if (!success) {
+      /* Writing failed for a previous element, we skip the remaining ones */
+      return;
+    }
+    /* Execute the given callback on each element */
+    success = kernel (forest, itree, t8_forest_get_tree (forest, itree), ielement, element, scheme, 0, output,
+                      &countcols, &data, T8_VTK_KERNEL_EXECUTE);
+    /* After max_columns we break the line */
+    if (success && break_lines && !(countcols % max_columns)) {
+      success = fprintf (output->vtufile, "\n         ") > 0;
     }
-  } /* tree loop ends here */
+  });
+  if (!success) {
+    /* call the kernel in clean-up modus */
+    kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
+    return 0;
+  }
 
   if (write_ghosts) {
     t8_locidx_t num_ghosts_in_tree;
@@ -516,19 +618,19 @@ t8_forest_vtk_write_cell_data (t8_forest_t forest, FILE *vtufile, const char *da
       ts = t8_forest_get_eclass_scheme (forest, t8_forest_ghost_get_tree_class (forest, ighost));
       /* The number of ghosts in this tree */
       num_ghosts_in_tree = t8_forest_ghost_tree_num_elements (forest, ighost);
-      for (element_index = 0; element_index < num_ghosts_in_tree; element_index++) {
+      for (t8_locidx_t element_index = 0; element_index < num_ghosts_in_tree; element_index++) {
         /* Get a pointer to the element */
-        element = t8_forest_ghost_get_element (forest, ighost, element_index);
+        const t8_element_t *element = t8_forest_ghost_get_element (forest, ighost, element_index);
         /* Execute the given callback on each element */
-        if (!kernel (forest, ighost + num_local_trees, NULL, element_index, element, ts, 1, vtufile, &countcols, &data,
+        if (!kernel (forest, ighost + num_local_trees, NULL, element_index, element, ts, 1, output, &countcols, &data,
                      T8_VTK_KERNEL_EXECUTE)) {
           /* call the kernel in clean-up modus */
           kernel (NULL, 0, NULL, 0, NULL, NULL, 1, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
           return 0;
         }
         /* After max_columns we break the line */
-        if (!(countcols % max_columns)) {
-          freturn = fprintf (vtufile, "\n         ");
+        if (break_lines && !(countcols % max_columns)) {
+          freturn = fprintf (output->vtufile, "\n         ");
           if (freturn <= 0) {
             /* call the kernel in clean-up modus */
             kernel (NULL, 0, NULL, 0, NULL, NULL, 1, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
@@ -545,12 +647,60 @@ t8_forest_vtk_write_cell_data (t8_forest_t forest, FILE *vtufile, const char *da
   }   /* write_ghosts ends here */
   /* call the kernel in clean-up modus */
   kernel (NULL, 0, NULL, 0, NULL, NULL, 0, NULL, NULL, &data, T8_VTK_KERNEL_CLEANUP);
-  freturn = fprintf (vtufile, "\n        </DataArray>\n");
-  if (freturn <= 0) {
+  /* Write the collected values and close the data array */
+  return t8_forest_vtk_write_data_array_end (output);
+}
+
+/* Write a data array of floating point values that are already given per point. */
+static int
+t8_forest_vtk_write_point_values (t8_forest_vtk_output_t *output, const char *dataname, const char *component_string,
+                                  const double *values, const size_t num_values)
+{
+  if (!t8_forest_vtk_write_data_array_begin (output, dataname, T8_VTK_FLOAT_NAME, component_string)) {
     return 0;
   }
+  for (size_t ivalue = 0; ivalue < num_values; ivalue++) {
+    if (!t8_forest_vtk_write_float (output, values[ivalue])) {
+      return 0;
+    }
+    /* After 8 values we break the line */
+    if (output->format == T8_VTK_ASCII && ivalue % 8 == 7 && fprintf (output->vtufile, "\n         ") <= 0) {
+      return 0;
+    }
+  }
+  return t8_forest_vtk_write_data_array_end (output);
+}
 
-  return 1;
+/* Average the element values of a data field to the shared points.
+ * Each point gets the mean value of the local elements that contain it, points that
+ * only belong to ghost elements get 0.
+ * On output, \a point_values holds \a dim values per point. */
+static void
+t8_forest_vtk_average_to_points (t8_forest_t forest, const t8_forest_vtk_shared_points_t *shared_points,
+                                 const double *element_values, const int dim, std::vector<double> &point_values)
+{
+  const size_t num_points = shared_points->coordinates.size () / 3;
+  std::vector<int> num_elements_at_point (num_points, 0);
+
+  point_values.assign (dim * num_points, 0);
+  const t8_locidx_t num_local_elements = t8_forest_get_local_num_elements (forest);
+  for (t8_locidx_t ielement = 0; ielement < num_local_elements; ielement++) {
+    for (t8_locidx_t icorner = shared_points->corner_offsets[ielement];
+         icorner < shared_points->corner_offsets[ielement + 1]; icorner++) {
+      const t8_locidx_t point = shared_points->corner_to_point[icorner];
+      for (int idim = 0; idim < dim; idim++) {
+        point_values[dim * point + idim] += element_values[dim * ielement + idim];
+      }
+      num_elements_at_point[point]++;
+    }
+  }
+  for (size_t ipoint = 0; ipoint < num_points; ipoint++) {
+    if (num_elements_at_point[ipoint] > 1) {
+      for (int idim = 0; idim < dim; idim++) {
+        point_values[dim * ipoint + idim] /= num_elements_at_point[ipoint];
+      }
+    }
+  }
 }
 
 /* Write the cell data to an open file stream.
@@ -558,24 +708,24 @@ t8_forest_vtk_write_cell_data (t8_forest_t forest, FILE *vtufile, const char *da
  * After completion the file will remain open, whether writing
  * cells was successful or not. */
 static int
-t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_treeid, const int write_mpirank,
-                           const int write_level, const int write_element_id, const int write_ghosts,
-                           const int num_data, t8_vtk_data_field_t *data)
+t8_forest_vtk_write_cells (t8_forest_t forest, t8_forest_vtk_output_t *output, const int write_treeid,
+                           const int write_mpirank, const int write_level, const int write_element_id,
+                           const int write_ghosts, const int num_data, t8_vtk_data_field_t *data)
 {
   int freturn;
   int idata;
 
   T8_ASSERT (t8_forest_is_committed (forest));
-  T8_ASSERT (vtufile != NULL);
+  T8_ASSERT (output != NULL && output->vtufile != NULL);
 
-  freturn = fprintf (vtufile, "      <Cells>\n");
+  freturn = fprintf (output->vtufile, "      <Cells>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_cell_failure;
   }
 
   /* Write the connectivity information.
    * Thus for each tree we write the indices of its corner vertices. */
-  freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "connectivity", T8_VTK_LOCIDX, "", 8,
+  freturn = t8_forest_vtk_write_cell_data (forest, output, "connectivity", T8_VTK_LOCIDX, "", 8,
                                            t8_forest_vtk_cells_connectivity_kernel, write_ghosts, NULL);
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
@@ -588,7 +738,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
    * For example if the trees are a square and a triangle, the offsets would
    * be 4 and 7, since indices 0,1,2,3 refer to the vertices of the square
    * and indices 4,5,6 to the indices of the triangle. */
-  freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "offsets", T8_VTK_LOCIDX, "", 8,
+  freturn = t8_forest_vtk_write_cell_data (forest, output, "offsets", T8_VTK_LOCIDX, "", 8,
                                            t8_forest_vtk_cells_offset_kernel, write_ghosts, NULL);
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
@@ -598,19 +748,19 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
   /* Write the element types. The type specifies the element class, thus
    * square/triangle/tet etc. */
 
-  freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "types", "Int32", "", 8, t8_forest_vtk_cells_type_kernel,
+  freturn = t8_forest_vtk_write_cell_data (forest, output, "types", "Int32", "", 8, t8_forest_vtk_cells_type_kernel,
                                            write_ghosts, NULL);
 
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
   }
   /* Done with writing the types */
-  freturn = fprintf (vtufile, "      </Cells>\n");
+  freturn = fprintf (output->vtufile, "      </Cells>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_cell_failure;
   }
   /* clang-format off */
-  freturn = fprintf (vtufile, "      <CellData Scalars =\"%s%s\">\n", "treeid,mpirank,level",
+  freturn = fprintf (output->vtufile, "      <CellData Scalars =\"%s%s\">\n", "treeid,mpirank,level",
                      (write_element_id ? "id" : ""));
   /* clang-format on */
   if (freturn <= 0) {
@@ -620,7 +770,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
   if (write_treeid) {
     /* Write the tree ids. */
 
-    freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "treeid", T8_VTK_GLOIDX, "", 8,
+    freturn = t8_forest_vtk_write_cell_data (forest, output, "treeid", T8_VTK_GLOIDX, "", 8,
                                              t8_forest_vtk_cells_treeid_kernel, write_ghosts, NULL);
     if (!freturn) {
       goto t8_forest_vtk_cell_failure;
@@ -630,7 +780,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
   if (write_mpirank) {
     /* Write the mpiranks. */
 
-    freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "mpirank", "Int32", "", 8,
+    freturn = t8_forest_vtk_write_cell_data (forest, output, "mpirank", "Int32", "", 8,
                                              t8_forest_vtk_cells_rank_kernel, write_ghosts, NULL);
     if (!freturn) {
       goto t8_forest_vtk_cell_failure;
@@ -640,7 +790,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
   if (write_level) {
     /* Write the element refinement levels. */
 
-    freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "level", "Int32", "", 8, t8_forest_vtk_cells_level_kernel,
+    freturn = t8_forest_vtk_write_cell_data (forest, output, "level", "Int32", "", 8, t8_forest_vtk_cells_level_kernel,
                                              write_ghosts, NULL);
     if (!freturn) {
       goto t8_forest_vtk_cell_failure;
@@ -654,7 +804,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
 
     /* Use 32 bit ints if the global element count fits, 64 bit otherwise. */
     datatype = forest->global_num_elements > T8_LOCIDX_MAX ? T8_VTK_GLOIDX : T8_VTK_LOCIDX;
-    freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "element_id", datatype, "", 8,
+    freturn = t8_forest_vtk_write_cell_data (forest, output, "element_id", datatype, "", 8,
                                              t8_forest_vtk_cells_elementid_kernel, write_ghosts, NULL);
     if (!freturn) {
       goto t8_forest_vtk_cell_failure;
@@ -665,14 +815,14 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
   /* Write the user defined data fields per element */
   for (idata = 0; idata < num_data; idata++) {
     if (data[idata].type == T8_VTK_SCALAR) {
-      freturn = t8_forest_vtk_write_cell_data (forest, vtufile, data[idata].description, T8_VTK_FLOAT_NAME, "", 8,
+      freturn = t8_forest_vtk_write_cell_data (forest, output, data[idata].description, T8_VTK_FLOAT_NAME, "", 8,
                                                t8_forest_vtk_cells_scalar_kernel, write_ghosts, data[idata].data);
     }
     else {
       char component_string[BUFSIZ];
       T8_ASSERT (data[idata].type == T8_VTK_VECTOR);
       snprintf (component_string, BUFSIZ, "NumberOfComponents=\"3\"");
-      freturn = t8_forest_vtk_write_cell_data (forest, vtufile, data[idata].description, T8_VTK_FLOAT_NAME,
+      freturn = t8_forest_vtk_write_cell_data (forest, output, data[idata].description, T8_VTK_FLOAT_NAME,
                                                component_string, 8 * forest->dimension,
                                                t8_forest_vtk_cells_vector_kernel, write_ghosts, data[idata].data);
     }
@@ -681,7 +831,7 @@ t8_forest_vtk_write_cells (t8_forest_t forest, FILE *vtufile, const int write_tr
     }
   }
 
-  freturn = fprintf (vtufile, "      </CellData>\n");
+  freturn = fprintf (output->vtufile, "      </CellData>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_cell_failure;
   }
@@ -699,8 +849,8 @@ t8_forest_vtk_cell_failure:
  * After completion the file will remain open, whether writing
  * cells was successful or not. */
 static int
-t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_ghosts, const int num_data,
-                            t8_vtk_data_field_t *data)
+t8_forest_vtk_write_points (t8_forest_t forest, t8_forest_vtk_output_t *output, const int write_ghosts,
+                            const int num_data, t8_vtk_data_field_t *data)
 {
   int freturn;
   int sreturn;
@@ -708,20 +858,28 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_g
   char description[BUFSIZ];
 
   T8_ASSERT (t8_forest_is_committed (forest));
-  T8_ASSERT (vtufile != NULL);
+  T8_ASSERT (output != NULL && output->vtufile != NULL);
 
   /* Write the vertex coordinates */
 
-  freturn = fprintf (vtufile, "      <Points>\n");
+  freturn = fprintf (output->vtufile, "      <Points>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_cell_failure;
   }
-  freturn = t8_forest_vtk_write_cell_data (forest, vtufile, "Position", T8_VTK_FLOAT_NAME, "NumberOfComponents=\"3\"",
-                                           8, t8_forest_vtk_cells_vertices_kernel, write_ghosts, NULL);
+  if (output->shared_points != NULL) {
+    freturn = t8_forest_vtk_write_point_values (output, "Position", "NumberOfComponents=\"3\"",
+                                                output->shared_points->coordinates.data (),
+                                                output->shared_points->coordinates.size ());
+  }
+  else {
+    freturn = t8_forest_vtk_write_cell_data (forest, output, "Position", T8_VTK_FLOAT_NAME,
+                                             "NumberOfComponents=\"3\"", 8, t8_forest_vtk_cells_vertices_kernel,
+                                             write_ghosts, NULL);
+  }
   if (!freturn) {
     goto t8_forest_vtk_cell_failure;
   }
-  freturn = fprintf (vtufile, "      </Points>\n");
+  freturn = fprintf (output->vtufile, "      </Points>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_cell_failure;
   }
@@ -729,7 +887,7 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_g
 
   /* Write the user defined data fields per element */
   if (num_data > 0) {
-    freturn = fprintf (vtufile, "      <PointData>\n");
+    freturn = fprintf (output->vtufile, "      <PointData>\n");
     for (idata = 0; idata < num_data; idata++) {
       if (data[idata].type == T8_VTK_SCALAR) {
         /* Write the description string. */
@@ -739,8 +897,17 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_g
           /* The output was truncated */
           t8_debugf ("Warning: Truncated vtk point data description to '%s'\n", description);
         }
-        freturn = t8_forest_vtk_write_cell_data (forest, vtufile, description, T8_VTK_FLOAT_NAME, "", 8,
-                                                 t8_forest_vtk_vertices_scalar_kernel, write_ghosts, data[idata].data);
+        if (output->shared_points != NULL) {
+          std::vector<double> point_values;
+          t8_forest_vtk_average_to_points (forest, output->shared_points, data[idata].data, 1, point_values);
+          freturn
+            = t8_forest_vtk_write_point_values (output, description, "", point_values.data (), point_values.size ());
+        }
+        else {
+          freturn
+            = t8_forest_vtk_write_cell_data (forest, output, description, T8_VTK_FLOAT_NAME, "", 8,
+                                             t8_forest_vtk_vertices_scalar_kernel, write_ghosts, data[idata].data);
+        }
       }
       else {
         char component_string[BUFSIZ];
@@ -756,15 +923,23 @@ t8_forest_vtk_write_points (t8_forest_t forest, FILE *vtufile, const int write_g
           t8_debugf ("Warning: Truncated vtk point data description to '%s'\n", description);
         }
 
-        freturn = t8_forest_vtk_write_cell_data (forest, vtufile, description, T8_VTK_FLOAT_NAME, component_string,
-                                                 8 * forest->dimension, t8_forest_vtk_vertices_vector_kernel,
-                                                 write_ghosts, data[idata].data);
+        if (output->shared_points != NULL) {
+          std::vector<double> point_values;
+          t8_forest_vtk_average_to_points (forest, output->shared_points, data[idata].data, 3, point_values);
+          freturn = t8_forest_vtk_write_point_values (output, description, component_string, point_values.data (),
+                                                      point_values.size ());
+        }
+        else {
+          freturn = t8_forest_vtk_write_cell_data (forest, output, description, T8_VTK_FLOAT_NAME, component_string,
+                                                   8 * forest->dimension, t8_forest_vtk_vertices_vector_kernel,
+                                                   write_ghosts, data[idata].data);
+        }
       }
       if (!freturn) {
         goto t8_forest_vtk_cell_failure;
       }
     }
-    freturn = fprintf (vtufile, "      </PointData>\n");
+    freturn = fprintf (output->vtufile, "      </PointData>\n");
   }
   /* Function completed successfully */
   return 1;
@@ -775,11 +950,14 @@ t8_forest_vtk_cell_failure:
 }
 
 int
-t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
-                           const int write_level, const int write_element_id, int write_ghosts, const int num_data,
-                           t8_vtk_data_field_t *data)
+t8_forest_vtk_write_native (t8_forest_t forest, const char *fileprefix, const t8_vtk_format_t format,
+                            const int write_treeid, const int write_mpirank, const int write_level,
+                            const int write_element_id, int write_ghosts, const int write_shared_points,
+                            const int num_data, t8_vtk_data_field_t *data)
 {
   FILE *vtufile = NULL;
+  t8_forest_vtk_output_t output;
+  t8_forest_vtk_shared_points_t shared_points;
   t8_locidx_t num_elements, num_points;
   char vtufilename[BUFSIZ];
   int freturn;
@@ -792,6 +970,18 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
     write_ghosts = 0;
   }
   T8_ASSERT (forest->ghosts != NULL || !write_ghosts);
+  T8_ASSERT (T8_VTK_ASCII <= format && format <= T8_VTK_APPENDED);
+
+  output.format = format;
+#ifndef SC_HAVE_ZLIB
+  if (format == T8_VTK_BINARY_COMPRESSED) {
+    t8_global_infof ("Compressed vtk output requires zlib. Writing uncompressed binary data instead.\n");
+    output.format = T8_VTK_BINARY;
+  }
+#endif
+  sc_array_init (&output.buffer, sizeof (char));
+  sc_array_init (&output.appended, sizeof (char));
+  output.shared_points = NULL;
 
   /* process 0 creates the .pvtu file */
   if (forest->mpirank == 0) {
@@ -807,8 +997,16 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
   if (write_ghosts) {
     num_elements += t8_forest_get_num_ghosts (forest);
   }
-  /* The local number of points, counted with multiplicity */
-  num_points = t8_forest_num_points (forest, write_ghosts);
+  if (write_shared_points) {
+    /* Each point shared by several elements is written once */
+    t8_forest_vtk_compute_shared_points (forest, write_ghosts, &shared_points);
+    output.shared_points = &shared_points;
+    num_points = shared_points.coordinates.size () / 3;
+  }
+  else {
+    /* The local number of points, counted with multiplicity */
+    num_points = t8_forest_num_points (forest, write_ghosts);
+  }
 
   /* The filename for this processes file */
   freturn = snprintf (vtufilename, BUFSIZ, "%s_%04d.vtu", fileprefix, forest->mpirank);
@@ -818,18 +1016,30 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
   }
 
   /* Open the vtufile to write to */
-  vtufile = fopen (vtufilename, "w");
+  vtufile = fopen (vtufilename, output.format == T8_VTK_ASCII ? "w" : "wb");
   if (vtufile == NULL) {
     t8_errorf ("Error when opening file %s\n", vtufilename);
     goto t8_forest_vtk_failure;
   }
+  output.vtufile = vtufile;
   /* Write the header information in the .vtu file.
    * xml type, Unstructured grid and number of points and elements. */
   freturn = fprintf (vtufile, "<?xml version=\"1.0\"?>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_failure;
   }
-  freturn = fprintf (vtufile, "<VTKFile type=\"UnstructuredGrid\" version=\"0.1\"");
+  freturn = fprintf (vtufile, "<VTKFile type=\"UnstructuredGrid\" version=\"%s\"",
+                     output.format == T8_VTK_APPENDED ? "1.0" : "0.1");
+  if (freturn <= 0) {
+    goto t8_forest_vtk_failure;
+  }
+  if (output.format == T8_VTK_BINARY_COMPRESSED) {
+    freturn = fprintf (vtufile, " compressor=\"vtkZLibDataCompressor\"");
+  }
+  else if (output.format == T8_VTK_APPENDED) {
+    /* The size of each array in the appended data is stored as t8_vtk_appended_header_t */
+    freturn = fprintf (vtufile, " header_type=\"UInt64\"");
+  }
   if (freturn <= 0) {
     goto t8_forest_vtk_failure;
   }
@@ -851,20 +1061,37 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
     goto t8_forest_vtk_failure;
   }
   /* write the point data */
-  if (!t8_forest_vtk_write_points (forest, vtufile, write_ghosts, num_data, data)) {
+  if (!t8_forest_vtk_write_points (forest, &output, write_ghosts, num_data, data)) {
     /* writings points was not successful */
     goto t8_forest_vtk_failure;
   }
   /* write the cell data */
-  if (!t8_forest_vtk_write_cells (forest, vtufile, write_treeid, write_mpirank, write_level, write_element_id,
+  if (!t8_forest_vtk_write_cells (forest, &output, write_treeid, write_mpirank, write_level, write_element_id,
                                   write_ghosts, num_data, data)) {
     /* Writing cells was not successful */
     goto t8_forest_vtk_failure;
   }
 
   freturn = fprintf (vtufile, "    </Piece>\n"
-                              "  </UnstructuredGrid>\n"
-                              "</VTKFile>\n");
+                              "  </UnstructuredGrid>\n");
+  if (freturn <= 0) {
+    goto t8_forest_vtk_failure;
+  }
+  if (output.format == T8_VTK_APPENDED) {
+    /* Write all data arrays at once. The underscore marks the beginning of the data. */
+    freturn = fprintf (vtufile, "  <AppendedData encoding=\"raw\">\n   _");
+    if (freturn <= 0) {
+      goto t8_forest_vtk_failure;
+    }
+    if (fwrite (output.appended.array, 1, output.appended.elem_count, vtufile) != output.appended.elem_count) {
+      goto t8_forest_vtk_failure;
+    }
+    freturn = fprintf (vtufile, "\n  </AppendedData>\n");
+    if (freturn <= 0) {
+      goto t8_forest_vtk_failure;
+    }
+  }
+  freturn = fprintf (vtufile, "</VTKFile>\n");
   if (freturn <= 0) {
     goto t8_forest_vtk_failure;
   }
@@ -879,16 +1106,29 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
     t8_global_errorf ("Error when closing file %s\n", vtufilename);
     goto t8_forest_vtk_failure;
   }
+  sc_array_reset (&output.buffer);
+  sc_array_reset (&output.appended);
   /* Writing was successful */
   return 1;
 t8_forest_vtk_failure:
   if (vtufile != NULL) {
     fclose (vtufile);
   }
+  sc_array_reset (&output.buffer);
+  sc_array_reset (&output.appended);
   t8_errorf ("Error when writing vtk file.\n");
   return 0;
 }
 
+int
+t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int write_treeid, const int write_mpirank,
+                           const int write_level, const int write_element_id, int write_ghosts, const int num_data,
+                           t8_vtk_data_field_t *data)
+{
+  return t8_forest_vtk_write_native (forest, fileprefix, T8_VTK_ASCII, write_treeid, write_mpirank, write_level,
+                                     write_element_id, write_ghosts, 0, num_data, data);
+}
+
 /* Return the local number of vertices in a cmesh.
  * \param [in] cmesh       The cmesh to be considered.
  * \param [in] count_ghosts If true, we also count the vertices of the ghost trees.
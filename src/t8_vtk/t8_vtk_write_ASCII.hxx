@@ -51,6 +51,36 @@ t8_forest_vtk_write_ASCII (t8_forest_t forest, const char *fileprefix, const int
                            const int write_level, const int write_element_id, int write_ghosts, const int num_data,
                            t8_vtk_data_field_t *data);
 
+/** Write the forest in .pvtu file format in a given format. Writes one .vtu file per
+ * process and a meta .pvtu file.
+ * In the binary formats, the values of each data array are collected in a
+ * contiguous buffer and written with a single call, which is considerably faster
+ * than ASCII output for large forests.
+ * \param [in]  forest    The forest.
+ * \param [in]  fileprefix  The prefix of the output files.
+ * \param [in]  format    The format of the data arrays, see \ref t8_vtk_format_t.
+ * \param [in]  write_treeid If true, the global tree id is written for each element.
+ * \param [in]  write_mpirank If true, the mpirank is written for each element.
+ * \param [in]  write_level If true, the refinement level is written for each element.
+ * \param [in]  write_element_id If true, the global element id is written for each element.
+ * \param [in]  write_ghosts If true, each process additionally writes its ghost elements.
+ *                           For ghost element the treeid is -1.
+ * \param [in]  write_shared_points If true, each point that is shared by several elements
+ *                           is written only once. Point data is then averaged over the local
+ *                           elements at each point.
+ * \param [in]  num_data  Number of user defined double valued data fields to write.
+ * \param [in]  data      Array of t8_vtk_data_field_t of length \a num_data
+ *                        providing the used defined per element data.
+ *                        If scalar and vector fields are used, all scalar fields
+ *                        must come first in the array.
+ * \return  True if successful, false if not (process local).
+ */
+int
+t8_forest_vtk_write_native (t8_forest_t forest, const char *fileprefix, const t8_vtk_format_t format,
+                            const int write_treeid, const int write_mpirank, const int write_level,
+                            const int write_element_id, int write_ghosts, const int write_shared_points,
+                            const int num_data, t8_vtk_data_field_t *data);
+
 int
 t8_cmesh_vtk_write_ASCII (t8_cmesh_t cmesh, const char *fileprefix);
 
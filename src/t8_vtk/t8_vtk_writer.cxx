@@ -129,6 +129,16 @@ t8_forest_vtk_write_file (const t8_forest_t forest, const char *fileprefix, cons
   return writer.write_ASCII (forest);
 }
 
+int
+t8_forest_vtk_write_file_format (const t8_forest_t forest, const char *fileprefix, const t8_vtk_format_t format,
+                                 const int write_treeid, const int write_mpirank, const int write_level,
+                                 const int write_element_id, int write_ghosts, const int write_shared_points,
+                                 const int num_data, t8_vtk_data_field_t *data)
+{
+  return t8_forest_vtk_write_native (forest, fileprefix, format, write_treeid, write_mpirank, write_level,
+                                     write_element_id, write_ghosts, write_shared_points, num_data, data);
+}
+
 int
 t8_cmesh_vtk_write_file_via_API (const t8_cmesh_t cmesh, const char *fileprefix, sc_MPI_Comm comm)
 {
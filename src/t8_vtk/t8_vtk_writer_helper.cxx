@@ -24,6 +24,15 @@
 #include <t8.h>
 #include <t8_forest/t8_forest.h>
 #include <t8_forest/t8_forest_types.h>
+#include <t8_forest/t8_forest_ghost.h>
+#include <t8_forest/t8_forest_geometrical.h>
+#include <t8_cmesh.h>
+#include <t8_geometry/t8_geometry.h>
+#include <t8_vec.h>
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <unordered_map>
 
 int
 t8_get_number_of_vtk_nodes (const t8_element_shape_t eclass, const int curved_flag)
@@ -206,3 +215,390 @@ grid_element_level<t8_cmesh_t> (const t8_cmesh_t grid, const t8_locidx_t itree,
 {
   return 0;
 }
+
+/* The key of a point of the vtk output.
+ * values[0] is zero for a point inside a tree, followed by the global tree id and
+ * the integer reference coordinates of the point.
+ * For a point on the tree boundary, values[0] is the number of tree corners with
+ * nonzero interpolation weight, followed by pairs of corner id and weight, sorted
+ * by the corner id. */
+struct t8_vtk_point_key
+{
+  std::array<uint64_t, 2 * T8_ECLASS_MAX_CORNERS_2D + 1> values;
+
+  bool
+  operator== (const t8_vtk_point_key &other) const
+  {
+    return values == other.values;
+  }
+};
+
+struct t8_vtk_point_key_hash
+{
+  size_t
+  operator() (const t8_vtk_point_key &key) const
+  {
+    size_t hash = 0;
+    for (const uint64_t value : key.values) {
+      hash ^= std::hash<uint64_t> {}(value) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    }
+    return hash;
+  }
+};
+
+/* Compute the interpolation weights of a point with respect to the corners of a tree.
+ * The point is given in integer reference coordinates of the tree, which is scaled to
+ * [0, root_len]^dim. The corners are numbered as in t8_element_corner_ref_coords.
+ * Returns true if the point lies on the boundary of the tree. Only in this case the
+ * weights are computed. */
+static int
+t8_vtk_tree_corner_weights (const t8_eclass_t eclass, const uint64_t *coords, const uint64_t root_len,
+                            uint64_t weights[T8_ECLASS_MAX_CORNERS])
+{
+  const uint64_t R = root_len;
+  const uint64_t x = coords[0], y = coords[1], z = coords[2];
+
+  switch (eclass) {
+  case T8_ECLASS_VERTEX:
+    /* A vertex tree has no boundary */
+    return 0;
+  case T8_ECLASS_LINE:
+    weights[0] = R - x;
+    weights[1] = x;
+    break;
+  case T8_ECLASS_QUAD:
+  case T8_ECLASS_HEX: {
+    const int dim = t8_eclass_to_dimension[eclass];
+    for (int icorner = 0; icorner < t8_eclass_num_vertices[eclass]; icorner++) {
+      weights[icorner] = 1;
+      for (int idim = 0; idim < dim; idim++) {
+        weights[icorner] *= (icorner & (1 << idim)) ? coords[idim] : R - coords[idim];
+      }
+    }
+    break;
+  }
+  case T8_ECLASS_TRIANGLE:
+    weights[0] = R - x;
+    weights[1] = x - y;
+    weights[2] = y;
+    break;
+  case T8_ECLASS_TET:
+    weights[0] = R - x;
+    weights[1] = x - z;
+    weights[2] = z - y;
+    weights[3] = y;
+    break;
+  case T8_ECLASS_PRISM: {
+    const uint64_t triangle_weights[3] = { R - x, x - y, y };
+    for (int icorner = 0; icorner < 3; icorner++) {
+      weights[icorner] = triangle_weights[icorner] * (R - z);
+      weights[icorner + 3] = triangle_weights[icorner] * z;
+    }
+    break;
+  }
+  case T8_ECLASS_PYRAMID:
+    /* The pyramid has no multilinear interpolation, hence we treat each face separately. */
+    std::fill (weights, weights + 5, 0);
+    if (z == 0) {
+      weights[0] = (R - x) * (R - y);
+      weights[1] = x * (R - y);
+      weights[2] = (R - x) * y;
+      weights[3] = x * y;
+    }
+    else if (x == R) {
+      weights[1] = R - y;
+      weights[3] = y - z;
+      weights[4] = z;
+    }
+    else if (y == R) {
+      weights[2] = R - x;
+      weights[3] = x - z;
+      weights[4] = z;
+    }
+    else if (x == z) {
+      weights[0] = R - y;
+      weights[2] = y - z;
+      weights[4] = z;
+    }
+    else if (y == z) {
+      weights[0] = R - x;
+      weights[1] = x - z;
+      weights[4] = z;
+    }
+    else {
+      /* The point is inside the pyramid */
+      return 0;
+    }
+    return 1;
+  default:
+    SC_ABORT_NOT_REACHED ();
+  }
+  /* The point lies on the boundary if and only if one of its weights vanishes. */
+  for (int icorner = 0; icorner < t8_eclass_num_vertices[eclass]; icorner++) {
+    if (weights[icorner] == 0) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* Find the representative of a tree corner and compress the path. */
+static size_t
+t8_vtk_corner_find (std::vector<size_t> &corner_parent, size_t corner)
+{
+  while (corner_parent[corner] != corner) {
+    corner_parent[corner] = corner_parent[corner_parent[corner]];
+    corner = corner_parent[corner];
+  }
+  return corner;
+}
+
+/* Return the index of the vertex of an element with the given reference coordinates or -1 if there is none. */
+static int
+t8_vtk_element_find_vertex (const t8_eclass_scheme_c *scheme, const t8_element_t *element, const double coords[3])
+{
+  for (int ivertex = 0; ivertex < scheme->t8_element_num_corners (element); ivertex++) {
+    double vertex_coords[3] = { 0, 0, 0 };
+    scheme->t8_element_vertex_reference_coords (element, ivertex, vertex_coords);
+    /* The reference coordinates of level 0 and level 1 vertices are exact in floating point */
+    if (vertex_coords[0] == coords[0] && vertex_coords[1] == coords[1] && vertex_coords[2] == coords[2]) {
+      return ivertex;
+    }
+  }
+  return -1;
+}
+
+/* Compute the corner of a face neighbor tree that matches a corner on the face of a tree.
+ * We transform across the tree face in the same way as t8_forest_element_face_neighbor:
+ * The child of the root element at the tree corner is transformed to the neighbor tree with
+ * the orientation of the face connection and extruded. The extruded child touches exactly
+ * one corner of the neighbor face, which is the matching corner.
+ * Returns -1 if the geometry places both corners at different positions, as periodic
+ * connections do. Such corners must not share a point. */
+static int
+t8_vtk_neighbor_tree_corner (t8_forest_t forest, const t8_gloidx_t gtree, const t8_eclass_t eclass,
+                             const int tree_face, const int tree_corner, const t8_gloidx_t neigh_gtree,
+                             const t8_eclass_t neigh_eclass, const int neigh_face, const int orientation)
+{
+  t8_eclass_scheme_c *scheme = t8_forest_get_eclass_scheme (forest, eclass);
+  t8_eclass_scheme_c *neigh_scheme = t8_forest_get_eclass_scheme (forest, neigh_eclass);
+  const t8_eclass_t face_class = (t8_eclass_t) t8_eclass_face_types[eclass][tree_face];
+  t8_eclass_scheme_c *face_scheme = t8_forest_get_eclass_scheme (forest, face_class);
+  t8_element_t *root, *face_element, *neigh_root, *neigh;
+  double corner_coords[3] = { 0, 0, 0 }, coords[3] = { 0, 0, 0 };
+
+  /* Find the child of the root element at the tree corner */
+  scheme->t8_element_new (1, &root);
+  scheme->t8_element_set_linear_id (root, 0, 0);
+  scheme->t8_element_vertex_reference_coords (root, tree_corner, corner_coords);
+  const int num_children = scheme->t8_element_num_children (root);
+  t8_element_t **children = T8_ALLOC (t8_element_t *, num_children);
+  scheme->t8_element_new (num_children, children);
+  scheme->t8_element_children (root, num_children, children);
+  int ichild = 0;
+  while (ichild < num_children && t8_vtk_element_find_vertex (scheme, children[ichild], corner_coords) < 0) {
+    ichild++;
+  }
+  T8_ASSERT (ichild < num_children);
+  const t8_element_t *child = children[ichild];
+
+  /* Find the face of the child on the tree face */
+  int child_face = 0;
+  while (!scheme->t8_element_is_root_boundary (child, child_face)
+         || scheme->t8_element_tree_face (child, child_face) != tree_face) {
+    child_face++;
+    T8_ASSERT (child_face < scheme->t8_element_num_faces (child));
+  }
+
+  /* Transform the face of the child to the neighbor tree and extrude it.
+   * The face with the smaller eclass, or the smaller face number if the eclasses match,
+   * is the face that the orientation refers to. */
+  const int eclass_compare = t8_eclass_compare (eclass, neigh_eclass);
+  const int is_smaller = eclass_compare < 0 || (eclass_compare == 0 && tree_face <= neigh_face);
+  const int sign
+    = t8_eclass_face_orientation[eclass][tree_face] == t8_eclass_face_orientation[neigh_eclass][neigh_face];
+  face_scheme->t8_element_new (1, &face_element);
+  scheme->t8_element_boundary_face (child, child_face, face_element, face_scheme);
+  face_scheme->t8_element_transform_face (face_element, face_element, orientation, sign, is_smaller);
+  neigh_scheme->t8_element_new (1, &neigh);
+  (void) neigh_scheme->t8_element_extrude_face (face_element, face_scheme, neigh, neigh_face);
+
+  /* Find the corner of the neighbor face that the extruded element touches */
+  neigh_scheme->t8_element_new (1, &neigh_root);
+  neigh_scheme->t8_element_set_linear_id (neigh_root, 0, 0);
+  int neigh_corner = -1;
+  const int face_type = t8_eclass_face_types[neigh_eclass][neigh_face];
+  for (int iface_vertex = 0; iface_vertex < t8_eclass_num_vertices[face_type]; iface_vertex++) {
+    const int ivertex = t8_face_vertex_to_tree_vertex[neigh_eclass][neigh_face][iface_vertex];
+    neigh_scheme->t8_element_vertex_reference_coords (neigh_root, ivertex, coords);
+    if (t8_vtk_element_find_vertex (neigh_scheme, neigh, coords) >= 0) {
+      T8_ASSERT (neigh_corner < 0);
+      neigh_corner = ivertex;
+    }
+  }
+  T8_ASSERT (neigh_corner >= 0);
+
+  /* Compare the positions of both corners */
+  double position[3], neigh_position[3];
+  t8_cmesh_t cmesh = t8_forest_get_cmesh (forest);
+  t8_geometry_evaluate (cmesh, gtree, corner_coords, 1, position);
+  neigh_scheme->t8_element_vertex_reference_coords (neigh_root, neigh_corner, coords);
+  t8_geometry_evaluate (cmesh, neigh_gtree, coords, 1, neigh_position);
+  if (t8_vec_dist (position, neigh_position) > T8_PRECISION_SQRT_EPS * SC_MAX (1.0, t8_vec_norm (position))) {
+    neigh_corner = -1;
+  }
+
+  neigh_scheme->t8_element_destroy (1, &neigh_root);
+  neigh_scheme->t8_element_destroy (1, &neigh);
+  face_scheme->t8_element_destroy (1, &face_element);
+  scheme->t8_element_destroy (num_children, children);
+  T8_FREE (children);
+  scheme->t8_element_destroy (1, &root);
+  return neigh_corner;
+}
+
+void
+t8_forest_vtk_compute_shared_points (t8_forest_t forest, const int write_ghosts,
+                                     t8_forest_vtk_shared_points_t *shared_points)
+{
+  T8_ASSERT (t8_forest_is_committed (forest));
+  T8_ASSERT (shared_points != NULL);
+
+  const t8_locidx_t num_local_trees = t8_forest_get_num_local_trees (forest);
+  const t8_locidx_t num_ghost_trees = write_ghosts ? t8_forest_ghost_num_trees (forest) : 0;
+  const t8_locidx_t num_trees = num_local_trees + num_ghost_trees;
+  t8_cmesh_t cmesh = t8_forest_get_cmesh (forest);
+
+  /* A ghost tree may have the same global id as a local tree. Each global tree gets one slot. */
+  std::unordered_map<t8_gloidx_t, size_t> tree_slot;
+  std::vector<t8_gloidx_t> slot_gtree;
+  std::vector<t8_eclass_t> slot_eclass;
+  for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+    const t8_gloidx_t gtree = t8_forest_global_tree_id (forest, itree);
+    if (tree_slot.emplace (gtree, slot_gtree.size ()).second) {
+      slot_gtree.push_back (gtree);
+      slot_eclass.push_back (itree < num_local_trees
+                               ? t8_forest_get_tree_class (forest, itree)
+                               : t8_forest_ghost_get_tree_class (forest, itree - num_local_trees));
+    }
+  }
+
+  /* Identify the corners of face connected trees via the face orientation of their connection. */
+  std::vector<size_t> corner_parent (slot_gtree.size () * T8_ECLASS_MAX_CORNERS);
+  std::iota (corner_parent.begin (), corner_parent.end (), 0);
+  for (size_t islot = 0; islot < slot_gtree.size (); islot++) {
+    const t8_locidx_t cmesh_ltree = t8_cmesh_get_local_id (cmesh, slot_gtree[islot]);
+    if (cmesh_ltree < 0) {
+      continue;
+    }
+    const t8_eclass_t eclass = slot_eclass[islot];
+    for (int iface = 0; iface < t8_eclass_num_faces[eclass]; iface++) {
+      int dual_face, orientation;
+      const t8_locidx_t neigh_ltree = t8_cmesh_get_face_neighbor (cmesh, cmesh_ltree, iface, &dual_face, &orientation);
+      if (neigh_ltree < 0) {
+        continue;
+      }
+      const auto neigh_slot = tree_slot.find (t8_cmesh_get_global_id (cmesh, neigh_ltree));
+      if (neigh_slot == tree_slot.end ()) {
+        /* The neighbor tree is not part of the output */
+        continue;
+      }
+      const t8_eclass_t neigh_eclass = slot_eclass[neigh_slot->second];
+      const int face_type = t8_eclass_face_types[eclass][iface];
+      for (int iface_vertex = 0; iface_vertex < t8_eclass_num_vertices[face_type]; iface_vertex++) {
+        const int ivertex = t8_face_vertex_to_tree_vertex[eclass][iface][iface_vertex];
+        const int neigh_vertex = t8_vtk_neighbor_tree_corner (forest, slot_gtree[islot], eclass, iface, ivertex,
+                                                              slot_gtree[neigh_slot->second], neigh_eclass, dual_face,
+                                                              orientation);
+        if (neigh_vertex < 0) {
+          continue;
+        }
+        const size_t root = t8_vtk_corner_find (corner_parent, islot * T8_ECLASS_MAX_CORNERS + ivertex);
+        const size_t neigh_root
+          = t8_vtk_corner_find (corner_parent, neigh_slot->second * T8_ECLASS_MAX_CORNERS + neigh_vertex);
+        corner_parent[SC_MAX (root, neigh_root)] = SC_MIN (root, neigh_root);
+      }
+    }
+  }
+
+  const t8_locidx_t num_elements
+    = t8_forest_get_local_num_elements (forest) + (write_ghosts ? t8_forest_get_num_ghosts (forest) : 0);
+  shared_points->corner_offsets.clear ();
+  shared_points->corner_offsets.reserve (num_elements + 1);
+  shared_points->corner_to_point.clear ();
+  shared_points->coordinates.clear ();
+
+  std::unordered_map<t8_vtk_point_key, t8_locidx_t, t8_vtk_point_key_hash> point_ids;
+  for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+    const int is_ghost = itree >= num_local_trees;
+    const t8_eclass_t tree_class = is_ghost ? t8_forest_ghost_get_tree_class (forest, itree - num_local_trees)
+                                            : t8_forest_get_tree_class (forest, itree);
+    const t8_eclass_scheme_c *scheme = t8_forest_get_eclass_scheme (forest, tree_class);
+    const t8_gloidx_t gtree = t8_forest_global_tree_id (forest, itree);
+    const size_t slot = tree_slot[gtree];
+    /* All reference coordinates of elements are multiples of 2^-maxlevel */
+    const uint64_t root_len = (uint64_t) 1 << SC_MIN (scheme->t8_element_maxlevel (), 30);
+    const t8_locidx_t num_tree_elements = is_ghost ? t8_forest_ghost_tree_num_elements (forest, itree - num_local_trees)
+                                                   : t8_forest_get_tree_num_elements (forest, itree);
+
+    for (t8_locidx_t ielement = 0; ielement < num_tree_elements; ielement++) {
+      const t8_element_t *element = is_ghost ? t8_forest_ghost_get_element (forest, itree - num_local_trees, ielement)
+                                             : t8_forest_get_element_in_tree (forest, itree, ielement);
+      const t8_element_shape_t shape = scheme->t8_element_shape (element);
+      shared_points->corner_offsets.push_back (shared_points->corner_to_point.size ());
+      for (int ivertex = 0; ivertex < t8_eclass_num_vertices[shape]; ivertex++) {
+        const double *element_ref_coords = t8_forest_vtk_point_to_element_ref_coords[shape][ivertex];
+        double tree_ref_coords[3] = { 0, 0, 0 };
+        scheme->t8_element_reference_coords (element, element_ref_coords, 1, tree_ref_coords);
+
+        uint64_t coords[3];
+        for (int idim = 0; idim < 3; idim++) {
+          coords[idim] = (uint64_t) (tree_ref_coords[idim] * root_len + 0.5);
+          T8_ASSERT ((double) coords[idim] == tree_ref_coords[idim] * root_len);
+        }
+
+        t8_vtk_point_key key;
+        key.values.fill (0);
+        uint64_t weights[T8_ECLASS_MAX_CORNERS];
+        if (!t8_vtk_tree_corner_weights (tree_class, coords, root_len, weights)) {
+          /* The point is inside the tree */
+          key.values[1] = (uint64_t) gtree;
+          std::copy (coords, coords + 3, key.values.begin () + 2);
+        }
+        else {
+          /* Collect the corners with nonzero weight and normalize the weights,
+           * such that the key does not depend on the scaling of the tree. */
+          std::array<std::pair<uint64_t, uint64_t>, T8_ECLASS_MAX_CORNERS> corner_weights;
+          int num_weights = 0;
+          uint64_t divisor = 0;
+          for (int icorner = 0; icorner < t8_eclass_num_vertices[tree_class]; icorner++) {
+            if (weights[icorner] != 0) {
+              const size_t corner = t8_vtk_corner_find (corner_parent, slot * T8_ECLASS_MAX_CORNERS + icorner);
+              corner_weights[num_weights++] = std::make_pair ((uint64_t) corner, weights[icorner]);
+              divisor = std::gcd (divisor, weights[icorner]);
+            }
+          }
+          T8_ASSERT (0 < num_weights && num_weights <= T8_ECLASS_MAX_CORNERS_2D);
+          std::sort (corner_weights.begin (), corner_weights.begin () + num_weights);
+          key.values[0] = num_weights;
+          for (int iweight = 0; iweight < num_weights; iweight++) {
+            key.values[1 + 2 * iweight] = corner_weights[iweight].first;
+            key.values[2 + 2 * iweight] = corner_weights[iweight].second / divisor;
+          }
+        }
+
+        const t8_locidx_t num_points = shared_points->coordinates.size () / 3;
+        const auto point = point_ids.emplace (key, num_points);
+        if (point.second) {
+          /* This is a new point, compute its coordinates */
+          shared_points->coordinates.resize (3 * (num_points + 1));
+          t8_forest_element_from_ref_coords (forest, itree, element, element_ref_coords, 1,
+                                             shared_points->coordinates.data () + 3 * num_points);
+        }
+        shared_points->corner_to_point.push_back (point.first->second);
+      }
+    }
+  }
+  shared_points->corner_offsets.push_back (shared_points->corner_to_point.size ());
+  T8_ASSERT ((t8_locidx_t) shared_points->corner_offsets.size () == num_elements + 1);
+}
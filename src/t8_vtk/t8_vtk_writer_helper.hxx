@@ -26,6 +26,7 @@
 #include <t8.h>
 #include <t8_element.hxx>
 #include <t8_forest/t8_forest.h>
+#include <vector>
 
 #define T8_FOREST_VTK_QUADRATIC_ELEMENT_MAX_CORNERS 20
 /** Lookup table for number of nodes for curved eclasses. */
@@ -226,4 +227,36 @@ template <typename grid_t>
 int
 grid_element_level (const grid_t grid, const t8_locidx_t itree, const t8_element_t *element);
 
+/** The points of the vtk output of a forest, where each point that is shared
+ * between several elements is stored only once.
+ * The elements are ordered as in the output, that is first the local elements
+ * and then, if written, the ghost elements. Their corners are ordered as vtk corners.
+ */
+struct t8_forest_vtk_shared_points_t
+{
+  std::vector<t8_locidx_t> corner_offsets;  /**< For each element the index of its first corner. Has one entry
+                                                 more than elements, the last entry is the number of corners. */
+  std::vector<t8_locidx_t> corner_to_point; /**< For each element corner the index of its point. */
+  std::vector<double> coordinates;          /**< The coordinates of the points, three per point. */
+};
+
+/**
+ * Compute the shared points of the linear vtk cells of a forest.
+ * Points are identified exactly via integer reference coordinates, no floating point
+ * comparison of the output coordinates takes place. Inside a tree, two element corners
+ * are the same point if their integer reference coordinates match. On the tree boundary,
+ * a point is identified by its interpolation weights with respect to the tree corners,
+ * where the corners of face connected trees are matched with the face orientation of their
+ * coarse mesh connection. Corners that the geometry places at different positions, as periodic
+ * connections do, are not matched.
+ * Points on tree faces are only merged if both trees are known to this process.
+ *
+ * \param[in] forest A committed forest.
+ * \param[in] write_ghosts If true, the ghost elements are included.
+ * \param[out] shared_points The shared points of \a forest.
+ */
+void
+t8_forest_vtk_compute_shared_points (t8_forest_t forest, const int write_ghosts,
+                                     t8_forest_vtk_shared_points_t *shared_points);
+
 #endif /* T8_VTK_WRITER_HELPER */
@@ -21,10 +21,16 @@
 */
 
 #include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
 #include <t8_vtk/t8_vtk_writer.hxx>
 #include <t8_cmesh.hxx>
 #include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_cmesh/t8_cmesh_helpers.h>
 #include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_geometry/t8_geometry_implementations/t8_geometry_linear.hxx>
+#include <t8_vec.h>
 
 #include <t8_vtk/t8_vtk_writer.h>
 
@@ -170,3 +176,245 @@ REGISTER_TYPED_TEST_SUITE_P (vtk_writer_test, write_vtk, c_interface);
 using GridTypes = ::testing::Types<t8_cmesh_t, t8_forest_t>;
 
 INSTANTIATE_TYPED_TEST_SUITE_P (Test_vtk_writer, vtk_writer_test, GridTypes, );
+
+/**
+ * Test the inbuilt writer in all data formats.
+ *
+ */
+class vtk_writer_format_test: public testing::TestWithParam<t8_vtk_format_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    forest = make_grid<t8_forest_t> ();
+    const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+    element_values = T8_ALLOC (double, num_elements);
+    for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+      element_values[ielement] = ielement;
+    }
+    vtk_data.type = T8_VTK_SCALAR;
+    snprintf (vtk_data.description, BUFSIZ, "values");
+    vtk_data.data = element_values;
+  }
+
+  void
+  TearDown () override
+  {
+    int mpirank;
+    int mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+    SC_CHECK_MPI (mpiret);
+
+    T8_FREE (element_values);
+    t8_forest_unref (&forest);
+    if (fileprefix[0] != '\0') {
+      /* Each process removes its own piece, process 0 also the .pvtu file */
+      char filename[BUFSIZ];
+      snprintf (filename, BUFSIZ, "%s_%04d.vtu", fileprefix, mpirank);
+      remove (filename);
+      if (mpirank == 0) {
+        snprintf (filename, BUFSIZ, "%s.pvtu", fileprefix);
+        remove (filename);
+      }
+    }
+  }
+
+  /* Check that the .vtu piece of this process is written in the format of the test parameter. */
+  void
+  check_format ()
+  {
+    int mpirank;
+    int mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+    SC_CHECK_MPI (mpiret);
+
+    char filename[BUFSIZ];
+    snprintf (filename, BUFSIZ, "%s_%04d.vtu", fileprefix, mpirank);
+    std::ifstream vtufile (filename, std::ios::binary);
+    ASSERT_TRUE (vtufile.good ()) << "Could not open " << filename;
+    std::stringstream content_stream;
+    content_stream << vtufile.rdbuf ();
+    std::string content = content_stream.str ();
+    /* Only the xml part is parsed, the appended block may contain arbitrary bytes */
+    const size_t appended_pos = content.find ("<AppendedData");
+    const std::string xml = content.substr (0, appended_pos);
+
+    t8_vtk_format_t format = GetParam ();
+#ifndef SC_HAVE_ZLIB
+    if (format == T8_VTK_BINARY_COMPRESSED) {
+      format = T8_VTK_BINARY;
+    }
+#endif
+    const char *expected_format = format == T8_VTK_ASCII ? "ascii" : format == T8_VTK_APPENDED ? "appended" : "binary";
+    const std::string vtkfile_header = xml.substr (0, xml.find ('>', xml.find ("<VTKFile")));
+    EXPECT_EQ (vtkfile_header.find ("compressor=\"vtkZLibDataCompressor\"") != std::string::npos,
+               format == T8_VTK_BINARY_COMPRESSED);
+    EXPECT_EQ (vtkfile_header.find ("header_type=\"UInt64\"") != std::string::npos, format == T8_VTK_APPENDED);
+    EXPECT_EQ (appended_pos != std::string::npos, format == T8_VTK_APPENDED);
+
+    /* Every data array has to carry the expected format attribute */
+    int num_data_arrays = 0;
+    for (size_t pos = xml.find ("<DataArray"); pos != std::string::npos; pos = xml.find ("<DataArray", pos + 1)) {
+      const std::string tag = xml.substr (pos, xml.find ('>', pos) - pos);
+      EXPECT_NE (tag.find (std::string ("format=\"") + expected_format + "\""), std::string::npos) << tag;
+      num_data_arrays++;
+    }
+    EXPECT_GT (num_data_arrays, 0);
+  }
+
+  t8_forest_t forest;
+  double *element_values;
+  t8_vtk_data_field_t vtk_data;
+  char fileprefix[BUFSIZ] = "";
+};
+
+TEST_P (vtk_writer_format_test, write_format)
+{
+  snprintf (fileprefix, BUFSIZ, "test_vtk_format_%i", (int) GetParam ());
+  EXPECT_TRUE (t8_forest_vtk_write_file_format (forest, fileprefix, GetParam (), 1, 1, 1, 1, 0, 0, 1, &vtk_data));
+  check_format ();
+}
+
+TEST_P (vtk_writer_format_test, write_shared_points)
+{
+  snprintf (fileprefix, BUFSIZ, "test_vtk_shared_points_%i", (int) GetParam ());
+  EXPECT_TRUE (t8_forest_vtk_write_file_format (forest, fileprefix, GetParam (), 1, 1, 1, 1, 0, 1, 1, &vtk_data));
+  check_format ();
+}
+
+INSTANTIATE_TEST_SUITE_P (Test_vtk_writer_format, vtk_writer_format_test,
+                          testing::Values (T8_VTK_ASCII, T8_VTK_BINARY, T8_VTK_BINARY_COMPRESSED, T8_VTK_APPENDED));
+
+/**
+ * Check that shared points are merged inside trees and across tree faces.
+ * A uniform forest of level l on the unit cube has (2^l + 1)^dim distinct vertices.
+ */
+class vtk_writer_shared_points: public testing::TestWithParam<t8_eclass_t> {
+};
+
+TEST_P (vtk_writer_shared_points, count_points)
+{
+  const t8_eclass_t eclass = GetParam ();
+  const int level = 3;
+  /* Use a single process, such that all trees are local */
+  t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_SELF, 0, 0, 0);
+  t8_forest_t forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level, 0, sc_MPI_COMM_SELF);
+
+  t8_forest_vtk_shared_points_t shared_points;
+  t8_forest_vtk_compute_shared_points (forest, 0, &shared_points);
+
+  const int dim = t8_eclass_to_dimension[eclass];
+  size_t expected_num_points = 1;
+  for (int idim = 0; idim < dim; idim++) {
+    expected_num_points *= (1 << level) + 1;
+  }
+  EXPECT_EQ (shared_points.coordinates.size () / 3, expected_num_points);
+  ASSERT_EQ ((t8_locidx_t) shared_points.corner_offsets.size (), t8_forest_get_local_num_elements (forest) + 1);
+  EXPECT_EQ ((size_t) shared_points.corner_offsets.back (), shared_points.corner_to_point.size ());
+
+  t8_forest_unref (&forest);
+}
+
+INSTANTIATE_TEST_SUITE_P (Test_vtk_writer_shared_points, vtk_writer_shared_points,
+                          testing::Values (T8_ECLASS_LINE, T8_ECLASS_QUAD, T8_ECLASS_TRIANGLE, T8_ECLASS_HEX,
+                                           T8_ECLASS_TET, T8_ECLASS_PRISM));
+
+/* Check that the point of each element corner lies at the position of the corner. */
+static void
+t8_test_vtk_shared_points_positions (t8_forest_t forest, const t8_forest_vtk_shared_points_t *shared_points)
+{
+  t8_locidx_t ielement = 0;
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    const t8_eclass_scheme_c *scheme = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    for (t8_locidx_t ielem_tree = 0; ielem_tree < t8_forest_get_tree_num_elements (forest, itree); ielem_tree++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielem_tree);
+      const t8_element_shape_t shape = scheme->t8_element_shape (element);
+      for (int ivertex = 0; ivertex < t8_eclass_num_vertices[shape]; ivertex++) {
+        const double *ref_coords = t8_forest_vtk_point_to_element_ref_coords[shape][ivertex];
+        double coords[3];
+        t8_forest_element_from_ref_coords (forest, itree, element, ref_coords, 1, coords);
+        const t8_locidx_t point = shared_points->corner_to_point[shared_points->corner_offsets[ielement] + ivertex];
+        EXPECT_LT (t8_vec_dist (coords, shared_points->coordinates.data () + 3 * point), T8_PRECISION_SQRT_EPS)
+          << "Element " << ielement << " corner " << ivertex;
+      }
+      ielement++;
+    }
+  }
+}
+
+/* Create two quads or hexes that share the face x = 1. The second tree is the first one rotated
+ * by 90 degrees around the z-axis, such that their face connection has a nontrivial orientation. */
+static t8_cmesh_t
+t8_test_vtk_rotated_cmesh (const t8_eclass_t eclass)
+{
+  const int num_vertices = t8_eclass_num_vertices[eclass];
+  const t8_eclass_t eclasses[2] = { eclass, eclass };
+  double vertices[2 * T8_ECLASS_MAX_CORNERS * 3];
+  t8_cmesh_t cmesh;
+
+  for (int ivertex = 0; ivertex < num_vertices; ivertex++) {
+    const double x = ivertex & 1, y = (ivertex >> 1) & 1, z = (ivertex >> 2) & 1;
+    vertices[3 * ivertex] = x;
+    vertices[3 * ivertex + 1] = y;
+    vertices[3 * ivertex + 2] = z;
+    vertices[3 * (num_vertices + ivertex)] = 2 - y;
+    vertices[3 * (num_vertices + ivertex) + 1] = x;
+    vertices[3 * (num_vertices + ivertex) + 2] = z;
+  }
+  t8_cmesh_init (&cmesh);
+  t8_cmesh_register_geometry<t8_geometry_linear> (cmesh, t8_eclass_to_dimension[eclass]);
+  for (int itree = 0; itree < 2; itree++) {
+    t8_cmesh_set_tree_class (cmesh, itree, eclass);
+    t8_cmesh_set_tree_vertices (cmesh, itree, vertices + 3 * num_vertices * itree, num_vertices);
+  }
+  t8_cmesh_set_join_by_vertices (cmesh, 2, eclasses, vertices, NULL, 0);
+  t8_cmesh_commit (cmesh, sc_MPI_COMM_SELF);
+  return cmesh;
+}
+
+/**
+ * Check that the corners of trees with a rotated face connection are matched via the orientation
+ * of the connection and that the corners at periodic connections are not merged.
+ */
+TEST (vtk_writer_shared_points_connection, rotated_trees)
+{
+  const int level = 2;
+  const t8_eclass_t eclasses[2] = { T8_ECLASS_QUAD, T8_ECLASS_HEX };
+  for (const t8_eclass_t eclass : eclasses) {
+    t8_cmesh_t cmesh = t8_test_vtk_rotated_cmesh (eclass);
+    t8_forest_t forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level, 0, sc_MPI_COMM_SELF);
+
+    t8_forest_vtk_shared_points_t shared_points;
+    t8_forest_vtk_compute_shared_points (forest, 0, &shared_points);
+
+    /* The two trees form a box of 2 x 1 (x 1) trees */
+    size_t expected_num_points = 2 * (1 << level) + 1;
+    for (int idim = 1; idim < t8_eclass_to_dimension[eclass]; idim++) {
+      expected_num_points *= (1 << level) + 1;
+    }
+    EXPECT_EQ (shared_points.coordinates.size () / 3, expected_num_points) << t8_eclass_to_string[eclass];
+    t8_test_vtk_shared_points_positions (forest, &shared_points);
+
+    t8_forest_unref (&forest);
+  }
+}
+
+TEST (vtk_writer_shared_points_connection, periodic)
+{
+  const int level = 2;
+  for (int dim = 2; dim <= 3; dim++) {
+    t8_cmesh_t cmesh = t8_cmesh_new_periodic (sc_MPI_COMM_SELF, dim);
+    t8_forest_t forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level, 0, sc_MPI_COMM_SELF);
+
+    t8_forest_vtk_shared_points_t shared_points;
+    t8_forest_vtk_compute_shared_points (forest, 0, &shared_points);
+
+    /* The periodic boundaries keep their own points */
+    size_t expected_num_points = 1;
+    for (int idim = 0; idim < dim; idim++) {
+      expected_num_points *= (1 << level) + 1;
+    }
+    EXPECT_EQ (shared_points.coordinates.size () / 3, expected_num_points) << "dimension " << dim;
+    t8_test_vtk_shared_points_positions (forest, &shared_points);
+
+    t8_forest_unref (&forest);
+  }
+}
@@ -0,0 +1,82 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element types in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+
+#include <gtest/gtest.h>
+#include <unistd.h> /* Needed to check for file access */
+#include <t8.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh_readmshfile.h>
+#include "t8_cmesh/t8_cmesh_trees.h"
+
+/* In this file we test the parallel reader for binary msh files of version 4.1.
+ * We read the binary example file on all processes and check whether each process
+ * got the correct trees with the correct vertices and face neighbors. */
+
+TEST (t8_cmesh_readmshfile_parallel, test_msh_file_vers4_bin)
+{
+  const char fileprefix[BUFSIZ - 4] = "test/testfiles/test_msh_file_vers4_bin";
+  char filename[BUFSIZ];
+
+  /* Description of the properties of the example msh-file. */
+  const int number_elements = 4;
+  const int vertex[6][2] = { { 0, 0 }, { 2, 0 }, { 4, 0 }, { 1, 2 }, { 3, 2 }, { 2, 4 } };
+  const int elements[4][3] = { { 0, 1, 3 }, { 1, 4, 3 }, { 1, 2, 4 }, { 3, 4, 5 } };
+  const int face_neigh_elem[4][3] = { { 1, -1, -1 }, { 3, 0, 2 }, { -1, 1, -1 }, { -1, -1, 1 } };
+
+  snprintf (filename, BUFSIZ, "%s.msh", fileprefix);
+  ASSERT_FALSE (access (filename, R_OK)) << "Could not open file " << filename;
+
+  t8_cmesh_t cmesh = t8_cmesh_from_msh_file_parallel (fileprefix, sc_MPI_COMM_WORLD, 2);
+  ASSERT_TRUE (cmesh != NULL) << "Could not read cmesh from binary version 4.1.";
+  ASSERT_TRUE (t8_cmesh_is_committed (cmesh)) << "Cmesh commit failed";
+  ASSERT_TRUE (t8_cmesh_is_partitioned (cmesh)) << "Cmesh is not partitioned.";
+  ASSERT_TRUE (t8_cmesh_trees_is_face_consistent (cmesh, cmesh->trees)) << "Cmesh face consistency failed.";
+  ASSERT_EQ (t8_cmesh_get_num_trees (cmesh), number_elements) << "Number of elements in msh-file was read incorrectly.";
+
+  const t8_locidx_t num_local_trees = t8_cmesh_get_num_local_trees (cmesh);
+  for (t8_locidx_t ltree_it = 0; ltree_it < num_local_trees; ltree_it++) {
+    const t8_gloidx_t gtree = t8_cmesh_get_global_id (cmesh, ltree_it);
+    ASSERT_EQ (t8_cmesh_get_tree_class (cmesh, ltree_it), T8_ECLASS_TRIANGLE)
+      << "Element type in msh-file was read incorrectly.";
+    const double *vertices = t8_cmesh_get_tree_vertices (cmesh, ltree_it);
+    for (int i = 0; i < 3; i++) {
+      EXPECT_EQ (vertex[elements[gtree][i]][0], (int) vertices[3 * i]) << "x coordinate was read incorrectly";
+      EXPECT_EQ (vertex[elements[gtree][i]][1], (int) vertices[3 * i + 1]) << "y coordinate was read incorrectly";
+
+      /* The neighbor may be a local tree or a ghost */
+      const t8_locidx_t neighbor = t8_cmesh_get_face_neighbor (cmesh, ltree_it, i, NULL, NULL);
+      const t8_gloidx_t gneighbor = neighbor < 0 ? -1 : t8_cmesh_get_global_id (cmesh, neighbor);
+      EXPECT_EQ (gneighbor, face_neigh_elem[gtree][i])
+        << "The face neighbor of tree " << gtree << " was read incorrectly.";
+    }
+  }
+  t8_cmesh_destroy (&cmesh);
+}
+
+TEST (t8_cmesh_readmshfile_parallel, test_msh_file_vers4_ascii)
+{
+  /* The parallel reader only supports binary files and must fail on all processes. */
+  t8_cmesh_t cmesh = t8_cmesh_from_msh_file_parallel ("test/testfiles/test_msh_file_vers4_ascii", sc_MPI_COMM_WORLD, 2);
+  ASSERT_TRUE (cmesh == NULL) << "Expected fail of reading ascii msh file, but did not fail.";
+}
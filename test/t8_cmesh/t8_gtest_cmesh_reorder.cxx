@@ -0,0 +1,197 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we build a line of quad trees whose tree ids are shuffled within
+ * blocks of consecutive trees. Each process owns one block. After reordering
+ * the trees along a space-filling curve or by reverse Cuthill-McKee, trees that
+ * are adjacent in the line must have consecutive tree ids. */
+
+#include <gtest/gtest.h>
+#include <t8_cmesh.hxx>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_geometry/t8_geometry_with_vertices.h>
+#include <t8_geometry/t8_geometry_implementations/t8_geometry_linear.hxx>
+#include <vector>
+
+/* The number of trees per process and the stride used to shuffle them */
+#define T8_TEST_REORDER_BLOCK 10
+#define T8_TEST_REORDER_STRIDE 3
+
+/* The tree id of the tree at position \a position in the line. */
+static t8_gloidx_t
+t8_test_reorder_tree_id (const t8_gloidx_t position)
+{
+  const t8_gloidx_t block_start = position - position % T8_TEST_REORDER_BLOCK;
+  return block_start + ((position - block_start) * T8_TEST_REORDER_STRIDE) % T8_TEST_REORDER_BLOCK;
+}
+
+/* Reorder the \a num_positions trees starting at position \a first_position on a
+ * single process and return the new global id of the tree at each position.
+ * A partitioned cmesh is reordered within each process's range, so the ids of
+ * a block must match this reference shifted to the start of the block. */
+static std::vector<t8_gloidx_t>
+t8_test_reorder_serial_reference (const t8_cmesh_reorder_type_t reorder, const t8_gloidx_t first_position,
+                                  const t8_gloidx_t num_positions)
+{
+  t8_cmesh_t cmesh;
+
+  t8_cmesh_init (&cmesh);
+  t8_cmesh_register_geometry<t8_geometry_linear> (cmesh, 2);
+  for (t8_gloidx_t position = first_position; position < first_position + num_positions; position++) {
+    const t8_gloidx_t tree_id = t8_test_reorder_tree_id (position) - first_position;
+    const double x = (double) position;
+    const double vertices[12] = { x, 0, 0, x + 1, 0, 0, x, 1, 0, x + 1, 1, 0 };
+    t8_cmesh_set_tree_class (cmesh, tree_id, T8_ECLASS_QUAD);
+    t8_cmesh_set_tree_vertices (cmesh, tree_id, vertices, 4);
+    if (position + 1 < first_position + num_positions) {
+      t8_cmesh_set_join (cmesh, tree_id, t8_test_reorder_tree_id (position + 1) - first_position, 1, 0, 0);
+    }
+  }
+  t8_cmesh_set_reorder (cmesh, reorder);
+  t8_cmesh_commit (cmesh, sc_MPI_COMM_SELF);
+
+  std::vector<t8_gloidx_t> ids (num_positions);
+  for (t8_locidx_t itree = 0; itree < t8_cmesh_get_num_local_trees (cmesh); itree++) {
+    const double *vertices = t8_cmesh_get_tree_vertices (cmesh, itree);
+    ids[(t8_gloidx_t) vertices[0] - first_position] = first_position + itree;
+  }
+  t8_cmesh_destroy (&cmesh);
+  return ids;
+}
+
+class cmesh_reorder: public testing::TestWithParam<std::tuple<t8_cmesh_reorder_type_t, int>> {
+ protected:
+  void
+  SetUp () override
+  {
+    const t8_cmesh_reorder_type_t reorder = std::get<0> (GetParam ());
+    const int partitioned = std::get<1> (GetParam ());
+    int mpisize, mpirank;
+    int mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+    SC_CHECK_MPI (mpiret);
+    mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+    SC_CHECK_MPI (mpiret);
+
+    const t8_gloidx_t num_trees = (t8_gloidx_t) T8_TEST_REORDER_BLOCK * mpisize;
+    const t8_gloidx_t first_position = partitioned ? (t8_gloidx_t) T8_TEST_REORDER_BLOCK * mpirank : 0;
+    const t8_gloidx_t last_position = partitioned ? first_position + T8_TEST_REORDER_BLOCK - 1 : num_trees - 1;
+
+    t8_cmesh_init (&cmesh);
+    t8_cmesh_register_geometry<t8_geometry_linear> (cmesh, 2);
+    for (t8_gloidx_t position = SC_MAX (first_position - 1, 0); position <= SC_MIN (last_position + 1, num_trees - 1);
+         position++) {
+      const t8_gloidx_t tree_id = t8_test_reorder_tree_id (position);
+      t8_cmesh_set_tree_class (cmesh, tree_id, T8_ECLASS_QUAD);
+      if (first_position <= position && position <= last_position) {
+        const double x = (double) position;
+        const double vertices[12] = { x, 0, 0, x + 1, 0, 0, x, 1, 0, x + 1, 1, 0 };
+        t8_cmesh_set_tree_vertices (cmesh, tree_id, vertices, 4);
+        if (position + 1 < num_trees) {
+          t8_cmesh_set_join (cmesh, tree_id, t8_test_reorder_tree_id (position + 1), 1, 0, 0);
+        }
+      }
+      else if (position == first_position - 1) {
+        t8_cmesh_set_join (cmesh, tree_id, t8_test_reorder_tree_id (first_position), 1, 0, 0);
+      }
+    }
+    if (partitioned) {
+      t8_cmesh_set_partition_range (cmesh, 3, first_position, last_position);
+    }
+    t8_cmesh_set_reorder (cmesh, reorder);
+    t8_cmesh_commit (cmesh, sc_MPI_COMM_WORLD);
+  }
+
+  void
+  TearDown () override
+  {
+    t8_cmesh_destroy (&cmesh);
+  }
+
+  t8_cmesh_t cmesh;
+};
+
+TEST_P (cmesh_reorder, neighbors_are_consecutive)
+{
+  const t8_cmesh_reorder_type_t reorder = std::get<0> (GetParam ());
+  const t8_locidx_t num_local_trees = t8_cmesh_get_num_local_trees (cmesh);
+  ASSERT_EQ (num_local_trees, std::get<1> (GetParam ()) ? T8_TEST_REORDER_BLOCK : t8_cmesh_get_num_trees (cmesh));
+
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const double *vertices = t8_cmesh_get_tree_vertices (cmesh, itree);
+    for (int face = 0; face < 2; face++) {
+      int dual_face, orientation;
+      const t8_locidx_t neighbor = t8_cmesh_get_face_neighbor (cmesh, itree, face, &dual_face, &orientation);
+      if (neighbor < 0 || neighbor >= num_local_trees) {
+        /* Boundary or ghost */
+        continue;
+      }
+      EXPECT_EQ (dual_face, 1 - face);
+      EXPECT_EQ (orientation, 0);
+      /* The local neighbor is the adjacent tree in the line */
+      const double *neighbor_vertices = t8_cmesh_get_tree_vertices (cmesh, neighbor);
+      EXPECT_EQ (neighbor_vertices[0], vertices[0] + (face == 1 ? 1 : -1));
+      if (reorder == T8_CMESH_REORDER_SFC) {
+        /* The curve follows the x-axis */
+        EXPECT_EQ (neighbor, itree + (face == 1 ? 1 : -1));
+      }
+      else {
+        /* A path is ordered from one of its ends */
+        EXPECT_EQ (abs (neighbor - itree), 1);
+      }
+    }
+  }
+}
+
+/* Local trees and ghosts must carry the global id that the owning block gets
+ * when it is reordered on its own. */
+TEST_P (cmesh_reorder, global_ids_match_serial_reference)
+{
+  const t8_cmesh_reorder_type_t reorder = std::get<0> (GetParam ());
+  const t8_gloidx_t num_trees = t8_cmesh_get_num_trees (cmesh);
+  const t8_gloidx_t block_size = std::get<1> (GetParam ()) ? T8_TEST_REORDER_BLOCK : num_trees;
+  const t8_locidx_t num_local_trees = t8_cmesh_get_num_local_trees (cmesh);
+
+  /* The reordered global id of the tree at \a position */
+  auto reference_id = [&] (const t8_gloidx_t position) {
+    const t8_gloidx_t block_start = position - position % block_size;
+    return t8_test_reorder_serial_reference (reorder, block_start, block_size)[position - block_start];
+  };
+
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const t8_gloidx_t position = (t8_gloidx_t) t8_cmesh_get_tree_vertices (cmesh, itree)[0];
+    EXPECT_EQ (t8_cmesh_get_global_id (cmesh, itree), reference_id (position));
+    for (int face = 0; face < 2; face++) {
+      int dual_face, orientation;
+      const t8_locidx_t neighbor = t8_cmesh_get_face_neighbor (cmesh, itree, face, &dual_face, &orientation);
+      if (neighbor < num_local_trees) {
+        /* Boundary or local tree */
+        continue;
+      }
+      EXPECT_EQ (dual_face, 1 - face);
+      EXPECT_EQ (t8_cmesh_get_global_id (cmesh, neighbor), reference_id (position + (face == 1 ? 1 : -1)));
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_cmesh_reorder, cmesh_reorder,
+                          testing::Combine (testing::Values (T8_CMESH_REORDER_SFC, T8_CMESH_REORDER_RCM),
+                                            testing::Values (0, 1)));
@@ -0,0 +1,108 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we save a replicated or partitioned hypercube cmesh to a binary
+ * file and load it again on the same communicator. The loaded cmesh must be
+ * equal to the saved one and must be usable to build a forest. */
+
+#include <gtest/gtest.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_cmesh/t8_cmesh_trees.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_forest/t8_forest_general.h>
+#include <test/t8_gtest_macros.hxx>
+
+class cmesh_save_binary: public testing::TestWithParam<std::tuple<t8_eclass_t, int>> {
+ protected:
+  void
+  SetUp () override
+  {
+    const t8_eclass_t eclass = std::get<0> (GetParam ());
+    const int do_partition = std::get<1> (GetParam ());
+    cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, do_partition, 0);
+    snprintf (filename, BUFSIZ, "test_cmesh_save_binary_%s_%i.t8cmesh", t8_eclass_to_string[eclass], do_partition);
+  }
+  void
+  TearDown () override
+  {
+    int mpirank;
+    int mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+    SC_CHECK_MPI (mpiret);
+
+    t8_cmesh_unref (&cmesh);
+    /* All processes are done with the file before it is removed */
+    mpiret = sc_MPI_Barrier (sc_MPI_COMM_WORLD);
+    SC_CHECK_MPI (mpiret);
+    if (mpirank == 0) {
+      remove (filename);
+    }
+  }
+  t8_cmesh_t cmesh;
+  char filename[BUFSIZ];
+};
+
+TEST_P (cmesh_save_binary, save_and_load)
+{
+  ASSERT_TRUE (t8_cmesh_save_binary (cmesh, filename, sc_MPI_COMM_WORLD));
+  t8_cmesh_t cmesh_loaded = t8_cmesh_load_binary (filename, sc_MPI_COMM_WORLD);
+  ASSERT_NE (cmesh_loaded, nullptr);
+
+  ASSERT_TRUE (t8_cmesh_is_committed (cmesh_loaded));
+  EXPECT_TRUE (t8_cmesh_trees_is_face_consistent (cmesh_loaded, cmesh_loaded->trees));
+  EXPECT_TRUE (t8_cmesh_is_equal (cmesh, cmesh_loaded));
+
+  /* The loaded cmesh can be used to build a forest */
+  t8_cmesh_ref (cmesh);
+  t8_forest_t forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 1, 0, sc_MPI_COMM_WORLD);
+  t8_forest_t forest_loaded
+    = t8_forest_new_uniform (cmesh_loaded, t8_scheme_new_default_cxx (), 1, 0, sc_MPI_COMM_WORLD);
+  EXPECT_EQ (t8_forest_get_global_num_elements (forest_loaded), t8_forest_get_global_num_elements (forest));
+  t8_forest_unref (&forest_loaded);
+  t8_forest_unref (&forest);
+}
+
+TEST_P (cmesh_save_binary, reject_text_file)
+{
+  int mpirank;
+  int mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+
+  /* A file that is not a binary cmesh file must not be loaded */
+  int file_written = 0;
+  if (mpirank == 0) {
+    FILE *fp = fopen (filename, "w");
+    if (fp != NULL) {
+      fprintf (fp, "This is not a binary cmesh file, but it is long enough to fill a header.\n"
+                   "It consists of plain text only and thus has the wrong magic bytes.\n");
+      file_written = !fclose (fp);
+    }
+  }
+  /* All processes learn whether the file could be written, such that they fail together */
+  mpiret = sc_MPI_Bcast (&file_written, 1, sc_MPI_INT, 0, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  ASSERT_TRUE (file_written);
+  EXPECT_EQ (t8_cmesh_load_binary (filename, sc_MPI_COMM_WORLD), nullptr);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_cmesh_save_binary, cmesh_save_binary,
+                          testing::Combine (AllEclasses, testing::Values (0, 1)));
@@ -21,6 +21,7 @@
 */
 
 #include <gtest/gtest.h>
+#include <vector>
 #include <t8.h>
 #include <t8_eclass.h>
 #include <t8_cmesh.h>
@@ -438,6 +439,40 @@ TEST (t8_cmesh_set_join_by_vertices, test_cmesh_set_join_by_vertices)
   }
 }
 
+/* Join two quads whose common face is shifted through the domain in small steps, such that
+ * the face centroids cross cell boundaries of the hashing grid. The vertices of the common face
+ * differ by a few ulps between the two trees. */
+TEST (t8_cmesh_set_join_by_vertices, test_cmesh_set_join_by_vertices_perturbed)
+{
+  const t8_eclass_t eclasses[2] = { T8_ECLASS_QUAD, T8_ECLASS_QUAD };
+  const int num_steps = 1000;
+
+  for (int istep = 0; istep < num_steps; istep++) {
+    std::vector<double> vertices (2 * T8_ECLASS_MAX_CORNERS * T8_ECLASS_MAX_DIM, 0.0);
+    const double x_face = 0.5 + istep * 1.0e-12;
+    /* The x coordinates of the vertices of both quads. Vertices 1 and 3 of the first quad
+     * coincide with vertices 0 and 2 of the second one up to rounding. */
+    const double x_lower = x_face * (1 + 2 * T8_PRECISION_EPS);
+    const double x_upper = x_face * (1 - T8_PRECISION_EPS);
+    const double x_coords[2][4] = { { 0.0, x_face, 0.0, x_face }, { x_lower, 1.0, x_upper, 1.0 } };
+    for (int itree = 0; itree < 2; itree++) {
+      for (int ivert = 0; ivert < 4; ivert++) {
+        vertices[T8_3D_TO_1D (2, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, 0)] = x_coords[itree][ivert];
+        vertices[T8_3D_TO_1D (2, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, 1)] = ivert / 2;
+      }
+    }
+
+    int *conn = NULL;
+    t8_cmesh_set_join_by_vertices (NULL, 2, eclasses, vertices.data (), &conn, 1);
+    EXPECT_EQ (conn[T8_3D_TO_1D (2, T8_ECLASS_MAX_FACES, 3, 0, 1, 0)], 1) << "step " << istep;
+    EXPECT_EQ (conn[T8_3D_TO_1D (2, T8_ECLASS_MAX_FACES, 3, 0, 1, 1)], 0) << "step " << istep;
+    EXPECT_EQ (conn[T8_3D_TO_1D (2, T8_ECLASS_MAX_FACES, 3, 0, 1, 2)], 0) << "step " << istep;
+    EXPECT_EQ (conn[T8_3D_TO_1D (2, T8_ECLASS_MAX_FACES, 3, 1, 0, 0)], 0) << "step " << istep;
+    EXPECT_EQ (conn[T8_3D_TO_1D (2, T8_ECLASS_MAX_FACES, 3, 1, 0, 1)], 1) << "step " << istep;
+    T8_FREE (conn);
+  }
+}
+
 class t8_cmesh_set_join_by_vertices_class: public testing::TestWithParam<cmesh_example_base *> {
  protected:
   void
@@ -473,6 +508,65 @@ TEST_P (t8_cmesh_set_join_by_vertices_class, test_cmesh_set_join_by_vertices_par
   test_with_cmesh (cmesh);
 }
 
+/* Distribute the trees of a replicated cmesh over all processes and check that
+ * `t8_cmesh_set_join_by_vertices_parallel` finds the same connections as the serial routine. */
+TEST_P (t8_cmesh_set_join_by_vertices_class, test_cmesh_set_join_by_vertices_parallel)
+{
+  int mpirank, mpisize;
+  int mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  const t8_locidx_t ntrees = t8_cmesh_get_num_local_trees (cmesh);
+  const t8_gloidx_t first_tree = (t8_gloidx_t) ntrees * mpirank / mpisize;
+  const t8_locidx_t num_local_trees = (t8_gloidx_t) ntrees * (mpirank + 1) / mpisize - first_tree;
+
+  /* Arrays of all trees for the serial routine and of the local trees for the parallel one. */
+  std::vector<double> all_verts (ntrees * T8_ECLASS_MAX_CORNERS * T8_ECLASS_MAX_DIM);
+  std::vector<t8_eclass_t> all_eclasses (ntrees);
+  std::vector<double> local_verts (num_local_trees * T8_ECLASS_MAX_CORNERS * T8_ECLASS_MAX_DIM);
+
+  for (t8_locidx_t itree = 0; itree < ntrees; itree++) {
+    const t8_eclass_t eclass = t8_cmesh_get_tree_class (cmesh, itree);
+    all_eclasses[itree] = eclass;
+    const double *vertices = t8_cmesh_get_tree_vertices (cmesh, itree);
+    const int nverts = t8_eclass_num_vertices[eclass];
+
+    for (int ivert = 0; ivert < nverts; ivert++) {
+      for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; icoord++) {
+        const double coord = vertices[T8_2D_TO_1D (nverts, T8_ECLASS_MAX_DIM, ivert, icoord)];
+        all_verts[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree, ivert, icoord)] = coord;
+        if (first_tree <= itree && itree < first_tree + num_local_trees) {
+          local_verts[T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_CORNERS, T8_ECLASS_MAX_DIM, itree - first_tree,
+                                   ivert, icoord)]
+            = coord;
+        }
+      }
+    }
+  }
+
+  int *conn = NULL;
+  t8_gloidx_t *parallel_conn = NULL;
+  t8_cmesh_set_join_by_vertices (NULL, ntrees, all_eclasses.data (), all_verts.data (), &conn, 1);
+  t8_cmesh_set_join_by_vertices_parallel (NULL, first_tree, num_local_trees, all_eclasses.data () + first_tree,
+                                          local_verts.data (), &parallel_conn, sc_MPI_COMM_WORLD);
+
+  for (t8_locidx_t itree = 0; itree < num_local_trees; itree++) {
+    const int nfaces = t8_eclass_num_faces[all_eclasses[first_tree + itree]];
+    for (int iface = 0; iface < nfaces; iface++) {
+      for (int ientry = 0; ientry < 3; ientry++) {
+        EXPECT_EQ (parallel_conn[T8_3D_TO_1D (num_local_trees, T8_ECLASS_MAX_FACES, 3, itree, iface, ientry)],
+                   conn[T8_3D_TO_1D (ntrees, T8_ECLASS_MAX_FACES, 3, first_tree + itree, iface, ientry)])
+          << "Connection of tree " << first_tree + itree << " at face " << iface << " differs.";
+      }
+    }
+  }
+
+  T8_FREE (conn);
+  T8_FREE (parallel_conn);
+}
+
 /* Test all cmeshes over all different inputs we get through their id */
 INSTANTIATE_TEST_SUITE_P (t8_cmesh_set_join_by_vertices, t8_cmesh_set_join_by_vertices_class, AllCmeshsParam,
                           pretty_print_base_example);
@@ -35,6 +35,7 @@
 #include <t8_geometry/t8_geometry_implementations/t8_geometry_linear.hxx>
 #include <t8_schemes/t8_default/t8_default.hxx>
 #include <t8_forest/t8_forest_balance.h>
+#include <t8_forest/t8_forest_profiling.h>
 
 #include <array>
 #include <vector>
@@ -244,5 +245,46 @@ TEST (gtest_balance, balance_consistency_test)
   t8_forest_unref (&already_balanced_forest);
 }
 
+/**
+ * \brief Balances a forest with a deep refinement front and checks that a single process
+ * needs one balance round and that the number of rounds is bounded independently of the
+ * number of processes.
+ */
+TEST (gtest_balance, balance_deep_front_rounds)
+{
+  const int additional_refinement = 4;
+  std::vector<t8_gloidx_t> trees_to_refine { 0 };
+  t8_forest_t forest = t8_gtest_obtain_forest_for_balance_tests (trees_to_refine, additional_refinement);
+
+  t8_forest_t balanced_forest;
+  t8_forest_init (&balanced_forest);
+  t8_forest_set_balance (balanced_forest, forest, 1);
+  t8_forest_set_profiling (balanced_forest, 1);
+  t8_forest_commit (balanced_forest);
+
+  EXPECT_EQ (t8_forest_is_balanced (balanced_forest), 1);
+
+  int mpisize;
+  const int mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+  SC_CHECK_MPI (mpiret);
+  int balance_rounds = -1;
+  t8_forest_profile_get_balance_time (balanced_forest, &balance_rounds);
+  if (mpisize == 1) {
+    /* One round refines the forest, no process boundary requires a confirming round */
+    EXPECT_EQ (balance_rounds, 1);
+  }
+  else {
+    /* A further round only refines elements at least one level coarser than the
+     * elements refined at a process boundary in the previous round. The first round
+     * refines elements up to level max_level - 2, so at most max_level - 1 rounds refine
+     * and one more round may confirm the result, regardless of the number of processes. */
+    const int max_level = 2 + additional_refinement;
+    EXPECT_GE (balance_rounds, 1);
+    EXPECT_LE (balance_rounds, max_level);
+  }
+
+  t8_forest_unref (&balanced_forest);
+}
+
 INSTANTIATE_TEST_SUITE_P (t8_gtest_balance, gtest_balance,
                           testing::Combine (AllEclasses, testing::Range (0, 5), testing::Range (0, 2)));
@@ -0,0 +1,169 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we evaluate the coordinates and the jacobian of random points in all
+ * elements of a tree with t8_forest_element_batch_from_ref_coords and
+ * t8_forest_element_batch_jacobian and compare them to t8_forest_element_from_ref_coords
+ * for each single point. The jacobian is compared to central finite differences and,
+ * if the elements are the trees themselves, to the jacobian of the tree geometry. */
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_element.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_geometrical.h>
+#include <t8_geometry/t8_geometry.h>
+#include <test/t8_gtest_macros.hxx>
+#include <vector>
+
+#define T8_BATCH_NUM_POINTS 5
+
+class forest_element_batch_geometry: public testing::TestWithParam<std::tuple<t8_eclass_t, int>> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = std::get<0> (GetParam ());
+    level = std::get<1> (GetParam ());
+    if (eclass == T8_ECLASS_VERTEX) {
+      GTEST_SKIP ();
+    }
+    t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), level, 0, sc_MPI_COMM_WORLD);
+  }
+  void
+  TearDown () override
+  {
+    if (eclass != T8_ECLASS_VERTEX) {
+      t8_forest_unref (&forest);
+    }
+  }
+  t8_forest_t forest;
+  t8_eclass_t eclass;
+  int level;
+};
+
+/* Fill \a ref_coords with random points inside the reference element of \a shape.
+ * Each point is a convex combination of the corners with weights bounded away from zero. */
+static void
+t8_test_random_ref_coords (const t8_element_shape_t shape, double *ref_coords)
+{
+  const int dim = t8_eclass_to_dimension[shape];
+  const int num_corners = t8_eclass_num_vertices[shape];
+  for (int ipoint = 0; ipoint < T8_BATCH_NUM_POINTS; ++ipoint) {
+    double weights[T8_ECLASS_MAX_CORNERS];
+    double sum = 0;
+    for (int icorner = 0; icorner < num_corners; ++icorner) {
+      weights[icorner] = 0.1 + (double) rand () / RAND_MAX;
+      sum += weights[icorner];
+    }
+    for (int idim = 0; idim < dim; ++idim) {
+      double coord = 0;
+      for (int icorner = 0; icorner < num_corners; ++icorner) {
+        coord += weights[icorner] / sum * t8_element_corner_ref_coords[shape][icorner][idim];
+      }
+      ref_coords[ipoint * dim + idim] = coord;
+    }
+  }
+}
+
+TEST_P (forest_element_batch_geometry, compare_with_single_points)
+{
+  const double h = 1e-6;
+  const double eps = 1e-7;
+  srand (0);
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (forest); ++itree) {
+    const t8_eclass_t tree_class = t8_forest_get_tree_class (forest, itree);
+    const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, tree_class);
+    const int dim = t8_eclass_to_dimension[tree_class];
+    const t8_locidx_t num_elements = t8_forest_get_tree_num_elements (forest, itree);
+
+    /* The reference coordinates must be inside all elements of a batch. Hence, we batch
+     * the elements of each shape separately, since pyramid trees also contain tetrahedra. */
+    for (int ishape = 0; ishape < T8_ECLASS_COUNT; ++ishape) {
+      const t8_element_shape_t shape = (t8_element_shape_t) ishape;
+      std::vector<const t8_element_t *> elements;
+      for (t8_locidx_t ielement = 0; ielement < num_elements; ++ielement) {
+        const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielement);
+        if (ts->t8_element_shape (element) == shape) {
+          elements.push_back (element);
+        }
+      }
+      if (elements.empty ()) {
+        continue;
+      }
+      const size_t num_batch = elements.size ();
+      double ref_coords[T8_BATCH_NUM_POINTS * T8_ECLASS_MAX_DIM];
+      t8_test_random_ref_coords (shape, ref_coords);
+
+      std::vector<double> coords (num_batch * T8_BATCH_NUM_POINTS * T8_ECLASS_MAX_DIM);
+      std::vector<double> jacobian (num_batch * T8_BATCH_NUM_POINTS * dim * T8_ECLASS_MAX_DIM);
+      t8_forest_element_batch_from_ref_coords (forest, itree, elements.data (), num_batch, ref_coords,
+                                               T8_BATCH_NUM_POINTS, coords.data ());
+      t8_forest_element_batch_jacobian (forest, itree, elements.data (), num_batch, ref_coords, T8_BATCH_NUM_POINTS,
+                                        jacobian.data ());
+
+      for (size_t ielement = 0; ielement < num_batch; ++ielement) {
+        for (int ipoint = 0; ipoint < T8_BATCH_NUM_POINTS; ++ipoint) {
+          const size_t point_index = ielement * T8_BATCH_NUM_POINTS + ipoint;
+          double *point = ref_coords + ipoint * dim;
+          double single_coords[T8_ECLASS_MAX_DIM];
+          t8_forest_element_from_ref_coords (forest, itree, elements[ielement], point, 1, single_coords);
+          for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; ++icoord) {
+            EXPECT_NEAR (coords[point_index * T8_ECLASS_MAX_DIM + icoord], single_coords[icoord], eps);
+          }
+
+          /* Compare each column of the jacobian with central finite differences */
+          for (int idim = 0; idim < dim; ++idim) {
+            double coords_plus[T8_ECLASS_MAX_DIM], coords_minus[T8_ECLASS_MAX_DIM];
+            const double value = point[idim];
+            point[idim] = value + h;
+            t8_forest_element_from_ref_coords (forest, itree, elements[ielement], point, 1, coords_plus);
+            point[idim] = value - h;
+            t8_forest_element_from_ref_coords (forest, itree, elements[ielement], point, 1, coords_minus);
+            point[idim] = value;
+            for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM; ++icoord) {
+              EXPECT_NEAR (jacobian[(point_index * dim + idim) * T8_ECLASS_MAX_DIM + icoord],
+                           (coords_plus[icoord] - coords_minus[icoord]) / (2 * h), eps)
+                << "element " << ielement << " point " << ipoint << " derivative " << idim;
+            }
+          }
+        }
+      }
+
+      if (level == 0) {
+        /* The element is the tree itself, hence the jacobians equal the jacobians of the tree geometry */
+        double tree_jacobian[T8_BATCH_NUM_POINTS * T8_ECLASS_MAX_DIM * T8_ECLASS_MAX_DIM];
+        t8_geometry_jacobian (t8_forest_get_cmesh (forest), t8_forest_global_tree_id (forest, itree), ref_coords,
+                              T8_BATCH_NUM_POINTS, tree_jacobian);
+        for (int ientry = 0; ientry < T8_BATCH_NUM_POINTS * dim * T8_ECLASS_MAX_DIM; ++ientry) {
+          EXPECT_NEAR (jacobian[ientry], tree_jacobian[ientry], eps);
+        }
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_element_batch_geometry, forest_element_batch_geometry,
+                          testing::Combine (AllEclasses, testing::Values (0, 2)));
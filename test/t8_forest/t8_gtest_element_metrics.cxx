@@ -0,0 +1,161 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we compute the element metrics of a forest and compare
+ * each entry with the result of the geometry functions in t8_forest_geometrical.h.
+ * We check a uniform forest and a forest that is adapted from it, where
+ * the metrics of the unchanged leaves are copied from the uniform forest. */
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_geometrical.h>
+#include <t8_forest/t8_forest_ghost.h>
+#include <t8_forest/t8_forest_element_metrics.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <test/t8_gtest_macros.hxx>
+
+class forest_element_metrics: public testing::TestWithParam<t8_eclass_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    if (eclass == T8_ECLASS_VERTEX) {
+      GTEST_SKIP ();
+    }
+    /* Construct a forest of a hypercube with ghosts and element metrics */
+    t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    t8_forest_init (&forest);
+    t8_forest_set_cmesh (forest, cmesh, sc_MPI_COMM_WORLD);
+    t8_forest_set_scheme (forest, t8_scheme_new_default_cxx ());
+    t8_forest_set_level (forest, level);
+    t8_forest_set_ghost (forest, 1, T8_GHOST_FACES);
+    t8_forest_set_element_metrics (forest, 1);
+    t8_forest_commit (forest);
+  }
+  void
+  TearDown () override
+  {
+    if (eclass != T8_ECLASS_VERTEX) {
+      t8_forest_unref (&forest);
+    }
+  }
+  t8_eclass_t eclass;
+  t8_forest_t forest;
+  const int level = 2;
+};
+
+/* Refine all elements of the first global tree once. */
+static int
+t8_test_metrics_refine_first_tree (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                                   t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
+                                   const int num_elements, t8_element_t *elements[])
+{
+  const int level = *(int *) t8_forest_get_user_data (forest);
+  return t8_forest_global_tree_id (forest_from, which_tree) == 0 && ts->t8_element_level (elements[0]) == level;
+}
+
+/* Compare the metrics of one element with the geometry functions */
+static void
+t8_test_element_metrics_compare_element (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *element,
+                                         t8_eclass_scheme_c *ts, t8_locidx_t lelement_id)
+{
+  const t8_locidx_t *face_offsets = t8_forest_element_metrics_get_face_offsets (forest);
+  const int num_faces = ts->t8_element_num_faces (element);
+  double centroid[3], centroid_cached[3], normal[3], normal_cached[3];
+
+  ASSERT_EQ (face_offsets[lelement_id + 1] - face_offsets[lelement_id], num_faces);
+  EXPECT_DOUBLE_EQ (t8_forest_element_metrics_volume (forest, lelement_id),
+                    t8_forest_element_volume (forest, ltreeid, element));
+  EXPECT_EQ (t8_forest_element_metrics_get_volumes (forest)[lelement_id],
+             t8_forest_element_metrics_volume (forest, lelement_id));
+  t8_forest_element_centroid (forest, ltreeid, element, centroid);
+  t8_forest_element_metrics_centroid (forest, lelement_id, centroid_cached);
+  for (int icomp = 0; icomp < 3; icomp++) {
+    EXPECT_DOUBLE_EQ (centroid_cached[icomp], centroid[icomp]);
+    EXPECT_EQ (t8_forest_element_metrics_get_centroids (forest, icomp)[lelement_id], centroid_cached[icomp]);
+  }
+  for (int face = 0; face < num_faces; face++) {
+    EXPECT_DOUBLE_EQ (t8_forest_element_metrics_face_area (forest, lelement_id, face),
+                      t8_forest_element_face_area (forest, ltreeid, element, face));
+    t8_forest_element_face_normal (forest, ltreeid, element, face, normal);
+    t8_forest_element_metrics_face_normal (forest, lelement_id, face, normal_cached);
+    for (int icomp = 0; icomp < 3; icomp++) {
+      EXPECT_DOUBLE_EQ (normal_cached[icomp], normal[icomp]);
+    }
+  }
+}
+
+/* Compare the metrics of all local leaves and ghosts with the geometry functions */
+static void
+t8_test_element_metrics_compare (t8_forest_t forest)
+{
+  ASSERT_TRUE (t8_forest_has_element_metrics (forest));
+  const t8_locidx_t num_trees = t8_forest_get_num_local_trees (forest);
+  t8_locidx_t lelement_id = 0;
+  for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    for (t8_locidx_t ielement = 0; ielement < t8_forest_get_tree_num_elements (forest, itree);
+         ielement++, lelement_id++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      t8_test_element_metrics_compare_element (forest, itree, element, ts, lelement_id);
+    }
+  }
+  for (t8_locidx_t ighost_tree = 0; ighost_tree < t8_forest_ghost_num_trees (forest); ighost_tree++) {
+    t8_eclass_scheme_c *ts
+      = t8_forest_get_eclass_scheme (forest, t8_forest_ghost_get_tree_class (forest, ighost_tree));
+    const t8_element_array_t *ghosts = t8_forest_ghost_get_tree_elements (forest, ighost_tree);
+    for (t8_locidx_t ighost = 0; ighost < t8_forest_ghost_tree_num_elements (forest, ighost_tree);
+         ighost++, lelement_id++) {
+      const t8_element_t *ghost = t8_element_array_index_locidx (ghosts, ighost);
+      t8_test_element_metrics_compare_element (forest, num_trees + ighost_tree, ghost, ts, lelement_id);
+    }
+  }
+  EXPECT_EQ (lelement_id, t8_forest_get_local_num_elements (forest) + t8_forest_get_num_ghosts (forest));
+}
+
+TEST_P (forest_element_metrics, uniform)
+{
+  t8_test_element_metrics_compare (forest);
+}
+
+TEST_P (forest_element_metrics, adapted)
+{
+  t8_forest_t forest_adapt;
+  int user_level = level;
+
+  t8_forest_ref (forest);
+  t8_forest_init (&forest_adapt);
+  t8_forest_set_user_data (forest_adapt, &user_level);
+  t8_forest_set_adapt (forest_adapt, forest, t8_test_metrics_refine_first_tree, 0);
+  t8_forest_set_ghost (forest_adapt, 1, T8_GHOST_FACES);
+  t8_forest_set_element_metrics (forest_adapt, 1);
+  t8_forest_commit (forest_adapt);
+
+  t8_test_element_metrics_compare (forest_adapt);
+  t8_forest_unref (&forest_adapt);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_element_metrics, forest_element_metrics, AllEclasses, print_eclass);
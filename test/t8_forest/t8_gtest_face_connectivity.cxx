@@ -0,0 +1,144 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we build the face connectivity table of a forest and compare
+ * each of its entries with the result of t8_forest_leaf_face_neighbors.
+ * We check a uniform forest and a forest that is adapted from it, where
+ * the table is partially copied from the uniform forest. */
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_face_connectivity.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <test/t8_gtest_macros.hxx>
+
+class forest_face_connectivity: public testing::TestWithParam<t8_eclass_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    scheme = t8_scheme_new_default_cxx ();
+    /* Construct a forest of a hypercube with face connectivity */
+    t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    t8_forest_init (&forest);
+    t8_forest_set_cmesh (forest, cmesh, sc_MPI_COMM_WORLD);
+    t8_forest_set_scheme (forest, scheme);
+    t8_forest_set_level (forest, level);
+    t8_forest_set_face_connectivity (forest, 1);
+    t8_forest_commit (forest);
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest);
+  }
+  t8_eclass_t eclass;
+  t8_scheme_cxx_t *scheme;
+  t8_forest_t forest;
+  const int level = 2;
+};
+
+/* Refine all elements of the first global tree once. */
+static int
+t8_test_refine_first_tree (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                           t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
+                           const int num_elements, t8_element_t *elements[])
+{
+  const int level = *(int *) t8_forest_get_user_data (forest);
+  return t8_forest_global_tree_id (forest_from, which_tree) == 0 && ts->t8_element_level (elements[0]) == level;
+}
+
+/* Compare the face connectivity table with t8_forest_leaf_face_neighbors */
+static void
+t8_test_face_connectivity_compare (t8_forest_t forest)
+{
+  ASSERT_TRUE (t8_forest_has_face_connectivity (forest));
+  t8_locidx_t lelement_id = 0;
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    for (t8_locidx_t ielement = 0; ielement < t8_forest_get_tree_num_elements (forest, itree);
+         ielement++, lelement_id++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      ASSERT_EQ (t8_forest_face_connectivity_num_faces (forest, lelement_id), ts->t8_element_num_faces (element));
+      for (int face = 0; face < ts->t8_element_num_faces (element); face++) {
+        t8_element_t **neighbor_leaves;
+        t8_locidx_t *element_indices;
+        t8_eclass_scheme_c *neigh_scheme;
+        int *dual_faces;
+        int num_neighbors;
+        const t8_locidx_t *table_ids;
+        const int8_t *table_dual_faces;
+        int flags;
+
+        t8_forest_leaf_face_neighbors (forest, itree, element, &neighbor_leaves, face, &dual_faces, &num_neighbors,
+                                       &element_indices, &neigh_scheme, 1);
+        const int table_num_neighbors = t8_forest_face_connectivity_get_neighbors (
+          forest, lelement_id, face, &table_ids, &table_dual_faces, NULL, &flags);
+        EXPECT_EQ (table_num_neighbors, num_neighbors) << "element " << lelement_id << " face " << face;
+        EXPECT_EQ (num_neighbors == 0, (flags & T8_FACE_CONNECTIVITY_BOUNDARY) != 0);
+        if (num_neighbors > 0) {
+          const int level = ts->t8_element_level (element);
+          const int neigh_level = neigh_scheme->t8_element_level (neighbor_leaves[0]);
+          EXPECT_EQ (neigh_level > level, (flags & T8_FACE_CONNECTIVITY_FINER) != 0);
+          EXPECT_EQ (neigh_level < level, (flags & T8_FACE_CONNECTIVITY_COARSER) != 0);
+        }
+        for (int ineigh = 0; ineigh < SC_MIN (num_neighbors, table_num_neighbors); ineigh++) {
+          EXPECT_EQ (table_ids[ineigh], element_indices[ineigh]);
+          EXPECT_EQ (table_dual_faces[ineigh], dual_faces[ineigh]);
+        }
+        if (num_neighbors > 0) {
+          neigh_scheme->t8_element_destroy (num_neighbors, neighbor_leaves);
+          T8_FREE (neighbor_leaves);
+          T8_FREE (element_indices);
+          T8_FREE (dual_faces);
+        }
+      }
+    }
+  }
+}
+
+TEST_P (forest_face_connectivity, uniform)
+{
+  t8_test_face_connectivity_compare (forest);
+}
+
+TEST_P (forest_face_connectivity, adapted)
+{
+  t8_forest_t forest_adapt;
+  int user_level = level;
+
+  t8_forest_ref (forest);
+  t8_forest_init (&forest_adapt);
+  t8_forest_set_user_data (forest_adapt, &user_level);
+  t8_forest_set_adapt (forest_adapt, forest, t8_test_refine_first_tree, 0);
+  t8_forest_set_face_connectivity (forest_adapt, 1);
+  t8_forest_commit (forest_adapt);
+
+  t8_test_face_connectivity_compare (forest_adapt);
+  t8_forest_unref (&forest_adapt);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_face_connectivity, forest_face_connectivity, AllEclasses, print_eclass);
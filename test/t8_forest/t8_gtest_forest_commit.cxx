@@ -166,4 +166,47 @@ TEST_P (forest_commit, test_forest_commit)
   t8_debugf ("Done testing forest commit.");
 }
 
+/* Adapt a forest with multiple threads and check that the
+ * result is the same as when adapting with one thread. */
+TEST_P (forest_commit, test_forest_commit_threaded_adapt)
+{
+  t8_scheme_cxx_t *scheme = t8_scheme_new_default_cxx ();
+  const int level = t8_forest_min_nonempty_level (cmesh, scheme);
+  int maxlevel = level + 2;
+
+  for (int recursive = 0; recursive <= 1; recursive++) {
+    t8_cmesh_ref (cmesh);
+    t8_scheme_cxx_ref (scheme);
+    t8_forest_t forest = t8_forest_new_uniform (cmesh, scheme, level, 0, sc_MPI_COMM_WORLD);
+    t8_forest_ref (forest);
+
+    t8_forest_t forest_serial;
+    t8_forest_init (&forest_serial);
+    t8_forest_set_user_data (forest_serial, &maxlevel);
+    t8_forest_set_adapt (forest_serial, forest, t8_test_adapt_balance, recursive);
+    t8_forest_commit (forest_serial);
+
+    t8_forest_t forest_threaded;
+    t8_forest_init (&forest_threaded);
+    t8_forest_set_user_data (forest_threaded, &maxlevel);
+    t8_forest_set_adapt (forest_threaded, forest, t8_test_adapt_balance, recursive);
+    t8_forest_set_num_threads (forest_threaded, 4);
+#if T8_ENABLE_OPENMP && !defined(SC_ENABLE_PTHREAD)
+    /* Without pthread support in libsc the forest falls back to one thread */
+    EXPECT_EQ (t8_forest_get_num_threads (forest_threaded), 1);
+#else
+    EXPECT_EQ (t8_forest_get_num_threads (forest_threaded), 4);
+#endif
+    t8_forest_commit (forest_threaded);
+
+    EXPECT_EQ (t8_forest_get_local_num_elements (forest_serial), t8_forest_get_local_num_elements (forest_threaded));
+    EXPECT_EQ (t8_forest_get_global_num_elements (forest_serial), t8_forest_get_global_num_elements (forest_threaded));
+    EXPECT_TRUE (t8_forest_is_equal (forest_serial, forest_threaded)) << "The forests are not equal";
+
+    t8_forest_unref (&forest_serial);
+    t8_forest_unref (&forest_threaded);
+  }
+  t8_scheme_cxx_unref (&scheme);
+}
+
 INSTANTIATE_TEST_SUITE_P (t8_gtest_forest_commit, forest_commit, AllCmeshsParam, pretty_print_base_example);
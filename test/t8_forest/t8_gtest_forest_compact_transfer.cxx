@@ -0,0 +1,130 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we check the compact element encoding that is used to send elements
+ * to other processes. We encode and decode the elements of an adapted forest and
+ * compare partitioned forests with ghost layers that were built with and without
+ * the compact encoding. */
+
+#include <gtest/gtest.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_ghost.h>
+#include <t8_forest/t8_forest_element_codec.hxx>
+#include <test/t8_gtest_macros.hxx>
+#include <test/t8_gtest_adapt_helpers.hxx>
+#include <vector>
+
+class forest_compact_transfer: public testing::TestWithParam<t8_eclass_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    forest = t8_gtest_new_adapted_hypercube_forest (GetParam ());
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest);
+  }
+
+  /* Partition forest with a face ghost layer, optionally with compact transfer. */
+  t8_forest_t
+  partition_with_ghost (const int compact)
+  {
+    t8_forest_t forest_partition;
+    t8_forest_init (&forest_partition);
+    t8_forest_ref (forest);
+    t8_forest_set_partition (forest_partition, forest, 0);
+    t8_forest_set_ghost (forest_partition, 1, T8_GHOST_FACES);
+    t8_forest_set_compact_transfer (forest_partition, compact);
+    t8_forest_commit (forest_partition);
+    return forest_partition;
+  }
+  t8_forest_t forest;
+};
+
+TEST_P (forest_compact_transfer, encode_decode)
+{
+  const t8_locidx_t num_trees = t8_forest_get_num_local_trees (forest);
+  for (t8_locidx_t itree = 0; itree < num_trees; itree++) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    const t8_element_array_t *leaves = t8_forest_tree_get_leaves (forest, itree);
+    const size_t num_elements = t8_element_array_get_count (leaves);
+
+    std::vector<char> buffer (t8_forest_element_encode_bound (ts, num_elements));
+    const size_t num_bytes = t8_forest_element_encode (ts, t8_element_array_get_data (leaves), num_elements,
+                                                       buffer.data ());
+    EXPECT_LE (num_bytes, t8_forest_element_encode_bound (ts, num_elements));
+    if (t8_forest_element_codec_is_compact (ts)) {
+      /* The encoding must be smaller than the raw elements */
+      EXPECT_LT (num_bytes, num_elements * ts->t8_element_size ());
+    }
+    else {
+      /* Only elements that are smaller than their encoding, such as vertices, are sent unencoded */
+      EXPECT_LE (ts->t8_element_size (), t8_forest_element_encode_bound (ts, 1));
+    }
+
+    t8_element_array_t decoded;
+    t8_element_array_init_size (&decoded, ts, num_elements);
+    const size_t bytes_read = t8_forest_element_decode (ts, buffer.data (), num_elements,
+                                                        t8_element_array_get_data_mutable (&decoded));
+    EXPECT_EQ (bytes_read, num_bytes);
+    for (size_t ielem = 0; ielem < num_elements; ielem++) {
+      EXPECT_TRUE (ts->t8_element_equal (t8_element_array_index_int (leaves, (int) ielem),
+                                         t8_element_array_index_int (&decoded, (int) ielem)));
+    }
+    t8_element_array_reset (&decoded);
+  }
+}
+
+TEST_P (forest_compact_transfer, partition_and_ghost)
+{
+  t8_forest_t forest_raw = partition_with_ghost (0);
+  t8_forest_t forest_compact = partition_with_ghost (1);
+
+  /* The partitioned forests must be equal */
+  EXPECT_TRUE (t8_forest_is_equal (forest_raw, forest_compact));
+
+  /* The ghost layers must be equal */
+  const t8_locidx_t num_ghost_trees = t8_forest_ghost_num_trees (forest_raw);
+  ASSERT_EQ (t8_forest_get_num_ghosts (forest_compact), t8_forest_get_num_ghosts (forest_raw));
+  ASSERT_EQ (t8_forest_ghost_num_trees (forest_compact), num_ghost_trees);
+  for (t8_locidx_t itree = 0; itree < num_ghost_trees; itree++) {
+    ASSERT_EQ (t8_forest_ghost_get_global_treeid (forest_compact, itree),
+               t8_forest_ghost_get_global_treeid (forest_raw, itree));
+    const t8_locidx_t num_elements = t8_forest_ghost_tree_num_elements (forest_raw, itree);
+    ASSERT_EQ (t8_forest_ghost_tree_num_elements (forest_compact, itree), num_elements);
+    const t8_eclass_t eclass = t8_forest_ghost_get_tree_class (forest_raw, itree);
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest_raw, eclass);
+    for (t8_locidx_t ielem = 0; ielem < num_elements; ielem++) {
+      EXPECT_TRUE (ts->t8_element_equal (t8_forest_ghost_get_element (forest_raw, itree, ielem),
+                                         t8_forest_ghost_get_element (forest_compact, itree, ielem)));
+    }
+  }
+
+  t8_forest_unref (&forest_raw);
+  t8_forest_unref (&forest_compact);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_forest_compact_transfer, forest_compact_transfer, AllEclasses, print_eclass);
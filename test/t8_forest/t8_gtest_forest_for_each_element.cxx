@@ -0,0 +1,72 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we iterate over the elements of an adapted forest with
+ * t8_forest_for_each_element and compare the visited elements with the
+ * elements obtained by t8_forest_get_element_in_tree. For the default scheme
+ * the kernel must be called with the concrete scheme of each tree. */
+
+#include <gtest/gtest.h>
+#include <type_traits>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_iterate.hxx>
+#include <test/t8_gtest_macros.hxx>
+#include <test/t8_gtest_adapt_helpers.hxx>
+
+class forest_for_each_element: public testing::TestWithParam<t8_eclass_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    forest = t8_gtest_new_adapted_hypercube_forest (GetParam ());
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest);
+  }
+  t8_forest_t forest;
+};
+
+TEST_P (forest_for_each_element, visits_all_elements)
+{
+  t8_locidx_t num_visited = 0;
+  int num_concrete = 0;
+  t8_forest_for_each_element (forest, [&] (const auto *scheme, t8_locidx_t ltreeid, t8_locidx_t ielement,
+                                           t8_locidx_t element_index, const t8_element_t *element) {
+    using scheme_type = std::remove_cv_t<std::remove_pointer_t<decltype (scheme)>>;
+    num_concrete += !std::is_same_v<scheme_type, t8_eclass_scheme_c>;
+
+    const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, ltreeid));
+    EXPECT_EQ (element_index, num_visited);
+    EXPECT_EQ (element, t8_forest_get_element_in_tree (forest, ltreeid, ielement));
+    EXPECT_EQ (scheme->t8_element_level (element), ts->t8_element_level (element));
+    num_visited++;
+  });
+  EXPECT_EQ (num_visited, t8_forest_get_local_num_elements (forest));
+  /* All trees use the default scheme */
+  EXPECT_EQ (num_concrete, num_visited);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_forest_for_each_element, forest_for_each_element, AllEclasses, print_eclass);
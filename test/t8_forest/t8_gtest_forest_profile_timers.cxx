@@ -0,0 +1,172 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we adapt, partition and balance a forest with profiling enabled
+ * and check that the nested timers and counters are recorded and written. */
+
+#include <gtest/gtest.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_profiling.h>
+#include <test/t8_gtest_macros.hxx>
+#include <test/t8_gtest_adapt_helpers.hxx>
+#include <cstdio>
+
+class forest_profile_timers: public testing::TestWithParam<t8_eclass_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    forest_uniform = t8_gtest_new_uniform_hypercube_forest (GetParam ());
+    int mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+    SC_CHECK_MPI (mpiret);
+    t8_forest_profile_reset_summary ();
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_profile_set_output (NULL, T8_PROFILE_FORMAT_CSV);
+  }
+  t8_forest_t forest_uniform;
+  int mpirank;
+};
+
+/* Return the number of lines of a file, or -1 if it cannot be opened. */
+static int
+t8_test_timers_count_lines (const char *filename)
+{
+  FILE *file = fopen (filename, "r");
+  if (file == NULL) {
+    return -1;
+  }
+  int num_lines = 0;
+  for (int c = fgetc (file); c != EOF; c = fgetc (file)) {
+    num_lines += c == '\n';
+  }
+  fclose (file);
+  return num_lines;
+}
+
+TEST_P (forest_profile_timers, adapt_partition)
+{
+  t8_forest_t forest;
+  t8_forest_init (&forest);
+  t8_forest_set_adapt (forest, forest_uniform, t8_gtest_adapt_first_child, 1);
+  t8_forest_set_partition (forest, NULL, 0);
+  t8_forest_set_ghost (forest, 1, T8_GHOST_FACES);
+  t8_forest_set_profiling (forest, 1);
+  t8_forest_commit (forest);
+
+  long calls;
+  const double commit_time = t8_forest_profile_get_timer (forest, "commit", &calls);
+  EXPECT_EQ (calls, 1);
+  EXPECT_GE (commit_time, 0);
+  /* The sub timers are nested in commit and not longer than it */
+  EXPECT_LE (t8_forest_profile_get_timer (forest, "commit/adapt", &calls), commit_time);
+  EXPECT_EQ (calls, 1);
+  EXPECT_LE (t8_forest_profile_get_timer (forest, "commit/partition", &calls), commit_time);
+  EXPECT_EQ (calls, 1);
+  EXPECT_LE (t8_forest_profile_get_timer (forest, "commit/ghost", &calls), commit_time);
+  EXPECT_EQ (calls, 1);
+  /* The counters of the intermediate adapted forest are merged into this forest.
+   * Partition does not change the global number of elements. */
+  double local_adapt_elements = t8_forest_profile_get_counter (forest, "commit/adapt/elements");
+  double global_adapt_elements;
+  int mpiret = sc_MPI_Allreduce (&local_adapt_elements, &global_adapt_elements, 1, sc_MPI_DOUBLE, sc_MPI_SUM,
+                                 sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  EXPECT_EQ (global_adapt_elements, t8_forest_get_global_num_elements (forest));
+  /* Entries that were never recorded are reported as 0 */
+  EXPECT_EQ (t8_forest_profile_get_timer (forest, "commit/balance", &calls), 0);
+  EXPECT_EQ (calls, 0);
+
+  /* User timers are nested in the timers that are running */
+  t8_forest_profile_timer_start (forest, "user");
+  t8_forest_profile_count (forest, "items", 2);
+  t8_forest_profile_count (forest, "items", 3);
+  t8_forest_profile_timer_stop (forest, "user");
+  EXPECT_GE (t8_forest_profile_get_timer (forest, "user", &calls), 0);
+  EXPECT_EQ (calls, 1);
+  EXPECT_EQ (t8_forest_profile_get_counter (forest, "user/items"), 5);
+
+  /* Write all entries as csv, one header line and one line per entry */
+  const char *filename = "test_forest_profile_timers.csv";
+  if (mpirank == 0) {
+    remove (filename);
+  }
+  t8_forest_profile_write (forest, filename, T8_PROFILE_FORMAT_CSV);
+  if (mpirank == 0) {
+    EXPECT_GT (t8_test_timers_count_lines (filename), 5);
+    remove (filename);
+  }
+  t8_forest_unref (&forest);
+}
+
+TEST_P (forest_profile_timers, balance_and_summary)
+{
+  const char *filename = "test_forest_profile_timers.json";
+  if (mpirank == 0) {
+    remove (filename);
+  }
+  /* Append one record per profiled commit */
+  t8_forest_profile_set_output (filename, T8_PROFILE_FORMAT_JSON);
+
+  t8_forest_t forest_adapt = t8_forest_new_adapt (forest_uniform, t8_gtest_adapt_first_child, 1, 0, NULL);
+  t8_forest_t forest;
+  t8_forest_init (&forest);
+  t8_forest_set_balance (forest, forest_adapt, 0);
+  t8_forest_set_profiling (forest, 1);
+  t8_forest_commit (forest);
+
+  long calls, round_calls;
+  EXPECT_GE (t8_forest_profile_get_timer (forest, "commit/balance", &calls), 0);
+  EXPECT_EQ (calls, 1);
+  t8_forest_profile_get_timer (forest, "commit/balance/round", &round_calls);
+  int balance_rounds;
+  t8_forest_profile_get_balance_time (forest, &balance_rounds);
+  EXPECT_EQ (round_calls, balance_rounds);
+  EXPECT_EQ (t8_forest_profile_get_counter (forest, "commit/balance/rounds"), balance_rounds);
+  /* The adapt passes of each round are merged into the round */
+  t8_forest_profile_get_timer (forest, "commit/balance/round/adapt", &calls);
+  EXPECT_GE (calls, balance_rounds);
+
+  /* The intermediate partitioned forests are part of the record of this commit only */
+  if (mpirank == 0) {
+    EXPECT_EQ (t8_test_timers_count_lines (filename), 1);
+    remove (filename);
+  }
+  t8_forest_unref (&forest);
+
+  /* The run totals contain the balanced commit */
+  const char *summary = "test_forest_profile_timers_summary.csv";
+  if (mpirank == 0) {
+    remove (summary);
+  }
+  t8_forest_profile_write_summary (summary, T8_PROFILE_FORMAT_CSV, sc_MPI_COMM_WORLD);
+  if (mpirank == 0) {
+    EXPECT_GT (t8_test_timers_count_lines (summary), 2);
+    remove (summary);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_forest_profile_timers, forest_profile_timers, AllEclasses, print_eclass);
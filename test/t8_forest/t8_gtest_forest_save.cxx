@@ -0,0 +1,165 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we save an adapted forest together with one value per element
+ * and load it again. Loaded on the same communicator, the forest must be equal
+ * to the saved one. Loaded on a single process, the elements must appear in the
+ * same global order, which we check with the element values. */
+
+#include <gtest/gtest.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_forest/t8_forest_io.h>
+#include <test/t8_gtest_macros.hxx>
+#include <test/t8_gtest_adapt_helpers.hxx>
+
+class forest_save: public testing::TestWithParam<t8_eclass_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    const t8_eclass_t eclass = GetParam ();
+    int mpiret = sc_MPI_Comm_rank (sc_MPI_COMM_WORLD, &mpirank);
+    SC_CHECK_MPI (mpiret);
+    forest = t8_test_save_new_forest (eclass, 0, &element_data);
+    snprintf (fileprefix, BUFSIZ, "test_forest_save_%s", t8_eclass_to_string[eclass]);
+  }
+  void
+  TearDown () override
+  {
+    sc_array_reset (&element_data);
+    t8_forest_unref (&forest);
+    t8_test_save_remove_files ();
+  }
+  /* Create an adapted forest and store the global id of each element as element data.
+   * If cmesh_partitioned is true, the forest is built on a partitioned coarse mesh. */
+  static t8_forest_t
+  t8_test_save_new_forest (const t8_eclass_t eclass, const int cmesh_partitioned, sc_array_t *data)
+  {
+    t8_forest_t forest_adapt = t8_gtest_new_adapted_hypercube_forest (eclass, cmesh_partitioned);
+
+    const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest_adapt);
+    const t8_gloidx_t first_element = t8_forest_get_first_local_element_id (forest_adapt);
+    sc_array_init_size (data, sizeof (t8_gloidx_t), num_elements);
+    for (t8_locidx_t ielement = 0; ielement < num_elements; ielement++) {
+      *(t8_gloidx_t *) t8_sc_array_index_locidx (data, ielement) = first_element + ielement;
+    }
+    return forest_adapt;
+  }
+  /* Remove the coarse mesh file of this process and the forest file once all processes are done */
+  void
+  t8_test_save_remove_files ()
+  {
+    char filename[BUFSIZ];
+    int mpiret = sc_MPI_Barrier (sc_MPI_COMM_WORLD);
+    SC_CHECK_MPI (mpiret);
+    snprintf (filename, BUFSIZ, "%s_%04i.cmesh", fileprefix, mpirank);
+    remove (filename);
+    if (mpirank == 0) {
+      snprintf (filename, BUFSIZ, "%s.t8f", fileprefix);
+      remove (filename);
+    }
+  }
+  t8_forest_t forest;
+  int mpirank;
+  sc_array_t element_data;
+  char fileprefix[BUFSIZ];
+};
+
+TEST_P (forest_save, save_and_load)
+{
+  ASSERT_TRUE (t8_forest_save (forest, fileprefix, sizeof (t8_gloidx_t), element_data.array));
+
+  sc_array_t loaded_data;
+  sc_array_init (&loaded_data, sizeof (t8_gloidx_t));
+  t8_forest_t forest_loaded
+    = t8_forest_load (fileprefix, t8_scheme_new_default_cxx (), sc_MPI_COMM_WORLD, &loaded_data);
+
+  /* The saved partition is restored */
+  EXPECT_TRUE (t8_forest_is_equal (forest, forest_loaded));
+  EXPECT_EQ (t8_forest_get_global_num_elements (forest_loaded), t8_forest_get_global_num_elements (forest));
+  ASSERT_EQ (loaded_data.elem_count, element_data.elem_count);
+  EXPECT_EQ (memcmp (loaded_data.array, element_data.array, element_data.elem_count * sizeof (t8_gloidx_t)), 0);
+
+  sc_array_reset (&loaded_data);
+  t8_forest_unref (&forest_loaded);
+}
+
+TEST_P (forest_save, save_and_load_partitioned_cmesh)
+{
+  sc_array_t partitioned_data;
+  t8_forest_t forest_partitioned = t8_test_save_new_forest (GetParam (), 1, &partitioned_data);
+  ASSERT_TRUE (t8_cmesh_is_partitioned (t8_forest_get_cmesh (forest_partitioned)));
+  ASSERT_TRUE (t8_forest_save (forest_partitioned, fileprefix, sizeof (t8_gloidx_t), partitioned_data.array));
+
+  sc_array_t loaded_data;
+  sc_array_init (&loaded_data, sizeof (t8_gloidx_t));
+  t8_forest_t forest_loaded
+    = t8_forest_load (fileprefix, t8_scheme_new_default_cxx (), sc_MPI_COMM_WORLD, &loaded_data);
+
+  /* The coarse mesh is loaded partitioned and the saved partition is restored */
+  EXPECT_TRUE (t8_cmesh_is_partitioned (t8_forest_get_cmesh (forest_loaded)));
+  EXPECT_TRUE (t8_forest_is_equal (forest_partitioned, forest_loaded));
+  EXPECT_EQ (t8_forest_get_global_num_elements (forest_loaded), t8_forest_get_global_num_elements (forest_partitioned));
+  ASSERT_EQ (loaded_data.elem_count, partitioned_data.elem_count);
+  EXPECT_EQ (memcmp (loaded_data.array, partitioned_data.array, partitioned_data.elem_count * sizeof (t8_gloidx_t)), 0);
+
+  sc_array_reset (&loaded_data);
+  sc_array_reset (&partitioned_data);
+  t8_forest_unref (&forest_loaded);
+  t8_forest_unref (&forest_partitioned);
+}
+
+TEST_P (forest_save, load_on_one_process)
+{
+  int mpiret;
+
+  ASSERT_TRUE (t8_forest_save (forest, fileprefix, sizeof (t8_gloidx_t), element_data.array));
+
+  /* Load the forest only on rank 0 */
+  sc_MPI_Comm comm_single;
+  mpiret = sc_MPI_Comm_split (sc_MPI_COMM_WORLD, mpirank == 0 ? 0 : sc_MPI_UNDEFINED, 0, &comm_single);
+  SC_CHECK_MPI (mpiret);
+  if (mpirank == 0) {
+    sc_array_t loaded_data;
+    sc_array_init (&loaded_data, sizeof (t8_gloidx_t));
+    t8_forest_t forest_loaded = t8_forest_load (fileprefix, t8_scheme_new_default_cxx (), comm_single, &loaded_data);
+
+    const t8_gloidx_t global_num_elements = t8_forest_get_global_num_elements (forest);
+    EXPECT_EQ (t8_forest_get_global_num_elements (forest_loaded), global_num_elements);
+    ASSERT_EQ (t8_forest_get_local_num_elements (forest_loaded), global_num_elements);
+    ASSERT_EQ ((t8_gloidx_t) loaded_data.elem_count, global_num_elements);
+    /* Each element carries its global index */
+    for (t8_locidx_t ielement = 0; ielement < global_num_elements; ielement++) {
+      EXPECT_EQ (*(t8_gloidx_t *) t8_sc_array_index_locidx (&loaded_data, ielement), ielement);
+    }
+
+    sc_array_reset (&loaded_data);
+    t8_forest_unref (&forest_loaded);
+    mpiret = sc_MPI_Comm_free (&comm_single);
+    SC_CHECK_MPI (mpiret);
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_forest_save, forest_save, AllEclasses, print_eclass);
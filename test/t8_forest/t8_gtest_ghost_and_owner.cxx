@@ -144,4 +144,65 @@ TEST_P (forest_ghost_owner, test_ghost_owner)
   }
 }
 
+/* Create the ghost layer of an adapted forest once with one thread and once with
+ * multiple threads, for the iterative (version 2) and the top-down (version 3) ghost algorithm.
+ * The ghost layers must be equal element by element. */
+TEST_P (forest_ghost_owner, test_ghost_threaded)
+{
+  const int level = SC_MAX (0, t8_forest_min_nonempty_level (cmesh, scheme));
+  int maxlevel = level + 2;
+  t8_scheme_cxx_ref (scheme);
+  t8_cmesh_ref (cmesh);
+  t8_forest_t forest = t8_forest_new_uniform (cmesh, scheme, level, 0, sc_MPI_COMM_WORLD);
+
+  for (int ghost_version = 2; ghost_version <= 3; ghost_version++) {
+    t8_forest_t forest_ghost[2];
+    for (int ithreaded = 0; ithreaded < 2; ithreaded++) {
+      t8_forest_ref (forest);
+      t8_forest_init (&forest_ghost[ithreaded]);
+      t8_forest_set_user_data (forest_ghost[ithreaded], &maxlevel);
+      t8_forest_set_adapt (forest_ghost[ithreaded], forest, t8_test_gao_adapt, 1);
+      t8_forest_set_ghost_ext (forest_ghost[ithreaded], 1, T8_GHOST_FACES, ghost_version);
+      t8_forest_set_num_threads (forest_ghost[ithreaded], ithreaded ? 4 : 1);
+      t8_forest_commit (forest_ghost[ithreaded]);
+    }
+
+    /* The remote processes and the remote elements are the same */
+    int num_remotes[2];
+    const int *remotes[2];
+    for (int ithreaded = 0; ithreaded < 2; ithreaded++) {
+      remotes[ithreaded] = t8_forest_ghost_get_remotes (forest_ghost[ithreaded], &num_remotes[ithreaded]);
+    }
+    ASSERT_EQ (num_remotes[0], num_remotes[1]) << "ghost version " << ghost_version;
+    for (int iremote = 0; iremote < num_remotes[0]; iremote++) {
+      EXPECT_EQ (remotes[0][iremote], remotes[1][iremote]);
+      EXPECT_EQ (t8_forest_ghost_remote_first_tree (forest_ghost[0], remotes[0][iremote]),
+                 t8_forest_ghost_remote_first_tree (forest_ghost[1], remotes[1][iremote]));
+      EXPECT_EQ (t8_forest_ghost_remote_first_elem (forest_ghost[0], remotes[0][iremote]),
+                 t8_forest_ghost_remote_first_elem (forest_ghost[1], remotes[1][iremote]));
+    }
+    /* The ghost elements are the same */
+    ASSERT_EQ (t8_forest_get_num_ghosts (forest_ghost[0]), t8_forest_get_num_ghosts (forest_ghost[1]));
+    const t8_locidx_t num_ghost_trees = t8_forest_ghost_num_trees (forest_ghost[0]);
+    ASSERT_EQ (num_ghost_trees, t8_forest_ghost_num_trees (forest_ghost[1]));
+    for (t8_locidx_t itree = 0; itree < num_ghost_trees; itree++) {
+      const t8_locidx_t num_elems = t8_forest_ghost_tree_num_elements (forest_ghost[0], itree);
+      ASSERT_EQ (num_elems, t8_forest_ghost_tree_num_elements (forest_ghost[1], itree));
+      ASSERT_EQ (t8_forest_ghost_get_global_treeid (forest_ghost[0], itree),
+                 t8_forest_ghost_get_global_treeid (forest_ghost[1], itree));
+      const t8_eclass_t eclass = t8_forest_ghost_get_tree_class (forest_ghost[0], itree);
+      const t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest_ghost[0], eclass);
+      for (t8_locidx_t ielem = 0; ielem < num_elems; ielem++) {
+        EXPECT_TRUE (ts->t8_element_equal (t8_forest_ghost_get_element (forest_ghost[0], itree, ielem),
+                                           t8_forest_ghost_get_element (forest_ghost[1], itree, ielem)))
+          << "ghost version " << ghost_version << " tree " << itree << " element " << ielem;
+      }
+    }
+
+    t8_forest_unref (&forest_ghost[0]);
+    t8_forest_unref (&forest_ghost[1]);
+  }
+  t8_forest_unref (&forest);
+}
+
 INSTANTIATE_TEST_SUITE_P (t8_gtest_ghost_and_owner, forest_ghost_owner, AllCmeshsParam, pretty_print_base_example);
@@ -168,6 +168,60 @@ t8_test_ghost_exchange_data_int (t8_forest_t forest)
   sc_array_reset (&element_data);
 }
 
+/* Fill the local entries of a data array of doubles with the element index, exchange
+ * the ghost entries twice with a persistent exchange plan and once with the
+ * begin/end interface and check the received values.
+ * If use_shared_memory is true, remotes on the same node exchange through shared memory.
+ */
+static void
+t8_test_ghost_exchange_plan (t8_forest_t forest, int use_shared_memory)
+{
+  sc_array_t element_data;
+
+  t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  t8_locidx_t num_ghosts = t8_forest_get_num_ghosts (forest);
+  sc_array_init_size (&element_data, sizeof (double), num_elements + num_ghosts);
+
+  /* Store the global element index as value */
+  const t8_gloidx_t first_element = t8_forest_get_first_local_element_id (forest);
+  t8_forest_ghost_exchange_plan_t plan
+    = t8_forest_ghost_exchange_plan_new_ext (forest, sizeof (double), use_shared_memory);
+  for (int iexchange = 0; iexchange < 3; iexchange++) {
+    for (t8_locidx_t ielem = 0; ielem < num_elements; ielem++) {
+      *(double *) t8_sc_array_index_locidx (&element_data, ielem) = (double) (first_element + ielem + iexchange);
+    }
+    for (t8_locidx_t ielem = 0; ielem < num_ghosts; ielem++) {
+      *(double *) t8_sc_array_index_locidx (&element_data, num_elements + ielem) = -1;
+    }
+    if (iexchange < 2) {
+      /* Exchange with the plan, the second time the requests are reused */
+      t8_forest_ghost_exchange_plan_begin (plan, &element_data);
+      t8_forest_ghost_exchange_plan_end (plan);
+    }
+    else {
+      t8_ghost_data_exchange_t *exchange = t8_forest_ghost_exchange_begin (forest, &element_data);
+      t8_forest_ghost_exchange_end (exchange);
+    }
+    /* The received values must be non-negative and equal to the values of the
+     * single exchange. */
+    sc_array_t compare_data;
+    sc_array_init_size (&compare_data, sizeof (double), num_elements + num_ghosts);
+    sc_array_copy (&compare_data, &element_data);
+    t8_forest_ghost_exchange_data (forest, &compare_data);
+    for (t8_locidx_t ielem = 0; ielem < num_ghosts; ielem++) {
+      const double received = *(double *) t8_sc_array_index_locidx (&element_data, num_elements + ielem);
+      const double expected = *(double *) t8_sc_array_index_locidx (&compare_data, num_elements + ielem);
+      ASSERT_GE (received, iexchange) << "Error when exchanging ghost data with a plan. Ghost not received.\n";
+      ASSERT_EQ (received, expected) << "Error when exchanging ghost data with a plan. Received wrong data.\n";
+    }
+    sc_array_reset (&compare_data);
+  }
+  t8_forest_ghost_exchange_plan_destroy (&plan);
+  ASSERT_EQ (plan, nullptr);
+  /* clean-up */
+  sc_array_reset (&element_data);
+}
+
 TEST_P (forest_ghost_exchange, test_ghost_exchange)
 {
 
@@ -185,11 +239,15 @@ TEST_P (forest_ghost_exchange, test_ghost_exchange)
     /* exchange ghost data */
     t8_test_ghost_exchange_data_int (forest);
     t8_test_ghost_exchange_data_id (forest);
+    t8_test_ghost_exchange_plan (forest, 0);
+    t8_test_ghost_exchange_plan (forest, 1);
     /* Adapt the forest and exchange data again */
     int maxlevel = level + 2;
     t8_forest_t forest_adapt = t8_forest_new_adapt (forest, t8_test_exchange_adapt, 1, 1, &maxlevel);
     t8_test_ghost_exchange_data_int (forest_adapt);
     t8_test_ghost_exchange_data_id (forest_adapt);
+    t8_test_ghost_exchange_plan (forest_adapt, 0);
+    t8_test_ghost_exchange_plan (forest_adapt, 1);
     t8_forest_unref (&forest_adapt);
   }
 }
@@ -0,0 +1,181 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we compute the leaf face neighbors of all local leaves of an
+ * unbalanced forest, where the first element of the first tree is refined
+ * several levels deeper than its neighbors. We check that the neighbor relation
+ * is symmetric for local neighbors and that the local neighbors are the leaves
+ * at the returned indices. On a balanced forest we compare the result with the
+ * balanced version of t8_forest_leaf_face_neighbors. */
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <test/t8_gtest_macros.hxx>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+class forest_leaf_face_neighbors: public testing::TestWithParam<t8_eclass_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    scheme = t8_scheme_new_default_cxx ();
+    t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    forest_uniform = t8_forest_new_uniform (cmesh, scheme, level, 0, sc_MPI_COMM_WORLD);
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest_uniform);
+  }
+  /* Refine the first element of the first tree recursively and create a ghost layer.
+   * If do_balance is true, the forest is balanced afterwards. */
+  t8_forest_t
+  adapt_forest (int do_balance)
+  {
+    t8_forest_t forest;
+
+    t8_forest_ref (forest_uniform);
+    t8_forest_init (&forest);
+    t8_forest_set_user_data (forest, (void *) &max_level);
+    t8_forest_set_adapt (forest, forest_uniform, t8_test_refine_first_element, 1);
+    t8_forest_set_partition (forest, NULL, 0);
+    if (do_balance) {
+      t8_forest_set_balance (forest, NULL, 0);
+    }
+    t8_forest_set_ghost (forest, 1, T8_GHOST_FACES);
+    t8_forest_commit (forest);
+    return forest;
+  }
+  /* Refine the first element of the first tree up to the maximum level */
+  static int
+  t8_test_refine_first_element (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                                t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
+                                const int num_elements, t8_element_t *elements[])
+  {
+    const int max_level = *(const int *) t8_forest_get_user_data (forest);
+    const int element_level = ts->t8_element_level (elements[0]);
+    return t8_forest_global_tree_id (forest_from, which_tree) == 0 && element_level < max_level
+           && ts->t8_element_get_linear_id (elements[0], element_level) == 0;
+  }
+  t8_eclass_t eclass;
+  t8_scheme_cxx_t *scheme;
+  t8_forest_t forest_uniform;
+  const int level = 1;
+  const int max_level = 5;
+};
+
+/* Compute the leaf face neighbors of a leaf as sorted pairs of element index and dual face. */
+static std::vector<std::pair<t8_locidx_t, int>>
+t8_test_leaf_face_neighbors (t8_forest_t forest, t8_locidx_t itree, const t8_element_t *element, int face,
+                             int forest_is_balanced)
+{
+  std::vector<std::pair<t8_locidx_t, int>> neighbors;
+  t8_element_t **neighbor_leaves;
+  t8_locidx_t *element_indices;
+  t8_eclass_scheme_c *neigh_scheme;
+  int *dual_faces;
+  int num_neighbors;
+
+  t8_forest_leaf_face_neighbors (forest, itree, element, &neighbor_leaves, face, &dual_faces, &num_neighbors,
+                                 &element_indices, &neigh_scheme, forest_is_balanced);
+  for (int ineigh = 0; ineigh < num_neighbors; ineigh++) {
+    neighbors.push_back (std::make_pair (element_indices[ineigh], dual_faces[ineigh]));
+    if (element_indices[ineigh] < t8_forest_get_local_num_elements (forest)) {
+      /* The neighbor is a local leaf, we check that it is stored at its index */
+      t8_locidx_t neigh_tree;
+      const t8_element_t *check_element = t8_forest_get_element (forest, element_indices[ineigh], &neigh_tree);
+      EXPECT_TRUE (neigh_scheme->t8_element_equal (check_element, neighbor_leaves[ineigh]));
+    }
+    else {
+      EXPECT_LT (element_indices[ineigh],
+                 t8_forest_get_local_num_elements (forest) + t8_forest_get_num_ghosts (forest));
+    }
+  }
+  if (num_neighbors > 0) {
+    neigh_scheme->t8_element_destroy (num_neighbors, neighbor_leaves);
+    T8_FREE (neighbor_leaves);
+    T8_FREE (element_indices);
+    T8_FREE (dual_faces);
+  }
+  else {
+    EXPECT_EQ (neighbor_leaves, nullptr);
+  }
+  std::sort (neighbors.begin (), neighbors.end ());
+  return neighbors;
+}
+
+TEST_P (forest_leaf_face_neighbors, unbalanced_symmetric)
+{
+  t8_forest_t forest = adapt_forest (0);
+  t8_locidx_t lelement_id = 0;
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    for (t8_locidx_t ielement = 0; ielement < t8_forest_get_tree_num_elements (forest, itree);
+         ielement++, lelement_id++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      for (int face = 0; face < ts->t8_element_num_faces (element); face++) {
+        const std::vector<std::pair<t8_locidx_t, int>> neighbors
+          = t8_test_leaf_face_neighbors (forest, itree, element, face, 0);
+        for (const auto &neighbor : neighbors) {
+          if (neighbor.first >= t8_forest_get_local_num_elements (forest)) {
+            continue;
+          }
+          /* The leaf must be a face neighbor of its local neighbor across the dual face */
+          t8_locidx_t neigh_tree;
+          const t8_element_t *neigh_element = t8_forest_get_element (forest, neighbor.first, &neigh_tree);
+          const std::vector<std::pair<t8_locidx_t, int>> back_neighbors
+            = t8_test_leaf_face_neighbors (forest, neigh_tree, neigh_element, neighbor.second, 0);
+          EXPECT_TRUE (std::find (back_neighbors.begin (), back_neighbors.end (), std::make_pair (lelement_id, face))
+                       != back_neighbors.end ())
+            << "element " << lelement_id << " face " << face << " neighbor " << neighbor.first;
+        }
+      }
+    }
+  }
+  t8_forest_unref (&forest);
+}
+
+TEST_P (forest_leaf_face_neighbors, balanced_compare)
+{
+  t8_forest_t forest = adapt_forest (1);
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    for (t8_locidx_t ielement = 0; ielement < t8_forest_get_tree_num_elements (forest, itree); ielement++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      for (int face = 0; face < ts->t8_element_num_faces (element); face++) {
+        EXPECT_EQ (t8_test_leaf_face_neighbors (forest, itree, element, face, 0),
+                   t8_test_leaf_face_neighbors (forest, itree, element, face, 1))
+          << "tree " << itree << " element " << ielement << " face " << face;
+      }
+    }
+  }
+  t8_forest_unref (&forest);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_leaf_face_neighbors, forest_leaf_face_neighbors, AllEclasses, print_eclass);
@@ -251,3 +251,72 @@ TEST (partition_data, test_partition_data)
   t8_forest_unref (&initial_forest);
   t8_forest_unref (&partitioned_forest);
 }
+
+/**
+ * \brief Test the transfer of several arrays of different element sizes with one
+ * \see t8_forest_partition_data_transfer_t. While the transfer is in progress, the ghost
+ * layer of the partitioned forest is created.
+ */
+TEST (partition_data, test_partition_data_transfer)
+{
+  t8_cmesh_t cmesh = t8_cmesh_new_hypercube (T8_ECLASS_QUAD, sc_MPI_COMM_WORLD, 0, 0, 0);
+  t8_forest_t base_forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 1, 0, sc_MPI_COMM_WORLD);
+  t8_forest_t initial_forest = t8_forest_new_adapt (base_forest, t8_test_partition_data_adapt, 1, 0, NULL);
+  t8_forest_ref (initial_forest);
+  t8_forest_t partitioned_forest;
+  t8_forest_init (&partitioned_forest);
+  t8_forest_set_partition (partitioned_forest, initial_forest, 0);
+  t8_forest_commit (partitioned_forest);
+
+  /* Three fields with different element sizes, each storing the global element id */
+  const t8_locidx_t num_in = t8_forest_get_local_num_elements (initial_forest);
+  const t8_locidx_t num_out = t8_forest_get_local_num_elements (partitioned_forest);
+  const t8_gloidx_t first_in = t8_forest_get_first_local_element_id (initial_forest);
+  const t8_gloidx_t first_out = t8_forest_get_first_local_element_id (partitioned_forest);
+  std::vector<int32_t> ids_in (num_in), ids_out (num_out);
+  std::vector<double> values_in (num_in), values_out (num_out);
+  std::vector<t8_test_partition_data_t> custom_in (num_in), custom_out (num_out);
+  std::iota (ids_in.begin (), ids_in.end (), static_cast<int32_t> (first_in));
+  std::iota (values_in.begin (), values_in.end (), static_cast<double> (first_in));
+  std::iota (custom_in.begin (), custom_in.end (), t8_test_partition_data_t (first_in));
+
+  sc_array_t* arrays_in[3]
+    = { sc_array_new_data (ids_in.data (), sizeof (int32_t), num_in),
+        sc_array_new_data (values_in.data (), sizeof (double), num_in),
+        sc_array_new_data (custom_in.data (), sizeof (t8_test_partition_data_t), num_in) };
+  sc_array_t* arrays_out[3]
+    = { sc_array_new_data (ids_out.data (), sizeof (int32_t), num_out),
+        sc_array_new_data (values_out.data (), sizeof (double), num_out),
+        sc_array_new_data (custom_out.data (), sizeof (t8_test_partition_data_t), num_out) };
+
+  t8_forest_partition_data_transfer_t transfer
+    = t8_forest_partition_data_transfer_new (initial_forest, partitioned_forest);
+  for (int ifield = 0; ifield < 3; ++ifield) {
+    t8_forest_partition_data_transfer_add (transfer, arrays_in[ifield], arrays_out[ifield]);
+  }
+  t8_forest_partition_data_transfer_begin (transfer);
+  /* Overlap the transfer with the creation of the ghost layer */
+  t8_forest_t ghost_forest;
+  t8_forest_init (&ghost_forest);
+  t8_forest_ref (partitioned_forest);
+  t8_forest_set_copy (ghost_forest, partitioned_forest);
+  t8_forest_set_ghost (ghost_forest, 1, T8_GHOST_FACES);
+  t8_forest_commit (ghost_forest);
+  t8_forest_partition_data_transfer_end (&transfer);
+  EXPECT_EQ (transfer, nullptr);
+
+  for (t8_locidx_t ielem = 0; ielem < num_out; ++ielem) {
+    const t8_gloidx_t global_id = first_out + ielem;
+    EXPECT_EQ (ids_out[ielem], global_id);
+    EXPECT_TRUE (gTestCompareEQ (values_out[ielem], static_cast<double> (global_id)));
+    EXPECT_EQ (custom_out[ielem].GetData (), global_id);
+  }
+
+  for (int ifield = 0; ifield < 3; ++ifield) {
+    sc_array_destroy (arrays_in[ifield]);
+    sc_array_destroy (arrays_out[ifield]);
+  }
+  t8_forest_unref (&ghost_forest);
+  t8_forest_unref (&initial_forest);
+  t8_forest_unref (&partitioned_forest);
+}
@@ -0,0 +1,127 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we partition a forest with element weights and check that
+ * the weights of the elements on each process sum up to at most the average
+ * plus the largest weight. We also check that the callback and the array of
+ * weights lead to the same forest. */
+
+#include <gtest/gtest.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_cmesh.h>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+#include <test/t8_gtest_macros.hxx>
+#include <vector>
+
+class forest_partition_weights: public testing::TestWithParam<t8_eclass_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    const t8_eclass_t eclass = GetParam ();
+    t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, 0, 0);
+    forest = t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 3, 0, sc_MPI_COMM_WORLD);
+  }
+  void
+  TearDown () override
+  {
+    t8_forest_unref (&forest);
+  }
+  t8_forest_t forest;
+};
+
+/* The first child of each family is ten times as expensive as the others. */
+static const double t8_test_max_weight = 10;
+
+static double
+t8_test_partition_weight (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                          t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const t8_element_t *element)
+{
+  return ts->t8_element_child_id (element) == 0 ? t8_test_max_weight : 1;
+}
+
+/* Sum up the weights of all local elements of a forest */
+static double
+t8_test_local_weight (t8_forest_t forest)
+{
+  double weight = 0;
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    for (t8_locidx_t ielement = 0; ielement < t8_forest_get_tree_num_elements (forest, itree); ielement++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      weight += t8_test_partition_weight (forest, forest, itree, ielement, ts, element);
+    }
+  }
+  return weight;
+}
+
+TEST_P (forest_partition_weights, balanced_weights)
+{
+  int mpisize;
+  int mpiret = sc_MPI_Comm_size (sc_MPI_COMM_WORLD, &mpisize);
+  SC_CHECK_MPI (mpiret);
+
+  /* Partition with a weight callback */
+  t8_forest_t forest_fn;
+  t8_forest_ref (forest);
+  t8_forest_init (&forest_fn);
+  t8_forest_set_partition (forest_fn, forest, 0);
+  t8_forest_set_partition_weights (forest_fn, t8_test_partition_weight);
+  t8_forest_commit (forest_fn);
+
+  /* Partition with an array of weights */
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  std::vector<double> weights (num_elements);
+  t8_locidx_t lelement_id = 0;
+  for (t8_locidx_t itree = 0; itree < t8_forest_get_num_local_trees (forest); itree++) {
+    t8_eclass_scheme_c *ts = t8_forest_get_eclass_scheme (forest, t8_forest_get_tree_class (forest, itree));
+    for (t8_locidx_t ielement = 0; ielement < t8_forest_get_tree_num_elements (forest, itree); ielement++) {
+      const t8_element_t *element = t8_forest_get_element_in_tree (forest, itree, ielement);
+      weights[lelement_id++] = t8_test_partition_weight (forest, forest, itree, ielement, ts, element);
+    }
+  }
+  t8_forest_t forest_array;
+  t8_forest_ref (forest);
+  t8_forest_init (&forest_array);
+  t8_forest_set_partition (forest_array, forest, 0);
+  t8_forest_set_partition_weights_array (forest_array, weights.data ());
+  t8_forest_commit (forest_array);
+
+  EXPECT_TRUE (t8_forest_is_equal (forest_fn, forest_array));
+  EXPECT_EQ (t8_forest_get_global_num_elements (forest_fn), t8_forest_get_global_num_elements (forest));
+
+  /* Each process must have at most the average weight plus one maximal element weight */
+  const double local_weight = t8_test_local_weight (forest_fn);
+  double total_weight;
+  double max_weight;
+  mpiret = sc_MPI_Allreduce (&local_weight, &total_weight, 1, sc_MPI_DOUBLE, sc_MPI_SUM, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  mpiret = sc_MPI_Allreduce (&local_weight, &max_weight, 1, sc_MPI_DOUBLE, sc_MPI_MAX, sc_MPI_COMM_WORLD);
+  SC_CHECK_MPI (mpiret);
+  EXPECT_LE (max_weight, total_weight / mpisize + t8_test_max_weight);
+
+  t8_forest_unref (&forest_fn);
+  t8_forest_unref (&forest_array);
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_partition_weights, forest_partition_weights, AllEclasses, print_eclass);
@@ -152,4 +152,72 @@ TEST_P (forest_search, test_search_one_query_matches_all)
   sc_array_reset (&queries);
 }
 
+/* A search function that continues the search for all elements. */
+static int
+t8_test_search_continue_fn (t8_forest_t forest, const t8_locidx_t ltreeid, const t8_element_t *element,
+                            const int is_leaf, const t8_element_array_t *leaf_elements,
+                            const t8_locidx_t tree_leaf_index)
+{
+  return 1;
+}
+
+/* A query function for queries that are local leaf indices.
+ * An element matches a query if the leaf with this index is a descendant of the element.
+ * This function assumes that the forest user pointer is an sc_array
+ * with one int for each local leaf, which counts how often the leaf was found.
+ */
+static void
+t8_test_search_query_leaf_fn (t8_forest_t forest, t8_locidx_t ltreeid, const t8_element_t *element,
+                              const int is_leaf, const t8_element_array_t *leaf_elements,
+                              const t8_locidx_t tree_leaf_index, sc_array_t *queries, sc_array_t *query_indices,
+                              int *query_matches, const size_t num_active_queries)
+{
+  sc_array_t *found_leaves = (sc_array_t *) t8_forest_get_user_data (forest);
+  const t8_locidx_t first_leaf = t8_forest_get_tree_element_offset (forest, ltreeid) + tree_leaf_index;
+  const t8_locidx_t num_leaves = t8_element_array_get_count (leaf_elements);
+
+  EXPECT_EQ (query_indices->elem_count, num_active_queries) << "Wrong number of query indices.";
+  for (size_t iquery = 0; iquery < num_active_queries; iquery++) {
+    const size_t query_index = *(size_t *) sc_array_index (query_indices, iquery);
+    if (iquery > 0) {
+      /* The active queries keep their order */
+      EXPECT_LT (*(size_t *) sc_array_index (query_indices, iquery - 1), query_index);
+    }
+    const t8_locidx_t leaf = *(t8_locidx_t *) sc_array_index (queries, query_index);
+    query_matches[iquery] = first_leaf <= leaf && leaf < first_leaf + num_leaves;
+    if (is_leaf && query_matches[iquery]) {
+      EXPECT_EQ (leaf, first_leaf) << "Leaf query matched the wrong element.";
+      *(int *) t8_sc_array_index_locidx (found_leaves, leaf) += 1;
+    }
+  }
+}
+
+TEST_P (forest_search, test_search_leaf_queries)
+{
+  sc_array_t queries;
+  sc_array_t found_leaves;
+
+  const t8_locidx_t num_elements = t8_forest_get_local_num_elements (forest);
+  /* set up one query for each leaf, in reversed order */
+  sc_array_init_size (&queries, sizeof (t8_locidx_t), num_elements);
+  sc_array_init_size (&found_leaves, sizeof (int), num_elements);
+  for (t8_locidx_t ielement = 0; ielement < num_elements; ++ielement) {
+    *(t8_locidx_t *) t8_sc_array_index_locidx (&queries, ielement) = num_elements - 1 - ielement;
+    *(int *) t8_sc_array_index_locidx (&found_leaves, ielement) = 0;
+  }
+
+  t8_forest_set_user_data (forest, &found_leaves);
+  /* Each query is passed down to exactly one leaf. */
+  t8_forest_search (forest, t8_test_search_continue_fn, t8_test_search_query_leaf_fn, &queries);
+
+  for (t8_locidx_t ielement = 0; ielement < num_elements; ++ielement) {
+    ASSERT_EQ (*(int *) t8_sc_array_index_locidx (&found_leaves, ielement), 1)
+      << "Leaf " << ielement << " was not found exactly once.";
+  }
+
+  t8_forest_unref (&forest);
+  sc_array_reset (&found_leaves);
+  sc_array_reset (&queries);
+}
+
 INSTANTIATE_TEST_SUITE_P (t8_gtest_search, forest_search, testing::Combine (AllEclasses, testing::Range (0, 6)));
@@ -111,6 +111,13 @@ sample (t8_eclass_t eclass, uint32_t n_point)
       pt[2] = 0;
     }
     break;
+  case T8_ECLASS_TRIANGLE:
+    for (auto &pt : points) {
+      pt[0] = random_number ();
+      pt[1] = random_number () * pt[0];
+      pt[2] = 0;
+    }
+    break;
   case T8_ECLASS_QUAD:
     for (auto &pt : points) {
       pt[0] = random_number ();
@@ -240,6 +247,46 @@ TEST_P (LagrangeCmesh, lagrange_mapping)
   }
 }
 
+/**
+ * Check that mapping several points at once gives the same result as
+ * mapping them one by one.
+ */
+TEST_P (LagrangeCmesh, batch_evaluation)
+{
+  t8_lagrange_element lag = create_sample_element (eclass, degree);
+  const auto points = sample (eclass, T8_NUM_SAMPLE_POINTS);
+  const auto mapped = lag.evaluate (points);
+  ASSERT_EQ (mapped.size (), points.size ());
+  for (size_t i_point = 0; i_point < points.size (); ++i_point) {
+    EXPECT_TRUE (allclose (mapped[i_point], lag.evaluate (points[i_point])));
+  }
+}
+
+/**
+ * Compare the analytic Jacobian with central finite differences of the mapping.
+ */
+TEST_P (LagrangeCmesh, jacobian)
+{
+  t8_lagrange_element lag = create_sample_element (eclass, degree);
+  const int dim = t8_eclass_to_dimension[eclass];
+  const double step = 1e-5;
+  for (const auto &point : sample (eclass, T8_NUM_SAMPLE_POINTS)) {
+    const auto jacobian = lag.jacobian (point);
+    for (int i_dir = 0; i_dir < dim; ++i_dir) {
+      auto point_plus = point;
+      auto point_minus = point;
+      point_plus[i_dir] += step;
+      point_minus[i_dir] -= step;
+      const auto mapped_plus = lag.evaluate (point_plus);
+      const auto mapped_minus = lag.evaluate (point_minus);
+      for (int i_dim = 0; i_dim < T8_ECLASS_MAX_DIM; ++i_dim) {
+        const double difference = (mapped_plus[i_dim] - mapped_minus[i_dim]) / (2 * step);
+        EXPECT_NEAR (jacobian[i_dir * T8_ECLASS_MAX_DIM + i_dim], difference, 1e-6);
+      }
+    }
+  }
+}
+
 /* clang-format off */
 INSTANTIATE_TEST_SUITE_P (t8_gtest_geometry_lagrange, LagrangeCmesh,
   testing::Combine (AllEclasses, testing::Range (1, T8_GEOMETRY_MAX_POLYNOMIAL_DEGREE + 1)),
@@ -33,7 +33,10 @@
 #include <t8_geometry/t8_geometry.h>
 #include <t8_geometry/t8_geometry_implementations/t8_geometry_linear.hxx>
 #include <t8_geometry/t8_geometry_implementations/t8_geometry_linear_axis_aligned.hxx>
+#include <t8_geometry/t8_geometry_helpers.h>
 #include <t8_element.h>
+#include <algorithm>
+#include <functional>
 
 class geometry_test: public testing::TestWithParam<std::tuple<int, t8_eclass>> {
  public:
@@ -104,8 +107,6 @@ int geometry_test::seed;
  * check whether the evaluation is correct. */
 TEST_P (geometry_test, cmesh_geometry)
 {
-  /* TODO: Add a test for the jacobian, as soon as its implemented. */
-
   /* Create random points in [0,1]^d and check if they are mapped correctly. */
 
   double point_mapped[3];
@@ -137,6 +138,116 @@ TEST_P (geometry_test, cmesh_geometry)
   }
 }
 
+/* The tree of the cmesh is the reference tree itself, hence the jacobian
+ * at each point must be the identity. */
+TEST_P (geometry_test, cmesh_jacobian)
+{
+  const int dim = t8_eclass_to_dimension[eclass];
+  if (dim == 0) {
+    GTEST_SKIP ();
+  }
+  double points[T8_ECLASS_MAX_DIM * T8_ECLASS_MAX_DIM] = { 0 };
+  double jacobian[T8_ECLASS_MAX_DIM * T8_ECLASS_MAX_DIM * T8_ECLASS_MAX_DIM];
+
+  srand (seed);
+  for (int ipoint = 0; ipoint < T8_NUM_SAMPLE_POINTS; ++ipoint) {
+    /* Evaluate the jacobian at three points at once with coordinates in [0,1/2]
+     * such that they lie inside the reference pyramid and away from its tip. */
+    for (int icoord = 0; icoord < T8_ECLASS_MAX_DIM * dim; ++icoord) {
+      points[icoord] = 0.5 * rand () / RAND_MAX;
+    }
+    if (eclass == T8_ECLASS_PYRAMID) {
+      for (int ip = 0; ip < T8_ECLASS_MAX_DIM; ++ip) {
+        points[ip * dim] += 0.5;
+        points[ip * dim + 1] += 0.5;
+      }
+    }
+    t8_geometry_jacobian (cmesh, 0, points, T8_ECLASS_MAX_DIM, jacobian);
+    for (int ip = 0; ip < T8_ECLASS_MAX_DIM; ++ip) {
+      for (int jdim = 0; jdim < dim; ++jdim) {
+        for (int kdim = 0; kdim < T8_ECLASS_MAX_DIM; ++kdim) {
+          EXPECT_NEAR (jacobian[T8_ECLASS_MAX_DIM * (ip * dim + jdim) + kdim], jdim == kdim ? 1 : 0,
+                       T8_PRECISION_SQRT_EPS);
+        }
+      }
+    }
+  }
+}
+
+/* Compute a random point inside the reference element of eclass. */
+static void
+t8_test_random_reference_point (const t8_eclass_t eclass, double *point)
+{
+  double values[3];
+  for (int idim = 0; idim < 3; ++idim) {
+    values[idim] = (double) rand () / RAND_MAX;
+  }
+  switch (eclass) {
+  case T8_ECLASS_TRIANGLE:
+  case T8_ECLASS_TET:
+    /* 1 >= x >= y (>= z) >= 0 */
+    std::sort (values, values + 3, std::greater<double> ());
+    break;
+  case T8_ECLASS_PRISM:
+    /* 1 >= x >= y >= 0, z arbitrary */
+    std::sort (values, values + 2, std::greater<double> ());
+    break;
+  case T8_ECLASS_PYRAMID:
+    /* x, y >= z, keep away from the tip */
+    values[2] *= 0.9;
+    values[0] = values[2] + (1 - values[2]) * values[0];
+    values[1] = values[2] + (1 - values[2]) * values[1];
+    break;
+  default:
+    break;
+  }
+  for (int idim = 0; idim < t8_eclass_to_dimension[eclass]; ++idim) {
+    point[idim] = values[idim];
+  }
+}
+
+/* Compare the jacobian of the linear geometry of trees with random vertices
+ * against central finite differences of the geometry. */
+TEST (test_geometry_linear, jacobian_finite_differences)
+{
+  const double h = 1e-6;
+  srand (0);
+  for (int ieclass = T8_ECLASS_LINE; ieclass < T8_ECLASS_COUNT; ++ieclass) {
+    const t8_eclass_t eclass = (t8_eclass_t) ieclass;
+    const int dim = t8_eclass_to_dimension[eclass];
+    const int num_vertices = t8_eclass_num_vertices[eclass];
+    double vertices[T8_ECLASS_MAX_CORNERS * T8_ECLASS_MAX_DIM];
+    /* Perturb the reference vertices to obtain a valid tree */
+    for (int ivertex = 0; ivertex < num_vertices; ++ivertex) {
+      for (int idim = 0; idim < T8_ECLASS_MAX_DIM; ++idim) {
+        vertices[ivertex * T8_ECLASS_MAX_DIM + idim]
+          = t8_element_corner_ref_coords[eclass][ivertex][idim] + 0.2 * rand () / RAND_MAX;
+      }
+    }
+    for (int ipoint = 0; ipoint < T8_NUM_SAMPLE_POINTS / 10; ++ipoint) {
+      double point[T8_ECLASS_MAX_DIM] = { 0 };
+      double jacobian[T8_ECLASS_MAX_DIM * T8_ECLASS_MAX_DIM];
+      t8_test_random_reference_point (eclass, point);
+      t8_geom_compute_linear_geometry_jacobian (eclass, vertices, point, 1, jacobian);
+      for (int jdim = 0; jdim < dim; ++jdim) {
+        double point_plus[T8_ECLASS_MAX_DIM], point_minus[T8_ECLASS_MAX_DIM];
+        double mapped_plus[T8_ECLASS_MAX_DIM], mapped_minus[T8_ECLASS_MAX_DIM];
+        std::copy (point, point + T8_ECLASS_MAX_DIM, point_plus);
+        std::copy (point, point + T8_ECLASS_MAX_DIM, point_minus);
+        point_plus[jdim] += h;
+        point_minus[jdim] -= h;
+        t8_geom_compute_linear_geometry (eclass, vertices, point_plus, 1, mapped_plus);
+        t8_geom_compute_linear_geometry (eclass, vertices, point_minus, 1, mapped_minus);
+        for (int kdim = 0; kdim < T8_ECLASS_MAX_DIM; ++kdim) {
+          EXPECT_NEAR (jacobian[T8_ECLASS_MAX_DIM * jdim + kdim], (mapped_plus[kdim] - mapped_minus[kdim]) / (2 * h),
+                       1e-6)
+            << "eclass " << t8_eclass_to_string[eclass] << ", derivative of coordinate " << kdim << " by " << jdim;
+        }
+      }
+    }
+  }
+}
+
 auto print_test = [] (const testing::TestParamInfo<std::tuple<int, t8_eclass>> &info) {
   std::string name;
   const int geom_int = std::get<0> (info.param);
@@ -0,0 +1,75 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_gtest_adapt_helpers.hxx
+* Provide an adapt callback and an adapted forest that are shared by several forest tests
+*/
+
+#ifndef T8_GTEST_ADAPT_HELPERS_HXX
+#define T8_GTEST_ADAPT_HELPERS_HXX
+
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <t8_cmesh/t8_cmesh_examples.h>
+#include <t8_forest/t8_forest_general.h>
+
+/**
+ * Adapt callback that refines the first child of each family up to level 3.
+ * Used recursively on a uniform forest, this creates a forest with elements of levels 1 to 3.
+ */
+inline int
+t8_gtest_adapt_first_child (t8_forest_t forest, t8_forest_t forest_from, t8_locidx_t which_tree,
+                            t8_locidx_t lelement_id, t8_eclass_scheme_c *ts, const int is_family,
+                            const int num_elements, t8_element_t *elements[])
+{
+  return ts->t8_element_level (elements[0]) < 3 && ts->t8_element_child_id (elements[0]) == 0;
+}
+
+/**
+ * Create a uniform forest of level 1 on the hypercube of an element class.
+ *
+ * \param[in] eclass The element class of the hypercube
+ * \param[in] cmesh_partitioned If true, the coarse mesh is partitioned
+ * \return t8_forest_t A committed forest on sc_MPI_COMM_WORLD
+ */
+inline t8_forest_t
+t8_gtest_new_uniform_hypercube_forest (const t8_eclass_t eclass, const int cmesh_partitioned = 0)
+{
+  t8_cmesh_t cmesh = t8_cmesh_new_hypercube (eclass, sc_MPI_COMM_WORLD, 0, cmesh_partitioned, 0);
+  return t8_forest_new_uniform (cmesh, t8_scheme_new_default_cxx (), 1, 0, sc_MPI_COMM_WORLD);
+}
+
+/**
+ * Create the forest of \ref t8_gtest_new_uniform_hypercube_forest and refine it
+ * recursively with \ref t8_gtest_adapt_first_child.
+ *
+ * \param[in] eclass The element class of the hypercube
+ * \param[in] cmesh_partitioned If true, the coarse mesh is partitioned
+ * \return t8_forest_t A committed, adapted forest on sc_MPI_COMM_WORLD
+ */
+inline t8_forest_t
+t8_gtest_new_adapted_hypercube_forest (const t8_eclass_t eclass, const int cmesh_partitioned = 0)
+{
+  t8_forest_t forest_uniform = t8_gtest_new_uniform_hypercube_forest (eclass, cmesh_partitioned);
+  return t8_forest_new_adapt (forest_uniform, t8_gtest_adapt_first_child, 1, 0, NULL);
+}
+
+#endif /* T8_GTEST_ADAPT_HELPERS_HXX */
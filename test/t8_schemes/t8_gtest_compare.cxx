@@ -0,0 +1,92 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2015 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/* In this test we check that t8_element_compare is consistent with the linear ids.
+ * For two elements of possibly different levels, the element with the smaller linear id at
+ * the maximum of both levels is smaller. If these ids coincide, the element of smaller level is smaller. */
+
+#include <gtest/gtest.h>
+#include <t8_eclass.h>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#include <test/t8_gtest_macros.hxx>
+
+class class_test_compare: public testing::TestWithParam<t8_eclass_t> {
+ protected:
+  void
+  SetUp () override
+  {
+    scheme = t8_scheme_new_default_cxx ();
+    ts = scheme->eclass_schemes[GetParam ()];
+    ts->t8_element_new (1, &elem1);
+    ts->t8_element_new (1, &elem2);
+  }
+  void
+  TearDown () override
+  {
+    ts->t8_element_destroy (1, &elem1);
+    ts->t8_element_destroy (1, &elem2);
+    t8_scheme_cxx_unref (&scheme);
+  }
+  t8_scheme_cxx *scheme;
+  t8_eclass_scheme_c *ts;
+  t8_element_t *elem1;
+  t8_element_t *elem2;
+};
+
+/* Return the sign of a comparison result */
+static int
+t8_test_sign (const int value)
+{
+  return (value > 0) - (value < 0);
+}
+
+TEST_P (class_test_compare, compare_with_linear_id)
+{
+#ifdef T8_ENABLE_LESS_TESTS
+  const int maxlvl = 3;
+#else
+  const int maxlvl = 4;
+#endif
+  for (int level1 = 0; level1 <= maxlvl; level1++) {
+    const t8_gloidx_t count1 = ts->t8_element_count_leaves_from_root (level1);
+    for (int level2 = 0; level2 <= maxlvl; level2++) {
+      const t8_gloidx_t count2 = ts->t8_element_count_leaves_from_root (level2);
+      const int level = SC_MAX (level1, level2);
+      /* Sample the element pairs with a stride to keep the test fast */
+      const t8_gloidx_t stride1 = SC_MAX (count1 / 64, 1);
+      const t8_gloidx_t stride2 = SC_MAX (count2 / 64, 1);
+      for (t8_gloidx_t id1 = 0; id1 < count1; id1 += stride1) {
+        ts->t8_element_set_linear_id (elem1, level1, id1);
+        const t8_linearidx_t linear_id1 = ts->t8_element_get_linear_id (elem1, level);
+        for (t8_gloidx_t id2 = 0; id2 < count2; id2 += stride2) {
+          ts->t8_element_set_linear_id (elem2, level2, id2);
+          const t8_linearidx_t linear_id2 = ts->t8_element_get_linear_id (elem2, level);
+          const int expected
+            = linear_id1 != linear_id2 ? (linear_id1 < linear_id2 ? -1 : 1) : t8_test_sign (level1 - level2);
+          EXPECT_EQ (t8_test_sign (ts->t8_element_compare (elem1, elem2)), expected);
+        }
+      }
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_compare, class_test_compare, AllEclasses, print_eclass);
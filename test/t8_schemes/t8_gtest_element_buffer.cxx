@@ -0,0 +1,114 @@
+/*
+  This file is part of t8code.
+  t8code is a C library to manage a collection (a forest) of multiple
+  connected adaptive space-trees of general element classes in parallel.
+
+  Copyright (C) 2024 the developers
+
+  t8code is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  t8code is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with t8code; if not, write to the Free Software Foundation, Inc.,
+  51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+*/
+
+/** \file t8_gtest_element_buffer.cxx
+ * Test the stack buffer for temporary elements and the allocation of
+ * elements from multiple threads.
+*/
+
+#include <gtest/gtest.h>
+#include <test/t8_gtest_custom_assertion.hxx>
+#include <test/t8_gtest_macros.hxx>
+#include <t8_eclass.h>
+#include <t8_element_buffer.hxx>
+#include <t8_schemes/t8_default/t8_default.hxx>
+#if T8_ENABLE_OPENMP
+#include <omp.h>
+#endif
+
+class element_buffer: public testing::TestWithParam<t8_eclass> {
+ protected:
+  void
+  SetUp () override
+  {
+    eclass = GetParam ();
+    scheme = t8_scheme_new_default_cxx ();
+    ts = scheme->eclass_schemes[eclass];
+  }
+  void
+  TearDown () override
+  {
+    t8_scheme_cxx_unref (&scheme);
+  }
+  t8_scheme_cxx *scheme;
+  t8_eclass_scheme_c *ts;
+  t8_eclass_t eclass;
+};
+
+/* The default elements must fit into the stack storage of the buffer. */
+TEST_P (element_buffer, fits_on_stack)
+{
+  EXPECT_LE (ts->t8_element_size (), (size_t) T8_ELEMENT_BUFFER_BYTES_PER_ELEMENT);
+}
+
+/* Compute the children of the root element in a buffer and compare them
+ * with children computed in elements allocated by the scheme. */
+TEST_P (element_buffer, children_equal_allocated)
+{
+  t8_element_buffer<1> root (ts);
+  ts->t8_element_root (root[0]);
+  const int num_children = ts->t8_element_num_children (root[0]);
+  /* Pyramids have the most children. */
+  ASSERT_LE (num_children, 10);
+
+  t8_element_buffer<10> children (ts, num_children);
+  EXPECT_EQ (children.size (), num_children);
+  ts->t8_element_children (root[0], num_children, children.data ());
+
+  t8_element_t *compare;
+  ts->t8_element_new (1, &compare);
+  for (int ichild = 0; ichild < num_children; ++ichild) {
+    EXPECT_TRUE (ts->t8_element_is_valid (children[ichild]));
+    ts->t8_element_child (root[0], ichild, compare);
+    EXPECT_ELEM_EQ (ts, children[ichild], compare);
+  }
+  ts->t8_element_destroy (1, &compare);
+}
+
+#if T8_ENABLE_OPENMP
+/* Allocate, use and destroy elements concurrently on multiple threads. */
+TEST_P (element_buffer, threaded_new_destroy)
+{
+  const int num_iterations = 100;
+  int num_errors = 0;
+  t8_element_buffer<1> root (ts);
+  ts->t8_element_root (root[0]);
+  const int num_children = ts->t8_element_num_children (root[0]);
+
+#pragma omp parallel num_threads (4) reduction (+ : num_errors)
+  {
+    t8_element_t *elements[2];
+    for (int iter = 0; iter < num_iterations; ++iter) {
+      ts->t8_element_new (2, elements);
+      ts->t8_element_set_linear_id (elements[0], 1, iter % num_children);
+      ts->t8_element_parent (elements[0], elements[1]);
+      if (ts->t8_element_level (elements[1]) != 0) {
+        num_errors++;
+      }
+      ts->t8_element_destroy (2, elements);
+    }
+  }
+  EXPECT_EQ (num_errors, 0);
+}
+#endif
+
+INSTANTIATE_TEST_SUITE_P (t8_gtest_element_buffer, element_buffer, AllEclasses, print_eclass);